@@ -0,0 +1,110 @@
+/*
+    SnoreToast is capable to invoke Windows 8 toast notifications.
+    Copyright (C) 2026  Hannah von Reth <vonreth@kde.org>
+
+    SnoreToast is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    SnoreToast is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with SnoreToast.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "benchmark.h"
+#include "benchinputs.h"
+
+#include "actionformatter.h"
+#include "mocknotificationbackend.h"
+#include "snoretoasts.h"
+
+#include <array>
+
+namespace {
+const std::array<std::wstring_view, 5> Buttons = { L"Open", L"Show log", L"Retry", L"Ignore",
+                                                   L"Report" };
+const std::filesystem::path Pipe = L"\\\\.\\pipe\\snoretoast-bench";
+const std::filesystem::path Application = L"C:\\Program Files\\Snore\\snore.exe";
+}
+
+// the launch arguments and five buttons of a toast, the per toast state is cached
+SNORETOAST_BENCHMARK(ActionFormatter_FiveButtons)
+{
+    ActionFormatter formatter;
+    formatter.setToast(L"4242", Pipe, Application);
+    std::wstring launch;
+    std::array<std::wstring, Buttons.size()> buttons;
+    const auto formatAll = [&] {
+        formatter.format(launch, SnoreToastActions::Actions::Clicked);
+        for (size_t i = 0; i < Buttons.size(); ++i) {
+            formatter.format(buttons[i], SnoreToastActions::Actions::ButtonClicked,
+                             { { L"button", Buttons[i] } });
+        }
+    };
+    // the first round sizes the buffers
+    formatAll();
+    state.setMaxAllocationsPerIteration(0);
+    while (state.keepRunning()) {
+        formatAll();
+        Benchmark::doNotOptimize(buttons.data());
+    }
+}
+
+SNORETOAST_BENCHMARK(ActionFormatter_FiveButtons_StackBuffer)
+{
+    ActionFormatter formatter;
+    formatter.setToast(L"4242", Pipe, Application);
+    state.setMaxAllocationsPerIteration(0);
+    wchar_t buffer[512];
+    while (state.keepRunning()) {
+        size_t size = formatter.format(buffer, std::size(buffer),
+                                       SnoreToastActions::Actions::Clicked);
+        for (const auto &button : Buttons) {
+            size += formatter.format(buffer, std::size(buffer),
+                                     SnoreToastActions::Actions::ButtonClicked,
+                                     { { L"button", button } });
+        }
+        Benchmark::doNotOptimize(size);
+        Benchmark::doNotOptimize(buffer);
+    }
+}
+
+// SnoreToasts::formatAction returning a new string, for comparison
+SNORETOAST_BENCHMARK(ActionFormatter_FiveButtons_NewStrings)
+{
+    MockNotificationBackend backend;
+    SnoreToasts toast(&backend, L"Snore.DesktopToasts");
+    toast.setId(L"4242");
+    toast.setPipeName(Pipe);
+    toast.setApplication(Application);
+    while (state.keepRunning()) {
+        Benchmark::doNotOptimize(toast.formatAction(SnoreToastActions::Actions::Clicked));
+        for (const auto &button : Buttons) {
+            Benchmark::doNotOptimize(toast.formatAction(SnoreToastActions::Actions::ButtonClicked,
+                                                        { { L"button", button } }));
+        }
+    }
+}
+
+// SnoreToasts::formatAction with a pipe name close to MAX_PATH
+SNORETOAST_BENCHMARK(ActionFormatter_FiveButtons_LongPipe)
+{
+    MockNotificationBackend backend;
+    SnoreToasts toast(&backend, L"Snore.DesktopToasts");
+    toast.setId(L"4242");
+    toast.setPipeName(BenchInputs::longPipe());
+    toast.setApplication(Application);
+    std::wstring out;
+    while (state.keepRunning()) {
+        toast.formatAction(out, SnoreToastActions::Actions::Clicked);
+        for (const auto &button : Buttons) {
+            toast.formatAction(out, SnoreToastActions::Actions::ButtonClicked,
+                               { { L"button", button } });
+        }
+        Benchmark::doNotOptimize(out.data());
+    }
+}
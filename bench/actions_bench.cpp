@@ -0,0 +1,108 @@
+/*
+    SnoreToast is capable to invoke Windows 8 toast notifications.
+    Copyright (C) 2026  Hannah von Reth <vonreth@kde.org>
+
+    SnoreToast is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    SnoreToast is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with SnoreToast.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "benchmark.h"
+
+#include "snoretoastactions.h"
+
+#include <map>
+#include <vector>
+
+namespace {
+template<typename CharT>
+std::vector<std::basic_string<CharT>> names()
+{
+    std::vector<std::basic_string<CharT>> out;
+    for (int i = 0; i < 6; ++i) {
+        out.emplace_back(
+                SnoreToastActions::actionString<CharT>(static_cast<SnoreToastActions::Actions>(i)));
+    }
+    // and a miss
+    auto miss = out.front();
+    miss.front() = static_cast<CharT>('C');
+    out.push_back(miss);
+    return out;
+}
+
+template<typename CharT>
+void classify(Benchmark::State &state)
+{
+    const auto input = names<CharT>();
+    state.setMaxAllocationsPerIteration(0);
+    while (state.keepRunning()) {
+        for (const auto &name : input) {
+            Benchmark::doNotOptimize(
+                    SnoreToastActions::getAction(std::basic_string_view<CharT>(name)));
+        }
+    }
+}
+
+// the lookup used before the perfect hash, for comparison
+SnoreToastActions::Actions linearMapLookup(const std::wstring &s)
+{
+    static const std::map<SnoreToastActions::Actions, std::wstring> actions = {
+        { SnoreToastActions::Actions::Clicked, L"clicked" },
+        { SnoreToastActions::Actions::Hidden, L"hidden" },
+        { SnoreToastActions::Actions::Dismissed, L"dismissed" },
+        { SnoreToastActions::Actions::Timedout, L"timedout" },
+        { SnoreToastActions::Actions::ButtonClicked, L"buttonClicked" },
+        { SnoreToastActions::Actions::TextEntered, L"textEntered" }
+    };
+    for (const auto &a : actions) {
+        if (a.second.compare(s) == 0) {
+            return a.first;
+        }
+    }
+    return SnoreToastActions::Actions::Error;
+}
+}
+
+SNORETOAST_BENCHMARK(Actions_GetAction_WChar)
+{
+    classify<wchar_t>(state);
+}
+
+SNORETOAST_BENCHMARK(Actions_GetAction_Char)
+{
+    classify<char>(state);
+}
+
+SNORETOAST_BENCHMARK(Actions_GetAction_Char16)
+{
+    classify<char16_t>(state);
+}
+
+SNORETOAST_BENCHMARK(Actions_GetActionString)
+{
+    state.setMaxAllocationsPerIteration(0);
+    while (state.keepRunning()) {
+        for (int i = 0; i < 6; ++i) {
+            Benchmark::doNotOptimize(SnoreToastActions::getActionString(
+                    static_cast<SnoreToastActions::Actions>(i)));
+        }
+    }
+}
+
+SNORETOAST_BENCHMARK(Actions_GetAction_LinearMap)
+{
+    const auto input = names<wchar_t>();
+    while (state.keepRunning()) {
+        for (const auto &name : input) {
+            Benchmark::doNotOptimize(linearMapLookup(name));
+        }
+    }
+}
@@ -0,0 +1,82 @@
+/*
+    SnoreToast is capable to invoke Windows 8 toast notifications.
+    Copyright (C) 2026  Hannah von Reth <vonreth@kde.org>
+
+    SnoreToast is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    SnoreToast is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with SnoreToast.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <filesystem>
+#include <iterator>
+#include <string>
+#include <vector>
+
+/**
+ * Reproducible inputs shared by the benchmarks, the same on every run and platform.
+ */
+namespace BenchInputs {
+constexpr size_t LongBodyLength = 2048;
+constexpr size_t LongPathLength = 240;
+constexpr size_t MaxButtons = 5;
+
+inline std::wstring shortBody()
+{
+    return L"The build of \"snoretoast\" finished in 42s & all tests <passed>.";
+}
+
+/**
+ * Words drawn from a fixed seed, including characters escaped in xml.
+ */
+inline std::wstring longBody()
+{
+    static const wchar_t *words[] = { L"build", L"finished", L"&", L"<tests>", L"\"snore\"",
+                                      L"toast", L"passed", L"in", L"42s" };
+    std::wstring out;
+    uint32_t seed = 42;
+    while (out.size() < LongBodyLength) {
+        seed = seed * 1664525u + 1013904223u;
+        out.append(words[(seed >> 16) % std::size(words)]);
+        out.push_back(L' ');
+    }
+    out.resize(LongBodyLength);
+    return out;
+}
+
+/**
+ * A pipe name close to MAX_PATH.
+ */
+inline std::filesystem::path longPipe()
+{
+    std::wstring out = L"\\\\.\\pipe\\snoretoast-";
+    out.append(LongPathLength - out.size(), L'p');
+    return out;
+}
+
+inline std::filesystem::path shortPipe()
+{
+    return L"\\\\.\\pipe\\snoretoast";
+}
+
+/**
+ * The first count of five button labels.
+ */
+inline std::vector<std::wstring> buttons(size_t count)
+{
+    static const wchar_t *labels[MaxButtons] = { L"Open", L"Show log", L"Retry", L"Ignore",
+                                                 L"Report" };
+    return std::vector<std::wstring>(labels, labels + std::min(count, MaxButtons));
+}
+};
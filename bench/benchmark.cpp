@@ -0,0 +1,298 @@
+/*
+    SnoreToast is capable to invoke Windows 8 toast notifications.
+    Copyright (C) 2026  Hannah von Reth <vonreth@kde.org>
+
+    SnoreToast is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    SnoreToast is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with SnoreToast.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "benchmark.h"
+#include "config.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <string>
+#include <vector>
+
+using namespace std::chrono;
+
+namespace {
+std::atomic<size_t> s_allocations { 0 };
+
+struct Entry
+{
+    const char *name;
+    Benchmark::Function function;
+};
+
+struct Result
+{
+    const char *name;
+    size_t iterations;
+    double nsPerOp;
+    double allocationsPerOp;
+    // 0 if the benchmark processes no bytes
+    double mbPerSecond;
+    bool failed;
+};
+
+enum class Format {
+    Table,
+    Json,
+    Csv
+};
+
+std::vector<Entry> &registry()
+{
+    static std::vector<Entry> _registry;
+    return _registry;
+}
+
+void usage(const char *self)
+{
+    std::printf("Usage: %s [--filter=<substring>] [--min-time=<seconds>] [--list]\n"
+                "          [--format=(table | json | csv)] [--output=<file>]\n",
+                self);
+}
+
+void writeTableHeader(FILE *out)
+{
+    std::fprintf(out, "%-48s %14s %14s %12s %12s\n", "benchmark", "iterations", "ns/op",
+                 "allocs/op", "MB/s");
+}
+
+void writeTableRow(FILE *out, const Result &result)
+{
+    std::fprintf(out, "%-48s %14zu %14.1f %12.2f", result.name, result.iterations,
+                 result.nsPerOp, result.allocationsPerOp);
+    if (result.mbPerSecond > 0) {
+        std::fprintf(out, " %12.1f", result.mbPerSecond);
+    }
+    std::fprintf(out, "\n");
+}
+
+// the names are identifiers, they need no escaping
+void writeJson(FILE *out, const std::vector<Result> &results)
+{
+    std::fprintf(out, "{\n  \"version\": \"%d.%d.%d\",\n  \"benchmarks\": [",
+                 SNORETOAST_VERSION_MAJOR, SNORETOAST_VERSION_MINOR, SNORETOAST_VERSION_PATCH);
+    for (size_t i = 0; i < results.size(); ++i) {
+        const auto &result = results[i];
+        std::fprintf(out,
+                     "%s\n    {\"name\": \"%s\", \"iterations\": %zu, \"ns_per_op\": %.3f, "
+                     "\"allocs_per_op\": %.3f, \"mb_per_s\": %.3f, \"failed\": %s}",
+                     i ? "," : "", result.name, result.iterations, result.nsPerOp,
+                     result.allocationsPerOp, result.mbPerSecond,
+                     result.failed ? "true" : "false");
+    }
+    std::fprintf(out, "\n  ]\n}\n");
+}
+
+void writeCsv(FILE *out, const std::vector<Result> &results)
+{
+    std::fprintf(out, "name,iterations,ns_per_op,allocs_per_op,mb_per_s,failed\n");
+    for (const auto &result : results) {
+        std::fprintf(out, "%s,%zu,%.3f,%.3f,%.3f,%d\n", result.name, result.iterations,
+                     result.nsPerOp, result.allocationsPerOp, result.mbPerSecond,
+                     result.failed ? 1 : 0);
+    }
+}
+}
+
+void *operator new(size_t size)
+{
+    s_allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void *p = std::malloc(size ? size : 1)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void *operator new[](size_t size)
+{
+    return operator new(size);
+}
+
+void operator delete(void *p) noexcept
+{
+    std::free(p);
+}
+
+void operator delete[](void *p) noexcept
+{
+    std::free(p);
+}
+
+void operator delete(void *p, size_t) noexcept
+{
+    std::free(p);
+}
+
+void operator delete[](void *p, size_t) noexcept
+{
+    std::free(p);
+}
+
+size_t Benchmark::allocationCount()
+{
+    return s_allocations.load(std::memory_order_relaxed);
+}
+
+Benchmark::State::State(size_t iterations) : m_iterations(iterations), m_remaining(iterations) { }
+
+size_t Benchmark::State::iterations() const
+{
+    return m_iterations;
+}
+
+nanoseconds Benchmark::State::elapsed() const
+{
+    return duration_cast<nanoseconds>(m_end - m_start);
+}
+
+void Benchmark::State::setBytesPerIteration(size_t bytes)
+{
+    m_bytesPerIteration = bytes;
+}
+
+size_t Benchmark::State::bytesPerIteration() const
+{
+    return m_bytesPerIteration;
+}
+
+size_t Benchmark::State::allocations() const
+{
+    return m_allocations;
+}
+
+void Benchmark::State::setMaxAllocationsPerIteration(size_t allocations)
+{
+    m_maxAllocationsPerIteration = allocations;
+}
+
+size_t Benchmark::State::maxAllocationsPerIteration() const
+{
+    return m_maxAllocationsPerIteration;
+}
+
+Benchmark::Registration::Registration(const char *name, Function function)
+{
+    registry().push_back({ name, function });
+}
+
+int main(int argc, char *argv[])
+{
+    std::string filter;
+    double minTime = 0.5;
+    bool list = false;
+    bool failed = false;
+    Format format = Format::Table;
+    std::string output;
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (arg.rfind("--filter=", 0) == 0) {
+            filter = arg.substr(std::strlen("--filter="));
+        } else if (arg.rfind("--min-time=", 0) == 0) {
+            minTime = std::atof(arg.c_str() + std::strlen("--min-time="));
+        } else if (arg == "--list") {
+            list = true;
+        } else if (arg == "--format=table") {
+            format = Format::Table;
+        } else if (arg == "--format=json") {
+            format = Format::Json;
+        } else if (arg == "--format=csv") {
+            format = Format::Csv;
+        } else if (arg.rfind("--output=", 0) == 0) {
+            output = arg.substr(std::strlen("--output="));
+        } else {
+            usage(argv[0]);
+            return arg == "--help" ? 0 : 1;
+        }
+    }
+
+    auto entries = registry();
+    std::sort(entries.begin(), entries.end(),
+              [](const Entry &a, const Entry &b) { return std::strcmp(a.name, b.name) < 0; });
+
+    FILE *out = stdout;
+    if (!output.empty()) {
+        out = std::fopen(output.c_str(), "w");
+        if (!out) {
+            std::fprintf(stderr, "Failed to open: %s\n", output.c_str());
+            return 1;
+        }
+    }
+    // the table is printed while running, the machine readable formats at the end
+    FILE *progress = format == Format::Table ? out : stderr;
+
+    const auto target = duration_cast<nanoseconds>(duration<double>(minTime));
+    if (!list) {
+        writeTableHeader(progress);
+    }
+    std::vector<Result> results;
+    for (const auto &entry : entries) {
+        if (!filter.empty() && std::strstr(entry.name, filter.c_str()) == nullptr) {
+            continue;
+        }
+        if (list) {
+            std::fprintf(out, "%s\n", entry.name);
+            continue;
+        }
+        size_t iterations = 1;
+        while (true) {
+            Benchmark::State state(iterations);
+            entry.function(state);
+            const auto elapsed = std::max(state.elapsed(), nanoseconds(1));
+            if (elapsed >= target || iterations >= 1000000000) {
+                Result result = {};
+                result.name = entry.name;
+                result.iterations = iterations;
+                result.nsPerOp = double(elapsed.count()) / double(iterations);
+                result.allocationsPerOp = double(state.allocations()) / double(iterations);
+                if (state.bytesPerIteration() > 0) {
+                    result.mbPerSecond =
+                            double(state.bytesPerIteration()) * 1000.0 / result.nsPerOp;
+                }
+                result.failed = result.allocationsPerOp
+                        > double(state.maxAllocationsPerIteration());
+                writeTableRow(progress, result);
+                if (result.failed) {
+                    std::fprintf(progress,
+                                 "FAILED: %s allocates, expected at most %zu allocations per "
+                                 "iteration\n",
+                                 entry.name, state.maxAllocationsPerIteration());
+                    failed = true;
+                }
+                results.push_back(result);
+                break;
+            }
+            // aim slightly above the target to avoid another round
+            const double factor = 1.4 * double(target.count()) / double(elapsed.count());
+            iterations = size_t(double(iterations) * std::clamp(factor, 2.0, 100.0));
+        }
+    }
+    if (!list) {
+        if (format == Format::Json) {
+            writeJson(out, results);
+        } else if (format == Format::Csv) {
+            writeCsv(out, results);
+        }
+    }
+    if (out != stdout) {
+        std::fclose(out);
+    }
+    return failed ? 1 : 0;
+}
@@ -0,0 +1,127 @@
+/*
+    SnoreToast is capable to invoke Windows 8 toast notifications.
+    Copyright (C) 2026  Hannah von Reth <vonreth@kde.org>
+
+    SnoreToast is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    SnoreToast is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with SnoreToast.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <limits>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+/**
+ * A minimal benchmark harness, benchmarks register themselves with SNORETOAST_BENCHMARK
+ * and are run by snoretoast_bench.
+ *
+ * SNORETOAST_BENCHMARK(MyCase)
+ * {
+ *     setup();
+ *     while (state.keepRunning()) {
+ *         Benchmark::doNotOptimize(work());
+ *     }
+ * }
+ */
+namespace Benchmark {
+/**
+ * The number of heap allocations of the process so far, snoretoast_bench replaces the global
+ * operator new to count them.
+ */
+size_t allocationCount();
+
+class State
+{
+public:
+    explicit State(size_t iterations);
+
+    /**
+     * The clock starts with the first call, code before the loop is not measured.
+     */
+    inline bool keepRunning()
+    {
+        if (!m_started) {
+            m_started = true;
+            m_allocations = allocationCount();
+            m_start = std::chrono::steady_clock::now();
+        }
+        if (m_remaining > 0) {
+            --m_remaining;
+            return true;
+        }
+        m_end = std::chrono::steady_clock::now();
+        m_allocations = allocationCount() - m_allocations;
+        return false;
+    }
+
+    size_t iterations() const;
+    std::chrono::nanoseconds elapsed() const;
+
+    /**
+     * The number of bytes processed by one iteration, reported as throughput.
+     */
+    void setBytesPerIteration(size_t bytes);
+    size_t bytesPerIteration() const;
+
+    /**
+     * The heap allocations done by the measured loop.
+     */
+    size_t allocations() const;
+    /**
+     * The benchmark fails if the loop allocates more often.
+     */
+    void setMaxAllocationsPerIteration(size_t allocations);
+    size_t maxAllocationsPerIteration() const;
+
+private:
+    size_t m_iterations;
+    size_t m_remaining;
+    size_t m_bytesPerIteration = 0;
+    size_t m_allocations = 0;
+    size_t m_maxAllocationsPerIteration = std::numeric_limits<size_t>::max();
+    bool m_started = false;
+    std::chrono::steady_clock::time_point m_start;
+    std::chrono::steady_clock::time_point m_end;
+};
+
+using Function = void (*)(State &);
+
+struct Registration
+{
+    Registration(const char *name, Function function);
+};
+
+/**
+ * Prevents the compiler from discarding the computation of value.
+ */
+template<typename T>
+inline void doNotOptimize(const T &value)
+{
+#ifdef _MSC_VER
+    static volatile const void *sink;
+    sink = &value;
+    _ReadWriteBarrier();
+#else
+    asm volatile("" : : "r,m"(value) : "memory");
+#endif
+}
+};
+
+#define SNORETOAST_BENCHMARK(NAME)                                                                 \
+    static void NAME(Benchmark::State &state);                                                     \
+    static const Benchmark::Registration NAME##_registration(#NAME, NAME);                        \
+    static void NAME(Benchmark::State &state)
@@ -0,0 +1,128 @@
+/*
+    SnoreToast is capable to invoke Windows 8 toast notifications.
+    Copyright (C) 2026  Hannah von Reth <vonreth@kde.org>
+
+    SnoreToast is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    SnoreToast is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with SnoreToast.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "benchmark.h"
+#include "benchinputs.h"
+
+#include "actionformatter.h"
+#include "callbackdata.h"
+
+#include <cstdint>
+#include <unordered_map>
+
+namespace {
+const std::wstring ButtonPayload =
+        L"action=buttonClicked;notificationId=4242;pipe=\\\\.\\pipe\\snoretoast;"
+        L"application=C:\\Program Files\\Snore\\snore.exe;button=Show log;version=0.9.1;";
+
+// the parser used before CallbackData, for comparison
+std::unordered_map<std::wstring_view, std::wstring_view> splitData(std::wstring_view data)
+{
+    std::unordered_map<std::wstring_view, std::wstring_view> out;
+    size_t start = 0;
+    for (size_t end = data.find(L";", start); end != std::wstring::npos;
+         start = end + 1, end = data.find(L";", start)) {
+        const std::wstring_view tmp(data.data() + start, end - start);
+        const auto pos = tmp.find(L"=");
+        if (pos > 0) {
+            out[tmp.substr(0, pos)] = tmp.substr(pos + 1);
+        }
+    }
+    return out;
+}
+
+// a 64K reply using all the characters that need to be escaped
+std::wstring escapedReplyPayload()
+{
+    std::wstring reply;
+    uint32_t seed = 7;
+    while (reply.size() < 64 * 1024) {
+        seed = seed * 1664525u + 1013904223u;
+        reply.push_back(static_cast<wchar_t>(L'a' + (seed >> 24) % 26));
+        if ((seed >> 16) % 64 == 0) {
+            reply.push_back(L"%;="[(seed >> 8) % 3]);
+        }
+    }
+    std::wstring payload = L"action=textEntered;notificationId=4242;";
+    ActionFormatter::appendField(payload, { L"text", reply });
+    return payload;
+}
+}
+
+SNORETOAST_BENCHMARK(CallbackData_ParseButton)
+{
+    CallbackData data;
+    data.parse(ButtonPayload);
+    state.setMaxAllocationsPerIteration(0);
+    while (state.keepRunning()) {
+        data.parse(ButtonPayload);
+        Benchmark::doNotOptimize(data.value(L"button"));
+    }
+    state.setBytesPerIteration(ButtonPayload.size() * sizeof(wchar_t));
+}
+
+SNORETOAST_BENCHMARK(CallbackData_ParseButtonLongPipe)
+{
+    const std::wstring payload = L"action=buttonClicked;notificationId=4242;pipe="
+            + BenchInputs::longPipe().wstring() + L";button=Show log;version=0.9.1;";
+    CallbackData data;
+    data.parse(payload);
+    state.setMaxAllocationsPerIteration(0);
+    while (state.keepRunning()) {
+        data.parse(payload);
+        Benchmark::doNotOptimize(data.value(L"button"));
+    }
+    state.setBytesPerIteration(payload.size() * sizeof(wchar_t));
+}
+
+SNORETOAST_BENCHMARK(CallbackData_ParseButton_UnorderedMap)
+{
+    while (state.keepRunning()) {
+        const auto data = splitData(ButtonPayload);
+        Benchmark::doNotOptimize(data.at(L"button"));
+    }
+    state.setBytesPerIteration(ButtonPayload.size() * sizeof(wchar_t));
+}
+
+SNORETOAST_BENCHMARK(CallbackData_ParseEscapedReply64K)
+{
+    const auto payload = escapedReplyPayload();
+    CallbackData data;
+    data.parse(payload);
+    state.setMaxAllocationsPerIteration(0);
+    while (state.keepRunning()) {
+        data.parse(payload);
+        Benchmark::doNotOptimize(data.value(L"text"));
+    }
+    state.setBytesPerIteration(payload.size() * sizeof(wchar_t));
+}
+
+SNORETOAST_BENCHMARK(CallbackData_EscapeReply64K)
+{
+    const auto payload = escapedReplyPayload();
+    const CallbackData data(payload);
+    const auto reply = data.value(L"text");
+    std::wstring out;
+    CallbackData::appendEscaped(out, reply);
+    state.setMaxAllocationsPerIteration(0);
+    while (state.keepRunning()) {
+        out.clear();
+        CallbackData::appendEscaped(out, reply);
+        Benchmark::doNotOptimize(out.data());
+    }
+    state.setBytesPerIteration(reply.size() * sizeof(wchar_t));
+}
@@ -0,0 +1,169 @@
+/*
+    SnoreToast is capable to invoke Windows 8 toast notifications.
+    Copyright (C) 2026  Hannah von Reth <vonreth@kde.org>
+
+    SnoreToast is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    SnoreToast is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with SnoreToast.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "benchmark.h"
+
+#include "callbackwriter.h"
+#include "snoretoastprotocol.h"
+#include "toastserver.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <filesystem>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace {
+constexpr size_t BatchSize = 100;
+
+std::filesystem::path socketName(const char *name)
+{
+#ifdef _WIN32
+    return std::filesystem::path(L"\\\\.\\pipe\\") / name;
+#else
+    return std::filesystem::temp_directory_path() / name;
+#endif
+}
+
+std::string buttonMessage()
+{
+    std::string out;
+    SnoreToastProtocol::Encoder encoder(out);
+    encoder.begin(SnoreToastActions::Actions::ButtonClicked);
+    encoder.addField(L"notificationId", L"4242");
+    encoder.addField(L"button", L"Show log");
+    encoder.addField(L"version", L"0.9.1");
+    encoder.end();
+    return out;
+}
+
+/**
+ * Counts the protocol 2 messages received on a local socket, serves one connection at a time.
+ */
+class Receiver
+{
+public:
+    explicit Receiver(const std::filesystem::path &name)
+        : m_listener(LocalSocket::listen(name)), m_thread([this] { run(); })
+    {
+    }
+
+    ~Receiver()
+    {
+        m_listener->close();
+        m_thread.join();
+    }
+
+    void waitFor(size_t count)
+    {
+        std::unique_lock lock(m_mutex);
+        m_condition.wait(lock, [this, count] { return m_received >= count; });
+    }
+
+private:
+    void run()
+    {
+        std::string buffer;
+        while (auto connection = m_listener->accept()) {
+            while (true) {
+                buffer.resize(SnoreToastProtocol::HeaderSize);
+                if (!connection->read(buffer.data(), buffer.size())) {
+                    break;
+                }
+                const auto payloadSize = static_cast<uint8_t>(buffer[16])
+                        | static_cast<uint8_t>(buffer[17]) << 8
+                        | static_cast<uint8_t>(buffer[18]) << 16
+                        | static_cast<uint32_t>(static_cast<uint8_t>(buffer[19])) << 24;
+                buffer.resize(SnoreToastProtocol::HeaderSize + payloadSize);
+                if (!connection->read(buffer.data() + SnoreToastProtocol::HeaderSize,
+                                      payloadSize)) {
+                    break;
+                }
+                SnoreToastProtocol::Message message;
+                if (SnoreToastProtocol::decode(buffer.data(), buffer.size(), message)
+                    != SnoreToastProtocol::Status::Ok) {
+                    break;
+                }
+                {
+                    std::scoped_lock lock(m_mutex);
+                    ++m_received;
+                }
+                m_condition.notify_all();
+            }
+        }
+    }
+
+    std::unique_ptr<ToastServerListener> m_listener;
+    std::mutex m_mutex;
+    std::condition_variable m_condition;
+    size_t m_received = 0;
+    std::thread m_thread;
+};
+}
+
+// one connection kept open, the messages of a batch share a single write
+SNORETOAST_BENCHMARK(CallbackWriter_Persistent100)
+{
+    const auto name = socketName("snoretoast_bench_persistent");
+    Receiver receiver(name);
+    const auto message = buttonMessage();
+    size_t sent = 0;
+    CallbackWriter writer(std::chrono::microseconds(0));
+    while (state.keepRunning()) {
+        for (size_t i = 0; i < BatchSize; ++i) {
+            writer.post(name, message);
+        }
+        writer.flush();
+        sent += BatchSize;
+        receiver.waitFor(sent);
+    }
+    state.setBytesPerIteration(message.size() * BatchSize);
+}
+
+// the behaviour of Utils::writePipe, a connection per message
+SNORETOAST_BENCHMARK(CallbackWriter_ConnectPerMessage100)
+{
+    const auto name = socketName("snoretoast_bench_connect");
+    Receiver receiver(name);
+    const auto message = buttonMessage();
+    size_t sent = 0;
+    while (state.keepRunning()) {
+        for (size_t i = 0; i < BatchSize; ++i) {
+            auto connection = LocalSocket::connect(name);
+            connection->write(message.data(), message.size());
+        }
+        sent += BatchSize;
+        receiver.waitFor(sent);
+    }
+    state.setBytesPerIteration(message.size() * BatchSize);
+}
+
+// from post() until the receiver decoded the message
+SNORETOAST_BENCHMARK(CallbackWriter_Latency)
+{
+    const auto name = socketName("snoretoast_bench_latency");
+    Receiver receiver(name);
+    const auto message = buttonMessage();
+    size_t sent = 0;
+    CallbackWriter writer(std::chrono::microseconds(0));
+    while (state.keepRunning()) {
+        writer.post(name, message);
+        receiver.waitFor(++sent);
+    }
+    state.setBytesPerIteration(message.size());
+}
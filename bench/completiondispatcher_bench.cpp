@@ -0,0 +1,85 @@
+/*
+    SnoreToast is capable to invoke Windows 8 toast notifications.
+    Copyright (C) 2026  Hannah von Reth <vonreth@kde.org>
+
+    SnoreToast is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    SnoreToast is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with SnoreToast.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "benchmark.h"
+
+#include "completiondispatcher.h"
+#include "mocknotificationbackend.h"
+#include "snoretoasts.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+/**
+ * 1000 toasts displayed at once on the mock, their results delivered by one dispatcher
+ * instead of a waiting thread per toast.
+ */
+SNORETOAST_BENCHMARK(CompletionDispatcher_1kToasts)
+{
+    CompletionDispatcher dispatcher(
+            [](uint64_t tag, SnoreToastActions::Actions action) {
+                Benchmark::doNotOptimize(tag);
+                Benchmark::doNotOptimize(action);
+            });
+    std::vector<std::wstring> ids(1000);
+    while (state.keepRunning()) {
+        // the mock keeps every toast in its history
+        MockNotificationBackend backend;
+        for (size_t i = 0; i < ids.size(); ++i) {
+            auto toast = std::make_unique<SnoreToasts>(&backend, L"Snore.DesktopToasts");
+            toast->displayToast(L"Build finished", L"All tests passed", {});
+            ids[i] = toast->id();
+            dispatcher.add(std::move(toast), i);
+        }
+        for (const auto &id : ids) {
+            backend.activate(id);
+        }
+        dispatcher.process();
+    }
+}
+
+/**
+ * The same toasts with a callback each, all on one thread like in an event loop that calls
+ * process() once nativeHandle() is signalled, every other toast is cancelled.
+ */
+SNORETOAST_BENCHMARK(CompletionDispatcher_1kCallbacksCancelHalf)
+{
+    CompletionDispatcher dispatcher;
+    std::vector<std::wstring> ids(1000);
+    std::vector<uint64_t> tickets(ids.size());
+    size_t results = 0;
+    while (state.keepRunning()) {
+        MockNotificationBackend backend;
+        for (size_t i = 0; i < ids.size(); ++i) {
+            auto toast = std::make_unique<SnoreToasts>(&backend, L"Snore.DesktopToasts");
+            toast->displayToast(L"Build finished", L"All tests passed", {});
+            ids[i] = toast->id();
+            tickets[i] = dispatcher.add(std::move(toast),
+                                        [&results](SnoreToastActions::Actions) { ++results; });
+        }
+        for (size_t i = 0; i < ids.size(); ++i) {
+            if (i % 2) {
+                backend.activate(ids[i]);
+            } else {
+                dispatcher.cancel(tickets[i]);
+            }
+        }
+        dispatcher.process();
+    }
+    Benchmark::doNotOptimize(results);
+}
@@ -0,0 +1,73 @@
+/*
+    SnoreToast is capable to invoke Windows 8 toast notifications.
+    Copyright (C) 2026  Hannah von Reth <vonreth@kde.org>
+
+    SnoreToast is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    SnoreToast is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with SnoreToast.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "benchmark.h"
+
+#include "imagecache.h"
+#include "pngimage.h"
+
+#include <fstream>
+
+namespace {
+// the signature and IHDR chunk of a 256x256 RGBA image, all the cache reads of small images
+std::string pngHeader()
+{
+    return std::string("\x89PNG\r\n\x1a\n\0\0\0\x0dIHDR\0\0\x01\0\0\0\x01\0\x08\x06\0\0\0", 29)
+            + std::string(4, '\0');
+}
+}
+
+SNORETOAST_BENCHMARK(PngImage_ReadHeader)
+{
+    const std::string data = pngHeader();
+    state.setBytesPerIteration(data.size());
+    while (state.keepRunning()) {
+        const auto header = PngImage::readHeader(data);
+        Benchmark::doNotOptimize(header);
+    }
+}
+
+// a toast repeating the image of the previous one
+SNORETOAST_BENCHMARK(ImageCache_NormalizeKnownImage)
+{
+    const auto directory = std::filesystem::temp_directory_path() / "snoretoast_bench_images";
+    const auto image = directory / "logo.png";
+    std::filesystem::create_directories(directory);
+    std::ofstream(image, std::ios::binary) << pngHeader();
+    ImageCache cache(directory);
+    while (state.keepRunning()) {
+        const auto result = cache.normalize(image);
+        Benchmark::doNotOptimize(result.native().data());
+    }
+    std::filesystem::remove_all(directory);
+}
+
+SNORETOAST_BENCHMARK(PngImage_Scale2048To1024)
+{
+    PngImage::Pixels pixels;
+    pixels.width = 2048;
+    pixels.height = 2048;
+    pixels.rgba.resize(size_t(pixels.width) * pixels.height * 4);
+    for (size_t i = 0; i < pixels.rgba.size(); ++i) {
+        pixels.rgba[i] = static_cast<uint8_t>(i * 7 + i / 4096);
+    }
+    state.setBytesPerIteration(pixels.rgba.size());
+    while (state.keepRunning()) {
+        const auto scaled = PngImage::scale(pixels, 1024, 1024);
+        Benchmark::doNotOptimize(scaled.rgba.data());
+    }
+}
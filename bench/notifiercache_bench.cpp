@@ -0,0 +1,80 @@
+/*
+    SnoreToast is capable to invoke Windows 8 toast notifications.
+    Copyright (C) 2026  Hannah von Reth <vonreth@kde.org>
+
+    SnoreToast is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    SnoreToast is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with SnoreToast.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "benchmark.h"
+
+#include "notifiercache.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace {
+struct Notifier
+{
+    std::wstring appID;
+};
+using Cache = NotifierCache<std::shared_ptr<const Notifier>>;
+
+bool create(const std::wstring &appID, std::shared_ptr<const Notifier> &out)
+{
+    out = std::make_shared<const Notifier>(Notifier { appID });
+    return true;
+}
+
+std::vector<std::wstring> appIDs()
+{
+    std::vector<std::wstring> out;
+    for (int i = 0; i < 16; ++i) {
+        out.push_back(L"Snore.DesktopToasts." + std::to_wstring(i));
+    }
+    return out;
+}
+}
+
+/**
+ * The lookup of every toast but the first one of an appID.
+ */
+SNORETOAST_BENCHMARK(NotifierCache_Hit)
+{
+    const auto ids = appIDs();
+    Cache cache;
+    std::shared_ptr<const Notifier> notifier;
+    size_t i = 0;
+    while (state.keepRunning()) {
+        const auto &appID = ids[i++ % ids.size()];
+        cache.get(appID, notifier, [&appID](auto &out) { return create(appID, out); });
+        Benchmark::doNotOptimize(notifier);
+    }
+}
+
+/**
+ * Every lookup misses, like a cache invalidated after each failed toast.
+ */
+SNORETOAST_BENCHMARK(NotifierCache_MissAfterInvalidate)
+{
+    const auto ids = appIDs();
+    Cache cache;
+    std::shared_ptr<const Notifier> notifier;
+    size_t i = 0;
+    while (state.keepRunning()) {
+        const auto &appID = ids[i++ % ids.size()];
+        cache.get(appID, notifier, [&appID](auto &out) { return create(appID, out); });
+        cache.invalidate(appID);
+        Benchmark::doNotOptimize(notifier);
+    }
+}
@@ -0,0 +1,63 @@
+/*
+    SnoreToast is capable to invoke Windows 8 toast notifications.
+    Copyright (C) 2026  Hannah von Reth <vonreth@kde.org>
+
+    SnoreToast is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    SnoreToast is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with SnoreToast.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "benchmark.h"
+#include "benchinputs.h"
+
+#include "mappedfile.h"
+#include "optionparser.h"
+
+#include <fstream>
+
+namespace {
+// a response file as written by a script driving snoretoast
+std::filesystem::path writeResponseFile()
+{
+    const auto path = std::filesystem::temp_directory_path() / "snoretoast_bench.rsp";
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    out << "\xEF\xBB\xBF# generated\r\n";
+    out << "-t \"Build finished\"\r\n";
+    out << "-m \"" << std::string(BenchInputs::longBody().size(), 'x') << "\"\r\n";
+    out << "-pipeName \"" << BenchInputs::longPipe().string() << "\"\r\n";
+    out << "-appID Snore.DesktopToasts.0.9.1 -id 4242 -d long -protocol 2\r\n";
+    return path;
+}
+}
+
+SNORETOAST_BENCHMARK(OptionParser_ExpandResponseFile)
+{
+    const auto path = writeResponseFile();
+    const std::wstring argument = L"@" + path.wstring();
+    state.setBytesPerIteration(std::filesystem::file_size(path));
+    std::wstring error;
+    while (state.keepRunning()) {
+        std::vector<std::wstring> args { argument };
+        const bool ok = OptionParser::expandResponseFiles(args, error);
+        Benchmark::doNotOptimize(ok);
+    }
+    std::filesystem::remove(path);
+}
+
+SNORETOAST_BENCHMARK(OptionParser_DecodeLongBody)
+{
+    std::string text(BenchInputs::longBody().size(), 'x');
+    state.setBytesPerIteration(text.size());
+    while (state.keepRunning()) {
+        const auto decoded = OptionParser::decodeText(text);
+        Benchmark::doNotOptimize(decoded.data());
+    }
+}
@@ -0,0 +1,112 @@
+/*
+    SnoreToast is capable to invoke Windows 8 toast notifications.
+    Copyright (C) 2026  Hannah von Reth <vonreth@kde.org>
+
+    SnoreToast is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    SnoreToast is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with SnoreToast.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "benchmark.h"
+
+#include "snoretoastprotocol.h"
+
+#include <cstdint>
+#include <string>
+
+namespace {
+void encodeButton(std::string &out)
+{
+    SnoreToastProtocol::Encoder encoder(out);
+    encoder.begin(SnoreToastActions::Actions::ButtonClicked);
+    encoder.addField(L"notificationId", L"4242");
+    encoder.addField(L"pipe", L"\\\\.\\pipe\\snoretoast");
+    encoder.addField(L"application", L"C:\\Program Files\\Snore\\snore.exe");
+    encoder.addField(L"button", L"Show log");
+    encoder.addField(L"version", L"0.9.1");
+    encoder.end();
+}
+
+std::string replyMessage()
+{
+    std::wstring reply;
+    uint32_t seed = 7;
+    while (reply.size() < 64 * 1024) {
+        seed = seed * 1664525u + 1013904223u;
+        reply.push_back(static_cast<wchar_t>(L'a' + (seed >> 24) % 26));
+    }
+    std::string out;
+    SnoreToastProtocol::Encoder encoder(out);
+    encoder.begin(SnoreToastActions::Actions::TextEntered);
+    encoder.addField(L"notificationId", L"4242");
+    encoder.addField(L"text", std::wstring_view(reply));
+    encoder.end();
+    return out;
+}
+}
+
+SNORETOAST_BENCHMARK(Protocol_EncodeButton)
+{
+    std::string out;
+    encodeButton(out);
+    state.setMaxAllocationsPerIteration(0);
+    while (state.keepRunning()) {
+        out.clear();
+        encodeButton(out);
+        Benchmark::doNotOptimize(out.data());
+    }
+    state.setBytesPerIteration(out.size());
+}
+
+SNORETOAST_BENCHMARK(Protocol_DecodeButton)
+{
+    std::string message;
+    encodeButton(message);
+    SnoreToastProtocol::Message decoded;
+    state.setMaxAllocationsPerIteration(0);
+    while (state.keepRunning()) {
+        SnoreToastProtocol::decode(message.data(), message.size(), decoded);
+        Benchmark::doNotOptimize(decoded.value(u"button"));
+    }
+    state.setBytesPerIteration(message.size());
+}
+
+SNORETOAST_BENCHMARK(Protocol_DecodeReply64K)
+{
+    const auto message = replyMessage();
+    SnoreToastProtocol::Message decoded;
+    state.setMaxAllocationsPerIteration(0);
+    while (state.keepRunning()) {
+        SnoreToastProtocol::decode(message.data(), message.size(), decoded);
+        Benchmark::doNotOptimize(decoded.value(u"text"));
+    }
+    state.setBytesPerIteration(message.size());
+}
+
+// 100 messages sharing one connection
+SNORETOAST_BENCHMARK(Protocol_DecodeStream)
+{
+    std::string stream;
+    for (int i = 0; i < 100; ++i) {
+        encodeButton(stream);
+    }
+    SnoreToastProtocol::Message decoded;
+    state.setMaxAllocationsPerIteration(0);
+    while (state.keepRunning()) {
+        size_t pos = 0;
+        while (SnoreToastProtocol::decode(stream.data() + pos, stream.size() - pos, decoded)
+               == SnoreToastProtocol::Status::Ok) {
+            Benchmark::doNotOptimize(decoded.action());
+            pos += decoded.size();
+        }
+    }
+    state.setBytesPerIteration(stream.size());
+}
@@ -0,0 +1,139 @@
+/*
+    SnoreToast is capable to invoke Windows 8 toast notifications.
+    Copyright (C) 2026  Hannah von Reth <vonreth@kde.org>
+
+    SnoreToast is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    SnoreToast is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with SnoreToast.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "benchmark.h"
+
+#include "callbackwriter.h"
+#include "snoretoastreceiver.h"
+#include "toastserver.h"
+
+#include <condition_variable>
+#include <filesystem>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace {
+constexpr size_t BatchSize = 100;
+
+std::filesystem::path socketName(const char *name)
+{
+#ifdef _WIN32
+    return std::filesystem::path(L"\\\\.\\pipe\\") / name;
+#else
+    return std::filesystem::temp_directory_path() / name;
+#endif
+}
+
+/**
+ * Runs a SnoreToastReceiver on its own thread and counts the button events.
+ */
+class ReceiverThread
+{
+public:
+    explicit ReceiverThread(const std::filesystem::path &name)
+    {
+        m_receiver.setHandler(SnoreToastActions::Actions::ButtonClicked,
+                              [this](const SnoreToastEvent &event) {
+                                  Benchmark::doNotOptimize(event.button());
+                                  {
+                                      std::scoped_lock lock(m_mutex);
+                                      ++m_received;
+                                  }
+                                  m_condition.notify_all();
+                              });
+        m_receiver.listen(name);
+        m_thread = std::thread([this] { m_receiver.run(); });
+    }
+
+    ~ReceiverThread()
+    {
+        m_receiver.stop();
+        m_thread.join();
+    }
+
+    void waitFor(size_t count)
+    {
+        std::unique_lock lock(m_mutex);
+        m_condition.wait(lock, [this, count] { return m_received >= count; });
+    }
+
+private:
+    SnoreToastReceiver m_receiver;
+    std::mutex m_mutex;
+    std::condition_variable m_condition;
+    size_t m_received = 0;
+    std::thread m_thread;
+};
+
+std::string v1Message()
+{
+    const std::u16string text = u"action=buttonClicked;notificationId=4242;button=Show log;"
+                                u"version=0.9.1;";
+    return std::string(reinterpret_cast<const char *>(text.c_str()),
+                       (text.size() + 1) * sizeof(char16_t));
+}
+
+std::string v2Message()
+{
+    std::string out;
+    SnoreToastProtocol::Encoder encoder(out);
+    encoder.begin(SnoreToastActions::Actions::ButtonClicked);
+    encoder.addField(L"notificationId", L"4242");
+    encoder.addField(L"button", L"Show log");
+    encoder.addField(L"version", L"0.9.1");
+    encoder.end();
+    return out;
+}
+}
+
+// protocol 2 messages of a persistent CallbackWriter connection
+SNORETOAST_BENCHMARK(Receiver_Persistent100)
+{
+    const auto name = socketName("snoretoast_bench_receiver_persistent");
+    ReceiverThread receiver(name);
+    const auto message = v2Message();
+    CallbackWriter writer(std::chrono::microseconds(0));
+    size_t sent = 0;
+    while (state.keepRunning()) {
+        for (size_t i = 0; i < BatchSize; ++i) {
+            writer.post(name, message);
+        }
+        writer.flush();
+        sent += BatchSize;
+        receiver.waitFor(sent);
+    }
+    state.setBytesPerIteration(message.size() * BatchSize);
+}
+
+// a connection per protocol 1 message, like SnoreToast without -pipeKeepAlive
+SNORETOAST_BENCHMARK(Receiver_Connections100)
+{
+    const auto name = socketName("snoretoast_bench_receiver_connections");
+    ReceiverThread receiver(name);
+    const auto message = v1Message();
+    size_t sent = 0;
+    while (state.keepRunning()) {
+        for (size_t i = 0; i < BatchSize; ++i) {
+            auto connection = LocalSocket::connect(name);
+            connection->write(message.data(), message.size());
+        }
+        sent += BatchSize;
+        receiver.waitFor(sent);
+    }
+    state.setBytesPerIteration(message.size() * BatchSize);
+}
@@ -0,0 +1,99 @@
+/*
+    SnoreToast is capable to invoke Windows 8 toast notifications.
+    Copyright (C) 2026  Hannah von Reth <vonreth@kde.org>
+
+    SnoreToast is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    SnoreToast is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with SnoreToast.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "benchmark.h"
+#include "benchinputs.h"
+
+#include "toastbatch.h"
+#include "toastrequest.h"
+
+namespace {
+std::vector<std::wstring> shortArguments()
+{
+    return { L"-t", L"Build finished", L"-m", BenchInputs::shortBody() };
+}
+
+std::vector<std::wstring> longArguments()
+{
+    std::wstring buttons;
+    for (const auto &button : BenchInputs::buttons(BenchInputs::MaxButtons)) {
+        buttons += button + L";";
+    }
+    return { L"-t",
+             L"Build finished",
+             L"-m",
+             BenchInputs::longBody(),
+             L"-b",
+             buttons,
+             L"-pipeName",
+             BenchInputs::longPipe().wstring(),
+             L"-application",
+             L"C:\\Program Files\\Snore\\snore.exe",
+             L"-appID",
+             L"Snore.DesktopToasts.0.9.1",
+             L"-id",
+             L"4242",
+             L"-d",
+             L"long",
+             L"-protocol",
+             L"2" };
+}
+
+void parse(Benchmark::State &state, const std::vector<std::wstring> &args)
+{
+    size_t bytes = 0;
+    for (const auto &arg : args) {
+        bytes += arg.size() * sizeof(wchar_t);
+    }
+    state.setBytesPerIteration(bytes);
+    while (state.keepRunning()) {
+        const auto request = ToastRequest::fromArguments(args);
+        Benchmark::doNotOptimize(request.mode);
+    }
+}
+}
+
+SNORETOAST_BENCHMARK(ToastRequest_Short)
+{
+    parse(state, shortArguments());
+}
+
+SNORETOAST_BENCHMARK(ToastRequest_LongFiveButtons)
+{
+    parse(state, longArguments());
+}
+
+// a -batch line, quoted like a Windows command line
+SNORETOAST_BENCHMARK(ToastBatch_SplitLongCommandLine)
+{
+    std::wstring line;
+    for (const auto &arg : longArguments()) {
+        line += L'"';
+        for (const auto c : arg) {
+            if (c == L'"') {
+                line += L'\\';
+            }
+            line += c;
+        }
+        line += L"\" ";
+    }
+    state.setBytesPerIteration(line.size() * sizeof(wchar_t));
+    while (state.keepRunning()) {
+        const auto args = ToastBatchReader::splitCommandLine(line);
+        Benchmark::doNotOptimize(args.data());
+    }
+}
@@ -0,0 +1,68 @@
+/*
+    SnoreToast is capable to invoke Windows 8 toast notifications.
+    Copyright (C) 2026  Hannah von Reth <vonreth@kde.org>
+
+    SnoreToast is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    SnoreToast is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with SnoreToast.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "benchmark.h"
+
+#include "mocknotificationbackend.h"
+#include "snoretoasts.h"
+
+#include <string>
+
+namespace {
+void configure(SnoreToasts &app)
+{
+    // like a process toasting under its pid, the id does not change between toasts
+    app.setId(L"4242");
+    app.setPipeName(L"\\\\.\\pipe\\snore");
+    app.setApplication(L"C:\\Program Files\\Snore\\snore.exe");
+    app.setButtons(L"Open;Snooze;Dismiss");
+    app.setProtocolVersion(2);
+}
+}
+
+/**
+ * The cost of one toast of a long running client, the instance, its formatter and the
+ * prepared content are reused, only title and body change.
+ */
+SNORETOAST_BENCHMARK(SnoreToasts_ReusedInstance)
+{
+    MockNotificationBackend backend;
+    SnoreToasts app(&backend, L"Snore.DesktopToasts.0.9.1");
+    configure(app);
+    std::wstring body;
+    size_t i = 0;
+    while (state.keepRunning()) {
+        body.assign(L"Message ").append(std::to_wstring(i++));
+        Benchmark::doNotOptimize(app.displayToast(L"Build finished", body, {}));
+    }
+}
+
+/**
+ * The same toasts with a new instance for every toast.
+ */
+SNORETOAST_BENCHMARK(SnoreToasts_FreshInstance)
+{
+    MockNotificationBackend backend;
+    std::wstring body;
+    size_t i = 0;
+    while (state.keepRunning()) {
+        SnoreToasts app(&backend, L"Snore.DesktopToasts.0.9.1");
+        configure(app);
+        body.assign(L"Message ").append(std::to_wstring(i++));
+        Benchmark::doNotOptimize(app.displayToast(L"Build finished", body, {}));
+    }
+}
@@ -0,0 +1,77 @@
+/*
+    SnoreToast is capable to invoke Windows 8 toast notifications.
+    Copyright (C) 2026  Hannah von Reth <vonreth@kde.org>
+
+    SnoreToast is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    SnoreToast is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with SnoreToast.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "benchmark.h"
+
+#include "mocknotificationbackend.h"
+#include "snoretoasts.h"
+#include "toastrequest.h"
+
+namespace {
+/**
+ * The path of the snoretoast executable from the command line to NotificationBackend::show,
+ * or to the close request, for one invocation mode.
+ */
+void startup(Benchmark::State &state, const std::vector<std::wstring> &args)
+{
+    MockNotificationBackend backend;
+    while (state.keepRunning()) {
+        const auto request = ToastRequest::fromArguments(
+                args, ToastRequest::ResponseFiles | ToastRequest::StandardInput);
+        SnoreToasts app(&backend, L"Snore.DesktopToasts.0.9.1");
+        // every invocation is a new process with the same default id, not a fresh "pid.N"
+        app.setId(request.id.empty() ? L"4242" : request.id);
+        if (request.mode == ToastRequest::Mode::Close) {
+            Benchmark::doNotOptimize(app.closeNotification());
+            continue;
+        }
+        app.setPipeName(request.pipe);
+        app.setApplication(request.application);
+        app.setSilent(request.silent);
+        app.setSound(request.sound);
+        app.setButtons(request.buttons);
+        app.setTextBoxEnabled(request.isTextBoxEnabled);
+        app.setDuration(request.duration);
+        app.setProtocolVersion(request.protocol);
+        Benchmark::doNotOptimize(app.displayToast(request.title, request.body, request.image));
+    }
+}
+}
+
+SNORETOAST_BENCHMARK(Startup_Toast)
+{
+    startup(state, { L"-t", L"Build finished", L"-m", L"All tests passed" });
+}
+
+SNORETOAST_BENCHMARK(Startup_ToastButtons)
+{
+    startup(state,
+            { L"-t", L"Build finished", L"-m", L"All tests passed", L"-b", L"Open;Dismiss",
+              L"-pipeName", L"\\\\.\\pipe\\snore" });
+}
+
+SNORETOAST_BENCHMARK(Startup_ToastTextBox)
+{
+    startup(state,
+            { L"-t", L"Reply", L"-m", L"How are you?", L"-tb", L"-pipeName",
+              L"\\\\.\\pipe\\snore" });
+}
+
+SNORETOAST_BENCHMARK(Startup_Close)
+{
+    startup(state, { L"-close", L"4242" });
+}
@@ -0,0 +1,163 @@
+/*
+    SnoreToast is capable to invoke Windows 8 toast notifications.
+    Copyright (C) 2026  Hannah von Reth <vonreth@kde.org>
+
+    SnoreToast is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    SnoreToast is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with SnoreToast.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "benchmark.h"
+
+#include "actionformatter.h"
+#include "callbackdata.h"
+#include "textkernels.h"
+#include "toastxml.h"
+
+#include <cstdint>
+
+using namespace TextKernels;
+
+namespace {
+constexpr size_t ReplySize = 64 * 1024;
+
+/**
+ * A text box reply of ReplySize characters: words, Windows line breaks every few lines and
+ * no ; or =. Always the same text.
+ */
+const std::wstring &largeReply()
+{
+    static const std::wstring reply = [] {
+        std::wstring out;
+        out.reserve(ReplySize);
+        uint32_t seed = 42;
+        size_t line = 0;
+        while (out.size() < ReplySize) {
+            seed = seed * 1664525u + 1013904223u;
+            const size_t length = 2 + (seed >> 28);
+            for (size_t i = 0; i < length; ++i) {
+                out.push_back(static_cast<wchar_t>(L'a' + (seed >> (i % 24)) % 26));
+            }
+            line += length + 1;
+            if (line > 72) {
+                out.append(L"\r\n");
+                line = 0;
+            } else {
+                out.push_back(L' ');
+            }
+        }
+        out.resize(ReplySize);
+        return out;
+    }();
+    return reply;
+}
+
+class IsaScope
+{
+public:
+    explicit IsaScope(Isa isa) : m_previous(TextKernels::isa()) { setIsa(isa); }
+    ~IsaScope() { setIsa(m_previous); }
+
+private:
+    Isa m_previous;
+};
+
+void find(Benchmark::State &state, Isa isa)
+{
+    IsaScope scope(isa);
+    const auto &reply = largeReply();
+    while (state.keepRunning()) {
+        Benchmark::doNotOptimize(TextKernels::find(reply, L';'));
+    }
+    state.setBytesPerIteration(reply.size() * sizeof(wchar_t));
+}
+
+void replace(Benchmark::State &state, Isa isa)
+{
+    IsaScope scope(isa);
+    auto reply = largeReply();
+    while (state.keepRunning()) {
+        // restores the \r on the next iteration, both directions do the same work
+        TextKernels::replace(reply, L'\r', L'\v');
+        TextKernels::replace(reply, L'\v', L'\r');
+        Benchmark::doNotOptimize(reply.data());
+    }
+    state.setBytesPerIteration(2 * reply.size() * sizeof(wchar_t));
+}
+
+void escape(Benchmark::State &state, Isa isa)
+{
+    IsaScope scope(isa);
+    ToastContent content;
+    content.title = L"Reply";
+    content.body = largeReply();
+    std::wstring out;
+    while (state.keepRunning()) {
+        ToastXml::build(content, out);
+        Benchmark::doNotOptimize(out.data());
+    }
+    state.setBytesPerIteration(content.body.size() * sizeof(wchar_t));
+}
+
+void parseCallbackData(Benchmark::State &state, Isa isa)
+{
+    IsaScope scope(isa);
+    std::wstring data = L"action=textEntered;notificationId=4242;pipe=\\\\.\\pipe\\snore;";
+    ActionFormatter::appendField(data, { L"text", largeReply() });
+    ActionFormatter::appendField(data, { L"version", L"0.9.1" });
+    CallbackData callbackData;
+    while (state.keepRunning()) {
+        callbackData.parse(data);
+        Benchmark::doNotOptimize(callbackData.value(L"text"));
+    }
+    state.setBytesPerIteration(data.size() * sizeof(wchar_t));
+}
+}
+
+SNORETOAST_BENCHMARK(TextKernels_Find64K_Scalar)
+{
+    find(state, Isa::Scalar);
+}
+
+SNORETOAST_BENCHMARK(TextKernels_Find64K_Dispatch)
+{
+    find(state, bestIsa());
+}
+
+SNORETOAST_BENCHMARK(TextKernels_Replace64K_Scalar)
+{
+    replace(state, Isa::Scalar);
+}
+
+SNORETOAST_BENCHMARK(TextKernels_Replace64K_Dispatch)
+{
+    replace(state, bestIsa());
+}
+
+SNORETOAST_BENCHMARK(TextKernels_XmlEscape64K_Scalar)
+{
+    escape(state, Isa::Scalar);
+}
+
+SNORETOAST_BENCHMARK(TextKernels_XmlEscape64K_Dispatch)
+{
+    escape(state, bestIsa());
+}
+
+SNORETOAST_BENCHMARK(TextKernels_CallbackData64K_Scalar)
+{
+    parseCallbackData(state, Isa::Scalar);
+}
+
+SNORETOAST_BENCHMARK(TextKernels_CallbackData64K_Dispatch)
+{
+    parseCallbackData(state, bestIsa());
+}
@@ -0,0 +1,45 @@
+/*
+    SnoreToast is capable to invoke Windows 8 toast notifications.
+    Copyright (C) 2026  Hannah von Reth <vonreth@kde.org>
+
+    SnoreToast is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    SnoreToast is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with SnoreToast.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "benchmark.h"
+#include "benchinputs.h"
+
+#include "toastcoalescer.h"
+
+// a producer repeating the same alert, all but the first toast are dropped
+SNORETOAST_BENCHMARK(ToastCoalescer_RepeatedToast)
+{
+    ToastCoalescer coalescer(ToastCoalescer::Policy {});
+    ToastRequest request;
+    request.title = L"Disk almost full";
+    request.body = BenchInputs::shortBody();
+    while (state.keepRunning()) {
+        ToastRequest copy = request;
+        Benchmark::doNotOptimize(coalescer.submit(copy));
+    }
+}
+
+SNORETOAST_BENCHMARK(ToastCoalescer_ContentHashLongBody)
+{
+    ToastRequest request;
+    request.title = L"Build finished";
+    request.body = BenchInputs::longBody();
+    state.setBytesPerIteration(request.body.size() * sizeof(wchar_t));
+    while (state.keepRunning()) {
+        Benchmark::doNotOptimize(ToastCoalescer::contentHash(request));
+    }
+}
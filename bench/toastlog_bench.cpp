@@ -0,0 +1,80 @@
+/*
+    SnoreToast is capable to invoke Windows 8 toast notifications.
+    Copyright (C) 2026  Hannah von Reth <vonreth@kde.org>
+
+    SnoreToast is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    SnoreToast is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with SnoreToast.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "benchmark.h"
+
+#include "toastlog.h"
+
+#include <string>
+
+namespace {
+constexpr size_t FlushInterval = 128;
+
+std::wstring expensive()
+{
+    return std::wstring(256, L'x');
+}
+
+/**
+ * Enables the log without an output, the records still pass the ring buffers and the sink.
+ */
+class LogScope
+{
+public:
+    explicit LogScope(ToastLog::Level level) : m_level(ToastLog::level())
+    {
+        ToastLog::setOutputs(ToastLog::NoOutput);
+        ToastLog::setLevel(level);
+    }
+    ~LogScope()
+    {
+        ToastLog::flush();
+        ToastLog::setLevel(m_level);
+    }
+
+private:
+    ToastLog::Level m_level;
+};
+}
+
+SNORETOAST_BENCHMARK(ToastLog_Disabled)
+{
+    LogScope scope(ToastLog::Level::Warning);
+    state.setMaxAllocationsPerIteration(0);
+    size_t i = 0;
+    while (state.keepRunning()) {
+        // the arguments of a disabled record must not be evaluated
+        tLog << L"Notification" << i++ << expensive();
+    }
+    Benchmark::doNotOptimize(i);
+}
+
+SNORETOAST_BENCHMARK(ToastLog_Enabled)
+{
+    LogScope scope(ToastLog::Level::Debug);
+    // registers the ring buffer of this thread and sizes the thread local buffer
+    tLog << L"warm up" << expensive();
+    ToastLog::flush();
+    state.setMaxAllocationsPerIteration(0);
+    size_t i = 0;
+    while (state.keepRunning()) {
+        tLog << L"Notification" << i << L"was activated by" << std::wstring_view(L"button");
+        if (++i % FlushInterval == 0) {
+            ToastLog::flush();
+        }
+    }
+}
@@ -0,0 +1,85 @@
+/*
+    SnoreToast is capable to invoke Windows 8 toast notifications.
+    Copyright (C) 2026  Hannah von Reth <vonreth@kde.org>
+
+    SnoreToast is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    SnoreToast is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with SnoreToast.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "benchmark.h"
+
+#include "toastregistry.h"
+
+#include <string>
+#include <vector>
+
+namespace {
+std::vector<std::wstring> ids(size_t count)
+{
+    std::vector<std::wstring> out;
+    out.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        out.push_back(L"alert." + std::to_wstring(i));
+    }
+    return out;
+}
+}
+
+/**
+ * The lookup of -close in a registry of 10000 toasts.
+ */
+SNORETOAST_BENCHMARK(ToastRegistry_Find10k)
+{
+    const auto all = ids(10000);
+    ToastRegistry registry;
+    for (const auto &id : all) {
+        registry.add(L"Snore.DesktopToasts", id, L"SnoreToast");
+    }
+    size_t i = 0;
+    while (state.keepRunning()) {
+        Benchmark::doNotOptimize(registry.find(L"Snore.DesktopToasts", all[i++ % all.size()]));
+    }
+}
+
+/**
+ * The selection of -closeGroup, 1000 of 10000 toasts.
+ */
+SNORETOAST_BENCHMARK(ToastRegistry_InGroup10k)
+{
+    const auto all = ids(10000);
+    ToastRegistry registry;
+    for (size_t i = 0; i < all.size(); ++i) {
+        registry.add(L"Snore.DesktopToasts", all[i], i % 10 == 0 ? L"alerts" : L"SnoreToast");
+    }
+    while (state.keepRunning()) {
+        Benchmark::doNotOptimize(registry.inGroup(L"Snore.DesktopToasts", L"alerts"));
+    }
+}
+
+/**
+ * The lazy reconciliation before -list, 10000 known toasts of which 100 left the history.
+ */
+SNORETOAST_BENCHMARK(ToastRegistry_Reconcile10k)
+{
+    const auto all = ids(10000);
+    std::vector<HistoryEntry> history;
+    for (size_t i = 100; i < all.size(); ++i) {
+        history.push_back({ all[i], L"SnoreToast" });
+    }
+    ToastRegistry registry;
+    while (state.keepRunning()) {
+        for (size_t i = 0; i < 100; ++i) {
+            registry.add(L"Snore.DesktopToasts", all[i], L"SnoreToast");
+        }
+        Benchmark::doNotOptimize(registry.reconcile(L"Snore.DesktopToasts", history));
+    }
+}
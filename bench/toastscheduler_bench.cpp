@@ -0,0 +1,77 @@
+/*
+    SnoreToast is capable to invoke Windows 8 toast notifications.
+    Copyright (C) 2026  Hannah von Reth <vonreth@kde.org>
+
+    SnoreToast is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    SnoreToast is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with SnoreToast.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "benchmark.h"
+
+#include "toastscheduler.h"
+
+namespace {
+constexpr size_t QueuedToasts = 100000;
+
+std::vector<ToastRequest> requests()
+{
+    std::vector<ToastRequest> out(QueuedToasts);
+    for (size_t i = 0; i < out.size(); ++i) {
+        out[i].title = L"Build " + std::to_wstring(i) + L" finished";
+        out[i].body = L"All tests passed";
+        out[i].priority = static_cast<Priority>(i % 3);
+        // every fourth toast expires, but not during the benchmark
+        if (i % 4 == 0) {
+            out[i].deadline = std::chrono::minutes(1);
+        }
+    }
+    return out;
+}
+
+ToastScheduler::Policy unbounded()
+{
+    ToastScheduler::Policy policy;
+    policy.capacity = QueuedToasts;
+    policy.memoryLimit = SIZE_MAX;
+    return policy;
+}
+}
+
+// 100k toasts of mixed priority queued and drained in priority order
+SNORETOAST_BENCHMARK(ToastScheduler_PushPop100k)
+{
+    const auto input = requests();
+    while (state.keepRunning()) {
+        ToastScheduler scheduler(unbounded());
+        for (size_t i = 0; i < input.size(); ++i) {
+            scheduler.push(input[i], i);
+        }
+        while (const auto item = scheduler.pop()) {
+            Benchmark::doNotOptimize(item->tag);
+        }
+    }
+}
+
+// 100k toasts pushed through a queue capped at 10k, evicting the lowest priority
+SNORETOAST_BENCHMARK(ToastScheduler_Evict100k)
+{
+    const auto input = requests();
+    ToastScheduler::Policy policy = unbounded();
+    policy.capacity = QueuedToasts / 10;
+    while (state.keepRunning()) {
+        ToastScheduler scheduler(policy);
+        for (size_t i = 0; i < input.size(); ++i) {
+            scheduler.push(input[i], i);
+        }
+        Benchmark::doNotOptimize(scheduler.statistics().evicted);
+    }
+}
@@ -0,0 +1,31 @@
+/*
+    SnoreToast is capable to invoke Windows 8 toast notifications.
+    Copyright (C) 2026  Hannah von Reth <vonreth@kde.org>
+
+    SnoreToast is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    SnoreToast is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with SnoreToast.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "benchmark.h"
+
+#include "toasttrace.h"
+
+SNORETOAST_BENCHMARK(ToastTrace_DisabledSpan)
+{
+    // the trace is not started, unless SNORETOAST_TRACE is set
+    state.setMaxAllocationsPerIteration(0);
+    size_t i = 0;
+    while (state.keepRunning()) {
+        ST_TRACE("ToastTrace_DisabledSpan");
+        Benchmark::doNotOptimize(++i);
+    }
+}
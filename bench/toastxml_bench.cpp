@@ -0,0 +1,136 @@
+/*
+    SnoreToast is capable to invoke Windows 8 toast notifications.
+    Copyright (C) 2026  Hannah von Reth <vonreth@kde.org>
+
+    SnoreToast is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    SnoreToast is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with SnoreToast.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "benchmark.h"
+#include "benchinputs.h"
+
+#include "toastxml.h"
+
+namespace {
+ToastContent textContent()
+{
+    ToastContent content;
+    content.id = L"4242";
+    content.group = L"SnoreToast";
+    content.title = L"Build finished";
+    content.body = L"The build of \"snoretoast\" finished in 42s & all tests <passed>.";
+    content.sound = L"ms-winsoundevent:Notification.Default";
+    content.launchArguments = L"action=clicked;notificationId=4242;pipe=\\\\.\\pipe\\"
+                              L"snoretoast;application=C:\\bin\\app.exe;version=0.9.1;";
+    return content;
+}
+
+ToastContent imageContent()
+{
+    auto content = textContent();
+    content.image = L"C:\\Users\\snore\\AppData\\Local\\Temp\\snoretoast\\icon.png";
+    return content;
+}
+
+ToastContent buttonContent()
+{
+    auto content = textContent();
+    for (const auto &button : { L"Open", L"Show log", L"Retry", L"Ignore", L"Report" }) {
+        content.buttons.push_back(
+                { button,
+                  std::wstring(L"action=buttonClicked;notificationId=4242;button=") + button
+                          + L";pipe=\\\\.\\pipe\\snoretoast;version=0.9.1;" });
+    }
+    return content;
+}
+
+// a 2K body, five buttons and a long pipe in all launch arguments
+ToastContent longContent()
+{
+    auto content = textContent();
+    content.body = BenchInputs::longBody();
+    const auto pipe = BenchInputs::longPipe().wstring();
+    content.launchArguments = L"action=clicked;notificationId=4242;pipe=" + pipe + L";";
+    for (const auto &button : BenchInputs::buttons(BenchInputs::MaxButtons)) {
+        content.buttons.push_back(
+                { button,
+                  L"action=buttonClicked;notificationId=4242;button=" + button + L";pipe=" + pipe
+                          + L";" });
+    }
+    return content;
+}
+
+ToastContent textBoxContent()
+{
+    auto content = textContent();
+    content.textBox = true;
+    content.textBoxArguments =
+            L"action=textEntered;notificationId=4242;pipe=\\\\.\\pipe\\snoretoast;version=0.9.1;";
+    return content;
+}
+
+void build(Benchmark::State &state, const ToastContent &content)
+{
+    std::wstring out;
+    while (state.keepRunning()) {
+        ToastXml::build(content, out);
+        Benchmark::doNotOptimize(out.data());
+    }
+    state.setBytesPerIteration(out.size() * sizeof(wchar_t));
+}
+
+void buildFresh(Benchmark::State &state, const ToastContent &content)
+{
+    size_t size = 0;
+    while (state.keepRunning()) {
+        const auto out = ToastXml::build(content);
+        Benchmark::doNotOptimize(out.data());
+        size = out.size();
+    }
+    state.setBytesPerIteration(size * sizeof(wchar_t));
+}
+}
+
+SNORETOAST_BENCHMARK(ToastXml_TextOnly)
+{
+    build(state, textContent());
+}
+
+SNORETOAST_BENCHMARK(ToastXml_Image)
+{
+    build(state, imageContent());
+}
+
+SNORETOAST_BENCHMARK(ToastXml_Buttons)
+{
+    build(state, buttonContent());
+}
+
+SNORETOAST_BENCHMARK(ToastXml_LongBodyFiveButtons)
+{
+    build(state, longContent());
+}
+
+SNORETOAST_BENCHMARK(ToastXml_TextBox)
+{
+    build(state, textBoxContent());
+}
+
+SNORETOAST_BENCHMARK(ToastXml_TextOnly_FreshBuffer)
+{
+    buildFresh(state, textContent());
+}
+
+SNORETOAST_BENCHMARK(ToastXml_Buttons_FreshBuffer)
+{
+    buildFresh(state, buttonContent());
+}
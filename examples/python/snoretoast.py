@@ -4,6 +4,7 @@ import subprocess
 import sys
 import time
 import threading
+from urllib.parse import unquote
 
 PIPE_NAME = r"\\.\PIPE\snorepy"
 APP_ID = "SnoreToast.Example.Python"
@@ -26,7 +27,8 @@ def server():
 
             dataString = buff.value
             print(dataString)
-            data = dict((a,b) for a,b in [x.split("=", 1) for x in filter(None, dataString.split(";"))])
+            # % ; and = are percent encoded in the values
+            data = dict((a,unquote(b)) for a,b in [x.split("=", 1) for x in filter(None, dataString.split(";"))])
             print("Callback from:", data["notificationId"])
             if data["action"] == "buttonClicked":
                 print("The user clicked the button: ", data["button"])
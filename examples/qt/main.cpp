@@ -22,10 +22,12 @@
 #include <QDebug>
 #include <QProcess>
 #include <QTimer>
+#include <QUrl>
 
 #include <iostream>
 
 #include <snoretoastactions.h>
+#include <snoretoastprotocol.h>
 
 namespace {
 constexpr int NOTIFICATION_COUNT = 10;
@@ -41,24 +43,42 @@ int main(int argc, char *argv[])
         const QByteArray rawData = sock->readAll();
         sock->deleteLater();
 
-        const QString data =
-                QString::fromWCharArray(reinterpret_cast<const wchar_t *>(rawData.constData()),
-                                        rawData.size() / static_cast<int>(sizeof(wchar_t)));
-        qDebug() << data;
+        SnoreToastActions::Actions snoreAction = SnoreToastActions::Actions::Error;
         QMap<QString, QString> map;
-        for (const auto &str : data.split(QLatin1Char(';'))) {
-            const auto index = str.indexOf(QLatin1Char('='));
-            if (index > 0) {
-                map[str.mid(0, index)] = str.mid(index + 1);
+        if (SnoreToastProtocol::isVersion2(rawData.constData(), rawData.size())) {
+            // -protocol 2, the fields are read in place
+            SnoreToastProtocol::Message message;
+            if (SnoreToastProtocol::decode(rawData.constData(), rawData.size(), message)
+                == SnoreToastProtocol::Status::Ok) {
+                snoreAction = message.action();
+                for (const auto &field : message) {
+                    map[QString::fromUtf16(field.key.data(), field.key.size())] =
+                            QString::fromUtf16(field.value.data(), field.value.size());
+                }
             }
+        } else {
+            const QString data =
+                    QString::fromWCharArray(reinterpret_cast<const wchar_t *>(rawData.constData()),
+                                            rawData.size() / static_cast<int>(sizeof(wchar_t)));
+            for (const auto &str : data.split(QLatin1Char(';'))) {
+                const auto index = str.indexOf(QLatin1Char('='));
+                if (index > 0) {
+                    // % ; and = are percent encoded in the values
+                    map[str.mid(0, index)] =
+                            QUrl::fromPercentEncoding(str.mid(index + 1).toUtf8());
+                }
+            }
+            const QString action = map["action"];
+            snoreAction = SnoreToastActions::getAction(std::u16string_view(
+                    reinterpret_cast<const char16_t *>(action.utf16()), action.size()));
         }
-        const QString action = map["action"];
-
-        const auto snoreAction = SnoreToastActions::getAction(action.toStdWString());
+        qDebug() << map;
 
-        std::wcout << qPrintable(data) << std::endl;
-        std::wcout << "Action: " << qPrintable(action) << " " << static_cast<int>(snoreAction)
-                   << std::endl;
+        const auto actionName = SnoreToastActions::actionString(snoreAction);
+        std::wcout << "Action: "
+                   << qPrintable(QString::fromWCharArray(actionName.data(),
+                                                         static_cast<int>(actionName.size())))
+                   << " " << static_cast<int>(snoreAction) << std::endl;
 
         switch (snoreAction) {
         case SnoreToastActions::Actions::Clicked:
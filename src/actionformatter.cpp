@@ -0,0 +1,130 @@
+/*
+    SnoreToast is capable to invoke Windows 8 toast notifications.
+    Copyright (C) 2026  Hannah von Reth <vonreth@kde.org>
+
+    SnoreToast is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    SnoreToast is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with SnoreToast.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "actionformatter.h"
+#include "callbackdata.h"
+#include "config.h"
+
+#include <cstring>
+#include <iterator>
+
+namespace {
+struct StringSink
+{
+    void append(std::wstring_view data) { out.append(data); }
+    std::wstring &out;
+};
+
+struct BufferSink
+{
+    void append(std::wstring_view data)
+    {
+        if (buffer && size + data.size() <= capacity) {
+            std::memcpy(buffer + size, data.data(), data.size() * sizeof(wchar_t));
+        }
+        size += data.size();
+    }
+    wchar_t *buffer;
+    size_t capacity;
+    size_t size = 0;
+};
+
+template<typename Sink>
+void appendField(Sink &sink, const ActionFormatter::Field &field)
+{
+    if (!field.second.empty()) {
+        sink.append(field.first);
+        sink.append(L"=");
+        CallbackData::appendEscaped(sink, field.second);
+        sink.append(L";");
+    }
+}
+
+template<typename Sink>
+void write(Sink &sink, std::wstring_view shared, SnoreToastActions::Actions action,
+           ActionFormatter::Fields extraData)
+{
+    appendField(sink, { L"action", SnoreToastActions::actionString(action) });
+    sink.append(shared);
+    for (const auto &field : extraData) {
+        appendField(sink, field);
+    }
+    appendField(sink, { L"version", SNORETOAST_VERSION });
+}
+}
+
+ActionFormatter::Fields::Fields(const std::initializer_list<Field> &fields)
+    : m_begin(std::data(fields)), m_end(std::data(fields) + fields.size())
+{
+}
+
+ActionFormatter::Fields::Fields(const std::vector<Field> &fields)
+    : m_begin(fields.data()), m_end(fields.data() + fields.size())
+{
+}
+
+ActionFormatter::ActionFormatter() = default;
+
+void ActionFormatter::setToast(std::wstring_view id, const std::filesystem::path &pipe,
+                               const std::filesystem::path &application, unsigned protocol)
+{
+    const auto pipeString = pipe.wstring();
+    const auto applicationString = application.wstring();
+    const auto protocolString = protocol == 1 ? std::wstring() : std::to_wstring(protocol);
+    m_shared.clear();
+    StringSink sink { m_shared };
+    ::appendField(sink, { L"notificationId", id });
+    ::appendField(sink, { L"pipe", pipeString });
+    ::appendField(sink, { L"application", applicationString });
+    ::appendField(sink, { L"protocol", protocolString });
+}
+
+size_t ActionFormatter::size(SnoreToastActions::Actions action, Fields extraData) const
+{
+    BufferSink sink { nullptr, 0 };
+    write(sink, m_shared, action, extraData);
+    return sink.size;
+}
+
+void ActionFormatter::format(std::wstring &out, SnoreToastActions::Actions action,
+                             Fields extraData) const
+{
+    // resize doesn't allocate if the capacity suffices
+    out.resize(size(action, extraData));
+    format(out.data(), out.size(), action, extraData);
+}
+
+size_t ActionFormatter::format(wchar_t *buffer, size_t capacity,
+                               SnoreToastActions::Actions action, Fields extraData) const
+{
+    BufferSink sink { buffer, capacity };
+    write(sink, m_shared, action, extraData);
+    return sink.size;
+}
+
+void ActionFormatter::appendField(std::wstring &out, const Field &field)
+{
+    StringSink sink { out };
+    ::appendField(sink, field);
+}
+
+size_t ActionFormatter::fieldSize(const Field &field)
+{
+    BufferSink sink { nullptr, 0 };
+    ::appendField(sink, field);
+    return sink.size;
+}
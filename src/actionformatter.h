@@ -0,0 +1,97 @@
+/*
+    SnoreToast is capable to invoke Windows 8 toast notifications.
+    Copyright (C) 2026  Hannah von Reth <vonreth@kde.org>
+
+    SnoreToast is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    SnoreToast is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with SnoreToast.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#pragma once
+
+#include "snoretoastactions.h"
+
+#include <filesystem>
+#include <initializer_list>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+/**
+ * Formats the activation arguments of a toast:
+ * action=buttonClicked;notificationId=1;pipe=...;application=...;button=Ok;version=0.9.1;
+ *
+ * The fields shared by all actions of a toast are formatted once by setToast(), format() only
+ * appends the action specific fields and doesn't allocate if the buffer is large enough.
+ */
+class ActionFormatter
+{
+public:
+    using Field = std::pair<std::wstring_view, std::wstring_view>;
+
+    /**
+     * A view on the extra fields of an action, the fields must outlive the call.
+     */
+    class Fields
+    {
+    public:
+        Fields() : m_begin(nullptr), m_end(nullptr) { }
+        Fields(const std::initializer_list<Field> &fields);
+        Fields(const std::vector<Field> &fields);
+
+        const Field *begin() const { return m_begin; }
+        const Field *end() const { return m_end; }
+
+    private:
+        const Field *m_begin;
+        const Field *m_end;
+    };
+
+    ActionFormatter();
+
+    /**
+     * A protocol other than 1 is announced with protocol=2; so the activation callback, which
+     * might run in another process, answers with the same pipe protocol.
+     */
+    void setToast(std::wstring_view id, const std::filesystem::path &pipe,
+                  const std::filesystem::path &application, unsigned protocol = 1);
+
+    /**
+     * The length of the formatted action.
+     */
+    size_t size(SnoreToastActions::Actions action, Fields extraData = {}) const;
+
+    /**
+     * Replaces the content of out, the capacity of out is reused.
+     */
+    void format(std::wstring &out, SnoreToastActions::Actions action,
+                Fields extraData = {}) const;
+
+    /**
+     * Writes the action to buffer, the result is not null terminated.
+     * Returns the length of the formatted action, if it is larger than capacity the content
+     * of buffer is unspecified.
+     */
+    size_t format(wchar_t *buffer, size_t capacity, SnoreToastActions::Actions action,
+                  Fields extraData = {}) const;
+
+    /**
+     * Appends key=value; with the value escaped as described in CallbackData, fields with an
+     * empty value are skipped.
+     */
+    static void appendField(std::wstring &out, const Field &field);
+    static size_t fieldSize(const Field &field);
+
+private:
+    // notificationId=...;pipe=...;application=...;[protocol=2;]
+    std::wstring m_shared;
+};
@@ -0,0 +1,156 @@
+/*
+    SnoreToast is capable to invoke Windows 8 toast notifications.
+    Copyright (C) 2026  Hannah von Reth <vonreth@kde.org>
+
+    SnoreToast is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    SnoreToast is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with SnoreToast.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "callbackdata.h"
+
+namespace {
+constexpr auto npos = std::wstring_view::npos;
+
+// the character encoded by one of our escape sequences, or 0
+wchar_t unescape(std::wstring_view sequence)
+{
+    if (sequence.size() < 3 || sequence[0] != L'%') {
+        return 0;
+    }
+    const wchar_t high = sequence[1];
+    const wchar_t low = sequence[2] | 0x20; // lower case
+    if (high == L'2' && low == L'5') {
+        return L'%';
+    } else if (high == L'3' && low == L'b') {
+        return L';';
+    } else if (high == L'3' && low == L'd') {
+        return L'=';
+    }
+    return 0;
+}
+}
+
+CallbackData::CallbackData() : m_fields(m_inline.data()) { }
+
+CallbackData::CallbackData(std::wstring_view data) : CallbackData()
+{
+    parse(data);
+}
+
+void CallbackData::parse(std::wstring_view data)
+{
+    m_fields = m_inline.data();
+    m_overflow.clear();
+    m_size = 0;
+    m_storage.clear();
+
+    size_t start = 0;
+    while (start < data.size()) {
+        const size_t separator = TextKernels::findAny(data, L'=', L';', L';', start);
+        if (separator == npos) {
+            // a trailing key without a value
+            break;
+        }
+        if (data[separator] == L';' || separator == start) {
+            // an empty segment or one without a key
+            start = TextKernels::find(data, L';', separator);
+            start = start == npos ? data.size() : start + 1;
+            continue;
+        }
+        bool escaped = false;
+        size_t end = separator + 1;
+        while (true) {
+            end = TextKernels::findAny(data, L';', L'%', L'%', end);
+            if (end == npos) {
+                end = data.size();
+                break;
+            } else if (data[end] == L';') {
+                break;
+            }
+            escaped = true;
+            ++end;
+        }
+        if (escaped && m_storage.empty()) {
+            // the unescaped values are never longer than data, the views into m_storage stay
+            // valid
+            m_storage.reserve(data.size());
+        }
+        add(data.substr(start, separator - start), data.substr(separator + 1, end - separator - 1),
+            escaped);
+        start = end + 1;
+    }
+}
+
+void CallbackData::add(std::wstring_view key, std::wstring_view value, bool escaped)
+{
+    if (escaped) {
+        const size_t offset = m_storage.size();
+        size_t pos = 0;
+        for (size_t i = value.find(L'%'); i != npos; i = value.find(L'%', i + 1)) {
+            if (const wchar_t c = unescape(value.substr(i))) {
+                m_storage.append(value.substr(pos, i - pos));
+                m_storage.push_back(c);
+                pos = i + 3;
+                i += 2;
+            }
+        }
+        m_storage.append(value.substr(pos));
+        value = std::wstring_view(m_storage).substr(offset);
+    }
+    if (m_size == InlineCapacity && m_overflow.empty()) {
+        m_overflow.assign(m_inline.cbegin(), m_inline.cend());
+    }
+    if (m_size >= InlineCapacity) {
+        m_overflow.push_back({ key, value });
+        m_fields = m_overflow.data();
+    } else {
+        m_inline[m_size] = { key, value };
+    }
+    ++m_size;
+}
+
+const std::wstring_view *CallbackData::find(std::wstring_view key) const
+{
+    // the last occurrence wins
+    for (size_t i = m_size; i > 0; --i) {
+        const auto &field = m_fields[i - 1];
+        if (field.first.size() == key.size() && field.first == key) {
+            return &field.second;
+        }
+    }
+    return nullptr;
+}
+
+std::wstring_view CallbackData::value(std::wstring_view key) const
+{
+    const auto value = find(key);
+    return value ? *value : std::wstring_view();
+}
+
+bool CallbackData::contains(std::wstring_view key) const
+{
+    return find(key) != nullptr;
+}
+
+std::wstring_view CallbackData::escape(wchar_t c)
+{
+    switch (c) {
+    case L'%':
+        return L"%25";
+    case L';':
+        return L"%3B";
+    case L'=':
+        return L"%3D";
+    default:
+        return {};
+    }
+}
@@ -0,0 +1,100 @@
+/*
+    SnoreToast is capable to invoke Windows 8 toast notifications.
+    Copyright (C) 2026  Hannah von Reth <vonreth@kde.org>
+
+    SnoreToast is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    SnoreToast is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with SnoreToast.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#pragma once
+
+#include "textkernels.h"
+
+#include <array>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+/**
+ * The key=value; pairs passed to the activation callbacks and written to the pipe.
+ *
+ * Values are escaped: % ; and = are written as %25 %3B and %3D, other % sequences are
+ * kept as they are so payloads of older versions are read unchanged.
+ * Empty segments and segments without a key are skipped, if a key is repeated the last value
+ * wins.
+ */
+class CallbackData
+{
+public:
+    using Field = std::pair<std::wstring_view, std::wstring_view>;
+
+    CallbackData();
+    explicit CallbackData(std::wstring_view data);
+    CallbackData(const CallbackData &) = delete;
+    CallbackData &operator=(const CallbackData &) = delete;
+
+    /**
+     * Parses data in a single pass, the previous content is discarded.
+     * The fields point into data, which must outlive them. Only escaped values are copied to
+     * an internal buffer.
+     */
+    void parse(std::wstring_view data);
+
+    /**
+     * The unescaped value of key or nullptr.
+     */
+    const std::wstring_view *find(std::wstring_view key) const;
+    /**
+     * The unescaped value of key or an empty string.
+     */
+    std::wstring_view value(std::wstring_view key) const;
+    bool contains(std::wstring_view key) const;
+
+    size_t size() const { return m_size; }
+    const Field *begin() const { return m_fields; }
+    const Field *end() const { return m_fields + m_size; }
+
+    /**
+     * The escape sequence for c, or an empty string if c is not escaped.
+     */
+    static std::wstring_view escape(wchar_t c);
+    /**
+     * Appends the escaped value to out, a std::wstring or anything else with
+     * append(std::wstring_view).
+     */
+    template<typename Out>
+    static void appendEscaped(Out &out, std::wstring_view value)
+    {
+        constexpr auto npos = std::wstring_view::npos;
+        size_t start = 0;
+        for (size_t i = TextKernels::findAny(value, L'%', L';', L'='); i != npos;
+             i = TextKernels::findAny(value, L'%', L';', L'=', i + 1)) {
+            out.append(value.substr(start, i - start));
+            out.append(escape(value[i]));
+            start = i + 1;
+        }
+        out.append(value.substr(start));
+    }
+
+private:
+    void add(std::wstring_view key, std::wstring_view value, bool escaped);
+
+    // callbacks carry about 6 fields
+    static constexpr size_t InlineCapacity = 16;
+    std::array<Field, InlineCapacity> m_inline;
+    std::vector<Field> m_overflow;
+    Field *m_fields;
+    size_t m_size = 0;
+    // unescaped values, reserved up front so the views stay valid
+    std::wstring m_storage;
+};
@@ -0,0 +1,205 @@
+/*
+    SnoreToast is capable to invoke Windows 8 toast notifications.
+    Copyright (C) 2026  Hannah von Reth <vonreth@kde.org>
+
+    SnoreToast is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    SnoreToast is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with SnoreToast.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "callbackwriter.h"
+#include "toastlog.h"
+
+#include <algorithm>
+
+CallbackWriter::CallbackWriter(std::chrono::microseconds window, Connector connector,
+                               Fallback fallback, std::chrono::milliseconds idleTimeout)
+    : m_window(window),
+      m_idleTimeout(idleTimeout),
+      m_connector(std::move(connector)),
+      m_fallback(std::move(fallback)),
+      m_thread([this] { run(); })
+{
+}
+
+CallbackWriter::~CallbackWriter()
+{
+    {
+        std::scoped_lock lock(m_mutex);
+        m_stop = true;
+    }
+    m_condition.notify_all();
+    m_thread.join();
+}
+
+void CallbackWriter::post(const std::filesystem::path &pipe, std::string message,
+                          const std::filesystem::path &application)
+{
+    {
+        std::scoped_lock lock(m_mutex);
+        auto &out = m_pipes[pipe];
+        out.queue.push_back(std::move(message));
+        if (!application.empty()) {
+            out.application = application;
+        }
+        ++m_pending;
+    }
+    m_condition.notify_all();
+}
+
+void CallbackWriter::flush()
+{
+    std::unique_lock lock(m_mutex);
+    ++m_flushing;
+    m_condition.notify_all();
+    m_idleCondition.wait(lock, [this] { return m_pending == 0 && !m_busy; });
+    --m_flushing;
+}
+
+CallbackWriter::Statistics CallbackWriter::statistics() const
+{
+    std::scoped_lock lock(m_mutex);
+    return m_statistics;
+}
+
+size_t CallbackWriter::pipeCount() const
+{
+    std::scoped_lock lock(m_mutex);
+    return m_pipes.size();
+}
+
+void CallbackWriter::run()
+{
+    std::unique_lock lock(m_mutex);
+    auto nextClose = std::chrono::steady_clock::time_point::max();
+    while (true) {
+        const auto due = [this] { return m_stop || m_pending > 0; };
+        if (nextClose == std::chrono::steady_clock::time_point::max()) {
+            m_condition.wait(lock, due);
+        } else {
+            m_condition.wait_until(lock, nextClose, due);
+        }
+        if (m_pending == 0) {
+            if (m_stop) {
+                break;
+            }
+            nextClose = closeIdle(lock);
+            continue;
+        }
+        if (m_window.count() > 0) {
+            // collect the messages posted shortly after the first one
+            m_condition.wait_for(lock, m_window, [this] { return m_stop || m_flushing > 0; });
+        }
+        for (auto &[path, pipe] : m_pipes) {
+            if (!pipe.queue.empty()) {
+                std::swap(pipe.queue, pipe.batch);
+                pipe.batchApplication = pipe.application;
+                m_ready.push_back({ &path, &pipe });
+            }
+        }
+        m_pending = 0;
+        m_busy = true;
+        lock.unlock();
+        for (const auto &[path, pipe] : m_ready) {
+            write(*path, *pipe);
+        }
+        lock.lock();
+        m_ready.clear();
+        nextClose = closeIdle(lock);
+        m_busy = false;
+        if (m_pending == 0) {
+            m_idleCondition.notify_all();
+        }
+    }
+}
+
+void CallbackWriter::write(const std::filesystem::path &path, Pipe &pipe)
+{
+    const size_t count = pipe.batch.size();
+    // the first message that wasn't written completely
+    size_t next = 0;
+    uint64_t writes = 0;
+    uint64_t connects = 0;
+    // a connection kept open might have been closed by the receiver, reconnect once
+    for (int attempt = 0; attempt < 2 && next < count; ++attempt) {
+        if (!pipe.connection) {
+            pipe.connection = m_connector(path);
+            if (!pipe.connection) {
+                break;
+            }
+            ++connects;
+        }
+        m_buffers.assign(pipe.batch.cbegin() + next, pipe.batch.cend());
+        size_t written = pipe.connection->writeVectored(m_buffers.data(), m_buffers.size());
+        ++writes;
+        // the messages written completely are delivered and never written again, a message
+        // cut off by the error is dropped with the connection and written again in full
+        while (next < count && written >= pipe.batch[next].size()) {
+            written -= pipe.batch[next].size();
+            ++next;
+        }
+        if (next < count) {
+            pipe.connection.reset();
+        }
+    }
+    m_buffers.clear();
+    const size_t failed = count - next;
+    if (failed > 0) {
+        tWarning << L"Failed to write" << failed << L"callbacks to" << path;
+        if (m_fallback) {
+            for (size_t i = next; i < count; ++i) {
+                m_fallback(path, pipe.batchApplication, std::move(pipe.batch[i]));
+            }
+        }
+    }
+    pipe.batch.clear();
+    pipe.used = std::chrono::steady_clock::now();
+
+    std::scoped_lock lock(m_mutex);
+    m_statistics.connects += connects;
+    m_statistics.writes += writes;
+    m_statistics.messages += next;
+    if (m_fallback) {
+        m_statistics.fallbacks += failed;
+    } else {
+        m_statistics.dropped += failed;
+    }
+}
+
+std::chrono::steady_clock::time_point
+CallbackWriter::closeIdle(std::unique_lock<std::mutex> &lock)
+{
+    const auto now = std::chrono::steady_clock::now();
+    auto next = std::chrono::steady_clock::time_point::max();
+    for (auto it = m_pipes.begin(); it != m_pipes.end();) {
+        auto &pipe = it->second;
+        // a failed write already dropped the connection
+        if (pipe.queue.empty() && (!pipe.connection || now - pipe.used >= m_idleTimeout)) {
+            if (pipe.connection) {
+                m_closing.push_back(std::move(pipe.connection));
+            }
+            it = m_pipes.erase(it);
+            ++m_statistics.closed;
+        } else {
+            if (pipe.connection) {
+                next = std::min(next, pipe.used + m_idleTimeout);
+            }
+            ++it;
+        }
+    }
+    if (!m_closing.empty()) {
+        // the connections are closed unlocked, post() doesn't wait for them
+        lock.unlock();
+        m_closing.clear();
+        lock.lock();
+    }
+    return next;
+}
@@ -0,0 +1,149 @@
+/*
+    SnoreToast is capable to invoke Windows 8 toast notifications.
+    Copyright (C) 2026  Hannah von Reth <vonreth@kde.org>
+
+    SnoreToast is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    SnoreToast is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with SnoreToast.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#pragma once
+
+#include "toastserver.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
+
+/**
+ * Delivers the callbacks of many toasts to their pipes from a background thread.
+ *
+ * One connection per pipe is kept open across events, the messages posted within the
+ * coalescing window are written with a single vectored write. The messages must be self
+ * delimiting and identify their toast, like the SnoreToastProtocol version 2 messages which
+ * carry the notificationId of the toast.
+ *
+ * The messages that can't be written to a pipe are handed to the fallback, which delivers
+ * them one by one like the callbacks written without a writer.
+ *
+ * A pipe without pending messages is closed and forgotten after a failed write or once its
+ * connection was idle for the idle timeout, a host process that exited doesn't keep it open.
+ */
+class CallbackWriter
+{
+public:
+    using Connector = std::function<std::unique_ptr<ToastServerConnection>(
+            const std::filesystem::path &pipe)>;
+    using Fallback = std::function<void(const std::filesystem::path &pipe,
+                                        const std::filesystem::path &application,
+                                        std::string message)>;
+
+    struct Statistics
+    {
+        uint64_t messages = 0; // messages written
+        uint64_t writes = 0; // vectored writes
+        uint64_t connects = 0;
+        uint64_t fallbacks = 0; // messages handed to the fallback
+        uint64_t dropped = 0; // messages that couldn't be delivered without a fallback
+        uint64_t closed = 0; // pipes closed after a failed write or the idle timeout
+    };
+
+    static constexpr std::chrono::microseconds DefaultWindow = std::chrono::milliseconds(1);
+    static constexpr std::chrono::milliseconds DefaultIdleTimeout = std::chrono::minutes(1);
+
+    /**
+     * The connector opens the connections, by default LocalSocket::connect.
+     */
+    explicit CallbackWriter(std::chrono::microseconds window = DefaultWindow,
+                            Connector connector = LocalSocket::connect,
+                            Fallback fallback = nullptr,
+                            std::chrono::milliseconds idleTimeout = DefaultIdleTimeout);
+    /**
+     * Writes the pending messages.
+     */
+    ~CallbackWriter();
+
+    CallbackWriter(const CallbackWriter &) = delete;
+    CallbackWriter &operator=(const CallbackWriter &) = delete;
+
+    /**
+     * application is passed to the fallback if the pipe can't be reached.
+     */
+    void post(const std::filesystem::path &pipe, std::string message,
+              const std::filesystem::path &application = {});
+
+    /**
+     * Blocks until all messages posted so far were written, handed to the fallback or dropped,
+     * skips the window.
+     */
+    void flush();
+
+    Statistics statistics() const;
+    /**
+     * The pipes with an open connection or pending messages.
+     */
+    size_t pipeCount() const;
+
+private:
+    struct Pipe
+    {
+        std::unique_ptr<ToastServerConnection> connection;
+        std::vector<std::string> queue;
+        // the batch taken from the queue, swapped to reuse the capacity of both
+        std::vector<std::string> batch;
+        // the last application posted, copied with the batch
+        std::filesystem::path application;
+        std::filesystem::path batchApplication;
+        // the end of the last write
+        std::chrono::steady_clock::time_point used;
+    };
+
+    void run();
+    void write(const std::filesystem::path &path, Pipe &pipe);
+    /**
+     * Erases the failed and idle pipes, returns when the next connection becomes idle.
+     */
+    std::chrono::steady_clock::time_point closeIdle(std::unique_lock<std::mutex> &lock);
+
+    const std::chrono::microseconds m_window;
+    const std::chrono::milliseconds m_idleTimeout;
+    const Connector m_connector;
+    const Fallback m_fallback;
+
+    mutable std::mutex m_mutex;
+    std::condition_variable m_condition;
+    std::condition_variable m_idleCondition;
+    // std::map keeps the pipes in place while the writer thread uses them unlocked
+    std::map<std::filesystem::path, Pipe> m_pipes;
+    // the pipes with a batch to write, the map isn't iterated unlocked
+    std::vector<std::pair<const std::filesystem::path *, Pipe *>> m_ready;
+    size_t m_pending = 0;
+    size_t m_flushing = 0;
+    bool m_busy = false;
+    bool m_stop = false;
+    Statistics m_statistics;
+
+    // only used by the writer thread
+    std::vector<std::string_view> m_buffers;
+    std::vector<std::unique_ptr<ToastServerConnection>> m_closing;
+
+    std::thread m_thread;
+};
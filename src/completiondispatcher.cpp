@@ -0,0 +1,265 @@
+/*
+    SnoreToast is capable to invoke Windows 8 toast notifications.
+    Copyright (C) 2026  Hannah von Reth <vonreth@kde.org>
+
+    SnoreToast is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    SnoreToast is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with SnoreToast.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "completiondispatcher.h"
+#include "snoretoasts.h"
+#include "toasttrace.h"
+
+CompletionDispatcher::CompletionDispatcher() : CompletionDispatcher(Handler()) { }
+
+CompletionDispatcher::CompletionDispatcher(Handler handler)
+    : CompletionDispatcher(std::move(handler), Policy())
+{
+}
+
+CompletionDispatcher::CompletionDispatcher(Handler handler, Policy policy, Clock clock)
+    : m_handler(std::move(handler)), m_policy(policy), m_clock(std::move(clock))
+{
+}
+
+CompletionDispatcher::~CompletionDispatcher()
+{
+    stop();
+    // the remaining toasts are released without a result
+    for (auto &pending : m_pending) {
+        pending.second.toast->setFinishedCallback(nullptr);
+    }
+    m_pending.clear();
+}
+
+uint64_t CompletionDispatcher::add(std::unique_ptr<SnoreToasts> toast, uint64_t tag)
+{
+    Pending pending;
+    pending.toast = std::move(toast);
+    pending.tag = tag;
+    return add(std::move(pending));
+}
+
+uint64_t CompletionDispatcher::add(std::unique_ptr<SnoreToasts> toast, Callback callback)
+{
+    Pending pending;
+    pending.toast = std::move(toast);
+    pending.callback = std::move(callback);
+    return add(std::move(pending));
+}
+
+uint64_t CompletionDispatcher::add(std::unique_ptr<SnoreToasts> toast,
+                                   std::promise<SnoreToastActions::Actions> promise)
+{
+    // std::function needs a copyable callback
+    auto result = std::make_shared<std::promise<SnoreToastActions::Actions>>(std::move(promise));
+    return add(std::move(toast),
+               [result](SnoreToastActions::Actions action) { result->set_value(action); });
+}
+
+uint64_t CompletionDispatcher::add(Pending pending)
+{
+    SnoreToasts *instance = pending.toast.get();
+    uint64_t key;
+    {
+        std::scoped_lock lock(m_mutex);
+        key = m_nextKey++;
+        pending.deadline = m_deadlines.end();
+        m_pending.emplace(key, std::move(pending));
+        ++m_statistics.added;
+    }
+    // without a deadline process() only takes the toast out once the callback reported it,
+    // the callback might be called right away
+    instance->setFinishedCallback([this, key] { finished(key); });
+    {
+        std::scoped_lock lock(m_mutex);
+        const auto it = m_pending.find(key);
+        if (it != m_pending.end()) {
+            it->second.deadline = m_deadlines.emplace(m_clock() + m_policy.timeout, key);
+            // the event loop of the host has to wait for the earlier timeout
+            if (it->second.deadline == m_deadlines.begin() && !m_signalled) {
+                m_signalled = true;
+                m_signal.set();
+            }
+        }
+    }
+    m_condition.notify_all();
+    return key;
+}
+
+bool CompletionDispatcher::cancel(uint64_t ticket)
+{
+    {
+        std::scoped_lock lock(m_mutex);
+        const auto it = m_pending.find(ticket);
+        if (it == m_pending.end() || it->second.finished) {
+            return false;
+        }
+        // closed by process(), the toast might be destroyed by a running process() otherwise
+        it->second.cancelled = true;
+        queue(it->second, ticket);
+    }
+    m_condition.notify_all();
+    return true;
+}
+
+void CompletionDispatcher::finished(uint64_t key)
+{
+    {
+        std::scoped_lock lock(m_mutex);
+        // a toast can report more than one event, only the first one counts
+        const auto it = m_pending.find(key);
+        if (it == m_pending.end() || it->second.finished) {
+            return;
+        }
+        queue(it->second, key);
+    }
+    m_condition.notify_all();
+}
+
+void CompletionDispatcher::queue(Pending &pending, uint64_t key)
+{
+    pending.finished = true;
+    m_finished.push_back(key);
+    // one write for all results until the next process()
+    if (!m_signalled) {
+        m_signalled = true;
+        m_signal.set();
+    }
+}
+
+std::chrono::steady_clock::time_point CompletionDispatcher::process()
+{
+    std::vector<Pending> done;
+    size_t timedOut = 0;
+    size_t cancelled = 0;
+    {
+        std::scoped_lock lock(m_mutex);
+        if (m_signalled) {
+            m_signalled = false;
+            m_signal.reset();
+        }
+        for (const uint64_t key : m_finished) {
+            const auto it = m_pending.find(key);
+            if (it == m_pending.end()) {
+                continue;
+            }
+            cancelled += it->second.cancelled ? 1 : 0;
+            if (it->second.deadline != m_deadlines.end()) {
+                m_deadlines.erase(it->second.deadline);
+            }
+            done.push_back(std::move(it->second));
+            m_pending.erase(it);
+        }
+        m_finished.clear();
+        const auto now = m_clock();
+        while (!m_deadlines.empty() && m_deadlines.begin()->first <= now) {
+            const auto it = m_pending.find(m_deadlines.begin()->second);
+            m_deadlines.erase(m_deadlines.begin());
+            done.push_back(std::move(it->second));
+            m_pending.erase(it);
+            ++timedOut;
+        }
+        m_inFlight += done.size();
+    }
+
+    for (auto &pending : done) {
+        ST_TRACE("CompletionDispatcher::deliver");
+        SnoreToastActions::Actions action;
+        if (pending.cancelled) {
+            pending.toast->closeNotification();
+            pending.toast->userAction(std::chrono::milliseconds(0));
+            action = SnoreToastActions::Actions::Hidden;
+        } else {
+            // returns without waiting, Error for the timed out toasts
+            action = pending.toast->userAction(std::chrono::milliseconds(0));
+        }
+        if (pending.callback) {
+            pending.callback(action);
+        } else if (m_handler) {
+            m_handler(pending.tag, action);
+        }
+        pending.toast.reset();
+    }
+
+    std::scoped_lock lock(m_mutex);
+    m_statistics.completed += done.size() - timedOut - cancelled;
+    m_statistics.timedOut += timedOut;
+    m_statistics.cancelled += cancelled;
+    m_inFlight -= done.size();
+    if (m_pending.empty() && m_inFlight == 0) {
+        m_emptyCondition.notify_all();
+    }
+    return m_deadlines.empty() ? std::chrono::steady_clock::time_point::max()
+                               : m_deadlines.begin()->first;
+}
+
+void CompletionDispatcher::start()
+{
+    std::scoped_lock lock(m_mutex);
+    if (!m_thread.joinable()) {
+        m_stop = false;
+        m_thread = std::thread([this] { run(); });
+    }
+}
+
+void CompletionDispatcher::stop()
+{
+    {
+        std::scoped_lock lock(m_mutex);
+        m_stop = true;
+    }
+    m_condition.notify_all();
+    if (m_thread.joinable()) {
+        m_thread.join();
+    }
+}
+
+bool CompletionDispatcher::waitUntilEmpty(std::chrono::milliseconds timeout)
+{
+    std::unique_lock lock(m_mutex);
+    return m_emptyCondition.wait_for(lock, timeout,
+                                     [this] { return m_pending.empty() && m_inFlight == 0; });
+}
+
+size_t CompletionDispatcher::size() const
+{
+    std::scoped_lock lock(m_mutex);
+    return m_pending.size() + m_inFlight;
+}
+
+CompletionDispatcher::Statistics CompletionDispatcher::statistics() const
+{
+    std::scoped_lock lock(m_mutex);
+    return m_statistics;
+}
+
+void CompletionDispatcher::run()
+{
+    while (true) {
+        const auto nextTimeout = process();
+        std::unique_lock lock(m_mutex);
+        const auto due = [this, nextTimeout] {
+            // add() might have registered an earlier timeout
+            return m_stop || !m_finished.empty()
+                    || (!m_deadlines.empty() && m_deadlines.begin()->first < nextTimeout);
+        };
+        if (nextTimeout == std::chrono::steady_clock::time_point::max()) {
+            m_condition.wait(lock, due);
+        } else {
+            m_condition.wait_for(lock, nextTimeout - m_clock(), due);
+        }
+        if (m_stop) {
+            break;
+        }
+    }
+}
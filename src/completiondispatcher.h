@@ -0,0 +1,173 @@
+/*
+    SnoreToast is capable to invoke Windows 8 toast notifications.
+    Copyright (C) 2026  Hannah von Reth <vonreth@kde.org>
+
+    SnoreToast is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    SnoreToast is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with SnoreToast.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#pragma once
+
+#include "completionsignal.h"
+#include "snoretoastactions.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+class SnoreToasts;
+
+/**
+ * Collects the results of any number of displayed toasts without a waiting thread per toast.
+ *
+ * A toast is handed over after SnoreToasts::displayToast(), its result is queued by the
+ * event that ends the toast and passed to the callback of the toast or to the handler together
+ * with the tag of the toast, in the order the results arrive. A toast without a result after
+ * the timeout is reported as Error, like a timed out SnoreToasts::userAction(). The instance
+ * is destroyed after the handler returned.
+ *
+ * The clock can be replaced, process() delivers the due results without the worker.
+ *
+ * Without the worker the dispatcher fits into the event loop of the host: nativeHandle() is
+ * signalled while process() has results to deliver and process() returns when it has to be
+ * called again for the next timeout, so no thread waits for a toast. The results are
+ * delivered on the thread calling process().
+ */
+class CompletionDispatcher
+{
+public:
+    using Clock = std::function<std::chrono::steady_clock::time_point()>;
+    using Handler = std::function<void(uint64_t tag, SnoreToastActions::Actions action)>;
+    using Callback = std::function<void(SnoreToastActions::Actions action)>;
+
+    struct Policy
+    {
+        // like the timeout of SnoreToasts::userAction()
+        std::chrono::milliseconds timeout = std::chrono::minutes(1);
+    };
+
+    struct Statistics
+    {
+        uint64_t added = 0;
+        uint64_t completed = 0;
+        uint64_t timedOut = 0;
+        uint64_t cancelled = 0;
+    };
+
+    /**
+     * A dispatcher for toasts with their own callback.
+     */
+    CompletionDispatcher();
+    explicit CompletionDispatcher(Handler handler);
+    CompletionDispatcher(Handler handler, Policy policy,
+                         Clock clock = std::chrono::steady_clock::now);
+    ~CompletionDispatcher();
+
+    CompletionDispatcher(const CompletionDispatcher &) = delete;
+    CompletionDispatcher &operator=(const CompletionDispatcher &) = delete;
+
+    /**
+     * Tracks the displayed toast, thread safe. Returns the ticket of the toast for cancel().
+     */
+    uint64_t add(std::unique_ptr<SnoreToasts> toast, uint64_t tag);
+    /**
+     * The result is passed to callback instead of the handler.
+     */
+    uint64_t add(std::unique_ptr<SnoreToasts> toast, Callback callback);
+    /**
+     * The result is set on promise, a toast released by the destructor breaks the promise.
+     * Waiting for the future blocks the results if it is the thread calling process().
+     */
+    uint64_t add(std::unique_ptr<SnoreToasts> toast,
+                 std::promise<SnoreToastActions::Actions> promise);
+
+    /**
+     * Closes the toast of ticket, its result is Hidden. Returns false if the result of the
+     * toast is already known.
+     */
+    bool cancel(uint64_t ticket);
+
+    /**
+     * Delivers the queued and timed out results on the calling thread, returns the next
+     * timeout or time_point::max() if no toast is pending.
+     */
+    std::chrono::steady_clock::time_point process();
+
+    /**
+     * Starts the worker thread calling process().
+     */
+    void start();
+    void stop();
+
+    /**
+     * Blocks until the results of all toasts were delivered, at most for timeout.
+     */
+    bool waitUntilEmpty(std::chrono::milliseconds timeout);
+
+    size_t size() const;
+    Statistics statistics() const;
+
+    /**
+     * Signalled while process() has results to deliver or a new timeout was added, for
+     * epoll, WaitForMultipleObjects, QSocketNotifier or QWinEventNotifier and alike.
+     */
+    CompletionSignal::NativeHandle nativeHandle() const { return m_signal.nativeHandle(); }
+
+private:
+    using Deadlines = std::multimap<std::chrono::steady_clock::time_point, uint64_t>;
+
+    struct Pending
+    {
+        std::unique_ptr<SnoreToasts> toast;
+        uint64_t tag = 0;
+        Callback callback;
+        // end() until the finished callback is installed
+        Deadlines::iterator deadline;
+        // queued in m_finished
+        bool finished = false;
+        bool cancelled = false;
+    };
+
+    uint64_t add(Pending pending);
+    void finished(uint64_t key);
+    // with m_mutex locked
+    void queue(Pending &pending, uint64_t key);
+    void run();
+
+    const Handler m_handler;
+    const Policy m_policy;
+    const Clock m_clock;
+
+    mutable std::mutex m_mutex;
+    std::condition_variable m_condition;
+    std::condition_variable m_emptyCondition;
+    std::unordered_map<uint64_t, Pending> m_pending;
+    Deadlines m_deadlines;
+    // the toasts with a result, in the order of the results
+    std::vector<uint64_t> m_finished;
+    uint64_t m_nextKey = 0;
+    // the toasts taken out by process() whose handler didn't return yet
+    size_t m_inFlight = 0;
+    Statistics m_statistics;
+    CompletionSignal m_signal;
+    bool m_signalled = false;
+    bool m_stop = false;
+    std::thread m_thread;
+};
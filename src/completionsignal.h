@@ -0,0 +1,55 @@
+/*
+    SnoreToast is capable to invoke Windows 8 toast notifications.
+    Copyright (C) 2026  Hannah von Reth <vonreth@kde.org>
+
+    SnoreToast is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    SnoreToast is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with SnoreToast.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#pragma once
+
+/**
+ * A handle an event loop can wait on, readable or signalled after set() until reset().
+ *
+ * An eventfd on Linux, a pipe on other unix systems and a manual reset event on Windows.
+ * nativeHandle() is -1 or nullptr if the handle couldn't be created, set() and reset() do
+ * nothing then.
+ */
+class CompletionSignal
+{
+public:
+#ifdef _WIN32
+    using NativeHandle = void *;
+#else
+    using NativeHandle = int;
+#endif
+
+    CompletionSignal();
+    ~CompletionSignal();
+
+    CompletionSignal(const CompletionSignal &) = delete;
+    CompletionSignal &operator=(const CompletionSignal &) = delete;
+
+    void set();
+    void reset();
+
+    NativeHandle nativeHandle() const { return m_handle; }
+
+private:
+#ifdef _WIN32
+    NativeHandle m_handle = nullptr;
+#else
+    NativeHandle m_handle = -1;
+    // the end set() writes to, m_handle for an eventfd
+    int m_write = -1;
+#endif
+};
@@ -0,0 +1,71 @@
+/*
+    SnoreToast is capable to invoke Windows 8 toast notifications.
+    Copyright (C) 2026  Hannah von Reth <vonreth@kde.org>
+
+    SnoreToast is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    SnoreToast is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with SnoreToast.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "completionsignal.h"
+
+#include <cstdint>
+
+#include <fcntl.h>
+#include <unistd.h>
+#ifdef __linux__
+#include <sys/eventfd.h>
+#endif
+
+CompletionSignal::CompletionSignal()
+{
+#ifdef __linux__
+    m_handle = ::eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    m_write = m_handle;
+#else
+    int fds[2];
+    if (::pipe(fds) == 0) {
+        for (const int fd : fds) {
+            ::fcntl(fd, F_SETFL, ::fcntl(fd, F_GETFL) | O_NONBLOCK);
+            ::fcntl(fd, F_SETFD, FD_CLOEXEC);
+        }
+        m_handle = fds[0];
+        m_write = fds[1];
+    }
+#endif
+}
+
+CompletionSignal::~CompletionSignal()
+{
+    if (m_write >= 0 && m_write != m_handle) {
+        ::close(m_write);
+    }
+    if (m_handle >= 0) {
+        ::close(m_handle);
+    }
+}
+
+void CompletionSignal::set()
+{
+    if (m_write >= 0) {
+        // an eventfd takes 8 bytes, a full pipe is readable already
+        const uint64_t value = 1;
+        [[maybe_unused]] const auto written = ::write(m_write, &value, sizeof(value));
+    }
+}
+
+void CompletionSignal::reset()
+{
+    if (m_handle >= 0) {
+        uint64_t buffer[8];
+        while (::read(m_handle, buffer, sizeof(buffer)) > 0) { }
+    }
+}
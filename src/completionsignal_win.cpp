@@ -0,0 +1,43 @@
+/*
+    SnoreToast is capable to invoke Windows 8 toast notifications.
+    Copyright (C) 2026  Hannah von Reth <vonreth@kde.org>
+
+    SnoreToast is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    SnoreToast is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with SnoreToast.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "completionsignal.h"
+
+#include <windows.h>
+
+CompletionSignal::CompletionSignal() : m_handle(CreateEventW(nullptr, TRUE, FALSE, nullptr)) { }
+
+CompletionSignal::~CompletionSignal()
+{
+    if (m_handle) {
+        CloseHandle(m_handle);
+    }
+}
+
+void CompletionSignal::set()
+{
+    if (m_handle) {
+        SetEvent(m_handle);
+    }
+}
+
+void CompletionSignal::reset()
+{
+    if (m_handle) {
+        ResetEvent(m_handle);
+    }
+}
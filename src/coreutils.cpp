@@ -0,0 +1,68 @@
+/*
+    SnoreToast is capable to invoke Windows 8 toast notifications.
+    Copyright (C) 2019  Hannah von Reth <vonreth@kde.org>
+
+    SnoreToast is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    SnoreToast is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with SnoreToast.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "coreutils.h"
+#include "actionformatter.h"
+#include "config.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#endif
+
+namespace Utils {
+
+const std::filesystem::path &selfLocate()
+{
+    static const std::filesystem::path path = [] {
+#ifdef _WIN32
+        // don't modify the lasterror
+        const auto lastError = GetLastError();
+        std::wstring buf;
+        size_t size;
+        do {
+            buf.resize(buf.size() + 1024);
+            size = GetModuleFileNameW(nullptr, const_cast<wchar_t *>(buf.data()),
+                                      static_cast<DWORD>(buf.size()));
+        } while (GetLastError() == ERROR_INSUFFICIENT_BUFFER);
+        buf.resize(size);
+        SetLastError(lastError);
+        return std::filesystem::path(buf);
+#else
+        std::error_code error;
+        return std::filesystem::read_symlink("/proc/self/exe", error);
+#endif
+    }();
+    return path;
+}
+
+std::wstring formatData(const std::vector<std::pair<std::wstring_view, std::wstring_view>> &data)
+{
+    const ActionFormatter::Field version = { L"version", SNORETOAST_VERSION };
+    size_t size = ActionFormatter::fieldSize(version);
+    for (const auto &p : data) {
+        size += ActionFormatter::fieldSize(p);
+    }
+    std::wstring out;
+    out.reserve(size);
+    for (const auto &p : data) {
+        ActionFormatter::appendField(out, p);
+    }
+    ActionFormatter::appendField(out, version);
+    return out;
+}
+}
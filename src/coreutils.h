@@ -0,0 +1,34 @@
+/*
+    SnoreToast is capable to invoke Windows 8 toast notifications.
+    Copyright (C) 2019  Hannah von Reth <vonreth@kde.org>
+
+    SnoreToast is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    SnoreToast is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with SnoreToast.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include "stringutils.h"
+
+#include <filesystem>
+#include <string_view>
+#include <vector>
+
+/**
+ * The parts of Utils that are used by libsnoretoast_core.
+ */
+namespace Utils {
+const std::filesystem::path &selfLocate();
+
+std::wstring formatData(const std::vector<std::pair<std::wstring_view, std::wstring_view>> &data);
+};
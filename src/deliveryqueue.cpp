@@ -0,0 +1,209 @@
+/*
+    SnoreToast is capable to invoke Windows 8 toast notifications.
+    Copyright (C) 2026  Hannah von Reth <vonreth@kde.org>
+
+    SnoreToast is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    SnoreToast is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with SnoreToast.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "deliveryqueue.h"
+#include "toastlog.h"
+#include "toasttrace.h"
+
+#include <algorithm>
+#include <vector>
+
+DeliveryQueue::DeliveryQueue(NotificationBackend *backend) : DeliveryQueue(backend, Policy())
+{
+}
+
+DeliveryQueue::DeliveryQueue(NotificationBackend *backend, Policy policy, Clock clock)
+    : m_backend(backend), m_policy(policy), m_clock(std::move(clock))
+{
+}
+
+DeliveryQueue::~DeliveryQueue()
+{
+    stop();
+}
+
+bool DeliveryQueue::push(const std::filesystem::path &pipe,
+                         const std::filesystem::path &application, std::string message)
+{
+    const auto now = m_clock();
+    {
+        std::scoped_lock lock(m_mutex);
+        if (m_queue.size() >= m_policy.capacity) {
+            ++m_statistics.dropped;
+            if (m_policy.dropPolicy == DropPolicy::RejectNew || m_queue.empty()) {
+                tWarning << L"Delivery queue full, dropped a callback for" << pipe;
+                return false;
+            }
+            tWarning << L"Delivery queue full, dropped a callback for" << m_queue.front().pipe;
+            m_queue.pop_front();
+        }
+        m_queue.push_back({ pipe, application, std::move(message), now + m_policy.deadline, now });
+    }
+    m_condition.notify_all();
+    return true;
+}
+
+std::chrono::steady_clock::time_point DeliveryQueue::process()
+{
+    const auto now = m_clock();
+    // the writes happen unlocked, push() must never wait for a pipe
+    std::vector<Delivery> due;
+    {
+        std::scoped_lock lock(m_mutex);
+        for (auto it = m_queue.begin(); it != m_queue.end();) {
+            if (it->nextAttempt <= now) {
+                due.push_back(std::move(*it));
+                it = m_queue.erase(it);
+            } else {
+                ++it;
+            }
+        }
+        m_inFlight = due.size();
+    }
+
+    Statistics statistics;
+    std::vector<Delivery> retry;
+    for (auto &delivery : due) {
+        ST_TRACE("DeliveryQueue::deliver");
+        if (m_backend->writePipe(delivery.pipe, delivery.message)) {
+            ++statistics.delivered;
+            continue;
+        }
+        if (!delivery.started && !delivery.application.empty()) {
+            // the host might not be running, start it once and keep retrying
+            delivery.started = true;
+            if (m_backend->startProcess(delivery.application)) {
+                ++statistics.started;
+            }
+        }
+        ++delivery.attempts;
+        if (now >= delivery.deadline) {
+            tWarning << L"Failed to deliver the callback to" << delivery.pipe << L"after"
+                     << delivery.attempts << L"attempts";
+            ++statistics.expired;
+            continue;
+        }
+        ++statistics.retries;
+        // the last attempt happens at the deadline
+        delivery.nextAttempt = std::min(now + backoff(delivery.attempts - 1), delivery.deadline);
+        retry.push_back(std::move(delivery));
+    }
+
+    auto nextAttempt = std::chrono::steady_clock::time_point::max();
+    {
+        std::scoped_lock lock(m_mutex);
+        m_statistics.delivered += statistics.delivered;
+        m_statistics.retries += statistics.retries;
+        m_statistics.started += statistics.started;
+        m_statistics.expired += statistics.expired;
+        for (auto &delivery : retry) {
+            // keep the oldest messages first for DropOldest
+            const auto pos = std::find_if(m_queue.begin(), m_queue.end(), [&](const Delivery &d) {
+                return d.deadline > delivery.deadline;
+            });
+            m_queue.insert(pos, std::move(delivery));
+        }
+        while (m_queue.size() > m_policy.capacity) {
+            ++m_statistics.dropped;
+            if (m_policy.dropPolicy == DropPolicy::RejectNew) {
+                m_queue.pop_back();
+            } else {
+                m_queue.pop_front();
+            }
+        }
+        for (const auto &delivery : m_queue) {
+            nextAttempt = std::min(nextAttempt, delivery.nextAttempt);
+        }
+        m_inFlight = 0;
+        if (m_queue.empty()) {
+            m_emptyCondition.notify_all();
+        }
+    }
+    return nextAttempt;
+}
+
+void DeliveryQueue::start()
+{
+    std::scoped_lock lock(m_mutex);
+    if (!m_thread.joinable()) {
+        m_stop = false;
+        m_thread = std::thread([this] { run(); });
+    }
+}
+
+void DeliveryQueue::stop()
+{
+    {
+        std::scoped_lock lock(m_mutex);
+        m_stop = true;
+    }
+    m_condition.notify_all();
+    if (m_thread.joinable()) {
+        m_thread.join();
+    }
+}
+
+bool DeliveryQueue::waitUntilEmpty(std::chrono::milliseconds timeout)
+{
+    std::unique_lock lock(m_mutex);
+    return m_emptyCondition.wait_for(lock, timeout,
+                                     [this] { return m_queue.empty() && m_inFlight == 0; });
+}
+
+size_t DeliveryQueue::size() const
+{
+    std::scoped_lock lock(m_mutex);
+    return m_queue.size() + m_inFlight;
+}
+
+DeliveryQueue::Statistics DeliveryQueue::statistics() const
+{
+    std::scoped_lock lock(m_mutex);
+    return m_statistics;
+}
+
+void DeliveryQueue::run()
+{
+    while (true) {
+        const auto nextAttempt = process();
+        std::unique_lock lock(m_mutex);
+        const auto due = [this, nextAttempt] {
+            // a push might have queued an earlier attempt
+            return m_stop
+                    || std::any_of(m_queue.cbegin(), m_queue.cend(), [&](const Delivery &d) {
+                           return d.nextAttempt < nextAttempt;
+                       });
+        };
+        if (nextAttempt == std::chrono::steady_clock::time_point::max()) {
+            m_condition.wait(lock, due);
+        } else {
+            m_condition.wait_for(lock, nextAttempt - m_clock(), due);
+        }
+        if (m_stop) {
+            break;
+        }
+    }
+}
+
+std::chrono::milliseconds DeliveryQueue::backoff(uint32_t attempts) const
+{
+    auto out = m_policy.initialBackoff;
+    for (uint32_t i = 0; i < attempts && out < m_policy.maxBackoff; ++i) {
+        out *= 2;
+    }
+    return std::min(out, m_policy.maxBackoff);
+}
@@ -0,0 +1,138 @@
+/*
+    SnoreToast is capable to invoke Windows 8 toast notifications.
+    Copyright (C) 2026  Hannah von Reth <vonreth@kde.org>
+
+    SnoreToast is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    SnoreToast is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with SnoreToast.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#pragma once
+
+#include "notificationbackend.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <filesystem>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+
+/**
+ * Delivers the callbacks of backgroundCallback without blocking the activation.
+ *
+ * The messages are queued and written by a worker thread. A failed write starts the
+ * application of the toast once and is retried with exponential backoff until the deadline
+ * of the message passed. The queue is bounded, the drop policy decides which message is
+ * discarded when it is full.
+ *
+ * The backend is the transport and the clock can be replaced, process() runs a single round
+ * of deliveries without the worker.
+ */
+class DeliveryQueue
+{
+public:
+    using Clock = std::function<std::chrono::steady_clock::time_point()>;
+
+    enum class DropPolicy {
+        DropOldest,
+        RejectNew
+    };
+
+    struct Policy
+    {
+        size_t capacity = 64;
+        std::chrono::milliseconds initialBackoff = std::chrono::milliseconds(50);
+        std::chrono::milliseconds maxBackoff = std::chrono::seconds(2);
+        // measured from push(), like the former WaitNamedPipe timeout
+        std::chrono::milliseconds deadline = std::chrono::seconds(20);
+        DropPolicy dropPolicy = DropPolicy::DropOldest;
+    };
+
+    struct Statistics
+    {
+        uint64_t delivered = 0;
+        uint64_t retries = 0;
+        uint64_t started = 0; // applications started
+        uint64_t expired = 0; // messages dropped at their deadline
+        uint64_t dropped = 0; // messages dropped because the queue was full
+    };
+
+    /**
+     * The backend must outlive the queue.
+     */
+    explicit DeliveryQueue(NotificationBackend *backend);
+    DeliveryQueue(NotificationBackend *backend, Policy policy,
+                  Clock clock = std::chrono::steady_clock::now);
+    ~DeliveryQueue();
+
+    DeliveryQueue(const DeliveryQueue &) = delete;
+    DeliveryQueue &operator=(const DeliveryQueue &) = delete;
+
+    /**
+     * Queues message for pipe, application is started if the pipe is not available.
+     * Returns false if the message was rejected.
+     */
+    bool push(const std::filesystem::path &pipe, const std::filesystem::path &application,
+              std::string message);
+
+    /**
+     * Attempts the due deliveries, returns when the next attempt is due or
+     * time_point::max() if the queue is empty.
+     */
+    std::chrono::steady_clock::time_point process();
+
+    /**
+     * Starts the worker thread calling process().
+     */
+    void start();
+    void stop();
+
+    /**
+     * Blocks until all messages were delivered or dropped, at most for timeout.
+     */
+    bool waitUntilEmpty(std::chrono::milliseconds timeout);
+
+    size_t size() const;
+    Statistics statistics() const;
+
+private:
+    struct Delivery
+    {
+        std::filesystem::path pipe;
+        std::filesystem::path application;
+        std::string message;
+        std::chrono::steady_clock::time_point deadline;
+        std::chrono::steady_clock::time_point nextAttempt;
+        uint32_t attempts = 0;
+        bool started = false;
+    };
+
+    void run();
+    std::chrono::milliseconds backoff(uint32_t attempts) const;
+
+    NotificationBackend *m_backend;
+    const Policy m_policy;
+    const Clock m_clock;
+
+    mutable std::mutex m_mutex;
+    std::condition_variable m_condition;
+    std::condition_variable m_emptyCondition;
+    std::deque<Delivery> m_queue;
+    // the number of deliveries taken out of m_queue by process()
+    size_t m_inFlight = 0;
+    Statistics m_statistics;
+    bool m_stop = false;
+    std::thread m_thread;
+};
@@ -0,0 +1,212 @@
+/*
+    SnoreToast is capable to invoke Windows 8 toast notifications.
+    Copyright (C) 2026  Hannah von Reth <vonreth@kde.org>
+
+    SnoreToast is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    SnoreToast is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with SnoreToast.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "imagecache.h"
+#include "mappedfile.h"
+#include "pngimage.h"
+#include "toastlog.h"
+#include "toasttrace.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <thread>
+
+namespace {
+// downscale() gives up on the file size below this edge length
+constexpr uint32_t MinDimension = 16;
+
+std::filesystem::path fileName(uint64_t hash)
+{
+    constexpr char Digits[] = "0123456789abcdef";
+    std::string name(16, '0');
+    for (size_t i = name.size(); i-- > 0; hash >>= 4) {
+        name[i] = Digits[hash & 0xf];
+    }
+    return name + ".png";
+}
+
+// unique among the processes sharing the directory
+std::filesystem::path partialName(const std::filesystem::path &target)
+{
+    static std::atomic<uint64_t> counter { 0 };
+    const auto unique = std::chrono::steady_clock::now().time_since_epoch().count()
+            ^ std::hash<std::thread::id>()(std::this_thread::get_id());
+    auto out = target;
+    out += "." + std::to_string(unique) + "-" + std::to_string(counter++) + ".partial";
+    return out;
+}
+}
+
+ImageCache::ImageCache(std::filesystem::path directory)
+    : ImageCache(std::move(directory), Limits())
+{
+}
+
+ImageCache::ImageCache(std::filesystem::path directory, Limits limits)
+    : m_directory(std::move(directory)), m_limits(limits)
+{
+}
+
+std::filesystem::path ImageCache::normalize(const std::filesystem::path &image)
+{
+    ST_TRACE("ImageCache::normalize");
+    std::error_code error;
+    const auto size = std::filesystem::file_size(image, error);
+    const auto modified = error ? std::filesystem::file_time_type()
+                                : std::filesystem::last_write_time(image, error);
+    if (error) {
+        tWarning << L"Failed to read the image" << image << error.message();
+        return image;
+    }
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        const auto it = m_entries.find(image.native());
+        if (it != m_entries.end() && it->second.size == size && it->second.modified == modified
+            && (it->second.result == image || std::filesystem::exists(it->second.result, error))) {
+            ++(m_statistics.*(it->second.result == image ? it->second.outcome
+                                                          : &Statistics::hits));
+            return it->second.result;
+        }
+    }
+
+    std::filesystem::path result = image;
+    uint64_t Statistics::*outcome = &Statistics::accepted;
+    const auto file = MappedFile::open(image);
+    const auto header = file ? PngImage::readHeader(file->data()) : std::nullopt;
+    if (header
+        && (header->width > m_limits.maxDimension || header->height > m_limits.maxDimension
+            || size > m_limits.maxFileSize)) {
+        result = downscale(image, file->data());
+        outcome = result == image ? &Statistics::failed : &Statistics::hits;
+    } else {
+        if (size > m_limits.maxFileSize) {
+            tWarning << image << L"is larger than" << m_limits.maxFileSize
+                     << L"bytes and not a PNG, it might not be displayed";
+            outcome = &Statistics::failed;
+        }
+        std::lock_guard<std::mutex> lock(m_mutex);
+        ++(m_statistics.*outcome);
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_entries[image.native()] = Entry { size, modified, result, outcome };
+    return result;
+}
+
+std::filesystem::path ImageCache::downscale(const std::filesystem::path &image,
+                                            std::string_view data)
+{
+    ST_TRACE("ImageCache::downscale");
+    const auto target = m_directory / fileName(contentHash(data));
+    std::error_code error;
+    if (std::filesystem::exists(target, error)) {
+        tLog << L"Reusing" << target << L"for" << image;
+        std::lock_guard<std::mutex> lock(m_mutex);
+        ++m_statistics.hits;
+        return target;
+    }
+
+    const auto fail = [&](std::wstring_view reason) {
+        tWarning << L"Failed to downscale" << image << reason << L"it might not be displayed";
+        std::lock_guard<std::mutex> lock(m_mutex);
+        ++m_statistics.failed;
+        return image;
+    };
+    PngImage::Pixels pixels;
+    std::wstring decodeError;
+    if (!PngImage::decode(data, pixels, decodeError)) {
+        return fail(decodeError);
+    }
+    // fit into maxDimension, then shrink until the file is small enough, the size of the file
+    // roughly follows the area of the image
+    double factor = std::min(1.0, double(m_limits.maxDimension)
+                                     / std::max(pixels.width, pixels.height));
+    std::string png;
+    uint32_t width = 0;
+    uint32_t height = 0;
+    while (true) {
+        width = std::max(1u, static_cast<uint32_t>(std::lround(pixels.width * factor)));
+        height = std::max(1u, static_cast<uint32_t>(std::lround(pixels.height * factor)));
+        if (!PngImage::encode(PngImage::scale(pixels, width, height), png)) {
+            return fail(L"Failed to encode the image");
+        }
+        if (png.size() <= m_limits.maxFileSize || std::max(width, height) <= MinDimension) {
+            break;
+        }
+        factor *= std::min(0.9, std::sqrt(double(m_limits.maxFileSize) / png.size()));
+    }
+    if (png.size() > m_limits.maxFileSize) {
+        return fail(L"The image can't be compressed enough");
+    }
+
+    std::filesystem::create_directories(m_directory, error);
+    const auto partial = partialName(target);
+    {
+        std::ofstream out(partial, std::ios::binary | std::ios::trunc);
+        out.write(png.data(), static_cast<std::streamsize>(png.size()));
+        if (!out) {
+            std::filesystem::remove(partial, error);
+            return fail(L"Failed to write " + target.wstring());
+        }
+    }
+    // another process might have stored the same image meanwhile, both copies are equal
+    std::filesystem::rename(partial, target, error);
+    if (error) {
+        std::filesystem::remove(partial, error);
+        if (!std::filesystem::exists(target, error)) {
+            return fail(L"Failed to write " + target.wstring());
+        }
+    }
+    tInfo << L"Downscaled" << image << pixels.width << L"x" << pixels.height << L"to" << width
+          << L"x" << height << L"as" << target;
+    std::lock_guard<std::mutex> lock(m_mutex);
+    ++m_statistics.stored;
+    return target;
+}
+
+ImageCache::Statistics ImageCache::statistics() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_statistics;
+}
+
+uint64_t ImageCache::contentHash(std::string_view data)
+{
+    // FNV-1a over 8 byte words with a fold of the high bits, finished with the murmur3 mixer
+    constexpr uint64_t Prime = 0x100000001b3ull;
+    uint64_t hash = 0xcbf29ce484222325ull ^ data.size();
+    size_t i = 0;
+    for (; i + sizeof(uint64_t) <= data.size(); i += sizeof(uint64_t)) {
+        uint64_t word;
+        std::memcpy(&word, data.data() + i, sizeof(word));
+        hash = (hash ^ word) * Prime;
+        hash ^= hash >> 32;
+    }
+    for (; i < data.size(); ++i) {
+        hash = (hash ^ static_cast<unsigned char>(data[i])) * Prime;
+    }
+    hash ^= hash >> 33;
+    hash *= 0xff51afd7ed558ccdull;
+    hash ^= hash >> 33;
+    hash *= 0xc4ceb9fe1a85ec53ull;
+    hash ^= hash >> 33;
+    return hash;
+}
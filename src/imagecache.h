@@ -0,0 +1,90 @@
+/*
+    SnoreToast is capable to invoke Windows 8 toast notifications.
+    Copyright (C) 2026  Hannah von Reth <vonreth@kde.org>
+
+    SnoreToast is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    SnoreToast is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with SnoreToast.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <mutex>
+#include <string_view>
+#include <unordered_map>
+
+/**
+ * Keeps the images of the toasts within the limits of the notification system.
+ *
+ * Only the PNG header of an image is read to check its dimensions. Images exceeding the
+ * limits are downscaled once and stored in the directory of the cache, named after the hash of
+ * their content, later toasts with the same image reuse the stored copy. The result for a path
+ * is remembered as long as the size and modification time of the file don't change.
+ */
+class ImageCache
+{
+public:
+    // documented in data/help.txt
+    struct Limits
+    {
+        uint32_t maxDimension = 1024;
+        uintmax_t maxFileSize = 200 * 1024;
+    };
+
+    struct Statistics
+    {
+        uint64_t accepted = 0; // images used as they are
+        uint64_t hits = 0; // downscaled copies reused
+        uint64_t stored = 0; // downscaled copies created
+        uint64_t failed = 0; // images that exceed the limits but couldn't be downscaled
+    };
+
+    explicit ImageCache(std::filesystem::path directory);
+    ImageCache(std::filesystem::path directory, Limits limits);
+
+    ImageCache(const ImageCache &) = delete;
+    ImageCache &operator=(const ImageCache &) = delete;
+
+    /**
+     * Returns the image to display instead of image, image itself if it is within the limits
+     * or can't be downscaled.
+     */
+    std::filesystem::path normalize(const std::filesystem::path &image);
+
+    const std::filesystem::path &directory() const { return m_directory; }
+    Statistics statistics() const;
+
+    static uint64_t contentHash(std::string_view data);
+
+private:
+    struct Entry
+    {
+        uintmax_t size = 0;
+        std::filesystem::file_time_type modified;
+        std::filesystem::path result;
+        // counted again when result is the image itself
+        uint64_t Statistics::*outcome = nullptr;
+    };
+
+    /**
+     * Returns the stored copy, or image if it can't be downscaled, counts the outcome.
+     */
+    std::filesystem::path downscale(const std::filesystem::path &image, std::string_view data);
+
+    const std::filesystem::path m_directory;
+    const Limits m_limits;
+
+    mutable std::mutex m_mutex;
+    std::unordered_map<std::filesystem::path::string_type, Entry> m_entries;
+    Statistics m_statistics;
+};
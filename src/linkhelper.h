@@ -17,7 +17,7 @@
 */
 #pragma once
 
-#include "snoretoasts.h"
+#include "winrtnotificationbackend.h"
 
 class LIBSNORETOAST_EXPORT LinkHelper
 {
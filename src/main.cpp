@@ -16,14 +16,24 @@
     along with SnoreToast.  If not, see <http://www.gnu.org/licenses/>.
     */
 #include "snoretoasts.h"
+#include "callbackwriter.h"
 #include "config.h"
 
 #include "toasteventhandler.h"
 
 #include "snoretoastactioncenterintegration.h"
+#include "stringutils.h"
 
+#include "completiondispatcher.h"
 #include "linkhelper.h"
+#include "toastbatch.h"
+#include "toastcoalescer.h"
+#include "toastrequest.h"
+#include "toastscheduler.h"
+#include "toastserver.h"
+#include "toasttrace.h"
 #include "utils.h"
+#include "winrtnotificationbackend.h"
 
 #include <cmrc/cmrc.hpp>
 
@@ -32,11 +42,18 @@
 #include <roapi.h>
 
 #include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <ctime>
 #include <functional>
 #include <fstream>
+#include <iomanip>
 #include <iostream>
+#include <memory>
+#include <mutex>
 #include <sstream>
 #include <string>
+#include <thread>
 #include <vector>
 
 CMRC_DECLARE(SnoreToastResource);
@@ -87,6 +104,9 @@ void help(const std::wstring &error)
                    << L"A command line application capable of creating Windows Toast notifications."
                    << std::endl;
     }
+    std::wcerr << L"---- Usage ----\nSnoreToast [Options]\n\n---- Options ----\n"
+               << ToastRequest::helpText();
+    // the exit codes and notes
     const auto filesystem = cmrc::SnoreToastResource::get_filesystem();
     const auto help = filesystem.open("help.txt");
     std::wcerr << help.begin() << std::endl;
@@ -104,209 +124,359 @@ void version()
                << L"(at your option) any later version." << std::endl;
 }
 
+/**
+ * The logo is only extracted if there is no complete copy from a previous run.
+ */
 std::filesystem::path getIcon()
 {
-    auto image = std::filesystem::temp_directory_path() / "snoretoast" / SnoreToasts::version()
-            / "logo.png";
-    if (!std::filesystem::exists(image)) {
-        std::filesystem::create_directories(image.parent_path());
-        const auto filesystem = cmrc::SnoreToastResource::get_filesystem();
-        const auto img = filesystem.open("256-256-snoretoast.png");
-        std::ofstream out(image, std::ios::binary);
+    ST_TRACE("getIcon");
+    static const auto image = std::filesystem::temp_directory_path() / "snoretoast"
+            / SnoreToasts::version() / "logo.png";
+    const auto filesystem = cmrc::SnoreToastResource::get_filesystem();
+    const auto img = filesystem.open("256-256-snoretoast.png");
+    std::error_code error;
+    if (std::filesystem::file_size(image, error) != img.size()) {
+        std::filesystem::create_directories(image.parent_path(), error);
+        std::ofstream out(image, std::ios::binary | std::ios::trunc);
         out.write(const_cast<char *>(img.begin()), img.size());
         out.close();
     }
     return image;
 }
 
-SnoreToastActions::Actions parse(std::vector<wchar_t *> args)
+/**
+ * Creates the shortcut of the default appID, once it succeeded the check is skipped.
+ */
+bool ensureDefaultShortcut(const std::wstring &appID)
 {
-    HRESULT hr = S_OK;
-
-    std::wstring appID;
-    std::wstring pid;
-    std::filesystem::path pipe;
-    std::filesystem::path application;
-    std::wstring title;
-    std::wstring body;
-    std::filesystem::path image;
-    std::wstring id;
-    std::wstring sound(L"Notification.Default");
-    std::wstring buttons;
-    Duration duration = Duration::Short;
-    bool silent = false;
-    bool closeNotify = false;
-    bool isTextBoxEnabled = false;
-
-    auto nextArg = [&](std::vector<wchar_t *>::const_iterator &it,
-                       const std::wstring &helpText) -> std::wstring {
-        if (it != args.cend()) {
-            return *it++;
-        } else {
-            help(helpText);
-            exit(static_cast<int>(SnoreToastActions::Actions::Error));
-        }
-    };
+    static std::atomic<bool> created = false;
+    if (!created) {
+        created = SUCCEEDED(LinkHelper::tryCreateShortcut(
+                std::filesystem::path(L"SnoreToast") / SnoreToasts::version() / L"SnoreToast",
+                appID, SnoreToastActionCenterIntegration::uuid()));
+    }
+    return created;
+}
+
+/**
+ * Shared by all toasts of the process, keeps the callback pipes open.
+ * The pending callbacks are written when the process exits. A callback that can't be written
+ * to the open pipe is written like before, waiting for the pipe and starting -application.
+ */
+CallbackWriter &callbackWriter()
+{
+    static CallbackWriter writer(
+            CallbackWriter::DefaultWindow, LocalSocket::connect,
+            [](const std::filesystem::path &pipe, const std::filesystem::path &application,
+               std::string message) {
+                auto &backend = WinRTNotificationBackend::instance();
+                if (!backend.writePipe(pipe, message) && !application.empty()
+                    && backend.startProcess(application)) {
+                    backend.writePipe(pipe, message, true);
+                }
+            });
+    return writer;
+}
 
-    auto it = args.begin() + 1;
-    while (it != args.end()) {
-        std::wstring arg(nextArg(it, L""));
-        std::transform(arg.begin(), arg.end(), arg.begin(),
-                       [](int i) -> int { return ::tolower(i); });
-        if (arg == L"-m") {
-            body = nextArg(it,
-                           L"Missing argument to -m.\n"
-                           L"Supply argument as -m \"message string\"");
-        } else if (arg == L"-t") {
-            title = nextArg(it,
-                            L"Missing argument to -t.\n"
-                            L"Supply argument as -t \"bold title string\"");
-        } else if (arg == L"-p") {
-            image = nextArg(it, L"Missing argument to -p. Supply argument as -p \"image path\"");
-        } else if (arg == L"-s") {
-            sound = nextArg(it,
-                            L"Missing argument to -s.\n"
-                            L"Supply argument as -s \"sound name\"");
-        } else if (arg == L"-d") {
-            std::wstring _d = nextArg(it,
-                                      L"Missing argument to -d.\n"
-                                      L"Supply argument as -d (short |long)");
-            if (_d == L"short") {
-                duration = Duration::Short;
-            } else if (_d == L"long") {
-                duration = Duration::Long;
-            } else {
-                help(_d + L" is not a valid");
-                return SnoreToastActions::Actions::Error;
+/**
+ * -close, -closePrefix and -closeGroup, fails if no notification was closed.
+ */
+bool closeNotifications(SnoreToasts &app, const ToastRequest &request)
+{
+    size_t closed = 0;
+    if (!request.id.empty()) {
+        std::vector<std::wstring> ids;
+        const std::wstring_view list = request.id;
+        for (size_t start = 0; start < list.size();) {
+            size_t end = list.find(L';', start);
+            if (end == std::wstring_view::npos) {
+                end = list.size();
             }
-        } else if (arg == L"-id") {
-            id = nextArg(it,
-                         L"Missing argument to -id.\n"
-                         L"Supply argument as -id \"id\"");
-        } else if (arg == L"-silent") {
-            silent = true;
-        } else if (arg == L"-appid") {
-            appID = nextArg(it,
-                            L"Missing argument to -appID.\n"
-                            L"Supply argument as -appID \"Your.APP.ID\"");
-        } else if (arg == L"-pid") {
-            pid = nextArg(it,
-                          L"Missing argument to -pid.\n"
-                          L"Supply argument as -pid \"pid\"");
-        } else if (arg == L"-pipename") {
-            pipe = nextArg(it,
-                           L"Missing argument to -pipeName.\n"
-                           L"Supply argument as -pipeName \"\\.\\pipe\\foo\\\"");
-        } else if (arg == L"-application") {
-            application = nextArg(it,
-                                  L"Missing argument to -application.\n"
-                                  L"Supply argument as -application \"C:\\foo.exe\"");
-        } else if (arg == L"-b") {
-            buttons = nextArg(it,
-                              L"Missing argument to -b.\n"
-                              L"Supply argument for buttons as -b \"button1;button2\"");
-        } else if (arg == L"-tb") {
-            isTextBoxEnabled = true;
-        } else if (arg == L"-install") {
-            const std::wstring shortcut(
-                    nextArg(it,
-                            L"Missing argument to -install.\n"
-                            L"Supply argument as -install \"path to your shortcut\" \"path to the "
-                            L"application the shortcut should point to\" \"App.ID\""));
-
-            const std::wstring exe(
-                    nextArg(it,
-                            L"Missing argument to -install.\n"
-                            L"Supply argument as -install \"path to your shortcut\" \"path to the "
-                            L"application the shortcut should point to\" \"App.ID\""));
-
-            appID = nextArg(it,
-                            L"Missing argument to -install.\n"
-                            L"Supply argument as -install \"path to your shortcut\" \"path to the "
-                            L"application the shortcut should point to\" \"App.ID\"");
-
-            return SUCCEEDED(LinkHelper::tryCreateShortcut(
-                           shortcut, exe, appID, SnoreToastActionCenterIntegration::uuid()))
-                    ? SnoreToastActions::Actions::Clicked
-                    : SnoreToastActions::Actions::Error;
-        } else if (arg == L"-close") {
-            id = nextArg(it,
-                         L"Missing agument to -close"
-                         L"Supply argument as -close \"id\"");
-            closeNotify = true;
-        } else if (arg == L"-v") {
-            version();
-            return SnoreToastActions::Actions::Clicked;
-        } else if (arg == L"-h") {
-            help(L"");
-            return SnoreToastActions::Actions::Clicked;
+            if (end > start) {
+                ids.emplace_back(list.substr(start, end - start));
+            }
+            start = end + 1;
+        }
+        closed += app.closeNotifications(ids);
+    }
+    if (!request.closePrefix.empty()) {
+        closed += app.closeNotificationsWithPrefix(request.closePrefix);
+    }
+    if (!request.closeGroup.empty()) {
+        closed += app.closeGroup(request.closeGroup);
+    }
+    return closed > 0;
+}
+
+/**
+ * -list, "<id> <group> <created>" per line, the creation time is only known for the toasts of
+ * this process.
+ */
+void listNotifications(SnoreToasts &app, std::wostream &out)
+{
+    for (const auto &entry : app.notifications()) {
+        out << entry.id << L"\t" << entry.group << L"\t";
+        if (entry.created == std::chrono::system_clock::time_point()) {
+            out << L"-";
         } else {
-            std::wstringstream ws;
-            ws << L"Unknown argument: " << arg << std::endl;
-            help(ws.str());
-            return SnoreToastActions::Actions::Error;
+            const std::time_t created = std::chrono::system_clock::to_time_t(entry.created);
+            std::tm utc;
+            gmtime_s(&utc, &created);
+            out << std::put_time(&utc, L"%Y-%m-%dT%H:%M:%SZ");
         }
+        out << std::endl;
     }
+}
 
-    appID = getAppId(pid, appID);
+/**
+ * The appID of request, empty if the shortcut of the default appID could not be created.
+ */
+std::wstring toastAppID(const ToastRequest &request)
+{
+    std::wstring appID = getAppId(request.pid, request.appID);
     if (appID.empty()) {
         std::wstringstream _appID;
         _appID << L"Snore.DesktopToasts." << SnoreToasts::version();
         appID = _appID.str();
-        hr = LinkHelper::tryCreateShortcut(std::filesystem::path(L"SnoreToast")
-                                                   / SnoreToasts::version() / L"SnoreToast",
-                                           appID, SnoreToastActionCenterIntegration::uuid());
-        if (!SUCCEEDED(hr)) {
+        // closing or listing toasts doesn't need the shortcut
+        if (request.mode == ToastRequest::Mode::Toast && !ensureDefaultShortcut(appID)) {
+            return {};
+        }
+    }
+    return appID;
+}
+
+/**
+ * Displays the toast of request, the result is collected with userAction() or by a
+ * CompletionDispatcher.
+ */
+std::unique_ptr<SnoreToasts> displayToast(const ToastRequest &request)
+{
+    const std::wstring appID = toastAppID(request);
+    if (appID.empty()) {
+        return nullptr;
+    }
+    auto app = std::make_unique<SnoreToasts>(&WinRTNotificationBackend::instance(), appID);
+    app->setPipeName(request.pipe);
+    app->setApplication(request.application);
+    app->setSilent(request.silent);
+    app->setSound(request.sound);
+    app->setId(request.id);
+    app->setGroup(request.group);
+    app->setButtons(request.buttons);
+    app->setTextBoxEnabled(request.isTextBoxEnabled);
+    app->setDuration(request.duration);
+    app->setProtocolVersion(request.protocol);
+    if (request.pipeKeepAlive) {
+        app->setCallbackWriter(&callbackWriter());
+    }
+    app->displayToast(request.title, request.body,
+                      request.image.empty() ? getIcon() : request.image);
+    return app;
+}
+
+/**
+ * Handles a Toast, Close or List request, -list prints to output.
+ */
+SnoreToastActions::Actions showToast(const ToastRequest &request,
+                                     std::wostream &output = std::wcout)
+{
+    if (request.mode == ToastRequest::Mode::Toast) {
+        const auto app = displayToast(request);
+        return app ? app->userAction() : SnoreToastActions::Actions::Error;
+    }
+    const std::wstring appID = toastAppID(request);
+    if (request.mode == ToastRequest::Mode::Close) {
+        SnoreToasts app(&WinRTNotificationBackend::instance(), appID);
+        app.setGroup(request.group);
+        if (closeNotifications(app, request)) {
+            return SnoreToastActions::Actions::Clicked;
+        }
+        return SnoreToastActions::Actions::Error;
+    }
+    if (request.mode == ToastRequest::Mode::List) {
+        SnoreToasts app(&WinRTNotificationBackend::instance(), appID);
+        listNotifications(app, output);
+        return SnoreToastActions::Actions::Clicked;
+    }
+    return SnoreToastActions::Actions::Error;
+}
+
+/**
+ * The -coalesce filter of -server and -batch, nullptr if it is not enabled.
+ */
+std::unique_ptr<ToastCoalescer> createCoalescer(const ToastRequest &request)
+{
+    if (request.coalesceWindow.count() == 0) {
+        return nullptr;
+    }
+    ToastCoalescer::Policy policy;
+    policy.window = request.coalesceWindow;
+    policy.limit = request.coalesceLimit;
+    return std::make_unique<ToastCoalescer>(policy);
+}
+
+SnoreToastActions::Actions runServer(const std::filesystem::path &name,
+                                     ToastCoalescer *coalescer)
+{
+    auto listener = LocalSocket::listen(name);
+    if (!listener) {
+        std::wcerr << L"Failed to listen on: " << name << std::endl;
+        return SnoreToastActions::Actions::Error;
+    }
+    std::wcout << L"Listening on: " << name << std::endl;
+    ToastServer server([coalescer](const ToastRequest &request, std::string &output) {
+        ToastRequest copy = request;
+        // close and list requests name their toasts, they are never coalesced
+        if (coalescer && copy.mode == ToastRequest::Mode::Toast
+            && coalescer->submit(copy) == ToastCoalescer::Decision::Drop) {
+            return SnoreToastActions::Actions::Hidden;
+        }
+        // the output of -list is sent with the response
+        std::wostringstream list;
+        const auto action = showToast(copy, list);
+        output = Utils::toUtf8(list.str());
+        return action;
+    });
+    server.serve(*listener);
+    return SnoreToastActions::Actions::Clicked;
+}
+
+SnoreToastActions::Actions runBatch(const std::filesystem::path &file,
+                                    ToastCoalescer *coalescer, size_t maxVisible)
+{
+    std::ifstream in;
+    if (file != L"-") {
+        in.open(file, std::ios::binary);
+        if (!in.is_open()) {
+            std::wcerr << L"Failed to open: " << file << std::endl;
             return SnoreToastActions::Actions::Error;
         }
     }
-    if (closeNotify) {
-        if (!id.empty()) {
-            SnoreToasts app(appID);
-            app.setId(id);
-            if (app.closeNotification()) {
-                return SnoreToastActions::Actions::Clicked;
-            }
-        } else {
-            help(L"Close only works if an -id id was provided.");
+    ToastBatchReader reader(file == L"-" ? std::cin : in);
+
+    std::mutex outputLock;
+    std::atomic<bool> failed = false;
+    const auto report = [&outputLock, &failed](size_t line, SnoreToastActions::Actions action) {
+        if (action == SnoreToastActions::Actions::Error) {
+            failed = true;
         }
-    } else {
-        hr = (title.length() > 0 && body.length() > 0) ? S_OK : E_FAIL;
-        if (SUCCEEDED(hr)) {
-            if (isTextBoxEnabled) {
-                if (pipe.empty()) {
-                    std::wcerr << L"TextBox notifications only work if a pipe for the result "
-                                  L"was provided"
-                               << std::endl;
-                    return SnoreToastActions::Actions::Error;
+        std::scoped_lock lock(outputLock);
+        std::wcout << line << L"\t" << static_cast<int>(action) << L"\t"
+                   << (action == SnoreToastActions::Actions::Error
+                               ? L"error"
+                               : SnoreToastActions::getActionString(action))
+                   << std::endl;
+    };
+
+    // without -maxVisible all toasts are displayed at once, their results are reported as they
+    // arrive
+    const CompletionDispatcher::Policy policy;
+    CompletionDispatcher completions(
+            [&report](uint64_t line, SnoreToastActions::Actions action) { report(line, action); },
+            policy);
+    completions.start();
+
+    std::vector<std::thread> toasts;
+    // with -maxVisible the toasts wait for one of the workers, ordered by priority
+    std::unique_ptr<ToastScheduler> scheduler;
+    if (maxVisible > 0) {
+        scheduler = std::make_unique<ToastScheduler>(ToastScheduler::Policy());
+        scheduler->setDiscardHandler([&report](const ToastScheduler::Item &item,
+                                               ToastScheduler::Discard reason) {
+            report(item.tag,
+                   reason == ToastScheduler::Discard::Expired
+                           ? SnoreToastActions::Actions::Timedout
+                           : SnoreToastActions::Actions::Hidden);
+        });
+        for (size_t i = 0; i < maxVisible; ++i) {
+            toasts.emplace_back([&report, &scheduler] {
+                while (const auto item = scheduler->waitPop()) {
+                    report(item->tag, showToast(item->request));
                 }
-            }
-            if (image.empty()) {
-                image = getIcon();
-            }
-            SnoreToasts app(appID);
-            app.setPipeName(pipe);
-            app.setApplication(application);
-            app.setSilent(silent);
-            app.setSound(sound);
-            app.setId(id);
-            app.setButtons(buttons);
-            app.setTextBoxEnabled(isTextBoxEnabled);
-            app.setDuration(duration);
-            app.displayToast(title, body, image);
-            return app.userAction();
+            });
+        }
+    }
+
+    ToastBatchRecord record;
+    while (reader.next(record)) {
+        if (record.request.mode == ToastRequest::Mode::Error) {
+            failed = true;
+            std::scoped_lock lock(outputLock);
+            std::wcout << record.line << L"\t"
+                       << static_cast<int>(SnoreToastActions::Actions::Error) << L"\t"
+                       << record.request.error << std::endl;
+            continue;
+        }
+        if (coalescer && record.request.mode == ToastRequest::Mode::Toast
+            && coalescer->submit(record.request) == ToastCoalescer::Decision::Drop) {
+            report(record.line, SnoreToastActions::Actions::Hidden);
+            continue;
+        }
+        if (scheduler) {
+            scheduler->push(std::move(record.request), record.line);
+            continue;
+        }
+        if (record.request.mode != ToastRequest::Mode::Toast) {
+            report(record.line, showToast(record.request));
+            continue;
+        }
+        if (auto app = displayToast(record.request)) {
+            completions.add(std::move(app), record.line);
         } else {
-            help(L"");
-            return SnoreToastActions::Actions::Clicked;
+            report(record.line, SnoreToastActions::Actions::Error);
         }
     }
+    if (scheduler) {
+        scheduler->close();
+    }
+    for (auto &t : toasts) {
+        t.join();
+    }
+    // every toast times out one timeout after it was added
+    completions.waitUntilEmpty(2 * policy.timeout);
+    return failed ? SnoreToastActions::Actions::Error : SnoreToastActions::Actions::Clicked;
+}
 
+SnoreToastActions::Actions parse(const std::vector<std::wstring> &args)
+{
+    const ToastRequest request = ToastRequest::fromArguments(
+            args, ToastRequest::ResponseFiles | ToastRequest::StandardInput);
+    if (!request.traceFile.empty()) {
+        // written at exit
+        ToastTrace::start(request.traceFile);
+    }
+    switch (request.mode) {
+    case ToastRequest::Mode::Install:
+        return SUCCEEDED(LinkHelper::tryCreateShortcut(request.shortcut, request.exe,
+                                                       request.appID,
+                                                       SnoreToastActionCenterIntegration::uuid()))
+                ? SnoreToastActions::Actions::Clicked
+                : SnoreToastActions::Actions::Error;
+    case ToastRequest::Mode::Version:
+        version();
+        return SnoreToastActions::Actions::Clicked;
+    case ToastRequest::Mode::Help:
+        help(request.error);
+        return SnoreToastActions::Actions::Clicked;
+    case ToastRequest::Mode::Error:
+        help(request.error);
+        return SnoreToastActions::Actions::Error;
+    case ToastRequest::Mode::Server:
+        return runServer(request.serverName, createCoalescer(request).get());
+    case ToastRequest::Mode::Batch:
+        return runBatch(request.batchFile, createCoalescer(request).get(), request.maxVisible);
+    case ToastRequest::Mode::Toast:
+    case ToastRequest::Mode::Close:
+    case ToastRequest::Mode::List:
+        return showToast(request);
+    }
     return SnoreToastActions::Actions::Error;
 }
 
 SnoreToastActions::Actions handleEmbedded()
 {
-    SnoreToasts::waitForCallbackActivation();
+    SnoreToasts::waitForCallbackActivation(&WinRTNotificationBackend::instance());
     return SnoreToastActions::Actions::Clicked;
 }
 
@@ -338,8 +508,10 @@ int WINAPI wWinMain(HINSTANCE, HINSTANCE, wchar_t *, int)
         if (std::wstring(commandLine).find(L"-Embedding") != std::wstring::npos) {
             action = handleEmbedded();
         } else {
-            action = parse(std::vector<wchar_t *>(argv, argv + argc));
+            action = parse(std::vector<std::wstring>(argv + 1, argv + argc));
         }
+        // the backend is a static, its com pointers must be gone before Uninitialize
+        WinRTNotificationBackend::instance().shutdown();
         Windows::Foundation::Uninitialize();
     }
 
@@ -0,0 +1,63 @@
+/*
+    SnoreToast is capable to invoke Windows 8 toast notifications.
+    Copyright (C) 2026  Hannah von Reth <vonreth@kde.org>
+
+    SnoreToast is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    SnoreToast is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with SnoreToast.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#pragma once
+
+#include <cstddef>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <string_view>
+
+/**
+ * The read only content of a file, regular files are memory mapped, pipes and terminals
+ * are read into a buffer.
+ */
+class MappedFile
+{
+public:
+    ~MappedFile();
+
+    MappedFile(const MappedFile &) = delete;
+    MappedFile &operator=(const MappedFile &) = delete;
+
+    /**
+     * Returns nullptr if the file can't be read.
+     */
+    static std::unique_ptr<MappedFile> open(const std::filesystem::path &path);
+
+    /**
+     * Reads stdin until the end, a redirected file is mapped.
+     */
+    static std::unique_ptr<MappedFile> standardInput();
+
+    std::string_view data() const { return m_view ? std::string_view(m_view, m_size) : m_buffer; }
+
+private:
+    MappedFile() = default;
+
+#ifdef _WIN32
+    bool load(void *handle);
+#else
+    bool load(int fd);
+#endif
+
+    // m_view is a mapping of m_size bytes, or nullptr if the content is in m_buffer
+    const char *m_view = nullptr;
+    size_t m_size = 0;
+    std::string m_buffer;
+};
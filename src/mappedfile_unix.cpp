@@ -0,0 +1,82 @@
+/*
+    SnoreToast is capable to invoke Windows 8 toast notifications.
+    Copyright (C) 2026  Hannah von Reth <vonreth@kde.org>
+
+    SnoreToast is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    SnoreToast is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with SnoreToast.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "mappedfile.h"
+
+#include <cerrno>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+MappedFile::~MappedFile()
+{
+    if (m_view) {
+        munmap(const_cast<char *>(m_view), m_size);
+    }
+}
+
+std::unique_ptr<MappedFile> MappedFile::open(const std::filesystem::path &path)
+{
+    const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return nullptr;
+    }
+    std::unique_ptr<MappedFile> out(new MappedFile);
+    const bool loaded = out->load(fd);
+    close(fd);
+    return loaded ? std::move(out) : nullptr;
+}
+
+std::unique_ptr<MappedFile> MappedFile::standardInput()
+{
+    std::unique_ptr<MappedFile> out(new MappedFile);
+    return out->load(STDIN_FILENO) ? std::move(out) : nullptr;
+}
+
+bool MappedFile::load(int fd)
+{
+    struct stat info;
+    if (fstat(fd, &info) != 0) {
+        return false;
+    }
+    // a mapping of an empty file fails, it is read like a pipe
+    if (S_ISREG(info.st_mode) && info.st_size > 0) {
+        const size_t size = static_cast<size_t>(info.st_size);
+        void *view = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (view != MAP_FAILED) {
+            m_view = static_cast<const char *>(view);
+            m_size = size;
+            return true;
+        }
+    }
+    char chunk[64 * 1024];
+    while (true) {
+        const ssize_t size = read(fd, chunk, sizeof(chunk));
+        if (size < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+        if (size == 0) {
+            return true;
+        }
+        m_buffer.append(chunk, static_cast<size_t>(size));
+    }
+}
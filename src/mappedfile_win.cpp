@@ -0,0 +1,82 @@
+/*
+    SnoreToast is capable to invoke Windows 8 toast notifications.
+    Copyright (C) 2026  Hannah von Reth <vonreth@kde.org>
+
+    SnoreToast is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    SnoreToast is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with SnoreToast.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "mappedfile.h"
+
+#include <windows.h>
+
+MappedFile::~MappedFile()
+{
+    if (m_view) {
+        UnmapViewOfFile(m_view);
+    }
+}
+
+std::unique_ptr<MappedFile> MappedFile::open(const std::filesystem::path &path)
+{
+    HANDLE file = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                              OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        return nullptr;
+    }
+    std::unique_ptr<MappedFile> out(new MappedFile);
+    const bool loaded = out->load(file);
+    CloseHandle(file);
+    return loaded ? std::move(out) : nullptr;
+}
+
+std::unique_ptr<MappedFile> MappedFile::standardInput()
+{
+    HANDLE input = GetStdHandle(STD_INPUT_HANDLE);
+    if (input == INVALID_HANDLE_VALUE || !input) {
+        return nullptr;
+    }
+    std::unique_ptr<MappedFile> out(new MappedFile);
+    return out->load(input) ? std::move(out) : nullptr;
+}
+
+bool MappedFile::load(void *handle)
+{
+    LARGE_INTEGER size;
+    // a mapping of an empty file fails, it is read like a pipe
+    if (GetFileType(handle) == FILE_TYPE_DISK && GetFileSizeEx(handle, &size)
+        && size.QuadPart > 0) {
+        // the view keeps the mapping alive
+        HANDLE mapping = CreateFileMappingW(handle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (mapping) {
+            const void *view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+            CloseHandle(mapping);
+            if (view) {
+                m_view = static_cast<const char *>(view);
+                m_size = static_cast<size_t>(size.QuadPart);
+                return true;
+            }
+        }
+    }
+    char chunk[64 * 1024];
+    while (true) {
+        DWORD read = 0;
+        if (!ReadFile(handle, chunk, sizeof(chunk), &read, nullptr)) {
+            // the writing end of a pipe was closed
+            return GetLastError() == ERROR_BROKEN_PIPE;
+        }
+        if (read == 0) {
+            return true;
+        }
+        m_buffer.append(chunk, read);
+    }
+}
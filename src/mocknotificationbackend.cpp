@@ -0,0 +1,370 @@
+/*
+    SnoreToast is capable to invoke Windows 8 toast notifications.
+    Copyright (C) 2026  Hannah von Reth <vonreth@kde.org>
+
+    SnoreToast is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    SnoreToast is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with SnoreToast.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "mocknotificationbackend.h"
+
+MockNotificationBackend::MockNotificationBackend() = default;
+
+MockNotificationBackend::~MockNotificationBackend() = default;
+
+void MockNotificationBackend::setRegistered(bool registered)
+{
+    std::scoped_lock lock(m_mutex);
+    m_registered = registered;
+}
+
+void MockNotificationBackend::setSetting(NotificationSetting setting)
+{
+    std::scoped_lock lock(m_mutex);
+    m_setting = setting;
+}
+
+void MockNotificationBackend::setPipeAvailable(bool available)
+{
+    std::scoped_lock lock(m_mutex);
+    m_pipeAvailable = available;
+}
+
+void MockNotificationBackend::setShowAvailable(bool available)
+{
+    std::scoped_lock lock(m_mutex);
+    m_showAvailable = available;
+}
+
+NotificationListener *MockNotificationBackend::listener(const std::wstring &id) const
+{
+    const auto it = m_toasts.find(id);
+    return it == m_toasts.cend() ? nullptr : it->second.listener;
+}
+
+void MockNotificationBackend::enter(NotificationListener *l)
+{
+    m_running.emplace(l, std::this_thread::get_id());
+}
+
+void MockNotificationBackend::leave(NotificationListener *l)
+{
+    {
+        std::scoped_lock lock(m_mutex);
+        const auto range = m_running.equal_range(l);
+        for (auto it = range.first; it != range.second; ++it) {
+            if (it->second == std::this_thread::get_id()) {
+                m_running.erase(it);
+                break;
+            }
+        }
+    }
+    m_released.notify_all();
+}
+
+std::shared_ptr<const MockNotificationBackend::Notifier>
+MockNotificationBackend::notifier(const std::wstring &appID)
+{
+    std::shared_ptr<const Notifier> out;
+    m_notifiers.get(appID, out, [&appID](std::shared_ptr<const Notifier> &notifier) {
+        notifier = std::make_shared<const Notifier>(Notifier { appID });
+        return true;
+    });
+    return out;
+}
+
+bool MockNotificationBackend::activate(const std::wstring &id)
+{
+    std::wstring arguments;
+    NotificationListener *l;
+    {
+        std::scoped_lock lock(m_mutex);
+        l = listener(id);
+        if (!l) {
+            return false;
+        }
+        arguments = m_toasts.at(id).content.launchArguments;
+        enter(l);
+    }
+    l->activated(arguments);
+    leave(l);
+    return true;
+}
+
+bool MockNotificationBackend::activateButton(const std::wstring &id, size_t button)
+{
+    std::wstring arguments;
+    NotificationListener *l;
+    {
+        std::scoped_lock lock(m_mutex);
+        l = listener(id);
+        if (!l || button >= m_toasts.at(id).content.buttons.size()) {
+            return false;
+        }
+        arguments = m_toasts.at(id).content.buttons[button].arguments;
+        enter(l);
+    }
+    l->activated(arguments);
+    leave(l);
+    return true;
+}
+
+bool MockNotificationBackend::activateTextBox(const std::wstring &id)
+{
+    std::wstring arguments;
+    NotificationListener *l;
+    {
+        std::scoped_lock lock(m_mutex);
+        l = listener(id);
+        if (!l || !m_toasts.at(id).content.textBox) {
+            return false;
+        }
+        arguments = m_toasts.at(id).content.textBoxArguments;
+        enter(l);
+    }
+    l->activated(arguments);
+    leave(l);
+    return true;
+}
+
+bool MockNotificationBackend::dismiss(const std::wstring &id, DismissalReason reason)
+{
+    NotificationListener *l;
+    {
+        std::scoped_lock lock(m_mutex);
+        l = listener(id);
+        if (!l) {
+            return false;
+        }
+        enter(l);
+    }
+    l->dismissed(reason);
+    leave(l);
+    return true;
+}
+
+bool MockNotificationBackend::fail(const std::wstring &id)
+{
+    NotificationListener *l;
+    {
+        std::scoped_lock lock(m_mutex);
+        l = listener(id);
+        if (!l) {
+            return false;
+        }
+        enter(l);
+    }
+    l->failed();
+    leave(l);
+    return true;
+}
+
+std::optional<MockNotificationBackend::Toast>
+MockNotificationBackend::toast(const std::wstring &id) const
+{
+    std::scoped_lock lock(m_mutex);
+    const auto it = m_toasts.find(id);
+    if (it == m_toasts.cend()) {
+        return {};
+    }
+    return it->second;
+}
+
+size_t MockNotificationBackend::toastCount() const
+{
+    std::scoped_lock lock(m_mutex);
+    return m_toasts.size();
+}
+
+size_t MockNotificationBackend::showCount() const
+{
+    std::scoped_lock lock(m_mutex);
+    return m_showCount;
+}
+
+size_t MockNotificationBackend::activatorRegistrations() const
+{
+    std::scoped_lock lock(m_mutex);
+    return m_activatorRegistrations;
+}
+
+std::vector<MockNotificationBackend::PipeMessage> MockNotificationBackend::pipeMessages() const
+{
+    std::scoped_lock lock(m_mutex);
+    return m_pipeMessages;
+}
+
+std::vector<std::filesystem::path> MockNotificationBackend::startedProcesses() const
+{
+    std::scoped_lock lock(m_mutex);
+    return m_startedProcesses;
+}
+
+MockNotificationBackend::Notifiers::Statistics MockNotificationBackend::notifierStatistics() const
+{
+    return m_notifiers.statistics();
+}
+
+bool MockNotificationBackend::isRegistered(const std::wstring &)
+{
+    std::scoped_lock lock(m_mutex);
+    return m_registered;
+}
+
+NotificationSetting MockNotificationBackend::setting(const std::wstring &appID)
+{
+    notifier(appID);
+    std::scoped_lock lock(m_mutex);
+    return m_setting;
+}
+
+bool MockNotificationBackend::registerActivator()
+{
+    std::scoped_lock lock(m_mutex);
+    ++m_activatorRegistrations;
+    return true;
+}
+
+void MockNotificationBackend::unregisterActivator()
+{
+    std::scoped_lock lock(m_mutex);
+    if (m_activatorRegistrations > 0) {
+        --m_activatorRegistrations;
+    }
+}
+
+bool MockNotificationBackend::show(const std::wstring &appID, const ToastContent &content,
+                                   NotificationListener *listener)
+{
+    notifier(appID);
+    NotificationListener *previous = nullptr;
+    {
+        std::scoped_lock lock(m_mutex);
+        if (!m_showAvailable) {
+            m_notifiers.invalidate(appID);
+            return false;
+        }
+        ++m_showCount;
+        // like the action center, a toast with the same tag replaces the previous one
+        auto &toast = m_toasts[content.id];
+        if (toast.listener != listener) {
+            previous = toast.listener;
+            if (previous) {
+                enter(previous);
+            }
+        }
+        toast = { appID, content, listener, false };
+    }
+    if (previous) {
+        previous->replaced();
+        leave(previous);
+    }
+    return true;
+}
+
+bool MockNotificationBackend::hide(const std::wstring &id, NotificationListener *listener)
+{
+    {
+        std::scoped_lock lock(m_mutex);
+        const auto it = m_toasts.find(id);
+        if (it == m_toasts.cend() || it->second.hidden || it->second.listener != listener) {
+            return false;
+        }
+        it->second.hidden = true;
+    }
+    if (listener) {
+        listener->dismissed(DismissalReason::ApplicationHidden);
+    }
+    return true;
+}
+
+void MockNotificationBackend::release(const std::wstring &id, NotificationListener *listener)
+{
+    std::unique_lock lock(m_mutex);
+    const auto it = m_toasts.find(id);
+    // the toast might have been replaced by a toast of another listener
+    if (it != m_toasts.cend() && it->second.listener == listener) {
+        it->second.listener = nullptr;
+        if (it->second.hidden) {
+            m_toasts.erase(it);
+        }
+    }
+    // the listener is destroyed after release, a listener releasing itself from its own event
+    // doesn't wait
+    m_released.wait(lock, [this, listener] {
+        const auto range = m_running.equal_range(listener);
+        for (auto it = range.first; it != range.second; ++it) {
+            if (it->second != std::this_thread::get_id()) {
+                return false;
+            }
+        }
+        return true;
+    });
+}
+
+bool MockNotificationBackend::requestClose(const std::wstring &id)
+{
+    NotificationListener *l;
+    {
+        std::scoped_lock lock(m_mutex);
+        l = listener(id);
+        if (!l) {
+            return false;
+        }
+        enter(l);
+    }
+    l->closeRequested();
+    leave(l);
+    return true;
+}
+
+bool MockNotificationBackend::removeFromHistory(const std::wstring &appID,
+                                                const std::wstring &group, const std::wstring &id)
+{
+    std::scoped_lock lock(m_mutex);
+    const auto it = m_toasts.find(id);
+    if (it == m_toasts.cend() || it->second.appID != appID || it->second.content.group != group) {
+        return false;
+    }
+    m_toasts.erase(it);
+    return true;
+}
+
+std::vector<HistoryEntry> MockNotificationBackend::history(const std::wstring &appID)
+{
+    std::vector<HistoryEntry> out;
+    std::scoped_lock lock(m_mutex);
+    for (const auto &toast : m_toasts) {
+        if (toast.second.appID == appID && !toast.second.hidden) {
+            out.push_back({ toast.first, toast.second.content.group });
+        }
+    }
+    return out;
+}
+
+bool MockNotificationBackend::writePipe(const std::filesystem::path &pipe, std::string_view data,
+                                        bool)
+{
+    std::scoped_lock lock(m_mutex);
+    if (!m_pipeAvailable) {
+        return false;
+    }
+    m_pipeMessages.push_back({ pipe, std::string(data) });
+    return true;
+}
+
+bool MockNotificationBackend::startProcess(const std::filesystem::path &app)
+{
+    std::scoped_lock lock(m_mutex);
+    m_startedProcesses.push_back(app);
+    return true;
+}
@@ -0,0 +1,127 @@
+/*
+    SnoreToast is capable to invoke Windows 8 toast notifications.
+    Copyright (C) 2026  Hannah von Reth <vonreth@kde.org>
+
+    SnoreToast is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    SnoreToast is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with SnoreToast.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#pragma once
+
+#include "notificationbackend.h"
+#include "notifiercache.h"
+
+#include <condition_variable>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+
+/**
+ * A deterministic in process backend.
+ * Nothing is displayed, events are only delivered when triggered by activate(), dismiss()
+ * and fail(), synchronously on the calling thread. Like the WinRT backend, release() waits for
+ * the events of the listener running on other threads.
+ */
+class MockNotificationBackend : public NotificationBackend
+{
+public:
+    struct Toast
+    {
+        std::wstring appID;
+        ToastContent content;
+        NotificationListener *listener = nullptr;
+        bool hidden = false;
+    };
+
+    // stands in for the IToastNotifier of an appID
+    struct Notifier
+    {
+        std::wstring appID;
+    };
+    using Notifiers = NotifierCache<std::shared_ptr<const Notifier>>;
+
+    struct PipeMessage
+    {
+        std::filesystem::path pipe;
+        // the bytes written, see SnoreToastProtocol
+        std::string data;
+    };
+
+    MockNotificationBackend();
+    ~MockNotificationBackend() override;
+
+    // configuration
+    void setRegistered(bool registered);
+    void setSetting(NotificationSetting setting);
+    // whether writePipe succeeds
+    void setPipeAvailable(bool available);
+    // whether show succeeds, like a failed IToastNotifier::Show it invalidates the notifier
+    void setShowAvailable(bool available);
+
+    // events, return false if there is no listener for id
+    bool activate(const std::wstring &id);
+    bool activateButton(const std::wstring &id, size_t button);
+    bool activateTextBox(const std::wstring &id);
+    bool dismiss(const std::wstring &id, DismissalReason reason);
+    bool fail(const std::wstring &id);
+
+    // inspection
+    std::optional<Toast> toast(const std::wstring &id) const;
+    size_t toastCount() const;
+    size_t showCount() const;
+    size_t activatorRegistrations() const;
+    std::vector<PipeMessage> pipeMessages() const;
+    std::vector<std::filesystem::path> startedProcesses() const;
+    Notifiers::Statistics notifierStatistics() const;
+
+    // NotificationBackend
+    bool isRegistered(const std::wstring &appID) override;
+    NotificationSetting setting(const std::wstring &appID) override;
+    bool registerActivator() override;
+    void unregisterActivator() override;
+    bool show(const std::wstring &appID, const ToastContent &content,
+              NotificationListener *listener) override;
+    bool hide(const std::wstring &id, NotificationListener *listener) override;
+    void release(const std::wstring &id, NotificationListener *listener) override;
+    bool requestClose(const std::wstring &id) override;
+    bool removeFromHistory(const std::wstring &appID, const std::wstring &group,
+                           const std::wstring &id) override;
+    std::vector<HistoryEntry> history(const std::wstring &appID) override;
+    bool writePipe(const std::filesystem::path &pipe, std::string_view data,
+                   bool wait = false) override;
+    bool startProcess(const std::filesystem::path &app) override;
+
+private:
+    NotificationListener *listener(const std::wstring &id) const;
+    // an event of l starts, called with m_mutex held, and returned
+    void enter(NotificationListener *l);
+    void leave(NotificationListener *l);
+    std::shared_ptr<const Notifier> notifier(const std::wstring &appID);
+
+    mutable std::mutex m_mutex;
+    bool m_registered = true;
+    bool m_pipeAvailable = true;
+    bool m_showAvailable = true;
+    NotificationSetting m_setting = NotificationSetting::Enabled;
+    size_t m_activatorRegistrations = 0;
+    size_t m_showCount = 0;
+    // toasts that are displayed or in the history
+    std::map<std::wstring, Toast> m_toasts;
+    std::vector<PipeMessage> m_pipeMessages;
+    std::vector<std::filesystem::path> m_startedProcesses;
+    Notifiers m_notifiers;
+    // the listeners called right now and their threads
+    std::multimap<NotificationListener *, std::thread::id> m_running;
+    std::condition_variable m_released;
+};
@@ -0,0 +1,157 @@
+/*
+    SnoreToast is capable to invoke Windows 8 toast notifications.
+    Copyright (C) 2026  Hannah von Reth <vonreth@kde.org>
+
+    SnoreToast is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    SnoreToast is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with SnoreToast.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#pragma once
+
+#include "toastrequest.h"
+
+#include <filesystem>
+#include <string>
+#include <string_view>
+#include <vector>
+
+enum class NotificationSetting {
+    Enabled,
+    DisabledForApplication,
+    DisabledForUser,
+    DisabledByGroupPolicy,
+    DisabledByManifest
+};
+
+enum class DismissalReason { ApplicationHidden, UserCanceled, TimedOut };
+
+struct ToastButton
+{
+    std::wstring content;
+    std::wstring arguments;
+};
+
+/**
+ * Everything a backend needs to display a toast.
+ * The activation arguments are already formatted by SnoreToasts::formatAction.
+ */
+struct ToastContent
+{
+    std::wstring id; // the tag of the notification
+    std::wstring group;
+    std::wstring title;
+    std::wstring body;
+    std::filesystem::path image;
+    std::wstring sound; // ms-winsoundevent:Notification.Default
+    bool silent = false;
+    Duration duration = Duration::Short;
+    std::wstring launchArguments;
+    std::vector<ToastButton> buttons;
+    // only used if there are no buttons
+    bool textBox = false;
+    std::wstring textBoxArguments;
+};
+
+/**
+ * A toast in the action center, identified by its tag and group.
+ */
+struct HistoryEntry
+{
+    std::wstring id;
+    std::wstring group;
+};
+
+/**
+ * Receives the events of a displayed toast.
+ * The events might be delivered on any thread.
+ */
+class NotificationListener
+{
+public:
+    virtual ~NotificationListener() = default;
+
+    virtual void activated(std::wstring_view arguments) = 0;
+    virtual void dismissed(DismissalReason reason) = 0;
+    virtual void failed() = 0;
+    /**
+     * Another SnoreToasts instance, possibly in a different process, requested to close
+     * the toast.
+     */
+    virtual void closeRequested() = 0;
+    /**
+     * A toast with the same id shown with a different listener replaced the toast, no more
+     * events are delivered.
+     */
+    virtual void replaced() = 0;
+};
+
+/**
+ * Abstracts the notification system and the platform specific parts of the callbacks,
+ * WinRTNotificationBackend on Windows and MockNotificationBackend for testing.
+ * A backend can be shared by any number of SnoreToasts instances.
+ */
+class NotificationBackend
+{
+public:
+    virtual ~NotificationBackend() = default;
+
+    /**
+     * Returns whether the appID is properly registered with a shortcut,
+     * if not only click actions are available.
+     */
+    virtual bool isRegistered(const std::wstring &appID) = 0;
+    virtual NotificationSetting setting(const std::wstring &appID) = 0;
+
+    /**
+     * Registers the com server that receives button and text box activations.
+     */
+    virtual bool registerActivator() = 0;
+    virtual void unregisterActivator() = 0;
+
+    /**
+     * Displays the toast, the events are delivered to listener until release() is called.
+     * listener might be nullptr if no events are required. Like in the action center a toast
+     * replaces the displayed toast with the same id, its listener is told by replaced().
+     */
+    virtual bool show(const std::wstring &appID, const ToastContent &content,
+                      NotificationListener *listener) = 0;
+    /**
+     * Hides the toast id displayed with listener, does nothing if it was replaced.
+     */
+    virtual bool hide(const std::wstring &id, NotificationListener *listener) = 0;
+    /**
+     * Stops the delivery of events to listener and frees the associated resources, does
+     * nothing if the toast id was replaced by a toast of another listener.
+     */
+    virtual void release(const std::wstring &id, NotificationListener *listener) = 0;
+
+    /**
+     * Asks the owner of the toast to close it, see NotificationListener::closeRequested().
+     * Returns false if no toast with id is displayed.
+     */
+    virtual bool requestClose(const std::wstring &id) = 0;
+    virtual bool removeFromHistory(const std::wstring &appID, const std::wstring &group,
+                                   const std::wstring &id) = 0;
+    /**
+     * The toasts of appID in the action center, including toasts of other processes.
+     */
+    virtual std::vector<HistoryEntry> history(const std::wstring &appID) = 0;
+
+    /**
+     * Delivers the encoded callback data to the client listening on pipe, see
+     * SnoreToastProtocol for the formats.
+     * If wait is true wait for the pipe to become available.
+     */
+    virtual bool writePipe(const std::filesystem::path &pipe, std::string_view data,
+                           bool wait = false) = 0;
+    virtual bool startProcess(const std::filesystem::path &app) = 0;
+};
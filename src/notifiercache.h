@@ -0,0 +1,110 @@
+/*
+    SnoreToast is capable to invoke Windows 8 toast notifications.
+    Copyright (C) 2026  Hannah von Reth <vonreth@kde.org>
+
+    SnoreToast is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    SnoreToast is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with SnoreToast.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#pragma once
+
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+/**
+ * The notifiers of a backend, one per AppUserModelId, shared by all toasts of the process.
+ *
+ * A notifier is created on the first lookup of its appID. A backend that sees a notifier fail
+ * invalidates it, the next lookup creates a new one.
+ * Notifier is a cheap to copy handle, a reference counted pointer.
+ */
+template<typename Notifier>
+class NotifierCache
+{
+public:
+    struct Statistics
+    {
+        uint64_t hits = 0;
+        uint64_t misses = 0;
+        uint64_t invalidations = 0;
+    };
+
+    NotifierCache() = default;
+    NotifierCache(const NotifierCache &) = delete;
+    NotifierCache &operator=(const NotifierCache &) = delete;
+
+    /**
+     * Returns the notifier of appID in out, on a miss it is created with create, which is
+     * called as bool create(Notifier &out) without holding the lock.
+     * Returns false and caches nothing if create fails.
+     * Thread safe, if two threads miss at once the notifier created first is kept.
+     */
+    template<typename Create>
+    bool get(const std::wstring &appID, Notifier &out, Create &&create)
+    {
+        {
+            std::scoped_lock lock(m_mutex);
+            const auto it = m_notifiers.find(appID);
+            if (it != m_notifiers.cend()) {
+                ++m_statistics.hits;
+                out = it->second;
+                return true;
+            }
+            ++m_statistics.misses;
+        }
+        Notifier notifier;
+        if (!create(notifier)) {
+            return false;
+        }
+        std::scoped_lock lock(m_mutex);
+        out = m_notifiers.try_emplace(appID, std::move(notifier)).first->second;
+        return true;
+    }
+
+    /**
+     * Drops the notifier of appID, toasts holding it keep it alive.
+     */
+    void invalidate(const std::wstring &appID)
+    {
+        std::scoped_lock lock(m_mutex);
+        if (m_notifiers.erase(appID)) {
+            ++m_statistics.invalidations;
+        }
+    }
+
+    void clear()
+    {
+        std::scoped_lock lock(m_mutex);
+        m_statistics.invalidations += m_notifiers.size();
+        m_notifiers.clear();
+    }
+
+    size_t size() const
+    {
+        std::scoped_lock lock(m_mutex);
+        return m_notifiers.size();
+    }
+
+    Statistics statistics() const
+    {
+        std::scoped_lock lock(m_mutex);
+        return m_statistics;
+    }
+
+private:
+    mutable std::mutex m_mutex;
+    std::unordered_map<std::wstring, Notifier> m_notifiers;
+    Statistics m_statistics;
+};
@@ -0,0 +1,207 @@
+/*
+    SnoreToast is capable to invoke Windows 8 toast notifications.
+    Copyright (C) 2026  Hannah von Reth <vonreth@kde.org>
+
+    SnoreToast is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    SnoreToast is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with SnoreToast.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "optionparser.h"
+#include "mappedfile.h"
+#include "stringutils.h"
+
+#include <algorithm>
+
+namespace {
+constexpr size_t MaxResponseFileDepth = 8;
+constexpr std::string_view UTF8_BOM = "\xEF\xBB\xBF";
+constexpr std::string_view UTF16LE_BOM = "\xFF\xFE";
+// the column of the | in data/help.txt
+constexpr size_t HelpColumn = 40;
+
+bool isSpace(wchar_t c)
+{
+    return c == L' ' || c == L'\t';
+}
+
+bool isResponseFile(std::wstring_view arg)
+{
+    return arg.size() > 1 && arg.front() == L'@';
+}
+
+bool expand(std::vector<std::wstring> &args, std::vector<std::wstring> &out,
+            const OptionParser::ValueCount &values, size_t &pending, size_t depth,
+            std::wstring &error)
+{
+    for (auto &arg : args) {
+        // the values of an option are never expanded, "-t @name" is a title
+        if (pending > 0) {
+            pending -= pending == OptionParser::AllValues ? 0 : 1;
+            out.push_back(std::move(arg));
+            continue;
+        }
+        if (!isResponseFile(arg)) {
+            pending = values ? values(arg) : 0;
+            out.push_back(std::move(arg));
+            continue;
+        }
+        if (depth == MaxResponseFileDepth) {
+            error = L"Response files are nested too deep: " + arg;
+            return false;
+        }
+        const std::wstring_view path = std::wstring_view(arg).substr(1);
+        const auto file = MappedFile::open(std::filesystem::path(path));
+        if (!file) {
+            error = L"Failed to read the response file: " + std::wstring(path);
+            return false;
+        }
+        const std::wstring text = OptionParser::decodeText(file->data());
+        std::vector<std::wstring> fileArgs;
+        std::wstring_view lines = text;
+        while (!lines.empty()) {
+            const size_t end = lines.find(L'\n');
+            std::wstring_view line = lines.substr(0, end);
+            lines.remove_prefix(end == std::wstring_view::npos ? lines.size() : end + 1);
+            if (!line.empty() && line.back() == L'\r') {
+                line.remove_suffix(1);
+            }
+            if (line.empty() || line.front() == L'#') {
+                continue;
+            }
+            for (auto &a : OptionParser::splitCommandLine(line)) {
+                fileArgs.push_back(std::move(a));
+            }
+        }
+        if (!expand(fileArgs, out, values, pending, depth + 1, error)) {
+            return false;
+        }
+    }
+    return true;
+}
+}
+
+void OptionParser::appendHelp(std::wstring &out, std::wstring_view usage, std::wstring_view help,
+                              bool separated)
+{
+    if (separated) {
+        out += L'\n';
+    }
+    bool first = true;
+    while (true) {
+        const size_t end = help.find(L'\n');
+        const std::wstring_view line = help.substr(0, end);
+        const std::wstring_view column = first ? usage : std::wstring_view();
+        out += column;
+        out.append(column.size() < HelpColumn ? HelpColumn - column.size() : 1, L' ');
+        out += L"| ";
+        out += line;
+        out += L'\n';
+        if (end == std::wstring_view::npos) {
+            break;
+        }
+        help.remove_prefix(end + 1);
+        first = false;
+    }
+}
+
+std::vector<std::wstring> OptionParser::splitCommandLine(std::wstring_view line)
+{
+    std::vector<std::wstring> out;
+    size_t i = 0;
+    while (i < line.size()) {
+        while (i < line.size() && isSpace(line[i])) {
+            ++i;
+        }
+        if (i == line.size()) {
+            break;
+        }
+        std::wstring arg;
+        bool quoted = false;
+        for (; i < line.size() && (quoted || !isSpace(line[i])); ++i) {
+            if (line[i] == L'\\') {
+                size_t backslashes = 0;
+                while (i < line.size() && line[i] == L'\\') {
+                    ++backslashes;
+                    ++i;
+                }
+                if (i < line.size() && line[i] == L'"') {
+                    // 2n backslashes followed by a quote produce n backslashes and a toggle,
+                    // 2n + 1 produce n backslashes and a literal quote
+                    arg.append(backslashes / 2, L'\\');
+                    if (backslashes % 2 == 1) {
+                        arg.push_back(L'"');
+                    } else {
+                        quoted = !quoted;
+                    }
+                } else {
+                    arg.append(backslashes, L'\\');
+                    --i;
+                }
+            } else if (line[i] == L'"') {
+                quoted = !quoted;
+            } else {
+                arg.push_back(line[i]);
+            }
+        }
+        out.push_back(std::move(arg));
+    }
+    return out;
+}
+
+std::wstring OptionParser::decodeText(std::string_view data)
+{
+    if (data.substr(0, UTF16LE_BOM.size()) != UTF16LE_BOM) {
+        if (data.substr(0, UTF8_BOM.size()) == UTF8_BOM) {
+            data.remove_prefix(UTF8_BOM.size());
+        }
+        return Utils::fromUtf8(data);
+    }
+    data.remove_prefix(UTF16LE_BOM.size());
+    std::wstring out;
+    out.reserve(data.size() / 2);
+    for (size_t i = 0; i + 1 < data.size(); i += 2) {
+        const char16_t unit = static_cast<char16_t>(static_cast<unsigned char>(data[i])
+                                                    | static_cast<unsigned char>(data[i + 1]) << 8);
+        if constexpr (sizeof(wchar_t) == 4) {
+            // combine the surrogate pairs
+            if (unit >= 0xDC00 && unit < 0xE000 && !out.empty() && out.back() >= 0xD800
+                && out.back() < 0xDC00) {
+                out.back() = static_cast<wchar_t>(0x10000 + ((out.back() - 0xD800) << 10)
+                                                  + (unit - 0xDC00));
+                continue;
+            }
+        }
+        out.push_back(static_cast<wchar_t>(unit));
+    }
+    return out;
+}
+
+bool OptionParser::expandResponseFiles(std::vector<std::wstring> &args, std::wstring &error)
+{
+    return expandResponseFiles(args, nullptr, error);
+}
+
+bool OptionParser::expandResponseFiles(std::vector<std::wstring> &args, const ValueCount &values,
+                                       std::wstring &error)
+{
+    if (std::none_of(args.cbegin(), args.cend(),
+                     [](const std::wstring &arg) { return isResponseFile(arg); })) {
+        return true;
+    }
+    std::vector<std::wstring> out;
+    size_t pending = 0;
+    if (!expand(args, out, values, pending, 0, error)) {
+        return false;
+    }
+    args = std::move(out);
+    return true;
+}
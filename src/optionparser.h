@@ -0,0 +1,295 @@
+/*
+    SnoreToast is capable to invoke Windows 8 toast notifications.
+    Copyright (C) 2026  Hannah von Reth <vonreth@kde.org>
+
+    SnoreToast is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    SnoreToast is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with SnoreToast.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * A parser driven by a constexpr table of options, the table also provides the help text
+ * and the error messages.
+ *
+ * Options are matched case insensitive, their values are passed to the handler of the
+ * option. Choices are validated before the handler is called and the handler receives the
+ * index of the choice.
+ *
+ * using Option = OptionParser::Option<Request>;
+ * constexpr Option Options[] = {
+ *     Option::value(L"-t", L"<title>", L"The title.",
+ *                   [](Request &r, const std::wstring *v, size_t) { r.title = v[0]; }),
+ * };
+ * static_assert(OptionParser::isValid(Options));
+ */
+namespace OptionParser {
+enum class Kind : uint8_t {
+    Flag,
+    Value,
+    // the argument lists the choices, (a | b | c)
+    Choice
+};
+
+enum Flags : uint8_t {
+    NoFlags = 0,
+    // shown in brackets in the help
+    Optional = 1 << 0,
+    // the remaining arguments are not parsed
+    Terminal = 1 << 1,
+    // preceded by an empty line in the help
+    Separated = 1 << 2
+};
+
+template<typename Target>
+struct Option
+{
+    using Handler = void (*)(Target &target, const std::wstring *values, size_t choice);
+
+    std::wstring_view name;
+    // the placeholder of the values in the help
+    std::wstring_view argument;
+    // lines are separated by \n
+    std::wstring_view help;
+    Kind kind;
+    size_t arity;
+    uint8_t flags;
+    Handler handler;
+
+    static constexpr Option flag(std::wstring_view name, std::wstring_view help, Handler handler,
+                                 uint8_t flags = Optional)
+    {
+        return { name, {}, help, Kind::Flag, 0, flags, handler };
+    }
+
+    static constexpr Option value(std::wstring_view name, std::wstring_view argument,
+                                  std::wstring_view help, Handler handler,
+                                  uint8_t flags = Optional, size_t arity = 1)
+    {
+        return { name, argument, help, Kind::Value, arity, flags, handler };
+    }
+
+    static constexpr Option choice(std::wstring_view name, std::wstring_view choices,
+                                   std::wstring_view help, Handler handler,
+                                   uint8_t flags = Optional)
+    {
+        return { name, choices, help, Kind::Choice, 1, flags, handler };
+    }
+};
+
+constexpr wchar_t toLower(wchar_t c)
+{
+    return c >= L'A' && c <= L'Z' ? static_cast<wchar_t>(c - L'A' + L'a') : c;
+}
+
+constexpr bool equalsIgnoreCase(std::wstring_view a, std::wstring_view b)
+{
+    if (a.size() != b.size()) {
+        return false;
+    }
+    for (size_t i = 0; i < a.size(); ++i) {
+        if (toLower(a[i]) != toLower(b[i])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * Returns the index of value in the choices "(a | b | c)" or npos.
+ */
+constexpr size_t choiceIndex(std::wstring_view choices, std::wstring_view value)
+{
+    if (choices.size() >= 2 && choices.front() == L'(' && choices.back() == L')') {
+        choices = choices.substr(1, choices.size() - 2);
+    }
+    size_t index = 0;
+    while (true) {
+        const size_t end = choices.find(L'|');
+        std::wstring_view choice = choices.substr(0, end);
+        while (!choice.empty() && choice.front() == L' ') {
+            choice.remove_prefix(1);
+        }
+        while (!choice.empty() && choice.back() == L' ') {
+            choice.remove_suffix(1);
+        }
+        if (!choice.empty() && choice == value) {
+            return index;
+        }
+        if (end == std::wstring_view::npos) {
+            return std::wstring_view::npos;
+        }
+        choices.remove_prefix(end + 1);
+        ++index;
+    }
+}
+
+template<typename Target, size_t N>
+constexpr const Option<Target> *find(const Option<Target> (&options)[N], std::wstring_view name)
+{
+    for (const auto &option : options) {
+        if (equalsIgnoreCase(option.name, name)) {
+            return &option;
+        }
+    }
+    return nullptr;
+}
+
+/**
+ * Checks the table at compile time: unique names starting with - , handlers, values for
+ * all but flags and at least one choice for choices.
+ */
+template<typename Target, size_t N>
+constexpr bool isValid(const Option<Target> (&options)[N])
+{
+    for (size_t i = 0; i < N; ++i) {
+        const auto &option = options[i];
+        if (option.name.size() < 2 || option.name.front() != L'-' || !option.handler) {
+            return false;
+        }
+        if ((option.kind == Kind::Flag) != (option.arity == 0)) {
+            return false;
+        }
+        if (option.kind == Kind::Choice
+            && (option.arity != 1 || option.argument.find(L'|') == std::wstring_view::npos)) {
+            return false;
+        }
+        for (size_t j = i + 1; j < N; ++j) {
+            if (equalsIgnoreCase(option.name, options[j].name)) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+template<typename Target>
+std::wstring missingArgument(const Option<Target> &option)
+{
+    return L"Missing argument to " + std::wstring(option.name) + L".\nSupply argument as "
+            + std::wstring(option.name) + L" " + std::wstring(option.argument);
+}
+
+/**
+ * Parses args into target, returns false and sets error if an argument is unknown, missing
+ * or not a valid choice.
+ */
+template<typename Target, size_t N>
+bool parse(const Option<Target> (&options)[N], const std::vector<std::wstring> &args,
+           Target &target, std::wstring &error)
+{
+    for (size_t i = 0; i < args.size();) {
+        const Option<Target> *option = find(options, args[i]);
+        if (!option) {
+            error = L"Unknown argument: " + args[i] + L"\n";
+            return false;
+        }
+        ++i;
+        if (args.size() - i < option->arity) {
+            error = missingArgument(*option);
+            return false;
+        }
+        size_t choice = 0;
+        if (option->kind == Kind::Choice) {
+            choice = choiceIndex(option->argument, args[i]);
+            if (choice == std::wstring_view::npos) {
+                error = args[i] + L" is not a valid argument to " + std::wstring(option->name);
+                return false;
+            }
+        }
+        option->handler(target, args.data() + i, choice);
+        i += option->arity;
+        if (option->flags & Terminal) {
+            break;
+        }
+    }
+    return true;
+}
+
+/**
+ * Formats a help line, the options are aligned to the same column as data/help.txt.
+ */
+void appendHelp(std::wstring &out, std::wstring_view usage, std::wstring_view help,
+                bool separated);
+
+template<typename Target, size_t N>
+std::wstring helpText(const Option<Target> (&options)[N])
+{
+    std::wstring out;
+    std::wstring usage;
+    for (const auto &option : options) {
+        usage.clear();
+        const bool optional = option.flags & Optional;
+        if (optional) {
+            usage += L'[';
+        }
+        usage += option.name;
+        if (optional) {
+            usage += L']';
+        }
+        if (!option.argument.empty()) {
+            usage += L' ';
+            usage += option.argument;
+        }
+        appendHelp(out, usage, option.help, option.flags & Separated);
+    }
+    return out;
+}
+
+/**
+ * Splits a command line following the rules of CommandLineToArgvW.
+ */
+std::vector<std::wstring> splitCommandLine(std::wstring_view line);
+
+/**
+ * Decodes the content of a text file, utf-16 with a byte order mark or utf-8.
+ */
+std::wstring decodeText(std::string_view data);
+
+// the values following an option, AllValues for a Terminal option
+using ValueCount = std::function<size_t(std::wstring_view option)>;
+constexpr size_t AllValues = SIZE_MAX;
+
+/**
+ * Replaces the arguments @file by the content of file, one command line per line,
+ * lines starting with # are skipped. Response files can include other response files.
+ *
+ * With values only the arguments in option position are expanded, the values of the
+ * options are kept.
+ */
+bool expandResponseFiles(std::vector<std::wstring> &args, std::wstring &error);
+bool expandResponseFiles(std::vector<std::wstring> &args, const ValueCount &values,
+                         std::wstring &error);
+
+template<typename Target, size_t N>
+bool expandResponseFiles(const Option<Target> (&options)[N], std::vector<std::wstring> &args,
+                         std::wstring &error)
+{
+    return expandResponseFiles(
+            args,
+            [&options](std::wstring_view name) -> size_t {
+                const Option<Target> *option = find(options, name);
+                if (!option) {
+                    return 0;
+                }
+                return option->flags & Terminal ? AllValues : option->arity;
+            },
+            error);
+}
+};
@@ -0,0 +1,484 @@
+/*
+    SnoreToast is capable to invoke Windows 8 toast notifications.
+    Copyright (C) 2026  Hannah von Reth <vonreth@kde.org>
+
+    SnoreToast is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    SnoreToast is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with SnoreToast.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "pngimage.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdlib>
+
+#ifdef SNORETOAST_HAVE_ZLIB
+#include <zlib.h>
+#endif
+
+namespace {
+constexpr std::string_view Signature = "\x89PNG\r\n\x1a\n";
+constexpr uint32_t HeaderLength = 13;
+
+enum ColorType : uint8_t { Gray = 0, RGB = 2, Palette = 3, GrayAlpha = 4, RGBA = 6 };
+
+uint32_t readU32(const char *data)
+{
+    const auto *p = reinterpret_cast<const unsigned char *>(data);
+    return (uint32_t(p[0]) << 24) | (uint32_t(p[1]) << 16) | (uint32_t(p[2]) << 8) | p[3];
+}
+
+bool isValidDepth(uint8_t colorType, uint8_t depth)
+{
+    switch (colorType) {
+    case Gray:
+        return depth == 1 || depth == 2 || depth == 4 || depth == 8 || depth == 16;
+    case Palette:
+        return depth == 1 || depth == 2 || depth == 4 || depth == 8;
+    case RGB:
+    case GrayAlpha:
+    case RGBA:
+        return depth == 8 || depth == 16;
+    default:
+        return false;
+    }
+}
+
+struct Span
+{
+    uint32_t first = 0;
+    std::vector<float> weights;
+};
+
+// the source pixels covered by each target pixel, weighted by their overlap
+std::vector<Span> spans(uint32_t source, uint32_t target)
+{
+    std::vector<Span> out(target);
+    const double ratio = static_cast<double>(source) / target;
+    for (uint32_t i = 0; i < target; ++i) {
+        const double begin = i * ratio;
+        const double end = (i + 1) * ratio;
+        const auto first = static_cast<uint32_t>(begin);
+        const auto last = std::min(source, static_cast<uint32_t>(std::ceil(end)));
+        out[i].first = first;
+        for (uint32_t s = first; s < last; ++s) {
+            const double overlap = std::min(end, s + 1.0) - std::max(begin, double(s));
+            out[i].weights.push_back(static_cast<float>(overlap / ratio));
+        }
+    }
+    return out;
+}
+
+// resamples a row to premultiplied floats
+void resampleRow(const uint8_t *row, const std::vector<Span> &columns, float *out)
+{
+    for (const auto &column : columns) {
+        float r = 0, g = 0, b = 0, a = 0;
+        const uint8_t *pixel = row + size_t(column.first) * 4;
+        for (const float weight : column.weights) {
+            const float alpha = pixel[3] * weight;
+            r += pixel[0] * alpha;
+            g += pixel[1] * alpha;
+            b += pixel[2] * alpha;
+            a += alpha;
+            pixel += 4;
+        }
+        *out++ = r;
+        *out++ = g;
+        *out++ = b;
+        *out++ = a;
+    }
+}
+
+#ifdef SNORETOAST_HAVE_ZLIB
+size_t channels(uint8_t colorType)
+{
+    switch (colorType) {
+    case RGB:
+        return 3;
+    case GrayAlpha:
+        return 2;
+    case RGBA:
+        return 4;
+    default:
+        return 1;
+    }
+}
+
+// bounds the memory used by decode(), 256MiB of RGBA
+constexpr uint64_t MaxDecodedPixels = 8192ull * 8192ull;
+
+uint16_t readU16(const char *data)
+{
+    const auto *p = reinterpret_cast<const unsigned char *>(data);
+    return static_cast<uint16_t>((p[0] << 8) | p[1]);
+}
+
+void appendU32(std::string &out, uint32_t value)
+{
+    out += static_cast<char>(value >> 24);
+    out += static_cast<char>(value >> 16);
+    out += static_cast<char>(value >> 8);
+    out += static_cast<char>(value);
+}
+
+void appendChunk(std::string &out, std::string_view type, std::string_view data)
+{
+    appendU32(out, static_cast<uint32_t>(data.size()));
+    out += type;
+    out += data;
+    uLong crc = crc32(0, reinterpret_cast<const Bytef *>(type.data()), 4);
+    crc = crc32(crc, reinterpret_cast<const Bytef *>(data.data()), static_cast<uInt>(data.size()));
+    appendU32(out, static_cast<uint32_t>(crc));
+}
+
+uint8_t paeth(int a, int b, int c)
+{
+    const int p = a + b - c;
+    const int pa = std::abs(p - a);
+    const int pb = std::abs(p - b);
+    const int pc = std::abs(p - c);
+    if (pa <= pb && pa <= pc) {
+        return static_cast<uint8_t>(a);
+    }
+    return static_cast<uint8_t>(pb <= pc ? b : c);
+}
+
+// the prediction of filter for byte i of row
+uint8_t predict(uint8_t filter, const uint8_t *row, const uint8_t *previous, size_t i, size_t bpp)
+{
+    const int left = i >= bpp ? row[i - bpp] : 0;
+    const int up = previous[i];
+    switch (filter) {
+    case 1:
+        return static_cast<uint8_t>(left);
+    case 2:
+        return static_cast<uint8_t>(up);
+    case 3:
+        return static_cast<uint8_t>((left + up) / 2);
+    case 4:
+        return paeth(left, up, i >= bpp ? previous[i - bpp] : 0);
+    default:
+        return 0;
+    }
+}
+
+bool unfilter(uint8_t filter, uint8_t *row, const uint8_t *previous, size_t size, size_t bpp)
+{
+    if (filter > 4) {
+        return false;
+    }
+    if (filter != 0) {
+        for (size_t i = 0; i < size; ++i) {
+            row[i] = static_cast<uint8_t>(row[i] + predict(filter, row, previous, i, bpp));
+        }
+    }
+    return true;
+}
+
+// picks the filter with the smallest sum of absolute differences, like libpng
+uint8_t filterRow(const uint8_t *row, const uint8_t *previous, size_t size, size_t bpp,
+                  std::vector<uint8_t> &out)
+{
+    uint8_t best = 0;
+    uint64_t bestScore = UINT64_MAX;
+    std::vector<uint8_t> candidate(size);
+    for (uint8_t filter = 0; filter <= 4; ++filter) {
+        uint64_t score = 0;
+        for (size_t i = 0; i < size; ++i) {
+            candidate[i] = static_cast<uint8_t>(row[i] - predict(filter, row, previous, i, bpp));
+            score += static_cast<uint64_t>(std::abs(static_cast<int8_t>(candidate[i])));
+        }
+        if (score < bestScore) {
+            bestScore = score;
+            best = filter;
+            out.swap(candidate);
+            candidate.resize(size);
+        }
+    }
+    return best;
+}
+#endif
+}
+
+std::optional<PngImage::Header> PngImage::readHeader(std::string_view data)
+{
+    if (data.size() < Signature.size() + 8 + HeaderLength
+        || data.substr(0, Signature.size()) != Signature) {
+        return std::nullopt;
+    }
+    const char *chunk = data.data() + Signature.size();
+    if (readU32(chunk) != HeaderLength || std::string_view(chunk + 4, 4) != "IHDR") {
+        return std::nullopt;
+    }
+    const char *fields = chunk + 8;
+    Header header;
+    header.width = readU32(fields);
+    header.height = readU32(fields + 4);
+    header.bitDepth = static_cast<uint8_t>(fields[8]);
+    header.colorType = static_cast<uint8_t>(fields[9]);
+    const uint8_t interlace = static_cast<uint8_t>(fields[12]);
+    if (header.width == 0 || header.height == 0 || header.width > INT32_MAX
+        || header.height > INT32_MAX || !isValidDepth(header.colorType, header.bitDepth)
+        || fields[10] != 0 || fields[11] != 0 || interlace > 1) {
+        return std::nullopt;
+    }
+    header.interlaced = interlace == 1;
+    return header;
+}
+
+bool PngImage::isCodecAvailable()
+{
+#ifdef SNORETOAST_HAVE_ZLIB
+    return true;
+#else
+    return false;
+#endif
+}
+
+bool PngImage::decode(std::string_view data, Pixels &out, std::wstring &error)
+{
+#ifndef SNORETOAST_HAVE_ZLIB
+    (void)data;
+    (void)out;
+    error = L"SnoreToast was built without zlib";
+    return false;
+#else
+    const auto header = readHeader(data);
+    if (!header) {
+        error = L"Not a PNG image";
+        return false;
+    }
+    if (header->interlaced) {
+        error = L"Interlaced PNG images are not supported";
+        return false;
+    }
+    if (uint64_t(header->width) * header->height > MaxDecodedPixels) {
+        error = L"The image is too large to be decoded";
+        return false;
+    }
+    const uint8_t depth = header->bitDepth;
+    const uint8_t colorType = header->colorType;
+    const size_t channelCount = channels(colorType);
+    const size_t bitsPerPixel = channelCount * depth;
+    const size_t stride = (header->width * bitsPerPixel + 7) / 8;
+    const size_t bpp = std::max<size_t>(1, bitsPerPixel / 8);
+
+    std::string compressed;
+    std::array<uint8_t, 256 * 4> palette = {};
+    size_t paletteSize = 0;
+    // the transparent color of Gray and RGB images
+    std::optional<std::array<uint16_t, 3>> key;
+    for (size_t pos = Signature.size(); true;) {
+        if (data.size() - pos < 12 || data.size() - pos - 12 < readU32(data.data() + pos)) {
+            error = L"The image is truncated";
+            return false;
+        }
+        const uint32_t length = readU32(data.data() + pos);
+        const std::string_view type = data.substr(pos + 4, 4);
+        const std::string_view chunk = data.substr(pos + 8, length);
+        pos += 12 + size_t(length);
+        if (type == "IDAT") {
+            compressed += chunk;
+        } else if (type == "PLTE") {
+            paletteSize = std::min<size_t>(length / 3, 256);
+            for (size_t i = 0; i < paletteSize; ++i) {
+                palette[i * 4] = static_cast<uint8_t>(chunk[i * 3]);
+                palette[i * 4 + 1] = static_cast<uint8_t>(chunk[i * 3 + 1]);
+                palette[i * 4 + 2] = static_cast<uint8_t>(chunk[i * 3 + 2]);
+                palette[i * 4 + 3] = 255;
+            }
+        } else if (type == "tRNS") {
+            if (colorType == Palette) {
+                for (size_t i = 0; i < std::min<size_t>(length, paletteSize); ++i) {
+                    palette[i * 4 + 3] = static_cast<uint8_t>(chunk[i]);
+                }
+            } else if (colorType == Gray && length >= 2) {
+                const uint16_t gray = readU16(chunk.data());
+                key = std::array<uint16_t, 3> { gray, gray, gray };
+            } else if (colorType == RGB && length >= 6) {
+                key = std::array<uint16_t, 3> { readU16(chunk.data()), readU16(chunk.data() + 2),
+                                                readU16(chunk.data() + 4) };
+            }
+        } else if (type == "IEND") {
+            break;
+        }
+    }
+    if (colorType == Palette && paletteSize == 0) {
+        error = L"The image has no palette";
+        return false;
+    }
+
+    std::vector<uint8_t> raw((stride + 1) * header->height);
+    uLongf rawSize = static_cast<uLongf>(raw.size());
+    if (uncompress(raw.data(), &rawSize, reinterpret_cast<const Bytef *>(compressed.data()),
+                   static_cast<uLong>(compressed.size()))
+                != Z_OK
+        || rawSize != raw.size()) {
+        error = L"The image data is corrupt";
+        return false;
+    }
+
+    out.width = header->width;
+    out.height = header->height;
+    out.rgba.resize(size_t(out.width) * out.height * 4);
+    const std::vector<uint8_t> zero(stride);
+    const uint8_t *previous = zero.data();
+    const unsigned maxSample = (1u << depth) - 1;
+    uint8_t *pixel = out.rgba.data();
+    for (uint32_t y = 0; y < out.height; ++y) {
+        uint8_t *row = raw.data() + y * (stride + 1);
+        if (!unfilter(row[0], row + 1, previous, stride, bpp)) {
+            error = L"The image data is corrupt";
+            return false;
+        }
+        ++row;
+        previous = row;
+        // channel c of pixel x at the depth of the image
+        const auto sample = [&](uint32_t x, size_t c) -> uint16_t {
+            const size_t index = x * channelCount + c;
+            if (depth == 16) {
+                return static_cast<uint16_t>((row[index * 2] << 8) | row[index * 2 + 1]);
+            }
+            if (depth == 8) {
+                return row[index];
+            }
+            const size_t bit = index * depth;
+            return static_cast<uint16_t>((row[bit / 8] >> (8 - depth - bit % 8)) & maxSample);
+        };
+        const auto to8 = [&](uint16_t value) -> uint8_t {
+            if (depth == 16) {
+                return static_cast<uint8_t>(value >> 8);
+            }
+            return static_cast<uint8_t>(depth == 8 ? value : value * 255 / maxSample);
+        };
+        for (uint32_t x = 0; x < out.width; ++x, pixel += 4) {
+            switch (colorType) {
+            case Gray: {
+                const uint16_t gray = sample(x, 0);
+                pixel[0] = pixel[1] = pixel[2] = to8(gray);
+                pixel[3] = key && (*key)[0] == gray ? 0 : 255;
+                break;
+            }
+            case RGB: {
+                const std::array<uint16_t, 3> rgb = { sample(x, 0), sample(x, 1), sample(x, 2) };
+                pixel[0] = to8(rgb[0]);
+                pixel[1] = to8(rgb[1]);
+                pixel[2] = to8(rgb[2]);
+                pixel[3] = key && *key == rgb ? 0 : 255;
+                break;
+            }
+            case Palette: {
+                const size_t index = std::min<size_t>(sample(x, 0), 255);
+                std::copy_n(palette.data() + index * 4, 4, pixel);
+                break;
+            }
+            case GrayAlpha:
+                pixel[0] = pixel[1] = pixel[2] = to8(sample(x, 0));
+                pixel[3] = to8(sample(x, 1));
+                break;
+            case RGBA:
+                for (size_t c = 0; c < 4; ++c) {
+                    pixel[c] = to8(sample(x, c));
+                }
+                break;
+            }
+        }
+    }
+    return true;
+#endif
+}
+
+bool PngImage::encode(const Pixels &pixels, std::string &out)
+{
+#ifndef SNORETOAST_HAVE_ZLIB
+    (void)pixels;
+    (void)out;
+    return false;
+#else
+    bool opaque = true;
+    for (size_t i = 3; i < pixels.rgba.size() && opaque; i += 4) {
+        opaque = pixels.rgba[i] == 255;
+    }
+    const size_t bpp = opaque ? 3 : 4;
+    const size_t stride = size_t(pixels.width) * bpp;
+    std::vector<uint8_t> raw;
+    raw.reserve((stride + 1) * pixels.height);
+    std::vector<uint8_t> row(stride);
+    std::vector<uint8_t> previous(stride);
+    std::vector<uint8_t> filtered(stride);
+    const uint8_t *pixel = pixels.rgba.data();
+    for (uint32_t y = 0; y < pixels.height; ++y) {
+        for (size_t i = 0; i < stride; i += bpp, pixel += 4) {
+            std::copy_n(pixel, bpp, row.data() + i);
+        }
+        raw.push_back(filterRow(row.data(), previous.data(), stride, bpp, filtered));
+        raw.insert(raw.end(), filtered.begin(), filtered.end());
+        row.swap(previous);
+    }
+
+    uLongf size = compressBound(static_cast<uLong>(raw.size()));
+    std::string compressed(size, '\0');
+    if (compress2(reinterpret_cast<Bytef *>(compressed.data()), &size, raw.data(),
+                  static_cast<uLong>(raw.size()), Z_BEST_COMPRESSION)
+        != Z_OK) {
+        return false;
+    }
+    compressed.resize(size);
+
+    std::string header;
+    appendU32(header, pixels.width);
+    appendU32(header, pixels.height);
+    header += static_cast<char>(8);
+    header += static_cast<char>(opaque ? RGB : RGBA);
+    header.append(3, '\0');
+
+    out.assign(Signature);
+    appendChunk(out, "IHDR", header);
+    appendChunk(out, "IDAT", compressed);
+    appendChunk(out, "IEND", {});
+    return true;
+#endif
+}
+
+PngImage::Pixels PngImage::scale(const Pixels &pixels, uint32_t width, uint32_t height)
+{
+    Pixels out;
+    out.width = width;
+    out.height = height;
+    out.rgba.resize(size_t(width) * height * 4);
+    const auto columns = spans(pixels.width, width);
+    const auto rows = spans(pixels.height, height);
+    std::vector<float> line(size_t(width) * 4);
+    std::vector<float> sum(size_t(width) * 4);
+    uint8_t *pixel = out.rgba.data();
+    for (const auto &row : rows) {
+        std::fill(sum.begin(), sum.end(), 0.0f);
+        for (size_t i = 0; i < row.weights.size(); ++i) {
+            resampleRow(pixels.rgba.data() + (row.first + i) * size_t(pixels.width) * 4, columns,
+                        line.data());
+            for (size_t k = 0; k < sum.size(); ++k) {
+                sum[k] += line[k] * row.weights[i];
+            }
+        }
+        for (size_t k = 0; k < sum.size(); k += 4, pixel += 4) {
+            const float alpha = sum[k + 3];
+            for (size_t c = 0; c < 3; ++c) {
+                const float value = alpha > 0 ? sum[k + c] / alpha : 0.0f;
+                pixel[c] = static_cast<uint8_t>(std::min(255.0f, value + 0.5f));
+            }
+            pixel[3] = static_cast<uint8_t>(std::min(255.0f, alpha + 0.5f));
+        }
+    }
+    return out;
+}
@@ -0,0 +1,73 @@
+/*
+    SnoreToast is capable to invoke Windows 8 toast notifications.
+    Copyright (C) 2026  Hannah von Reth <vonreth@kde.org>
+
+    SnoreToast is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    SnoreToast is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with SnoreToast.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * The subset of PNG needed to keep toast images within the limits of the notification system.
+ *
+ * readHeader() only looks at the IHDR chunk and is always available. decode() and encode()
+ * need zlib, without it they fail and isCodecAvailable() returns false.
+ */
+namespace PngImage {
+struct Header
+{
+    uint32_t width = 0;
+    uint32_t height = 0;
+    uint8_t bitDepth = 0;
+    uint8_t colorType = 0;
+    bool interlaced = false;
+};
+
+/**
+ * Non premultiplied 8 bit RGBA.
+ */
+struct Pixels
+{
+    uint32_t width = 0;
+    uint32_t height = 0;
+    std::vector<uint8_t> rgba;
+};
+
+/**
+ * Returns the header if data starts with a PNG signature followed by a valid IHDR chunk.
+ */
+std::optional<Header> readHeader(std::string_view data);
+
+bool isCodecAvailable();
+
+/**
+ * Decodes a non interlaced PNG of any color type and bit depth.
+ */
+bool decode(std::string_view data, Pixels &out, std::wstring &error);
+
+/**
+ * Encodes pixels as RGB if they are opaque, as RGBA otherwise.
+ */
+bool encode(const Pixels &pixels, std::string &out);
+
+/**
+ * Resamples pixels to width x height by averaging the covered area, for downscaling.
+ */
+Pixels scale(const Pixels &pixels, uint32_t width, uint32_t height);
+}
@@ -17,7 +17,10 @@
 */
 #pragma once
 
-#include <algorithm>
+#include "snoretoasts.h"
+#include "textkernels.h"
+#include "winrtnotificationbackend.h"
+
 #include <ntverp.h>
 #include <sstream>
 #include <wrl.h>
@@ -67,10 +70,13 @@ public:
         for (ULONG i = 0; i < count; ++i) {
             std::wstring tmp = data[i].Value;
             // printing \r to stdcout is kind of problematic :D
-            std::replace(tmp.begin(), tmp.end(), L'\r', L'\n');
+            TextKernels::replace(tmp, L'\r', L'\n');
             msg << tmp;
         }
-        return SnoreToasts::backgroundCallback(appUserModelId, invokedArgs, msg.str());
+        return SnoreToasts::backgroundCallback(&WinRTNotificationBackend::instance(),
+                                               appUserModelId, invokedArgs, msg.str())
+                ? S_OK
+                : S_FALSE;
     }
 };
 
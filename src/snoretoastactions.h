@@ -17,9 +17,79 @@
 */
 #pragma once
 
+#include <array>
+#include <cstdint>
 #include <string>
-#include <map>
-#include <vector>
+#include <string_view>
+#include <type_traits>
+
+namespace SnoreToastActionsDetail {
+// indexed by the value of SnoreToastActions::Actions
+constexpr std::array<std::string_view, 6> Names = { "clicked",  "hidden",        "dismissed",
+                                                    "timedout", "buttonClicked", "textEntered" };
+constexpr size_t MaxNameSize = 13;
+
+// slot = (size * seed + first character) % TableSize
+constexpr size_t TableSize = 8;
+
+constexpr size_t hash(size_t size, uint32_t first, uint32_t seed)
+{
+    return (size * seed + first) % TableSize;
+}
+
+// the first seed that maps every name to its own slot
+constexpr uint32_t findSeed()
+{
+    for (uint32_t seed = 1; seed < 1024; ++seed) {
+        std::array<bool, TableSize> used = {};
+        bool collision = false;
+        for (const auto &name : Names) {
+            const auto slot = hash(name.size(), static_cast<unsigned char>(name[0]), seed);
+            collision |= used[slot];
+            used[slot] = true;
+        }
+        if (!collision) {
+            return seed;
+        }
+    }
+    return 0;
+}
+
+constexpr uint32_t Seed = findSeed();
+static_assert(Seed != 0, "No perfect hash for the action names");
+
+// slot -> index in Names or -1
+constexpr std::array<int, TableSize> buildTable()
+{
+    std::array<int, TableSize> table = {};
+    for (auto &slot : table) {
+        slot = -1;
+    }
+    for (size_t i = 0; i < Names.size(); ++i) {
+        table[hash(Names[i].size(), static_cast<unsigned char>(Names[i][0]), Seed)] =
+                static_cast<int>(i);
+    }
+    return table;
+}
+
+constexpr std::array<int, TableSize> Table = buildTable();
+
+// the names are ascii, so they can be widened to any character type at compile time
+template<typename CharT>
+constexpr std::array<std::array<CharT, MaxNameSize>, Names.size()> widenNames()
+{
+    std::array<std::array<CharT, MaxNameSize>, Names.size()> out = {};
+    for (size_t i = 0; i < Names.size(); ++i) {
+        for (size_t j = 0; j < Names[i].size(); ++j) {
+            out[i][j] = static_cast<CharT>(Names[i][j]);
+        }
+    }
+    return out;
+}
+
+template<typename CharT>
+inline constexpr auto WideNames = widenNames<CharT>();
+}
 
 class SnoreToastActions
 {
@@ -35,33 +105,75 @@ public:
         Error = -1
     };
 
+    /**
+     * The name of the action in any character type, empty for Actions::Error.
+     */
+    template<typename CharT = wchar_t>
+    static constexpr std::basic_string_view<CharT> actionString(Actions a)
+    {
+        const auto index = static_cast<size_t>(a);
+        if (index >= SnoreToastActionsDetail::Names.size()) {
+            return {};
+        }
+        return { SnoreToastActionsDetail::WideNames<CharT>[index].data(),
+                 SnoreToastActionsDetail::Names[index].size() };
+    }
+
+    /**
+     * Throws std::out_of_range for Actions::Error
+     */
     static const inline std::wstring &getActionString(const Actions &a)
     {
-        return actionMap().at(a);
+        static const auto strings = [] {
+            std::array<std::wstring, SnoreToastActionsDetail::Names.size()> out;
+            for (size_t i = 0; i < out.size(); ++i) {
+                out[i] = actionString<wchar_t>(static_cast<Actions>(i));
+            }
+            return out;
+        }();
+        return strings.at(static_cast<size_t>(a));
     }
 
-    template<typename T>
-    static inline SnoreToastActions::Actions getAction(const T &s)
+    /**
+     * Classifies an action name in any character type, without allocating.
+     * Returns Actions::Error for unknown names.
+     */
+    template<typename CharT>
+    static constexpr SnoreToastActions::Actions getAction(std::basic_string_view<CharT> s)
     {
-        for (const auto &a : actionMap()) {
-            if (a.second.compare(s) == 0) {
-                return a.first;
+        static_assert(std::is_integral_v<CharT>, "getAction requires a character type");
+        if (s.empty()) {
+            return SnoreToastActions::Actions::Error;
+        }
+        const auto first = static_cast<uint32_t>(static_cast<std::make_unsigned_t<CharT>>(s[0]));
+        const auto index = SnoreToastActionsDetail::Table[SnoreToastActionsDetail::hash(
+                s.size(), first, SnoreToastActionsDetail::Seed)];
+        if (index < 0) {
+            return SnoreToastActions::Actions::Error;
+        }
+        const auto &name = SnoreToastActionsDetail::Names[static_cast<size_t>(index)];
+        if (name.size() != s.size()) {
+            return SnoreToastActions::Actions::Error;
+        }
+        for (size_t i = 0; i < s.size(); ++i) {
+            if (static_cast<uint32_t>(static_cast<std::make_unsigned_t<CharT>>(s[i]))
+                != static_cast<uint32_t>(name[i])) {
+                return SnoreToastActions::Actions::Error;
             }
         }
-        return SnoreToastActions::Actions::Error;
+        return static_cast<SnoreToastActions::Actions>(index);
+    }
+
+    template<typename CharT, typename Traits, typename Allocator>
+    static inline SnoreToastActions::Actions
+    getAction(const std::basic_string<CharT, Traits, Allocator> &s)
+    {
+        return getAction(std::basic_string_view<CharT>(s.data(), s.size()));
     }
 
-private:
-    static const std::map<Actions, std::wstring> &actionMap()
+    template<typename CharT>
+    static constexpr SnoreToastActions::Actions getAction(const CharT *s)
     {
-        static const std::map<Actions, std::wstring> _ActionStrings = {
-            { Actions::Clicked, L"clicked" },
-            { Actions::Hidden, L"hidden" },
-            { Actions::Dismissed, L"dismissed" },
-            { Actions::Timedout, L"timedout" },
-            { Actions::ButtonClicked, L"buttonClicked" },
-            { Actions::TextEntered, L"textEntered" }
-        };
-        return _ActionStrings;
+        return getAction(std::basic_string_view<CharT>(s));
     }
 };
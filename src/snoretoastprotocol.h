@@ -0,0 +1,398 @@
+/*
+    SnoreToast is capable to invoke Windows 8 toast notifications.
+    Copyright (C) 2026  Hannah von Reth <vonreth@kde.org>
+
+    SnoreToast is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    SnoreToast is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with SnoreToast.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#pragma once
+
+#include "snoretoastactions.h"
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <string>
+#include <string_view>
+
+/**
+ * Version 2 of the pipe protocol, selected with -protocol 2.
+ *
+ * Version 1 writes a single null terminated wchar_t string per connection:
+ * action=clicked;notificationId=1;pipe=...;version=0.9.1;
+ *
+ * Version 2 frames every message with a fixed header and explicit field lengths, so a receiver
+ * can parse the messages in place and several messages can share one connection.
+ *
+ *   header
+ *     uint32  magic        "SNT2"
+ *     uint16  version      2
+ *     uint16  headerSize   the fields start at headerSize, newer versions may extend the header
+ *     int32   action       SnoreToastActions::Actions
+ *     uint32  fieldCount
+ *     uint32  payloadSize  the number of bytes following the header
+ *   fieldCount times
+ *     uint32  keySize      in UTF-16 code units
+ *     uint32  valueSize    in UTF-16 code units
+ *     char16  key[keySize]
+ *     char16  value[valueSize]
+ *
+ * Integers and strings are little endian, the strings are UTF-16 and neither escaped nor null
+ * terminated. The action is only part of the header, the other fields are the same as in
+ * version 1.
+ */
+namespace SnoreToastProtocol {
+
+constexpr uint16_t Version = 2;
+constexpr size_t HeaderSize = 20;
+constexpr size_t FieldHeaderSize = 8;
+// messages claiming a larger payload are rejected
+constexpr size_t MaxPayloadSize = 16 * 1024 * 1024;
+
+namespace Detail {
+constexpr char Magic[4] = { 'S', 'N', 'T', '2' };
+
+#if defined(_WIN32) || (defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__)
+constexpr bool LittleEndian = true;
+#else
+constexpr bool LittleEndian = false;
+#endif
+
+inline uint32_t load(const unsigned char *data, size_t bytes)
+{
+    uint32_t out = 0;
+    for (size_t i = 0; i < bytes; ++i) {
+        out |= static_cast<uint32_t>(data[i]) << (8 * i);
+    }
+    return out;
+}
+
+inline void store(char *data, uint32_t value, size_t bytes)
+{
+    for (size_t i = 0; i < bytes; ++i) {
+        data[i] = static_cast<char>((value >> (8 * i)) & 0xff);
+    }
+}
+
+inline void append(std::string &out, uint32_t value, size_t bytes)
+{
+    const size_t pos = out.size();
+    out.resize(pos + bytes);
+    store(out.data() + pos, value, bytes);
+}
+
+// appends the UTF-16 code units of value, returns their number
+template<typename CharT>
+inline size_t appendUtf16(std::string &out, std::basic_string_view<CharT> value)
+{
+    if constexpr (sizeof(CharT) == sizeof(char16_t)) {
+        if constexpr (LittleEndian) {
+            out.append(reinterpret_cast<const char *>(value.data()),
+                       value.size() * sizeof(CharT));
+        } else {
+            for (const CharT c : value) {
+                append(out, static_cast<uint16_t>(c), 2);
+            }
+        }
+        return value.size();
+    } else {
+        size_t units = value.size();
+        for (const CharT c : value) {
+            units += static_cast<uint32_t>(c) > 0xffff;
+        }
+        const size_t pos = out.size();
+        out.resize(pos + units * sizeof(char16_t));
+        char *data = out.data() + pos;
+        for (const CharT c : value) {
+            const auto codePoint = static_cast<uint32_t>(c);
+            if (codePoint > 0xffff) {
+                store(data, 0xd800 + ((codePoint - 0x10000) >> 10), 2);
+                store(data + 2, 0xdc00 + ((codePoint - 0x10000) & 0x3ff), 2);
+                data += 4;
+            } else {
+                store(data, codePoint, 2);
+                data += 2;
+            }
+        }
+        return units;
+    }
+}
+}
+
+/**
+ * Returns true if data starts with a version 2 message, a version 1 string never does.
+ */
+inline bool isVersion2(const void *data, size_t size)
+{
+    const auto bytes = static_cast<const char *>(data);
+    return size >= sizeof(Detail::Magic)
+            && std::char_traits<char>::compare(bytes, Detail::Magic, sizeof(Detail::Magic)) == 0;
+}
+
+/**
+ * Appends messages to a byte buffer:
+ *
+ *   std::string buffer;
+ *   SnoreToastProtocol::Encoder encoder(buffer);
+ *   encoder.begin(SnoreToastActions::Actions::ButtonClicked);
+ *   encoder.addField(L"notificationId", L"1");
+ *   encoder.addField(L"button", L"Ok");
+ *   encoder.end();
+ */
+class Encoder
+{
+public:
+    explicit Encoder(std::string &out) : m_out(out) { }
+
+    void begin(SnoreToastActions::Actions action)
+    {
+        assert(m_start == std::string::npos);
+        m_start = m_out.size();
+        m_fieldCount = 0;
+        m_out.append(Detail::Magic, sizeof(Detail::Magic));
+        Detail::append(m_out, Version, 2);
+        Detail::append(m_out, HeaderSize, 2);
+        Detail::append(m_out, static_cast<uint32_t>(action), 4);
+        // fieldCount and payloadSize are written by end()
+        m_out.append(8, '\0');
+    }
+
+    /**
+     * Accepts any string view of 16 or 32 bit characters, wchar_t on Linux is transcoded to
+     * UTF-16.
+     */
+    template<typename CharT>
+    void addField(std::basic_string_view<CharT> key, std::basic_string_view<CharT> value)
+    {
+        static_assert(sizeof(CharT) == sizeof(char16_t) || sizeof(CharT) == sizeof(char32_t),
+                      "Only UTF-16 and UTF-32 strings are supported");
+        assert(m_start != std::string::npos);
+        const size_t sizes = m_out.size();
+        m_out.append(FieldHeaderSize, '\0');
+        const auto keySize = Detail::appendUtf16(m_out, key);
+        const auto valueSize = Detail::appendUtf16(m_out, value);
+        Detail::store(m_out.data() + sizes, static_cast<uint32_t>(keySize), 4);
+        Detail::store(m_out.data() + sizes + 4, static_cast<uint32_t>(valueSize), 4);
+        ++m_fieldCount;
+    }
+
+    template<typename CharT>
+    void addField(const CharT *key, std::basic_string_view<CharT> value)
+    {
+        addField(std::basic_string_view<CharT>(key), value);
+    }
+
+    template<typename CharT>
+    void addField(const CharT *key, const CharT *value)
+    {
+        addField(std::basic_string_view<CharT>(key), std::basic_string_view<CharT>(value));
+    }
+
+    void end()
+    {
+        assert(m_start != std::string::npos);
+        char *header = m_out.data() + m_start;
+        Detail::store(header + 12, m_fieldCount, 4);
+        Detail::store(header + 16, static_cast<uint32_t>(m_out.size() - m_start - HeaderSize), 4);
+        m_start = std::string::npos;
+    }
+
+private:
+    std::string &m_out;
+    size_t m_start = std::string::npos;
+    uint32_t m_fieldCount = 0;
+};
+
+enum class Status {
+    Ok,
+    Incomplete, // more data is needed to decode the message
+    Invalid
+};
+
+class Message;
+inline Status decode(const void *data, size_t size, Message &out);
+
+/**
+ * A decoded message, the views point into the decoded buffer.
+ */
+class Message
+{
+public:
+    struct Field
+    {
+        std::u16string_view key;
+        std::u16string_view value;
+    };
+
+    class const_iterator
+    {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = Field;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const Field *;
+        using reference = const Field &;
+
+        const_iterator() = default;
+        const_iterator(const unsigned char *pos, uint32_t remaining)
+            : m_pos(pos), m_remaining(remaining)
+        {
+            read();
+        }
+
+        reference operator*() const { return m_field; }
+        pointer operator->() const { return &m_field; }
+
+        const_iterator &operator++()
+        {
+            m_pos += FieldHeaderSize
+                    + (m_field.key.size() + m_field.value.size()) * sizeof(char16_t);
+            --m_remaining;
+            read();
+            return *this;
+        }
+
+        const_iterator operator++(int)
+        {
+            const auto out = *this;
+            ++*this;
+            return out;
+        }
+
+        bool operator==(const const_iterator &other) const
+        {
+            return m_remaining == other.m_remaining;
+        }
+        bool operator!=(const const_iterator &other) const { return !(*this == other); }
+
+    private:
+        void read()
+        {
+            if (m_remaining == 0) {
+                m_field = {};
+                return;
+            }
+            const auto keySize = Detail::load(m_pos, 4);
+            const auto valueSize = Detail::load(m_pos + 4, 4);
+            const auto key = reinterpret_cast<const char16_t *>(m_pos + FieldHeaderSize);
+            m_field = { { key, keySize }, { key + keySize, valueSize } };
+        }
+
+        const unsigned char *m_pos = nullptr;
+        uint32_t m_remaining = 0;
+        Field m_field;
+    };
+
+    SnoreToastActions::Actions action() const { return m_action; }
+    uint32_t fieldCount() const { return m_fieldCount; }
+    /**
+     * The encoded size in bytes, the next message starts at this offset.
+     */
+    size_t size() const { return m_size; }
+
+    const_iterator begin() const { return { m_fields, m_fieldCount }; }
+    const_iterator end() const { return { m_fields, 0 }; }
+
+    /**
+     * Returns the value of key or an empty view.
+     */
+    std::u16string_view value(std::u16string_view key) const
+    {
+        for (const auto &field : *this) {
+            if (field.key == key) {
+                return field.value;
+            }
+        }
+        return {};
+    }
+
+    bool contains(std::u16string_view key) const
+    {
+        for (const auto &field : *this) {
+            if (field.key == key) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+private:
+    friend Status decode(const void *data, size_t size, Message &out);
+
+    const unsigned char *m_fields = nullptr;
+    uint32_t m_fieldCount = 0;
+    size_t m_size = 0;
+    SnoreToastActions::Actions m_action = SnoreToastActions::Actions::Error;
+};
+
+/**
+ * Decodes the message at the start of data without copying, data must be aligned to two bytes
+ * and outlive out. All field lengths are validated, iterating out is safe afterwards.
+ * The views are only valid UTF-16 on little endian hosts, like all Windows platforms.
+ */
+inline Status decode(const void *data, size_t size, Message &out)
+{
+    const auto bytes = static_cast<const unsigned char *>(data);
+    if (reinterpret_cast<uintptr_t>(bytes) % alignof(char16_t) != 0) {
+        return Status::Invalid;
+    }
+    const size_t magicSize = size < sizeof(Detail::Magic) ? size : sizeof(Detail::Magic);
+    if (std::char_traits<char>::compare(static_cast<const char *>(data), Detail::Magic, magicSize)
+        != 0) {
+        return Status::Invalid;
+    }
+    if (size < HeaderSize) {
+        return Status::Incomplete;
+    }
+    const auto version = Detail::load(bytes + 4, 2);
+    const size_t headerSize = Detail::load(bytes + 6, 2);
+    const size_t payloadSize = Detail::load(bytes + 16, 4);
+    const auto action = static_cast<int32_t>(Detail::load(bytes + 8, 4));
+    if (version < Version || headerSize < HeaderSize || headerSize % alignof(char16_t) != 0
+        || payloadSize > MaxPayloadSize
+        || action < static_cast<int32_t>(SnoreToastActions::Actions::Error)
+        || action > static_cast<int32_t>(SnoreToastActions::Actions::TextEntered)) {
+        return Status::Invalid;
+    }
+    const size_t messageSize = headerSize + payloadSize;
+    if (size < messageSize) {
+        return Status::Incomplete;
+    }
+
+    const auto fieldCount = Detail::load(bytes + 12, 4);
+    const unsigned char *pos = bytes + headerSize;
+    const unsigned char *const payloadEnd = bytes + messageSize;
+    for (uint32_t i = 0; i < fieldCount; ++i) {
+        if (static_cast<size_t>(payloadEnd - pos) < FieldHeaderSize) {
+            return Status::Invalid;
+        }
+        const uint64_t stringBytes =
+                (static_cast<uint64_t>(Detail::load(pos, 4)) + Detail::load(pos + 4, 4))
+                * sizeof(char16_t);
+        pos += FieldHeaderSize;
+        if (stringBytes > static_cast<uint64_t>(payloadEnd - pos)) {
+            return Status::Invalid;
+        }
+        pos += stringBytes;
+    }
+    if (pos != payloadEnd) {
+        return Status::Invalid;
+    }
+    out.m_fields = bytes + headerSize;
+    out.m_fieldCount = fieldCount;
+    out.m_size = messageSize;
+    out.m_action = static_cast<SnoreToastActions::Actions>(action);
+    return Status::Ok;
+}
+}
@@ -0,0 +1,234 @@
+/*
+    SnoreToast is capable to invoke Windows 8 toast notifications.
+    Copyright (C) 2026  Hannah von Reth <vonreth@kde.org>
+
+    SnoreToast is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    SnoreToast is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with SnoreToast.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "snoretoastreceiver_p.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace {
+// the size of the reads, the buffer only grows for larger messages
+constexpr size_t READ_SIZE = 64 * 1024;
+
+size_t handlerIndex(SnoreToastActions::Actions action)
+{
+    return static_cast<size_t>(static_cast<int>(action) + 1);
+}
+
+// % ; and = are escaped in the protocol 1 values
+char16_t unescape(std::u16string_view escaped)
+{
+    if (escaped == u"%25") {
+        return u'%';
+    } else if (escaped == u"%3B") {
+        return u';';
+    } else if (escaped == u"%3D") {
+        return u'=';
+    }
+    return 0;
+}
+}
+
+char *ReceiverStream::reserve(size_t minimum, size_t &available)
+{
+    if (m_begin > 0) {
+        // move the incomplete message to the front
+        std::memmove(m_buffer.data(), m_buffer.data() + m_begin, m_end - m_begin);
+        m_end -= m_begin;
+        m_scanned = m_scanned > m_begin ? m_scanned - m_begin : 0;
+        m_begin = 0;
+    }
+    if (m_buffer.size() - m_end < minimum) {
+        m_buffer.resize(std::max(m_buffer.size() * 2, m_end + std::max(minimum, READ_SIZE)));
+    }
+    available = m_buffer.size() - m_end;
+    return m_buffer.data() + m_end;
+}
+
+void ReceiverStream::commit(size_t bytes)
+{
+    m_end += bytes;
+}
+
+void ReceiverStream::reset()
+{
+    m_begin = 0;
+    m_end = 0;
+    m_scanned = 0;
+}
+
+bool ReceiverStream::process(SnoreToastReceiverPrivate &receiver, uint64_t connection, bool eof)
+{
+    SnoreToastProtocol::Message message;
+    while (m_begin < m_end) {
+        const char *data = m_buffer.data() + m_begin;
+        const size_t size = m_end - m_begin;
+        if (data[0] == 'S') {
+            switch (SnoreToastProtocol::decode(data, size, message)) {
+            case SnoreToastProtocol::Status::Ok:
+                receiver.dispatch(connection, message);
+                m_begin += message.size();
+                continue;
+            case SnoreToastProtocol::Status::Incomplete:
+                return !eof;
+            case SnoreToastProtocol::Status::Invalid:
+                return false;
+            }
+        }
+
+        // protocol 1, a null terminated UTF-16 string
+        const auto text = reinterpret_cast<const char16_t *>(data);
+        const size_t units = size / sizeof(char16_t);
+        size_t length = std::max(m_scanned, m_begin) - m_begin;
+        length /= sizeof(char16_t);
+        while (length < units && text[length] != 0) {
+            ++length;
+        }
+        if (length == units && !eof) {
+            if (size > SnoreToastProtocol::MaxPayloadSize) {
+                return false;
+            }
+            m_scanned = m_begin + length * sizeof(char16_t);
+            return true;
+        }
+        if (!convert({ text, length })
+            || SnoreToastProtocol::decode(m_converted.data(), m_converted.size(), message)
+                    != SnoreToastProtocol::Status::Ok) {
+            return false;
+        }
+        receiver.dispatch(connection, message);
+        // skip the terminator
+        m_begin += std::min(size, (length + 1) * sizeof(char16_t));
+        m_scanned = m_begin;
+    }
+    return true;
+}
+
+bool ReceiverStream::convert(std::u16string_view message)
+{
+    auto action = SnoreToastActions::Actions::Error;
+    // the action is part of the header, find it first
+    for (size_t start = 0; start < message.size();) {
+        const size_t end = std::min(message.find(u';', start), message.size());
+        const auto field = message.substr(start, end - start);
+        if (field.substr(0, 7) == u"action=") {
+            action = SnoreToastActions::getAction(field.substr(7));
+            break;
+        }
+        start = end + 1;
+    }
+    if (action == SnoreToastActions::Actions::Error) {
+        return false;
+    }
+
+    m_converted.clear();
+    SnoreToastProtocol::Encoder encoder(m_converted);
+    encoder.begin(action);
+    for (size_t start = 0; start < message.size();) {
+        const size_t end = std::min(message.find(u';', start), message.size());
+        const auto field = message.substr(start, end - start);
+        start = end + 1;
+        const size_t equals = field.find(u'=');
+        if (equals == std::u16string_view::npos || equals == 0) {
+            continue;
+        }
+        const auto key = field.substr(0, equals);
+        auto value = field.substr(equals + 1);
+        if (key == u"action") {
+            continue;
+        }
+        if (value.find(u'%') != std::u16string_view::npos) {
+            m_unescaped.clear();
+            for (size_t i = 0; i < value.size(); ++i) {
+                const char16_t c = value[i] == u'%' ? unescape(value.substr(i, 3)) : 0;
+                if (c) {
+                    m_unescaped.push_back(c);
+                    i += 2;
+                } else {
+                    m_unescaped.push_back(value[i]);
+                }
+            }
+            value = m_unescaped;
+        }
+        encoder.addField(key, value);
+    }
+    encoder.end();
+    return true;
+}
+
+void SnoreToastReceiverPrivate::dispatch(uint64_t connection,
+                                         const SnoreToastProtocol::Message &message)
+{
+    ++m_statistics.events;
+    const auto &handler = m_handlers[handlerIndex(message.action())];
+    const SnoreToastEvent event(connection, message);
+    if (handler) {
+        handler(event);
+    } else if (m_defaultHandler) {
+        m_defaultHandler(event);
+    }
+}
+
+SnoreToastReceiver::SnoreToastReceiver() : d(new SnoreToastReceiverPrivate) { }
+
+SnoreToastReceiver::~SnoreToastReceiver()
+{
+    delete d;
+}
+
+void SnoreToastReceiver::setHandler(Handler handler)
+{
+    d->m_defaultHandler = std::move(handler);
+}
+
+void SnoreToastReceiver::setHandler(SnoreToastActions::Actions action, Handler handler)
+{
+    d->m_handlers[handlerIndex(action)] = std::move(handler);
+}
+
+bool SnoreToastReceiver::listen(const std::filesystem::path &name)
+{
+    return d->m_loop.listen(name);
+}
+
+void SnoreToastReceiver::run()
+{
+    while (!d->m_stop) {
+        d->m_loop.poll(std::chrono::milliseconds(-1));
+    }
+    d->m_stop = false;
+}
+
+size_t SnoreToastReceiver::poll(std::chrono::milliseconds timeout)
+{
+    return d->m_loop.poll(timeout);
+}
+
+void SnoreToastReceiver::stop()
+{
+    d->m_stop = true;
+    d->m_loop.wake();
+}
+
+SnoreToastReceiver::Statistics SnoreToastReceiver::statistics() const
+{
+    Statistics out;
+    out.connections = d->m_statistics.connections;
+    out.events = d->m_statistics.events;
+    out.errors = d->m_statistics.errors;
+    return out;
+}
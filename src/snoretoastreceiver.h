@@ -0,0 +1,129 @@
+/*
+    SnoreToast is capable to invoke Windows 8 toast notifications.
+    Copyright (C) 2026  Hannah von Reth <vonreth@kde.org>
+
+    SnoreToast is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    SnoreToast is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with SnoreToast.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#pragma once
+
+#include "snoretoastactions.h"
+#include "snoretoastprotocol.h"
+
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <string_view>
+
+/**
+ * A callback received from SnoreToast, only valid during the handler call.
+ */
+class SnoreToastEvent
+{
+public:
+    SnoreToastEvent(uint64_t connection, const SnoreToastProtocol::Message &message)
+        : m_connection(connection), m_message(message)
+    {
+    }
+
+    SnoreToastActions::Actions action() const { return m_message.action(); }
+
+    /**
+     * Identifies the connection the event was received on, unique for the receiver.
+     */
+    uint64_t connection() const { return m_connection; }
+
+    std::u16string_view notificationId() const { return m_message.value(u"notificationId"); }
+    // the button of Actions::ButtonClicked
+    std::u16string_view button() const { return m_message.value(u"button"); }
+    // the reply of Actions::TextEntered
+    std::u16string_view text() const { return m_message.value(u"text"); }
+
+    std::u16string_view value(std::u16string_view key) const { return m_message.value(key); }
+
+    /**
+     * All fields, the values of protocol 1 callbacks are unescaped.
+     */
+    const SnoreToastProtocol::Message &message() const { return m_message; }
+
+private:
+    uint64_t m_connection;
+    const SnoreToastProtocol::Message &m_message;
+};
+
+class SnoreToastReceiverPrivate;
+
+/**
+ * The receiving end of the SnoreToast -pipeName.
+ *
+ * Accepts any number of concurrent connections on a single thread, with IOCP on Windows and
+ * epoll on Linux, and dispatches the callbacks to the handlers. Protocol 1 and protocol 2
+ * callbacks are understood, a connection may carry any number of them. Connections and their
+ * buffers are reused, receiving doesn't allocate once the buffers are large enough.
+ *
+ *   SnoreToastReceiver receiver;
+ *   receiver.setHandler(SnoreToastActions::Actions::ButtonClicked,
+ *                       [](const SnoreToastEvent &event) { ... });
+ *   receiver.listen(L"\\\\.\\pipe\\myapp");
+ *   receiver.run();
+ *
+ * On Windows name is the name of a pipe, on Linux the path of a unix domain socket.
+ * Protocol 1 callbacks are expected in UTF-16, as written by SnoreToast on Windows.
+ */
+class SnoreToastReceiver
+{
+public:
+    using Handler = std::function<void(const SnoreToastEvent &)>;
+
+    struct Statistics
+    {
+        uint64_t connections = 0; // accepted
+        uint64_t events = 0; // dispatched
+        uint64_t errors = 0; // connections closed because of invalid data
+    };
+
+    SnoreToastReceiver();
+    ~SnoreToastReceiver();
+
+    SnoreToastReceiver(const SnoreToastReceiver &) = delete;
+    SnoreToastReceiver &operator=(const SnoreToastReceiver &) = delete;
+
+    /**
+     * Called for every event without a handler for its action.
+     */
+    void setHandler(Handler handler);
+    void setHandler(SnoreToastActions::Actions action, Handler handler);
+
+    bool listen(const std::filesystem::path &name);
+
+    /**
+     * Dispatches the events until stop() is called.
+     */
+    void run();
+    /**
+     * Handles the pending io, waits at most timeout for it.
+     * Returns the number of dispatched events.
+     */
+    size_t poll(std::chrono::milliseconds timeout);
+    /**
+     * Ends run(), can be called from any thread.
+     */
+    void stop();
+
+    Statistics statistics() const;
+
+private:
+    friend class SnoreToastReceiverPrivate;
+    SnoreToastReceiverPrivate *d;
+};
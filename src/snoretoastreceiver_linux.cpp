@@ -0,0 +1,229 @@
+/*
+    SnoreToast is capable to invoke Windows 8 toast notifications.
+    Copyright (C) 2026  Hannah von Reth <vonreth@kde.org>
+
+    SnoreToast is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    SnoreToast is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with SnoreToast.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "snoretoastreceiver_p.h"
+
+#include <cerrno>
+#include <cstring>
+#include <vector>
+
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace {
+constexpr int MAX_EVENTS = 64;
+constexpr size_t MIN_READ_SIZE = 4096;
+
+struct Connection
+{
+    int fd = -1;
+    uint64_t id = 0;
+    ReceiverStream stream;
+};
+}
+
+class ReceiverEventLoop::Private
+{
+public:
+    explicit Private(SnoreToastReceiverPrivate &receiver)
+        : m_receiver(receiver),
+          m_epoll(::epoll_create1(EPOLL_CLOEXEC)),
+          m_wake(::eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK))
+    {
+        if (m_epoll >= 0 && m_wake >= 0) {
+            epoll_event event = {};
+            event.events = EPOLLIN;
+            event.data.ptr = &m_wake;
+            ::epoll_ctl(m_epoll, EPOLL_CTL_ADD, m_wake, &event);
+        }
+    }
+
+    ~Private()
+    {
+        for (auto &connection : m_connections) {
+            if (connection->fd >= 0) {
+                ::close(connection->fd);
+            }
+        }
+        if (m_listener >= 0) {
+            ::close(m_listener);
+            ::unlink(m_path.c_str());
+        }
+        if (m_wake >= 0) {
+            ::close(m_wake);
+        }
+        if (m_epoll >= 0) {
+            ::close(m_epoll);
+        }
+    }
+
+    bool listen(const std::filesystem::path &name)
+    {
+        const std::string path = name.string();
+        sockaddr_un address = {};
+        address.sun_family = AF_UNIX;
+        if (m_epoll < 0 || m_listener >= 0 || path.size() >= sizeof(address.sun_path)) {
+            return false;
+        }
+        std::memcpy(address.sun_path, path.c_str(), path.size() + 1);
+        const int fd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC | SOCK_NONBLOCK, 0);
+        if (fd < 0) {
+            return false;
+        }
+        // remove a stale socket of a previous instance
+        ::unlink(address.sun_path);
+        epoll_event event = {};
+        event.events = EPOLLIN;
+        event.data.ptr = &m_listener;
+        if (::bind(fd, reinterpret_cast<sockaddr *>(&address), sizeof(address)) != 0
+            || ::listen(fd, SOMAXCONN) != 0
+            || ::epoll_ctl(m_epoll, EPOLL_CTL_ADD, fd, &event) != 0) {
+            ::close(fd);
+            return false;
+        }
+        m_listener = fd;
+        m_path = path;
+        return true;
+    }
+
+    size_t poll(std::chrono::milliseconds timeout)
+    {
+        if (m_epoll < 0) {
+            return 0;
+        }
+        const uint64_t events = m_receiver.m_statistics.events;
+        epoll_event ready[MAX_EVENTS];
+        const int wait = timeout.count() < 0 ? -1 : static_cast<int>(timeout.count());
+        const int count = ::epoll_wait(m_epoll, ready, MAX_EVENTS, wait);
+        for (int i = 0; i < count; ++i) {
+            if (ready[i].data.ptr == &m_wake) {
+                uint64_t value;
+                while (::read(m_wake, &value, sizeof(value)) > 0) { }
+            } else if (ready[i].data.ptr == &m_listener) {
+                accept();
+            } else {
+                read(*static_cast<Connection *>(ready[i].data.ptr));
+            }
+        }
+        return static_cast<size_t>(m_receiver.m_statistics.events - events);
+    }
+
+    void wake()
+    {
+        if (m_wake >= 0) {
+            const uint64_t value = 1;
+            [[maybe_unused]] const auto written = ::write(m_wake, &value, sizeof(value));
+        }
+    }
+
+private:
+    void accept()
+    {
+        while (true) {
+            const int fd = ::accept4(m_listener, nullptr, nullptr, SOCK_CLOEXEC | SOCK_NONBLOCK);
+            if (fd < 0) {
+                if (errno == EINTR || errno == ECONNABORTED) {
+                    continue;
+                }
+                return;
+            }
+            Connection *connection;
+            if (m_free.empty()) {
+                m_connections.push_back(std::make_unique<Connection>());
+                connection = m_connections.back().get();
+            } else {
+                connection = m_free.back();
+                m_free.pop_back();
+            }
+            connection->fd = fd;
+            connection->id = m_receiver.nextConnection();
+            epoll_event event = {};
+            event.events = EPOLLIN | EPOLLRDHUP;
+            event.data.ptr = connection;
+            if (::epoll_ctl(m_epoll, EPOLL_CTL_ADD, fd, &event) != 0) {
+                close(*connection);
+            }
+        }
+    }
+
+    // level triggered, a single read per wake up keeps the connections fair
+    void read(Connection &connection)
+    {
+        size_t available;
+        char *buffer = connection.stream.reserve(MIN_READ_SIZE, available);
+        ssize_t r;
+        do {
+            r = ::recv(connection.fd, buffer, available, 0);
+        } while (r < 0 && errno == EINTR);
+        if (r < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            return;
+        }
+        const bool eof = r <= 0;
+        if (!eof) {
+            connection.stream.commit(static_cast<size_t>(r));
+        }
+        if (!connection.stream.process(m_receiver, connection.id, eof)) {
+            m_receiver.error();
+            close(connection);
+        } else if (eof) {
+            close(connection);
+        }
+    }
+
+    void close(Connection &connection)
+    {
+        ::epoll_ctl(m_epoll, EPOLL_CTL_DEL, connection.fd, nullptr);
+        ::close(connection.fd);
+        connection.fd = -1;
+        connection.stream.reset();
+        m_free.push_back(&connection);
+    }
+
+    SnoreToastReceiverPrivate &m_receiver;
+    int m_epoll;
+    int m_wake;
+    int m_listener = -1;
+    std::string m_path;
+    // the connections are reused with their buffers
+    std::vector<std::unique_ptr<Connection>> m_connections;
+    std::vector<Connection *> m_free;
+};
+
+ReceiverEventLoop::ReceiverEventLoop(SnoreToastReceiverPrivate &receiver)
+    : d(std::make_unique<Private>(receiver))
+{
+}
+
+ReceiverEventLoop::~ReceiverEventLoop() = default;
+
+bool ReceiverEventLoop::listen(const std::filesystem::path &name)
+{
+    return d->listen(name);
+}
+
+size_t ReceiverEventLoop::poll(std::chrono::milliseconds timeout)
+{
+    return d->poll(timeout);
+}
+
+void ReceiverEventLoop::wake()
+{
+    d->wake();
+}
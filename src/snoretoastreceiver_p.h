@@ -0,0 +1,104 @@
+/*
+    SnoreToast is capable to invoke Windows 8 toast notifications.
+    Copyright (C) 2026  Hannah von Reth <vonreth@kde.org>
+
+    SnoreToast is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    SnoreToast is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with SnoreToast.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#pragma once
+
+#include "snoretoastreceiver.h"
+
+#include <array>
+#include <atomic>
+#include <memory>
+#include <string>
+
+class SnoreToastReceiverPrivate;
+
+/**
+ * The receive buffer of a connection, splits the received bytes into messages.
+ * The buffer is kept when the connection is reused.
+ */
+class ReceiverStream
+{
+public:
+    /**
+     * Returns the free space at the end of the buffer, at least minimum bytes.
+     */
+    char *reserve(size_t minimum, size_t &available);
+    void commit(size_t bytes);
+
+    /**
+     * Dispatches all complete messages, at eof the rest of a protocol 1 message too.
+     * Returns false if the data is invalid and the connection should be closed.
+     */
+    bool process(SnoreToastReceiverPrivate &receiver, uint64_t connection, bool eof);
+
+    void reset();
+
+private:
+    // converts the protocol 1 message to protocol 2 in m_converted
+    bool convert(std::u16string_view message);
+
+    std::string m_buffer;
+    size_t m_begin = 0;
+    size_t m_end = 0;
+    // the part of a protocol 1 message already searched for the terminator
+    size_t m_scanned = 0;
+    std::string m_converted;
+    std::u16string m_unescaped;
+};
+
+/**
+ * Implemented with IOCP on Windows and with epoll on Linux.
+ */
+class ReceiverEventLoop
+{
+public:
+    explicit ReceiverEventLoop(SnoreToastReceiverPrivate &receiver);
+    ~ReceiverEventLoop();
+
+    bool listen(const std::filesystem::path &name);
+    // a negative timeout waits until io is pending or wake() was called
+    size_t poll(std::chrono::milliseconds timeout);
+    void wake();
+
+private:
+    class Private;
+    std::unique_ptr<Private> d;
+};
+
+class SnoreToastReceiverPrivate
+{
+public:
+    SnoreToastReceiverPrivate() : m_loop(*this) { }
+
+    void dispatch(uint64_t connection, const SnoreToastProtocol::Message &message);
+    uint64_t nextConnection() { return ++m_statistics.connections; }
+    void error() { ++m_statistics.errors; }
+
+    // indexed by action + 1, Actions::Error is -1
+    std::array<SnoreToastReceiver::Handler, 7> m_handlers;
+    SnoreToastReceiver::Handler m_defaultHandler;
+
+    struct
+    {
+        std::atomic<uint64_t> connections = 0;
+        std::atomic<uint64_t> events = 0;
+        std::atomic<uint64_t> errors = 0;
+    } m_statistics;
+    std::atomic<bool> m_stop = false;
+
+    ReceiverEventLoop m_loop;
+};
@@ -0,0 +1,237 @@
+/*
+    SnoreToast is capable to invoke Windows 8 toast notifications.
+    Copyright (C) 2026  Hannah von Reth <vonreth@kde.org>
+
+    SnoreToast is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    SnoreToast is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with SnoreToast.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "snoretoastreceiver_p.h"
+
+#include <windows.h>
+
+#include <vector>
+
+namespace {
+constexpr DWORD PIPE_BUFFER_SIZE = 64 * 1024;
+constexpr size_t MIN_READ_SIZE = 4096;
+// pipe instances waiting for a client, more are created when they are all connected
+constexpr size_t LISTENING_INSTANCES = 4;
+constexpr ULONG MAX_ENTRIES = 64;
+constexpr ULONG_PTR WAKE_KEY = 1;
+
+struct Instance
+{
+    OVERLAPPED overlapped = {};
+    HANDLE pipe = INVALID_HANDLE_VALUE;
+    bool connected = false;
+    uint64_t id = 0;
+    ReceiverStream stream;
+};
+}
+
+class ReceiverEventLoop::Private
+{
+public:
+    explicit Private(SnoreToastReceiverPrivate &receiver)
+        : m_receiver(receiver),
+          m_port(CreateIoCompletionPort(INVALID_HANDLE_VALUE, nullptr, 0, 1))
+    {
+    }
+
+    ~Private()
+    {
+        for (auto &instance : m_instances) {
+            // wait for the cancelled io, it still references the instance
+            if (CancelIoEx(instance->pipe, &instance->overlapped)
+                || GetLastError() != ERROR_NOT_FOUND) {
+                DWORD transferred;
+                GetOverlappedResult(instance->pipe, &instance->overlapped, &transferred, true);
+            }
+            CloseHandle(instance->pipe);
+        }
+        if (m_port) {
+            CloseHandle(m_port);
+        }
+    }
+
+    bool listen(const std::filesystem::path &name)
+    {
+        if (!m_port || !m_name.empty()) {
+            return false;
+        }
+        m_name = name.wstring();
+        for (size_t i = 0; i < LISTENING_INSTANCES; ++i) {
+            if (!addInstance()) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    size_t poll(std::chrono::milliseconds timeout)
+    {
+        if (!m_port) {
+            return 0;
+        }
+        const uint64_t events = m_receiver.m_statistics.events;
+        OVERLAPPED_ENTRY entries[MAX_ENTRIES];
+        ULONG count = 0;
+        if (!GetQueuedCompletionStatusEx(
+                    m_port, entries, MAX_ENTRIES, &count,
+                    timeout.count() < 0 ? INFINITE : static_cast<DWORD>(timeout.count()), false)) {
+            return 0;
+        }
+        for (ULONG i = 0; i < count; ++i) {
+            if (entries[i].lpCompletionKey == WAKE_KEY) {
+                continue;
+            }
+            auto &instance = *CONTAINING_RECORD(entries[i].lpOverlapped, Instance, overlapped);
+            DWORD transferred;
+            const bool ok = GetOverlappedResult(instance.pipe, &instance.overlapped,
+                                                &transferred, false);
+            if (!instance.connected) {
+                if (ok) {
+                    connected(instance);
+                } else {
+                    reconnect(instance);
+                }
+            } else {
+                if (ok) {
+                    instance.stream.commit(transferred);
+                }
+                // ERROR_BROKEN_PIPE, the client closed its end
+                if (!instance.stream.process(m_receiver, instance.id, !ok)) {
+                    m_receiver.error();
+                    reconnect(instance);
+                } else if (!ok) {
+                    reconnect(instance);
+                } else {
+                    read(instance);
+                }
+            }
+        }
+        return static_cast<size_t>(m_receiver.m_statistics.events - events);
+    }
+
+    void wake()
+    {
+        if (m_port) {
+            PostQueuedCompletionStatus(m_port, 0, WAKE_KEY, nullptr);
+        }
+    }
+
+private:
+    bool addInstance()
+    {
+        auto instance = std::make_unique<Instance>();
+        instance->pipe = CreateNamedPipeW(
+                m_name.c_str(),
+                PIPE_ACCESS_INBOUND | FILE_FLAG_OVERLAPPED
+                        | (m_instances.empty() ? FILE_FLAG_FIRST_PIPE_INSTANCE : 0),
+                PIPE_TYPE_BYTE | PIPE_READMODE_BYTE | PIPE_WAIT | PIPE_REJECT_REMOTE_CLIENTS,
+                PIPE_UNLIMITED_INSTANCES, 0, PIPE_BUFFER_SIZE, 0, nullptr);
+        if (instance->pipe == INVALID_HANDLE_VALUE) {
+            return false;
+        }
+        if (!CreateIoCompletionPort(instance->pipe, m_port, 0, 0)) {
+            CloseHandle(instance->pipe);
+            return false;
+        }
+        m_instances.push_back(std::move(instance));
+        connect(*m_instances.back());
+        return true;
+    }
+
+    void connect(Instance &instance)
+    {
+        instance.connected = false;
+        instance.overlapped = {};
+        ++m_listening;
+        if (!ConnectNamedPipe(instance.pipe, &instance.overlapped)) {
+            switch (GetLastError()) {
+            case ERROR_IO_PENDING:
+                return;
+            case ERROR_PIPE_CONNECTED:
+                // no completion is queued for a client that connected in between
+                connected(instance);
+                return;
+            default:
+                --m_listening;
+                break;
+            }
+        }
+    }
+
+    void connected(Instance &instance)
+    {
+        --m_listening;
+        instance.connected = true;
+        instance.id = m_receiver.nextConnection();
+        if (m_listening == 0) {
+            addInstance();
+        }
+        read(instance);
+    }
+
+    void read(Instance &instance)
+    {
+        size_t available;
+        char *buffer = instance.stream.reserve(MIN_READ_SIZE, available);
+        instance.overlapped = {};
+        // the completion is queued even if the read finishes immediately
+        if (!ReadFile(instance.pipe, buffer, static_cast<DWORD>(available), nullptr,
+                      &instance.overlapped)
+            && GetLastError() != ERROR_IO_PENDING) {
+            if (!instance.stream.process(m_receiver, instance.id, true)) {
+                m_receiver.error();
+            }
+            reconnect(instance);
+        }
+    }
+
+    // the instance and its buffer are reused for the next client
+    void reconnect(Instance &instance)
+    {
+        DisconnectNamedPipe(instance.pipe);
+        instance.stream.reset();
+        connect(instance);
+    }
+
+    SnoreToastReceiverPrivate &m_receiver;
+    HANDLE m_port;
+    std::wstring m_name;
+    std::vector<std::unique_ptr<Instance>> m_instances;
+    size_t m_listening = 0;
+};
+
+ReceiverEventLoop::ReceiverEventLoop(SnoreToastReceiverPrivate &receiver)
+    : d(std::make_unique<Private>(receiver))
+{
+}
+
+ReceiverEventLoop::~ReceiverEventLoop() = default;
+
+bool ReceiverEventLoop::listen(const std::filesystem::path &name)
+{
+    return d->listen(name);
+}
+
+size_t ReceiverEventLoop::poll(std::chrono::milliseconds timeout)
+{
+    return d->poll(timeout);
+}
+
+void ReceiverEventLoop::wake()
+{
+    d->wake();
+}
@@ -17,54 +17,184 @@
 */
 
 #include "snoretoasts.h"
-#include "toasteventhandler.h"
-#include "linkhelper.h"
-#include "utils.h"
+#include "actionformatter.h"
+#include "callbackdata.h"
+#include "callbackwriter.h"
+#include "deliveryqueue.h"
+#include "imagecache.h"
+#include "snoretoastprotocol.h"
+#include "textkernels.h"
+#include "toastlog.h"
+#include "toasttrace.h"
 #include "config.h"
 
-#include <wrl\wrappers\corewrappers.h>
-#include <sstream>
+#include <atomic>
+#include <cstdint>
+#include <cassert>
+#include <chrono>
+#include <condition_variable>
 #include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
 
-using namespace Microsoft::WRL;
-using namespace ABI::Windows::UI;
-using namespace ABI::Windows::UI::Notifications;
-using namespace ABI::Windows::Data::Xml::Dom;
-using namespace Windows::Foundation;
-using namespace Wrappers;
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <unistd.h>
+#endif
 
 namespace {
-constexpr DWORD EVENT_TIMEOUT = 60 * 1000; // one minute should be more than enough
+constexpr auto EVENT_TIMEOUT = std::chrono::minutes(1); // one minute should be more than enough
+
+unsigned long currentProcessId()
+{
+#ifdef _WIN32
+    return GetCurrentProcessId();
+#else
+    return static_cast<unsigned long>(getpid());
+#endif
+}
+
+/**
+ * The pid for the first instance, like before there could be more than one toast per process,
+ * the pid followed by a counter for the others.
+ */
+std::wstring defaultId()
+{
+    static std::atomic<uint64_t> instances = 0;
+    const uint64_t n = instances++;
+    std::wstring id = std::to_wstring(currentProcessId());
+    if (n > 0) {
+        id.append(L".").append(std::to_wstring(n));
+    }
+    return id;
 }
 
-class SnoreToastsPrivate
+/**
+ * Encodes the callback data for the pipe.
+ * Version 1 is the null terminated string, version 2 is described in SnoreToastProtocol.
+ */
+std::string pipeMessage(std::wstring_view data, unsigned protocol)
+{
+    std::string out;
+    if (protocol < SnoreToastProtocol::Version) {
+        out.reserve((data.size() + 1) * sizeof(wchar_t));
+        out.append(reinterpret_cast<const char *>(data.data()), data.size() * sizeof(wchar_t));
+        out.append(sizeof(wchar_t), '\0');
+        return out;
+    }
+    const CallbackData fields(data);
+    SnoreToastProtocol::Encoder encoder(out);
+    encoder.begin(SnoreToastActions::getAction(fields.value(L"action")));
+    for (const auto &field : fields) {
+        // the action is part of the header and the protocol is implied
+        if (field.first != L"action" && field.first != L"protocol") {
+            encoder.addField(field.first, field.second);
+        }
+    }
+    encoder.end();
+    return out;
+}
+
+unsigned pipeProtocol(const CallbackData &data)
+{
+    return data.value(L"protocol") == L"2" ? SnoreToastProtocol::Version : 1;
+}
+
+/**
+ * The delivery queue of backgroundCallback, one per backend.
+ */
+DeliveryQueue &deliveryQueue(NotificationBackend *backend)
+{
+    static std::mutex mutex;
+    static std::map<NotificationBackend *, std::unique_ptr<DeliveryQueue>> queues;
+    std::scoped_lock lock(mutex);
+    auto &queue = queues[backend];
+    if (!queue) {
+        queue = std::make_unique<DeliveryQueue>(backend);
+        queue->start();
+    }
+    return *queue;
+}
+
+/**
+ * The toasts shown by the process, one registry per backend.
+ */
+ToastRegistry &toastRegistry(NotificationBackend *backend)
+{
+    static std::mutex mutex;
+    static std::map<NotificationBackend *, std::unique_ptr<ToastRegistry>> registries;
+    std::scoped_lock lock(mutex);
+    auto &registry = registries[backend];
+    if (!registry) {
+        registry = std::make_unique<ToastRegistry>();
+    }
+    return *registry;
+}
+
+/**
+ * Downscaled images of all toasts, next to the logo written by the application.
+ */
+ImageCache &imageCache()
+{
+    static ImageCache cache(std::filesystem::temp_directory_path() / "snoretoast"
+                            / SnoreToasts::version() / "images");
+    return cache;
+}
+
+/**
+ * Signaled by backgroundCallback to end waitForCallbackActivation.
+ */
+class CallbackActivation
 {
 public:
-    SnoreToastsPrivate(SnoreToasts *parent, const std::wstring &appID)
-        : m_parent(parent), m_appID(appID), m_id(std::to_wstring(GetCurrentProcessId()))
+    static CallbackActivation &instance()
     {
+        static CallbackActivation _instance;
+        return _instance;
+    }
 
-        ComPtr<IShellItem> app;
-        if (FAILED(SHCreateItemFromParsingName(std::wstring(L"shell:AppsFolder\\" + m_appID).data(),
-                                               nullptr, IID_PPV_ARGS(&app)))) {
-            m_useFallbackMode = true;
-            tLog << "AppUserModelId:" << m_appID
-                 << " is not properly registered. Using fallback mode. Only click actions will be "
-                    "availible";
+    void set()
+    {
+        {
+            std::scoped_lock lock(m_mutex);
+            m_activated = true;
         }
+        m_condition.notify_all();
+    }
 
-        HRESULT hr = GetActivationFactory(
-                HStringReference(RuntimeClass_Windows_UI_Notifications_ToastNotificationManager)
-                        .Get(),
-                &m_toastManager);
-        if (!SUCCEEDED(hr)) {
-            std::wcerr << L"SnoreToasts: Failed to register com Factory, please make sure you "
-                          L"correctly initialised with RO_INIT_MULTITHREADED"
-                       << std::endl;
-            m_action = SnoreToastActions::Actions::Error;
-        }
+    void wait()
+    {
+        std::unique_lock lock(m_mutex);
+        m_condition.wait_for(lock, EVENT_TIMEOUT, [this] { return m_activated; });
+    }
+
+private:
+    std::mutex m_mutex;
+    std::condition_variable m_condition;
+    bool m_activated = false;
+};
+}
+
+class SnoreToastsPrivate : public NotificationListener
+{
+public:
+    SnoreToastsPrivate(SnoreToasts *parent, NotificationBackend *backend,
+                       const std::wstring &appID)
+        : m_parent(parent),
+          m_backend(backend),
+          m_registry(toastRegistry(backend)),
+          m_appID(appID),
+          m_id(defaultId())
+    {
+        updateFormatter();
     }
     SnoreToasts *m_parent;
+    NotificationBackend *m_backend;
+    ToastRegistry &m_registry;
 
     std::wstring m_appID;
     std::filesystem::path m_pipeName;
@@ -75,416 +205,468 @@ public:
     std::filesystem::path m_image;
     std::wstring m_sound = L"Notification.Default";
     std::wstring m_id;
+    std::wstring m_group = L"SnoreToast";
     std::wstring m_buttons;
+    ActionFormatter m_formatter;
+    unsigned m_protocol = 1;
+    CallbackWriter *m_callbackWriter = nullptr;
     bool m_silent = false;
     bool m_textbox = false;
 
+    // the content of the last toast, the arguments are only formatted again when one of the
+    // setters changed them, a repeated display only rewrites title, body and image
+    ToastContent m_content;
+    bool m_contentChanged = true;
+
+    // queried by fallbackMode(), the lookup of the shortcut is slow
+    std::once_flag m_registrationChecked;
     bool m_useFallbackMode = false;
+    // only toasts with buttons or a text box need the activator
+    bool m_activatorRegistered = false;
 
     Duration m_duration = Duration::Short;
 
     SnoreToastActions::Actions m_action = SnoreToastActions::Actions::Clicked;
 
-    ComPtr<IXmlDocument> m_toastXml;
-    ComPtr<IToastNotificationManagerStatics> m_toastManager;
-    ComPtr<IToastNotifier> m_notifier;
-    ComPtr<IToastNotification> m_notification;
+    // set by the listener
+    std::mutex m_eventMutex;
+    std::condition_variable m_eventCondition;
+    bool m_hasListener = false;
+    bool m_finished = false;
+    SnoreToastActions::Actions m_userAction = SnoreToastActions::Actions::Hidden;
+    // the id of the toast the events belong to, setId() doesn't change it until the next
+    // displayToast()
+    std::wstring m_displayedId;
+    std::function<void()> m_finishedCallback;
+
+    void finish(SnoreToastActions::Actions action)
+    {
+        std::function<void()> callback;
+        {
+            std::scoped_lock lock(m_eventMutex);
+            // a toast can report more than one event, keep the first result
+            if (m_finished) {
+                return;
+            }
+            m_userAction = action;
+            m_finished = true;
+            // a timed out toast stays in the action center
+            if (action != SnoreToastActions::Actions::Timedout) {
+                m_registry.remove(m_appID, m_displayedId);
+            }
+            callback = m_finishedCallback;
+        }
+        m_eventCondition.notify_all();
+        // last, the callback might destroy the instance
+        if (callback) {
+            callback();
+        }
+    }
+
+    bool close(const std::wstring &id, const std::wstring &group)
+    {
+        const bool closed = m_backend->requestClose(id)
+                || m_backend->removeFromHistory(m_appID, group, id);
+        m_registry.remove(m_appID, id);
+        if (!closed) {
+            tLog << "Notification " << id << " does not exist";
+        }
+        return closed;
+    }
 
-    ComPtr<ToastEventHandler> m_eventHanlder;
+    size_t close(const std::vector<ToastRegistry::Entry> &entries)
+    {
+        size_t closed = 0;
+        for (const auto &entry : entries) {
+            closed += close(entry.id, entry.group) ? 1 : 0;
+        }
+        return closed;
+    }
+
+    // picks up the toasts of other processes and drops the ones that left the action center
+    void reconcile()
+    {
+        ST_TRACE("ToastRegistry::reconcile");
+        m_registry.reconcile(m_appID, m_backend->history(m_appID));
+    }
+
+    bool fallbackMode()
+    {
+        std::call_once(m_registrationChecked, [this] {
+            ST_TRACE("NotificationBackend::isRegistered");
+            m_useFallbackMode = !m_backend->isRegistered(m_appID);
+            if (m_useFallbackMode) {
+                tLog << "AppUserModelId:" << m_appID
+                     << " is not properly registered. Using fallback mode. Only click actions "
+                        "will be availible";
+            }
+        });
+        return m_useFallbackMode;
+    }
 
-    static HANDLE ctoastEvent()
+    // the formatter caches id, pipe, application and protocol
+    void updateFormatter()
     {
-        static HANDLE _event = [] {
-            std::wstringstream eventName;
-            eventName << L"ToastActivationEvent" << GetCurrentProcessId();
-            return CreateEvent(nullptr, true, false, eventName.str().c_str());
-        }();
-        return _event;
+        m_formatter.setToast(m_id, m_pipeName, m_application, m_protocol);
+        m_contentChanged = true;
     }
 
-    ComPtr<IToastNotificationHistory> getHistory()
+    void writePipe(SnoreToastActions::Actions action)
     {
-        ComPtr<IToastNotificationManagerStatics2> toastStatics2;
-        if (ST_CHECK_RESULT(m_toastManager.As(&toastStatics2))) {
-            ComPtr<IToastNotificationHistory> nativeHistory;
-            ST_CHECK_RESULT(toastStatics2->get_History(&nativeHistory));
-            return nativeHistory;
+        ST_TRACE("SnoreToasts::writePipe");
+        auto message = pipeMessage(m_parent->formatAction(action), m_protocol);
+        if (m_callbackWriter) {
+            m_callbackWriter->post(m_pipeName, std::move(message), m_application);
+        } else {
+            m_backend->writePipe(m_pipeName, message);
+        }
+    }
+
+    // NotificationListener
+    void activated(std::wstring_view arguments) override
+    {
+        tLog << arguments;
+        const CallbackData data(arguments);
+        const auto action = SnoreToastActions::getAction(data.value(L"action"));
+        assert(data.value(L"notificationId") == m_displayedId);
+
+        SnoreToastActions::Actions userAction;
+        if (action == SnoreToastActions::Actions::TextEntered) {
+            // The text is only passed to the named pipe
+            tLog << L"The user entered a text.";
+            userAction = SnoreToastActions::Actions::TextEntered;
+        } else if (action == SnoreToastActions::Actions::Clicked) {
+            tLog << L"The user clicked on the toast.";
+            userAction = SnoreToastActions::Actions::Clicked;
+        } else {
+            tLog << L"The user clicked on a toast button.";
+            std::wcout << data.value(L"button") << std::endl;
+            userAction = SnoreToastActions::Actions::ButtonClicked;
+        }
+        if (!m_pipeName.empty() && fallbackMode()) {
+            writePipe(userAction);
+        }
+        finish(userAction);
+    }
+
+    void dismissed(DismissalReason reason) override
+    {
+        SnoreToastActions::Actions userAction = SnoreToastActions::Actions::Hidden;
+        switch (reason) {
+        case DismissalReason::ApplicationHidden:
+            tLog << L"The application hid the toast using ToastNotifier.hide()";
+            userAction = SnoreToastActions::Actions::Hidden;
+            break;
+        case DismissalReason::UserCanceled:
+            tLog << L"The user dismissed this toast";
+            userAction = SnoreToastActions::Actions::Dismissed;
+            break;
+        case DismissalReason::TimedOut:
+            tLog << L"The toast has timed out";
+            userAction = SnoreToastActions::Actions::Timedout;
+            break;
         }
-        return {};
+        if (!m_pipeName.empty()) {
+            writePipe(userAction);
+        }
+        finish(userAction);
+    }
+
+    void failed() override
+    {
+        std::wcerr << L"The toast encountered an error." << std::endl;
+        std::wcerr << L"Please make sure that the app id is set correctly." << std::endl;
+        finish(SnoreToastActions::Actions::Error);
+    }
+
+    void closeRequested() override
+    {
+        // Hidden results in a hide of the toast in userAction
+        finish(SnoreToastActions::Actions::Hidden);
+    }
+
+    void replaced() override
+    {
+        // the toast is gone, the hide in userAction leaves the replacing toast alone
+        tLog << L"The toast was replaced by a toast with the same id";
+        if (!m_pipeName.empty()) {
+            writePipe(SnoreToastActions::Actions::Hidden);
+        }
+        finish(SnoreToastActions::Actions::Hidden);
     }
 };
 
-SnoreToasts::SnoreToasts(const std::wstring &appID) : d(new SnoreToastsPrivate(this, appID))
+SnoreToasts::SnoreToasts(NotificationBackend *backend, const std::wstring &appID)
+    : d(new SnoreToastsPrivate(this, backend, appID))
 {
-    Utils::registerActivator();
 }
 
 SnoreToasts::~SnoreToasts()
 {
-    Utils::unregisterActivator();
+    d->m_backend->release(d->m_displayedId, d);
+    if (d->m_activatorRegistered) {
+        d->m_backend->unregisterActivator();
+    }
     delete d;
 }
 
-HRESULT SnoreToasts::displayToast(const std::wstring &title, const std::wstring &body,
-                                  const std::filesystem::path &image)
+bool SnoreToasts::displayToast(const std::wstring &title, const std::wstring &body,
+                               const std::filesystem::path &image)
 {
+    ST_TRACE("SnoreToasts::displayToast");
     // asume that we fail
     d->m_action = SnoreToastActions::Actions::Error;
 
+    // the instance displays one toast at a time, stop listening to the previous one
+    if (d->m_hasListener) {
+        d->m_backend->release(d->m_displayedId, d);
+    }
+    {
+        std::scoped_lock lock(d->m_eventMutex);
+        d->m_hasListener = false;
+        d->m_finished = false;
+        d->m_userAction = SnoreToastActions::Actions::Hidden;
+    }
+
     d->m_title = title;
     d->m_body = body;
-    d->m_image = std::filesystem::absolute(image);
-
-    if (!d->m_image.empty()) {
-        ST_RETURN_ON_ERROR(d->m_toastManager->GetTemplateContent(
-                ToastTemplateType_ToastImageAndText02, &d->m_toastXml));
-    } else {
-        ST_RETURN_ON_ERROR(d->m_toastManager->GetTemplateContent(ToastTemplateType_ToastText02,
-                                                                 &d->m_toastXml));
-    }
-    ComPtr<ABI::Windows::Data::Xml::Dom::IXmlNodeList> rootList;
-    ST_RETURN_ON_ERROR(
-            d->m_toastXml->GetElementsByTagName(HStringReference(L"toast").Get(), &rootList));
-
-    ComPtr<IXmlNode> root;
-    ST_RETURN_ON_ERROR(rootList->Item(0, &root));
-    ComPtr<IXmlNamedNodeMap> rootAttributes;
-    ST_RETURN_ON_ERROR(root->get_Attributes(&rootAttributes));
-
-    const auto data = formatAction(SnoreToastActions::Actions::Clicked);
-    ST_RETURN_ON_ERROR(addAttribute(L"launch", rootAttributes.Get(), data));
-    ST_RETURN_ON_ERROR(addAttribute(L"duration", rootAttributes.Get(),
-                                    d->m_duration == Duration::Short ? L"short" : L"long"));
-    // Adding buttons
-    if (!d->m_buttons.empty()) {
-        setButtons(root);
-    } else if (d->m_textbox) {
-        setTextBox(root);
-    }
-    ComPtr<ABI::Windows::Data::Xml::Dom::IXmlElement> audioElement;
-    ST_RETURN_ON_ERROR(
-            d->m_toastXml->CreateElement(HStringReference(L"audio").Get(), &audioElement));
-
-    ComPtr<IXmlNode> audioNodeTmp;
-    ST_RETURN_ON_ERROR(audioElement.As(&audioNodeTmp));
-
-    ComPtr<IXmlNode> audioNode;
-    ST_RETURN_ON_ERROR(root->AppendChild(audioNodeTmp.Get(), &audioNode));
-
-    ComPtr<IXmlNamedNodeMap> attributes;
-    ST_RETURN_ON_ERROR(audioNode->get_Attributes(&attributes));
-    ST_RETURN_ON_ERROR(addAttribute(L"src", attributes.Get()));
-    ST_RETURN_ON_ERROR(addAttribute(L"silent", attributes.Get()));
-    //    printXML();
-
-    if (!d->m_image.empty()) {
-        ST_RETURN_ON_ERROR(setImage());
-    }
-    ST_RETURN_ON_ERROR(setSound());
-
-    ST_RETURN_ON_ERROR(setTextValues());
-
-    printXML();
-    ST_RETURN_ON_ERROR(createToast());
+    d->m_image =
+            image.empty() ? image : imageCache().normalize(std::filesystem::absolute(image));
+
+    std::wstring error;
+    switch (d->m_backend->setting(d->m_appID)) {
+    case NotificationSetting::Enabled:
+        break;
+    case NotificationSetting::DisabledForApplication:
+        error = L"DisabledForApplication";
+        break;
+    case NotificationSetting::DisabledForUser:
+        error = L"DisabledForUser";
+        break;
+    case NotificationSetting::DisabledByGroupPolicy:
+        error = L"DisabledByGroupPolicy";
+        break;
+    case NotificationSetting::DisabledByManifest:
+        error = L"DisabledByManifest";
+        break;
+    }
+    if (!error.empty()) {
+        std::wstringstream err;
+        err << L"Notifications are disabled\n"
+            << L"Reason: " << error << L" Please make sure that the app id is set correctly.";
+        tLog << err.str();
+        std::wcerr << err.str() << std::endl;
+    }
+
+    const ToastContent &content = prepareContent();
+    {
+        std::scoped_lock lock(d->m_eventMutex);
+        d->m_displayedId = content.id;
+    }
+    // the activations of buttons and text boxes are delivered to the activator, which can't
+    // be reached without a registered appID
+    if ((!content.buttons.empty() || content.textBox) && !d->m_activatorRegistered
+        && !d->fallbackMode()) {
+        d->m_activatorRegistered = d->m_backend->registerActivator();
+    }
+
+    // only listen for events if the notification can be displayed
+    const bool listen = error.empty();
+    {
+        std::scoped_lock lock(d->m_eventMutex);
+        d->m_hasListener = listen;
+    }
+    // registered first, an event delivered during show() removes the entry again, a toast that
+    // failed to replace a displayed one keeps its entry
+    const auto previous = d->m_registry.find(d->m_appID, content.id);
+    d->m_registry.add(d->m_appID, content.id, content.group);
+    if (!d->m_backend->show(d->m_appID, content, listen ? d : nullptr)) {
+        if (previous) {
+            d->m_registry.add(d->m_appID, previous->id, previous->group);
+        } else {
+            d->m_registry.remove(d->m_appID, content.id);
+        }
+        std::scoped_lock lock(d->m_eventMutex);
+        d->m_hasListener = false;
+        return false;
+    }
     d->m_action = SnoreToastActions::Actions::Clicked;
-    return S_OK;
+    return true;
 }
 
 SnoreToastActions::Actions SnoreToasts::userAction()
 {
-    if (d->m_eventHanlder.Get()) {
-        HANDLE event = d->m_eventHanlder.Get()->event();
-        if (WaitForSingleObject(event, EVENT_TIMEOUT) == WAIT_TIMEOUT) {
-            d->m_action = SnoreToastActions::Actions::Error;
-        } else {
-            d->m_action = d->m_eventHanlder.Get()->userAction();
+    return userAction(EVENT_TIMEOUT);
+}
+
+SnoreToastActions::Actions SnoreToasts::userAction(std::chrono::milliseconds timeout)
+{
+    if (d->m_hasListener) {
+        {
+            ST_TRACE("SnoreToasts::userAction wait");
+            std::unique_lock lock(d->m_eventMutex);
+            if (!d->m_eventCondition.wait_for(lock, timeout, [this] { return d->m_finished; })) {
+                d->m_action = SnoreToastActions::Actions::Error;
+            } else {
+                d->m_action = d->m_userAction;
+            }
         }
         // the initial value is SnoreToastActions::Actions::Hidden so if no action happend when we
         // end up here, a hide was requested
         if (d->m_action == SnoreToastActions::Actions::Hidden) {
-            d->m_notifier->Hide(d->m_notification.Get());
+            d->m_backend->hide(d->m_displayedId, d);
             tLog << L"The application hid the toast using ToastNotifier.hide()";
         }
-        CloseHandle(event);
+        d->m_backend->release(d->m_displayedId, d);
+        std::scoped_lock lock(d->m_eventMutex);
+        d->m_hasListener = false;
     }
     return d->m_action;
 }
 
-bool SnoreToasts::closeNotification()
+void SnoreToasts::setFinishedCallback(std::function<void()> callback)
 {
-    std::wstringstream eventName;
-    eventName << L"ToastEvent" << d->m_id;
-
-    HANDLE event = OpenEventW(EVENT_ALL_ACCESS, FALSE, eventName.str().c_str());
-    if (event) {
-        SetEvent(event);
-        return true;
+    bool finished;
+    {
+        std::scoped_lock lock(d->m_eventMutex);
+        d->m_finishedCallback = callback;
+        finished = d->m_finished || !d->m_hasListener;
     }
-    if (auto history = d->getHistory()) {
-        if (ST_CHECK_RESULT(history->RemoveGroupedTagWithId(
-                    HStringReference(d->m_id.c_str()).Get(), HStringReference(L"SnoreToast").Get(),
-                    HStringReference(d->m_appID.c_str()).Get()))) {
-            return true;
-        }
+    if (finished && callback) {
+        callback();
     }
-    tLog << "Notification " << d->m_id << " does not exist";
-    return false;
-}
-
-void SnoreToasts::setSound(const std::wstring &soundFile)
-{
-    d->m_sound = soundFile;
 }
 
-void SnoreToasts::setSilent(bool silent)
+bool SnoreToasts::closeNotification()
 {
-    d->m_silent = silent;
+    const auto entry = d->m_registry.find(d->m_appID, d->m_id);
+    return d->close(d->m_id, entry ? entry->group : d->m_group);
 }
 
-void SnoreToasts::setId(const std::wstring &id)
+size_t SnoreToasts::closeNotifications(const std::vector<std::wstring> &ids)
 {
-    if (!id.empty()) {
-        d->m_id = id;
+    size_t closed = 0;
+    for (const auto &id : ids) {
+        const auto entry = d->m_registry.find(d->m_appID, id);
+        closed += d->close(id, entry ? entry->group : d->m_group) ? 1 : 0;
     }
+    return closed;
 }
 
-std::wstring SnoreToasts::id() const
+size_t SnoreToasts::closeNotificationsWithPrefix(const std::wstring &prefix)
 {
-    return d->m_id;
+    d->reconcile();
+    return d->close(d->m_registry.withPrefix(d->m_appID, prefix));
 }
 
-void SnoreToasts::setButtons(const std::wstring &buttons)
+size_t SnoreToasts::closeGroup(const std::wstring &group)
 {
-    d->m_buttons = buttons;
+    d->reconcile();
+    return d->close(d->m_registry.inGroup(d->m_appID, group));
 }
 
-void SnoreToasts::setTextBoxEnabled(bool textBoxEnabled)
+std::vector<ToastRegistry::Entry> SnoreToasts::notifications()
 {
-    d->m_textbox = textBoxEnabled;
+    d->reconcile();
+    return d->m_registry.entries(d->m_appID);
 }
 
-// Set the value of the "src" attribute of the "image" node
-HRESULT SnoreToasts::setImage()
+ToastRegistry &SnoreToasts::registry(NotificationBackend *backend)
 {
-    ComPtr<IXmlNodeList> nodeList;
-    ST_RETURN_ON_ERROR(
-            d->m_toastXml->GetElementsByTagName(HStringReference(L"image").Get(), &nodeList));
-
-    ComPtr<IXmlNode> imageNode;
-    ST_RETURN_ON_ERROR(nodeList->Item(0, &imageNode));
-
-    ComPtr<IXmlNamedNodeMap> attributes;
-    ST_RETURN_ON_ERROR(imageNode->get_Attributes(&attributes));
-
-    ComPtr<IXmlNode> srcAttribute;
-    ST_RETURN_ON_ERROR(attributes->GetNamedItem(HStringReference(L"src").Get(), &srcAttribute));
-    return setNodeValueString(HStringReference(d->m_image.wstring().c_str()).Get(),
-                              srcAttribute.Get());
+    return toastRegistry(backend);
 }
 
-HRESULT SnoreToasts::setSound()
+void SnoreToasts::setSound(const std::wstring &soundFile)
 {
-    ComPtr<IXmlNodeList> nodeList;
-    ST_RETURN_ON_ERROR(
-            d->m_toastXml->GetElementsByTagName(HStringReference(L"audio").Get(), &nodeList));
-
-    ComPtr<IXmlNode> audioNode;
-    ST_RETURN_ON_ERROR(nodeList->Item(0, &audioNode));
-
-    ComPtr<IXmlNamedNodeMap> attributes;
-
-    ST_RETURN_ON_ERROR(audioNode->get_Attributes(&attributes));
-    ComPtr<IXmlNode> srcAttribute;
-
-    ST_RETURN_ON_ERROR(attributes->GetNamedItem(HStringReference(L"src").Get(), &srcAttribute));
-    std::wstring sound;
-    if (d->m_sound.find(L"ms-winsoundevent:") == std::wstring::npos) {
-        sound = L"ms-winsoundevent:";
-        sound.append(d->m_sound);
-    } else {
-        sound = d->m_sound;
-    }
-
-    ST_RETURN_ON_ERROR(
-            setNodeValueString(HStringReference(sound.c_str()).Get(), srcAttribute.Get()));
-    ST_RETURN_ON_ERROR(attributes->GetNamedItem(HStringReference(L"silent").Get(), &srcAttribute));
-    return setNodeValueString(HStringReference(d->m_silent ? L"true" : L"false").Get(),
-                              srcAttribute.Get());
+    d->m_sound = soundFile;
+    d->m_contentChanged = true;
 }
 
-// Set the values of each of the text nodes
-HRESULT SnoreToasts::setTextValues()
+void SnoreToasts::setSilent(bool silent)
 {
-    ComPtr<IXmlNodeList> nodeList;
-    ST_RETURN_ON_ERROR(
-            d->m_toastXml->GetElementsByTagName(HStringReference(L"text").Get(), &nodeList));
-    // create the title
-    ComPtr<IXmlNode> textNode;
-    ST_RETURN_ON_ERROR(nodeList->Item(0, &textNode));
-    ST_RETURN_ON_ERROR(
-            setNodeValueString(HStringReference(d->m_title.c_str()).Get(), textNode.Get()));
-    ST_RETURN_ON_ERROR(nodeList->Item(1, &textNode));
-    return setNodeValueString(HStringReference(d->m_body.c_str()).Get(), textNode.Get());
+    d->m_silent = silent;
+    d->m_contentChanged = true;
 }
 
-HRESULT SnoreToasts::setButtons(ComPtr<IXmlNode> root)
+void SnoreToasts::setId(const std::wstring &id)
 {
-    ComPtr<ABI::Windows::Data::Xml::Dom::IXmlElement> actionsElement;
-    ST_RETURN_ON_ERROR(
-            d->m_toastXml->CreateElement(HStringReference(L"actions").Get(), &actionsElement));
-
-    ComPtr<IXmlNode> actionsNodeTmp;
-    ST_RETURN_ON_ERROR(actionsElement.As(&actionsNodeTmp));
-
-    ComPtr<IXmlNode> actionsNode;
-    ST_RETURN_ON_ERROR(root->AppendChild(actionsNodeTmp.Get(), &actionsNode));
-
-    std::wstring buttonText;
-    std::wstringstream wss(d->m_buttons);
-    while (std::getline(wss, buttonText, L';')) {
-        ST_RETURN_ON_ERROR(createNewActionButton(actionsNode, buttonText));
+    if (!id.empty()) {
+        d->m_id = id;
+        d->updateFormatter();
     }
-    return S_OK;
-}
-
-HRESULT SnoreToasts::setTextBox(ComPtr<IXmlNode> root)
-{
-    ComPtr<ABI::Windows::Data::Xml::Dom::IXmlElement> actionsElement;
-    ST_RETURN_ON_ERROR(
-            d->m_toastXml->CreateElement(HStringReference(L"actions").Get(), &actionsElement));
-
-    ComPtr<IXmlNode> actionsNodeTmp;
-    ST_RETURN_ON_ERROR(actionsElement.As(&actionsNodeTmp));
-
-    ComPtr<IXmlNode> actionsNode;
-    ST_RETURN_ON_ERROR(root->AppendChild(actionsNodeTmp.Get(), &actionsNode));
-
-    ComPtr<ABI::Windows::Data::Xml::Dom::IXmlElement> inputElement;
-    ST_RETURN_ON_ERROR(
-            d->m_toastXml->CreateElement(HStringReference(L"input").Get(), &inputElement));
-
-    ComPtr<IXmlNode> inputNodeTmp;
-    ST_RETURN_ON_ERROR(inputElement.As(&inputNodeTmp));
-
-    ComPtr<IXmlNode> inputNode;
-    ST_RETURN_ON_ERROR(actionsNode->AppendChild(inputNodeTmp.Get(), &inputNode));
-
-    ComPtr<IXmlNamedNodeMap> inputAttributes;
-    ST_RETURN_ON_ERROR(inputNode->get_Attributes(&inputAttributes));
-
-    ST_RETURN_ON_ERROR(addAttribute(L"id", inputAttributes.Get(), L"textBox"));
-    ST_RETURN_ON_ERROR(addAttribute(L"type", inputAttributes.Get(), L"text"));
-    ST_RETURN_ON_ERROR(addAttribute(L"placeHolderContent", inputAttributes.Get(), L"Type a reply"));
-
-    ComPtr<IXmlElement> actionElement;
-    ST_RETURN_ON_ERROR(
-            d->m_toastXml->CreateElement(HStringReference(L"action").Get(), &actionElement));
-
-    ComPtr<IXmlNode> actionNodeTmp;
-    ST_RETURN_ON_ERROR(actionElement.As(&actionNodeTmp));
-
-    ComPtr<IXmlNode> actionNode;
-    ST_RETURN_ON_ERROR(actionsNode->AppendChild(actionNodeTmp.Get(), &actionNode));
-
-    ComPtr<IXmlNamedNodeMap> actionAttributes;
-    ST_RETURN_ON_ERROR(actionNode->get_Attributes(&actionAttributes));
-
-    ST_RETURN_ON_ERROR(addAttribute(L"content", actionAttributes.Get(), L"Send"));
-
-    const auto data = formatAction(SnoreToastActions::Actions::TextEntered);
-
-    ST_RETURN_ON_ERROR(addAttribute(L"arguments", actionAttributes.Get(), data));
-    return addAttribute(L"hint-inputId", actionAttributes.Get(), L"textBox");
 }
 
-HRESULT SnoreToasts::setEventHandler(ComPtr<IToastNotification> toast)
+std::wstring SnoreToasts::id() const
 {
-    // Register the event handlers
-    EventRegistrationToken activatedToken, dismissedToken, failedToken;
-    ComPtr<ToastEventHandler> eventHandler(new ToastEventHandler(*this));
-
-    ST_RETURN_ON_ERROR(toast->add_Activated(eventHandler.Get(), &activatedToken));
-    ST_RETURN_ON_ERROR(toast->add_Dismissed(eventHandler.Get(), &dismissedToken));
-    ST_RETURN_ON_ERROR(toast->add_Failed(eventHandler.Get(), &failedToken));
-    d->m_eventHanlder = eventHandler;
-    return S_OK;
+    return d->m_id;
 }
 
-HRESULT SnoreToasts::setNodeValueString(const HSTRING &inputString, IXmlNode *node)
+void SnoreToasts::setGroup(const std::wstring &group)
 {
-    ComPtr<IXmlText> inputText;
-    ST_RETURN_ON_ERROR(d->m_toastXml->CreateTextNode(inputString, &inputText));
-
-    ComPtr<IXmlNode> inputTextNode;
-    ST_RETURN_ON_ERROR(inputText.As(&inputTextNode));
-
-    ComPtr<IXmlNode> pAppendedChild;
-    return node->AppendChild(inputTextNode.Get(), &pAppendedChild);
+    if (!group.empty()) {
+        d->m_group = group;
+        d->m_contentChanged = true;
+    }
 }
 
-HRESULT SnoreToasts::addAttribute(const std::wstring &name, IXmlNamedNodeMap *attributeMap)
+std::wstring SnoreToasts::group() const
 {
-    ComPtr<ABI::Windows::Data::Xml::Dom::IXmlAttribute> srcAttribute;
-    HRESULT hr =
-            d->m_toastXml->CreateAttribute(HStringReference(name.c_str()).Get(), &srcAttribute);
-
-    if (SUCCEEDED(hr)) {
-        ComPtr<IXmlNode> node;
-        hr = srcAttribute.As(&node);
-        if (SUCCEEDED(hr)) {
-            ComPtr<IXmlNode> pNode;
-            hr = attributeMap->SetNamedItem(node.Get(), &pNode);
-        }
-    }
-    return hr;
+    return d->m_group;
 }
 
-HRESULT SnoreToasts::addAttribute(const std::wstring &name, IXmlNamedNodeMap *attributeMap,
-                                  const std::wstring &value)
+void SnoreToasts::setButtons(const std::wstring &buttons)
 {
-    ComPtr<ABI::Windows::Data::Xml::Dom::IXmlAttribute> srcAttribute;
-    ST_RETURN_ON_ERROR(
-            d->m_toastXml->CreateAttribute(HStringReference(name.c_str()).Get(), &srcAttribute));
-
-    ComPtr<IXmlNode> node;
-    ST_RETURN_ON_ERROR(srcAttribute.As(&node));
-
-    ComPtr<IXmlNode> pNode;
-    ST_RETURN_ON_ERROR(attributeMap->SetNamedItem(node.Get(), &pNode));
-    return setNodeValueString(HStringReference(value.c_str()).Get(), node.Get());
+    d->m_buttons = buttons;
+    d->m_contentChanged = true;
 }
 
-HRESULT SnoreToasts::createNewActionButton(ComPtr<IXmlNode> actionsNode, const std::wstring &value)
+void SnoreToasts::setTextBoxEnabled(bool textBoxEnabled)
 {
-    ComPtr<ABI::Windows::Data::Xml::Dom::IXmlElement> actionElement;
-    ST_RETURN_ON_ERROR(
-            d->m_toastXml->CreateElement(HStringReference(L"action").Get(), &actionElement));
-    ComPtr<IXmlNode> actionNodeTmp;
-    ST_RETURN_ON_ERROR(actionElement.As(&actionNodeTmp));
-
-    ComPtr<IXmlNode> actionNode;
-    ST_RETURN_ON_ERROR(actionsNode->AppendChild(actionNodeTmp.Get(), &actionNode));
-
-    ComPtr<IXmlNamedNodeMap> actionAttributes;
-    ST_RETURN_ON_ERROR(actionNode->get_Attributes(&actionAttributes));
-
-    ST_RETURN_ON_ERROR(addAttribute(L"content", actionAttributes.Get(), value));
-
-    const auto data =
-            formatAction(SnoreToastActions::Actions::ButtonClicked, { { L"button", value } });
-    ST_RETURN_ON_ERROR(addAttribute(L"arguments", actionAttributes.Get(), data));
-    return addAttribute(L"activationType", actionAttributes.Get(), L"foreground");
+    d->m_textbox = textBoxEnabled;
+    d->m_contentChanged = true;
 }
 
-void SnoreToasts::printXML()
+const ToastContent &SnoreToasts::prepareContent()
 {
-    ComPtr<ABI::Windows::Data::Xml::Dom::IXmlNodeSerializer> s;
-    ComPtr<ABI::Windows::Data::Xml::Dom::IXmlDocument> ss(d->m_toastXml);
-    ss.As(&s);
-    HSTRING string;
-    s->GetXml(&string);
-    PCWSTR str = WindowsGetStringRawBuffer(string, nullptr);
-    tLog << L"------------------------\n\t\t\t" << str << L"\n\t\t" << L"------------------------";
+    ST_TRACE("SnoreToasts::prepareContent");
+    ToastContent &content = d->m_content;
+    if (d->m_contentChanged) {
+        content = ToastContent();
+        content.id = d->m_id;
+        content.group = d->m_group;
+        if (d->m_sound.find(L"ms-winsoundevent:") == std::wstring::npos) {
+            content.sound = L"ms-winsoundevent:";
+            content.sound.append(d->m_sound);
+        } else {
+            content.sound = d->m_sound;
+        }
+        content.silent = d->m_silent;
+        content.duration = d->m_duration;
+        formatAction(content.launchArguments, SnoreToastActions::Actions::Clicked);
+        if (!d->m_buttons.empty()) {
+            const std::wstring_view buttons = d->m_buttons;
+            for (size_t start = 0; start < buttons.size();) {
+                size_t end = TextKernels::find(buttons, L';', start);
+                if (end == std::wstring_view::npos) {
+                    end = buttons.size();
+                }
+                const auto buttonText = buttons.substr(start, end - start);
+                auto &button = content.buttons.emplace_back();
+                button.content = buttonText;
+                formatAction(button.arguments, SnoreToastActions::Actions::ButtonClicked,
+                             { { L"button", buttonText } });
+                start = end + 1;
+            }
+        } else if (d->m_textbox) {
+            content.textBox = true;
+            formatAction(content.textBoxArguments, SnoreToastActions::Actions::TextEntered);
+        }
+        d->m_contentChanged = false;
+    }
+    content.title = d->m_title;
+    content.body = d->m_body;
+    content.image = d->m_image;
+    return content;
 }
 
 std::filesystem::path SnoreToasts::pipeName() const
@@ -495,6 +677,7 @@ std::filesystem::path SnoreToasts::pipeName() const
 void SnoreToasts::setPipeName(const std::filesystem::path &pipeName)
 {
     d->m_pipeName = pipeName;
+    d->updateFormatter();
 }
 
 std::filesystem::path SnoreToasts::application() const
@@ -505,11 +688,13 @@ std::filesystem::path SnoreToasts::application() const
 void SnoreToasts::setApplication(const std::filesystem::path &application)
 {
     d->m_application = application;
+    d->updateFormatter();
 }
 
 void SnoreToasts::setDuration(Duration duration)
 {
     d->m_duration = duration;
+    d->m_contentChanged = true;
 }
 
 Duration SnoreToasts::duration() const
@@ -517,71 +702,35 @@ Duration SnoreToasts::duration() const
     return d->m_duration;
 }
 
-std::wstring SnoreToasts::formatAction(
-        const SnoreToastActions::Actions &action,
-        const std::vector<std::pair<std::wstring_view, std::wstring_view>> &extraData) const
+unsigned SnoreToasts::protocolVersion() const
 {
-    const auto pipe = d->m_pipeName.wstring();
-    const auto application = d->m_application.wstring();
-    std::vector<std::pair<std::wstring_view, std::wstring_view>> data = {
-        { L"action", SnoreToastActions::getActionString(action) },
-        { L"notificationId", std::wstring_view(d->m_id) },
-        { L"pipe", std::wstring_view(pipe) },
-        { L"application", std::wstring_view(application) }
-    };
-    data.insert(data.end(), extraData.cbegin(), extraData.cend());
-    return Utils::formatData(data);
+    return d->m_protocol;
 }
 
-// Create and display the toast
-HRESULT SnoreToasts::createToast()
+void SnoreToasts::setProtocolVersion(unsigned protocol)
 {
-    ST_RETURN_ON_ERROR(d->m_toastManager->CreateToastNotifierWithId(
-            HStringReference(d->m_appID.c_str()).Get(), &d->m_notifier));
+    d->m_protocol = protocol;
+    d->updateFormatter();
+}
 
-    ComPtr<IToastNotificationFactory> factory;
-    ST_RETURN_ON_ERROR(GetActivationFactory(
-            HStringReference(RuntimeClass_Windows_UI_Notifications_ToastNotification).Get(),
-            &factory));
-    ST_RETURN_ON_ERROR(factory->CreateToastNotification(d->m_toastXml.Get(), &d->m_notification));
+void SnoreToasts::setCallbackWriter(CallbackWriter *writer)
+{
+    d->m_callbackWriter = writer;
+}
 
-    ComPtr<Notifications::IToastNotification2> toastV2;
-    if (SUCCEEDED(d->m_notification.As(&toastV2))) {
-        ST_RETURN_ON_ERROR(toastV2->put_Tag(HStringReference(d->m_id.c_str()).Get()));
-        ST_RETURN_ON_ERROR(toastV2->put_Group(HStringReference(L"SnoreToast").Get()));
-    }
+std::wstring SnoreToasts::formatAction(
+        const SnoreToastActions::Actions &action,
+        const std::vector<std::pair<std::wstring_view, std::wstring_view>> &extraData) const
+{
+    std::wstring out;
+    d->m_formatter.format(out, action, extraData);
+    return out;
+}
 
-    std::wstring error;
-    NotificationSetting setting = NotificationSetting_Enabled;
-    if (!ST_CHECK_RESULT(d->m_notifier->get_Setting(&setting))) {
-        tLog << "Failed to retreive NotificationSettings ensure your appId is registered";
-    }
-    switch (setting) {
-    case NotificationSetting_Enabled:
-        ST_RETURN_ON_ERROR(setEventHandler(d->m_notification));
-        break;
-    case NotificationSetting_DisabledForApplication:
-        error = L"DisabledForApplication";
-        break;
-    case NotificationSetting_DisabledForUser:
-        error = L"DisabledForUser";
-        break;
-    case NotificationSetting_DisabledByGroupPolicy:
-        error = L"DisabledByGroupPolicy";
-        break;
-    case NotificationSetting_DisabledByManifest:
-        error = L"DisabledByManifest";
-        break;
-    }
-    if (!error.empty()) {
-        std::wstringstream err;
-        err << L"Notifications are disabled\n"
-            << L"Reason: " << error << L" Please make sure that the app id is set correctly.\n"
-            << L"Command Line: " << GetCommandLineW();
-        tLog << err.str();
-        std::wcerr << err.str() << std::endl;
-    }
-    return d->m_notifier->Show(d->m_notification.Get());
+void SnoreToasts::formatAction(std::wstring &out, SnoreToastActions::Actions action,
+                               ActionFormatter::Fields extraData) const
+{
+    d->m_formatter.format(out, action, extraData);
 }
 
 std::wstring SnoreToasts::version()
@@ -589,48 +738,44 @@ std::wstring SnoreToasts::version()
     return SNORETOAST_VERSION;
 }
 
-HRESULT SnoreToasts::backgroundCallback(const std::wstring &appUserModelId,
-                                        const std::wstring &invokedArgs, const std::wstring &msg)
+bool SnoreToasts::backgroundCallback(NotificationBackend *backend,
+                                     const std::wstring &appUserModelId,
+                                     const std::wstring &invokedArgs, const std::wstring &msg)
 {
+    ST_TRACE("SnoreToasts::backgroundCallback");
     tLog << "CToastNotificationActivationCallback::Activate: " << appUserModelId << " : "
          << invokedArgs << " : " << msg;
-    const auto dataMap = Utils::splitData(invokedArgs);
-    const auto action = SnoreToastActions::getAction(dataMap.at(L"action"));
-    std::wstring dataString;
+    const CallbackData data(invokedArgs);
+    const auto action = SnoreToastActions::getAction(data.value(L"action"));
+    std::wstring dataString = invokedArgs;
     if (action == SnoreToastActions::Actions::TextEntered) {
-        std::wstringstream sMsg;
-        sMsg << invokedArgs << L"text=" << msg;
-        dataString = sMsg.str();
-    } else {
-        dataString = invokedArgs;
-    }
-    const auto pipe = dataMap.find(L"pipe");
-    if (pipe != dataMap.cend()) {
-        if (!Utils::writePipe(pipe->second, dataString)) {
-            const auto app = dataMap.find(L"application");
-            if (app != dataMap.cend()) {
-                if (Utils::startProcess(app->second)) {
-                    Utils::writePipe(pipe->second, dataString, true);
-                }
-            }
-        }
+        ActionFormatter::appendField(dataString, { L"text", msg });
+    }
+    if (const auto pipe = data.find(L"pipe")) {
+        // never block Activate on a slow or absent host
+        deliveryQueue(backend).push(*pipe, data.value(L"application"),
+                                    pipeMessage(dataString, pipeProtocol(data)));
     }
 
     tLog << dataString;
-    if (!SetEvent(SnoreToastsPrivate::ctoastEvent())) {
-        tLog << "SetEvent failed" << GetLastError();
-        return S_FALSE;
-    }
-    return S_OK;
+    CallbackActivation::instance().set();
+    return true;
 }
-void SnoreToasts::waitForCallbackActivation()
+
+void SnoreToasts::waitForCallbackActivation(NotificationBackend *backend)
 {
-    Utils::registerActivator();
-    WaitForSingleObject(SnoreToastsPrivate::ctoastEvent(), EVENT_TIMEOUT);
-    Utils::unregisterActivator();
+    backend->registerActivator();
+    {
+        ST_TRACE("SnoreToasts::waitForCallbackActivation");
+        CallbackActivation::instance().wait();
+    }
+    // the process must not exit before the callback reached the pipe
+    ST_TRACE("DeliveryQueue::waitUntilEmpty");
+    deliveryQueue(backend).waitUntilEmpty(DeliveryQueue::Policy().deadline);
+    backend->unregisterActivator();
 }
 
 bool SnoreToasts::useFalbackMode() const
 {
-    return d->m_useFallbackMode;
-}
\ No newline at end of file
+    return d->fallbackMode();
+}
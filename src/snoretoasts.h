@@ -18,58 +18,86 @@
 #pragma once
 
 #include "snoretoastactions.h"
+#include "actionformatter.h"
+#include "notificationbackend.h"
+#include "toastregistry.h"
+#include "toastrequest.h"
 #include "libsnoretoast_export.h"
 
-#include <sdkddkver.h>
-
-// Windows Header Files:
-#include <windows.h>
-#include <sal.h>
-#include <psapi.h>
-#include <strsafe.h>
-#include <objbase.h>
-#include <shobjidl.h>
-#include <functiondiscoverykeys.h>
-#include <guiddef.h>
-#include <shlguid.h>
-
-#include <wrl/client.h>
-#include <wrl/implements.h>
-#include <windows.ui.notifications.h>
-
+#include <chrono>
 #include <filesystem>
+#include <functional>
 #include <string>
 #include <vector>
 
-using namespace Microsoft::WRL;
-using namespace ABI::Windows::Data::Xml::Dom;
-
-enum class Duration {
-    Short, // default 7s
-    Long // 25s
-};
+class CallbackWriter;
+class SnoreToastsPrivate;
 
 class LIBSNORETOAST_EXPORT SnoreToasts
 {
 public:
     static std::wstring version();
-    static void waitForCallbackActivation();
-    static HRESULT backgroundCallback(const std::wstring &appUserModelId,
-                                      const std::wstring &invokedArgs, const std::wstring &msg);
+    static void waitForCallbackActivation(NotificationBackend *backend);
+    static bool backgroundCallback(NotificationBackend *backend, const std::wstring &appUserModelId,
+                                   const std::wstring &invokedArgs, const std::wstring &msg);
+    /**
+     * The toasts shown by the SnoreToasts instances of backend in this process.
+     */
+    static ToastRegistry &registry(NotificationBackend *backend);
 
-    SnoreToasts(const std::wstring &appID);
+    /**
+     * The backend must outlive the SnoreToasts instance.
+     */
+    SnoreToasts(NotificationBackend *backend, const std::wstring &appID);
     ~SnoreToasts();
 
-    HRESULT displayToast(const std::wstring &title, const std::wstring &body,
-                         const std::filesystem::path &image);
+    /**
+     * Displays a toast, the instance can be used for any number of toasts.
+     * A repeated call replaces the toast with the same id and stops listening to the previous
+     * toast, the content is only rebuilt if one of the setters was called in between.
+     */
+    bool displayToast(const std::wstring &title, const std::wstring &body,
+                      const std::filesystem::path &image);
+    /**
+     * Waits for the result of the last displayed toast, Error if it is not known after one
+     * minute or after timeout. CompletionDispatcher waits without blocking a thread.
+     */
     SnoreToastActions::Actions userAction();
+    SnoreToastActions::Actions userAction(std::chrono::milliseconds timeout);
+    /**
+     * Called once the result of the displayed toast is known, from then on userAction() returns
+     * without waiting. The callback is called on the thread of the event, or right away if the
+     * result is already known or no toast is waiting for events. The callback may destroy the
+     * instance.
+     */
+    void setFinishedCallback(std::function<void()> callback);
+    /**
+     * Closes the toast with id().
+     */
     bool closeNotification();
+    /**
+     * Closes the toasts of the appID, the toasts of other processes are included.
+     * Returns the number of closed toasts.
+     */
+    size_t closeNotifications(const std::vector<std::wstring> &ids);
+    size_t closeNotificationsWithPrefix(const std::wstring &prefix);
+    size_t closeGroup(const std::wstring &group);
+    /**
+     * The toasts of the appID that are displayed or in the action center, the oldest first.
+     */
+    std::vector<ToastRegistry::Entry> notifications();
 
     void setSound(const std::wstring &soundFile);
     void setSilent(bool silent);
     void setId(const std::wstring &id);
     std::wstring id() const;
 
+    /**
+     * The group of the toasts, default is SnoreToast.
+     */
+    void setGroup(const std::wstring &group);
+    std::wstring group() const;
+
     void setButtons(const std::wstring &buttons);
     void setTextBoxEnabled(bool textBoxEnabled);
 
@@ -82,36 +110,38 @@ public:
     Duration duration() const;
     void setDuration(Duration duration);
 
+    /**
+     * The format of the data written to the pipe, 1 (default) or 2, see SnoreToastProtocol.
+     */
+    unsigned protocolVersion() const;
+    void setProtocolVersion(unsigned protocol);
+
+    /**
+     * Writes the pipe callbacks with writer instead of opening the pipe for every callback.
+     * The writer must outlive the SnoreToasts instance.
+     */
+    void setCallbackWriter(CallbackWriter *writer);
+
     std::wstring formatAction(const SnoreToastActions::Actions &action,
                               const std::vector<std::pair<std::wstring_view, std::wstring_view>>
                                       &extraData = {}) const;
+    /**
+     * Formats into out reusing its capacity, the fields shared by all actions are cached.
+     */
+    void formatAction(std::wstring &out, SnoreToastActions::Actions action,
+                      ActionFormatter::Fields extraData = {}) const;
 
     /**
      * Returns true if the appID is not properly registered
      * This usually means that no shortcut with the appID is installed.
      * In fallback mode no text replies or buttons are available.
+     * The registration is looked up on first use.
      */
     bool useFalbackMode() const;
 
 private:
-    HRESULT createToast();
-    HRESULT setImage();
-    HRESULT setSound();
-    HRESULT setTextValues();
-    HRESULT setButtons(ComPtr<IXmlNode> root);
-    HRESULT setTextBox(ComPtr<IXmlNode> root);
-    HRESULT setEventHandler(
-            Microsoft::WRL::ComPtr<ABI::Windows::UI::Notifications::IToastNotification> toast);
-    HRESULT setNodeValueString(const HSTRING &onputString,
-                               ABI::Windows::Data::Xml::Dom::IXmlNode *node);
-    HRESULT addAttribute(const std::wstring &name,
-                         ABI::Windows::Data::Xml::Dom::IXmlNamedNodeMap *attributeMap);
-    HRESULT addAttribute(const std::wstring &name,
-                         ABI::Windows::Data::Xml::Dom::IXmlNamedNodeMap *attributeMap,
-                         const std::wstring &value);
-    HRESULT createNewActionButton(ComPtr<IXmlNode> actionsNode, const std::wstring &value);
-
-    void printXML();
+    // rebuilds the cached content if a setter changed it, fills in title, body and image
+    const ToastContent &prepareContent();
 
     friend class SnoreToastsPrivate;
     SnoreToastsPrivate *d;
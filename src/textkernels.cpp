@@ -0,0 +1,340 @@
+/*
+    SnoreToast is capable to invoke Windows 8 toast notifications.
+    Copyright (C) 2026  Hannah von Reth <vonreth@kde.org>
+
+    SnoreToast is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    SnoreToast is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with SnoreToast.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "textkernels.h"
+#include "textkernels_impl.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <cwchar>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define ST_SSE2_KERNELS
+#include <emmintrin.h>
+#endif
+
+#if defined(__aarch64__) || defined(_M_ARM64)
+#define ST_NEON_KERNELS
+#include <arm_neon.h>
+#endif
+
+using namespace TextKernels;
+
+namespace {
+#ifdef ST_SSE2_KERNELS
+struct Sse2Vector
+{
+    using Type = __m128i;
+    static constexpr size_t Lanes = 16 / sizeof(wchar_t);
+    static constexpr unsigned BitsPerLane = sizeof(wchar_t);
+
+    static Type load(const wchar_t *data)
+    {
+        return _mm_loadu_si128(reinterpret_cast<const __m128i *>(data));
+    }
+    static void store(wchar_t *data, Type value)
+    {
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(data), value);
+    }
+    static Type splat(wchar_t c)
+    {
+        if constexpr (sizeof(wchar_t) == 2) {
+            return _mm_set1_epi16(static_cast<short>(c));
+        } else {
+            return _mm_set1_epi32(static_cast<int>(c));
+        }
+    }
+    static Type equal(Type a, Type b)
+    {
+        if constexpr (sizeof(wchar_t) == 2) {
+            return _mm_cmpeq_epi16(a, b);
+        } else {
+            return _mm_cmpeq_epi32(a, b);
+        }
+    }
+    // a < b, with the signedness of wchar_t
+    static Type less(Type a, Type b)
+    {
+        if constexpr (sizeof(wchar_t) == 2) {
+            // unsigned: a <= b - 1 if the saturated difference is zero
+            return _mm_cmpeq_epi16(_mm_subs_epu16(a, _mm_sub_epi16(b, _mm_set1_epi16(1))),
+                                   _mm_setzero_si128());
+        } else {
+#if WCHAR_MIN < 0
+            return _mm_cmplt_epi32(a, b);
+#else
+            const auto sign = _mm_set1_epi32(static_cast<int>(0x80000000));
+            return _mm_cmplt_epi32(_mm_xor_si128(a, sign), _mm_xor_si128(b, sign));
+#endif
+        }
+    }
+    static Type bitOr(Type a, Type b) { return _mm_or_si128(a, b); }
+    // mask ? a : b
+    static Type select(Type mask, Type a, Type b)
+    {
+        return _mm_or_si128(_mm_and_si128(mask, a), _mm_andnot_si128(mask, b));
+    }
+    static uint64_t bits(Type mask) { return static_cast<uint32_t>(_mm_movemask_epi8(mask)); }
+};
+#endif
+
+#ifdef ST_NEON_KERNELS
+template<size_t CharSize>
+struct NeonVector;
+
+template<>
+struct NeonVector<2>
+{
+    using Type = uint16x8_t;
+    static constexpr size_t Lanes = 8;
+    static constexpr unsigned BitsPerLane = 8;
+
+    static Type load(const wchar_t *data)
+    {
+        return vld1q_u16(reinterpret_cast<const uint16_t *>(data));
+    }
+    static void store(wchar_t *data, Type value)
+    {
+        vst1q_u16(reinterpret_cast<uint16_t *>(data), value);
+    }
+    static Type splat(wchar_t c) { return vdupq_n_u16(static_cast<uint16_t>(c)); }
+    static Type equal(Type a, Type b) { return vceqq_u16(a, b); }
+    static Type less(Type a, Type b) { return vcltq_u16(a, b); }
+    static Type bitOr(Type a, Type b) { return vorrq_u16(a, b); }
+    static Type select(Type mask, Type a, Type b) { return vbslq_u16(mask, a, b); }
+    // narrow every lane to 8 bits, there is no movemask on arm
+    static uint64_t bits(Type mask)
+    {
+        return vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(mask, 4)), 0);
+    }
+};
+
+template<>
+struct NeonVector<4>
+{
+    using Type = uint32x4_t;
+    static constexpr size_t Lanes = 4;
+    static constexpr unsigned BitsPerLane = 16;
+
+    static Type load(const wchar_t *data)
+    {
+        return vld1q_u32(reinterpret_cast<const uint32_t *>(data));
+    }
+    static void store(wchar_t *data, Type value)
+    {
+        vst1q_u32(reinterpret_cast<uint32_t *>(data), value);
+    }
+    static Type splat(wchar_t c) { return vdupq_n_u32(static_cast<uint32_t>(c)); }
+    static Type equal(Type a, Type b) { return vceqq_u32(a, b); }
+    static Type less(Type a, Type b)
+    {
+#if WCHAR_MIN < 0
+        return vcltq_s32(vreinterpretq_s32_u32(a), vreinterpretq_s32_u32(b));
+#else
+        return vcltq_u32(a, b);
+#endif
+    }
+    static Type bitOr(Type a, Type b) { return vorrq_u32(a, b); }
+    static Type select(Type mask, Type a, Type b) { return vbslq_u32(mask, a, b); }
+    static uint64_t bits(Type mask)
+    {
+        return vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u32(mask), 4)),
+                             0);
+    }
+};
+#endif
+
+const Implementation ScalarImplementation { &scalarFind, &scalarReplace, &scalarFindXmlSpecial,
+                                            &scalarFindAny };
+
+#ifdef ST_SSE2_KERNELS
+const Implementation Sse2Implementation { &find<Sse2Vector>, &replace<Sse2Vector>,
+                                          &findXmlSpecial<Sse2Vector>, &findAny<Sse2Vector> };
+#endif
+
+#ifdef ST_NEON_KERNELS
+const Implementation NeonImplementation { &find<NeonVector<sizeof(wchar_t)>>,
+                                          &replace<NeonVector<sizeof(wchar_t)>>,
+                                          &findXmlSpecial<NeonVector<sizeof(wchar_t)>>,
+                                          &findAny<NeonVector<sizeof(wchar_t)>> };
+#endif
+
+#ifdef SNORETOAST_AVX2_KERNELS
+bool cpuSupportsAvx2()
+{
+#ifdef _MSC_VER
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7) {
+        return false;
+    }
+    __cpuid(info, 1);
+    // the os must save the ymm registers
+    constexpr int osxsave = 1 << 27;
+    constexpr int avx = 1 << 28;
+    if ((info[2] & (osxsave | avx)) != (osxsave | avx) || (_xgetbv(0) & 0x6) != 0x6) {
+        return false;
+    }
+    __cpuidex(info, 7, 0);
+    return info[1] & (1 << 5);
+#else
+    return __builtin_cpu_supports("avx2");
+#endif
+}
+#endif
+
+const Implementation *implementation(Isa isa)
+{
+    switch (isa) {
+    case Isa::Scalar:
+        return &ScalarImplementation;
+    case Isa::Sse2:
+#ifdef ST_SSE2_KERNELS
+        return &Sse2Implementation;
+#else
+        return nullptr;
+#endif
+    case Isa::Avx2:
+#ifdef SNORETOAST_AVX2_KERNELS
+        return cpuSupportsAvx2() ? avx2Implementation() : nullptr;
+#else
+        return nullptr;
+#endif
+    case Isa::Neon:
+#ifdef ST_NEON_KERNELS
+        return &NeonImplementation;
+#else
+        return nullptr;
+#endif
+    }
+    return nullptr;
+}
+
+struct Dispatch
+{
+    Dispatch()
+    {
+        Isa selected = bestIsa();
+        if (const char *env = std::getenv("SNORETOAST_SIMD")) {
+            for (const auto candidate : { Isa::Scalar, Isa::Sse2, Isa::Avx2, Isa::Neon }) {
+                if (std::strcmp(env, isaName(candidate)) == 0 && implementation(candidate)) {
+                    selected = candidate;
+                }
+            }
+        }
+        isa = selected;
+        impl = implementation(selected);
+    }
+
+    std::atomic<Isa> isa;
+    std::atomic<const Implementation *> impl;
+};
+
+Dispatch &dispatch()
+{
+    static Dispatch _dispatch;
+    return _dispatch;
+}
+
+const Implementation &current()
+{
+    return *dispatch().impl.load(std::memory_order_relaxed);
+}
+}
+
+size_t TextKernels::find(std::wstring_view data, wchar_t c, size_t from)
+{
+    if (from >= data.size()) {
+        return std::wstring_view::npos;
+    }
+    const size_t size = data.size() - from;
+    const size_t pos = current().find(data.data() + from, size, c);
+    return pos == size ? std::wstring_view::npos : from + pos;
+}
+
+size_t TextKernels::findAny(std::wstring_view data, wchar_t a, wchar_t b, wchar_t c,
+                            size_t from)
+{
+    if (from >= data.size()) {
+        return std::wstring_view::npos;
+    }
+    const size_t size = data.size() - from;
+    const size_t pos = current().findAny(data.data() + from, size, a, b, c);
+    return pos == size ? std::wstring_view::npos : from + pos;
+}
+
+void TextKernels::replace(wchar_t *data, size_t size, wchar_t from, wchar_t to)
+{
+    current().replace(data, size, from, to);
+}
+
+void TextKernels::replace(std::wstring &data, wchar_t from, wchar_t to)
+{
+    current().replace(data.data(), data.size(), from, to);
+}
+
+size_t TextKernels::findXmlSpecial(std::wstring_view data, size_t from)
+{
+    if (from >= data.size()) {
+        return std::wstring_view::npos;
+    }
+    const size_t size = data.size() - from;
+    const size_t pos = current().findXmlSpecial(data.data() + from, size);
+    return pos == size ? std::wstring_view::npos : from + pos;
+}
+
+Isa TextKernels::isa()
+{
+    return dispatch().isa;
+}
+
+Isa TextKernels::bestIsa()
+{
+    for (const auto candidate : { Isa::Avx2, Isa::Neon, Isa::Sse2 }) {
+        if (implementation(candidate)) {
+            return candidate;
+        }
+    }
+    return Isa::Scalar;
+}
+
+bool TextKernels::setIsa(Isa isa)
+{
+    const auto impl = implementation(isa);
+    if (!impl) {
+        return false;
+    }
+    dispatch().impl = impl;
+    dispatch().isa = isa;
+    return true;
+}
+
+const char *TextKernels::isaName(Isa isa)
+{
+    switch (isa) {
+    case Isa::Scalar:
+        return "scalar";
+    case Isa::Sse2:
+        return "sse2";
+    case Isa::Avx2:
+        return "avx2";
+    case Isa::Neon:
+        return "neon";
+    }
+    return "unknown";
+}
@@ -0,0 +1,66 @@
+/*
+    SnoreToast is capable to invoke Windows 8 toast notifications.
+    Copyright (C) 2026  Hannah von Reth <vonreth@kde.org>
+
+    SnoreToast is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    SnoreToast is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with SnoreToast.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#pragma once
+
+#include <string>
+#include <string_view>
+
+/**
+ * Vectorised scans over wide strings, for 16 bit (Windows) and 32 bit wchar_t.
+ * The implementation is picked at runtime: AVX2 or SSE2 on x86, NEON on arm64 and a scalar
+ * fallback everywhere else. SNORETOAST_SIMD=scalar|sse2|avx2|neon overrides the choice.
+ */
+namespace TextKernels {
+enum class Isa { Scalar, Sse2, Avx2, Neon };
+
+/**
+ * The position of the first c in data at or after from, or npos.
+ */
+size_t find(std::wstring_view data, wchar_t c, size_t from = 0);
+
+/**
+ * The position of the first a, b or c in data at or after from, or npos.
+ */
+size_t findAny(std::wstring_view data, wchar_t a, wchar_t b, wchar_t c, size_t from = 0);
+
+/**
+ * Replaces every occurrence of from with to.
+ */
+void replace(wchar_t *data, size_t size, wchar_t from, wchar_t to);
+void replace(std::wstring &data, wchar_t from, wchar_t to);
+
+/**
+ * The position of the first character at or after from that might need to be escaped in
+ * xml: &, <, >, ", control characters and the non characters U+FFFE and U+FFFF, or npos.
+ */
+size_t findXmlSpecial(std::wstring_view data, size_t from = 0);
+
+/**
+ * The implementation in use.
+ */
+Isa isa();
+/**
+ * The best implementation supported by the cpu.
+ */
+Isa bestIsa();
+/**
+ * Forces an implementation, returns false if the cpu doesn't support it.
+ */
+bool setIsa(Isa isa);
+const char *isaName(Isa isa);
+};
@@ -0,0 +1,91 @@
+/*
+    SnoreToast is capable to invoke Windows 8 toast notifications.
+    Copyright (C) 2026  Hannah von Reth <vonreth@kde.org>
+
+    SnoreToast is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    SnoreToast is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with SnoreToast.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+// Compiled with -mavx2 (/arch:AVX2), only called after the cpu was checked.
+// Don't include anything but textkernels_impl.h and the intrinsics, see textkernels_impl.h.
+#include "textkernels_impl.h"
+
+#include <immintrin.h>
+#include <wchar.h>
+
+using namespace TextKernels;
+
+namespace {
+struct Avx2Vector
+{
+    using Type = __m256i;
+    static constexpr size_t Lanes = 32 / sizeof(wchar_t);
+    static constexpr unsigned BitsPerLane = sizeof(wchar_t);
+
+    static Type load(const wchar_t *data)
+    {
+        return _mm256_loadu_si256(reinterpret_cast<const __m256i *>(data));
+    }
+    static void store(wchar_t *data, Type value)
+    {
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(data), value);
+    }
+    static Type splat(wchar_t c)
+    {
+        if constexpr (sizeof(wchar_t) == 2) {
+            return _mm256_set1_epi16(static_cast<short>(c));
+        } else {
+            return _mm256_set1_epi32(static_cast<int>(c));
+        }
+    }
+    static Type equal(Type a, Type b)
+    {
+        if constexpr (sizeof(wchar_t) == 2) {
+            return _mm256_cmpeq_epi16(a, b);
+        } else {
+            return _mm256_cmpeq_epi32(a, b);
+        }
+    }
+    // a < b, with the signedness of wchar_t
+    static Type less(Type a, Type b)
+    {
+        if constexpr (sizeof(wchar_t) == 2) {
+            return _mm256_cmpeq_epi16(
+                    _mm256_subs_epu16(a, _mm256_sub_epi16(b, _mm256_set1_epi16(1))),
+                    _mm256_setzero_si256());
+        } else {
+#if WCHAR_MIN < 0
+            return _mm256_cmpgt_epi32(b, a);
+#else
+            const auto sign = _mm256_set1_epi32(static_cast<int>(0x80000000));
+            return _mm256_cmpgt_epi32(_mm256_xor_si256(b, sign), _mm256_xor_si256(a, sign));
+#endif
+        }
+    }
+    static Type bitOr(Type a, Type b) { return _mm256_or_si256(a, b); }
+    // mask ? a : b
+    static Type select(Type mask, Type a, Type b) { return _mm256_blendv_epi8(b, a, mask); }
+    static uint64_t bits(Type mask)
+    {
+        return static_cast<uint32_t>(_mm256_movemask_epi8(mask));
+    }
+};
+
+const Implementation Avx2Implementation { &find<Avx2Vector>, &replace<Avx2Vector>,
+                                          &findXmlSpecial<Avx2Vector>, &findAny<Avx2Vector> };
+}
+
+const TextKernels::Implementation *TextKernels::avx2Implementation()
+{
+    return &Avx2Implementation;
+}
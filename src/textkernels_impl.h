@@ -0,0 +1,189 @@
+/*
+    SnoreToast is capable to invoke Windows 8 toast notifications.
+    Copyright (C) 2026  Hannah von Reth <vonreth@kde.org>
+
+    SnoreToast is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    SnoreToast is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with SnoreToast.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#pragma once
+
+// Included by the translation units that are compiled with different instruction sets.
+// Everything below has internal linkage and the standard library is not used: an inline
+// function compiled with -mavx2 could otherwise be picked by the linker for the whole program.
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+namespace TextKernels {
+struct Implementation
+{
+    // the functions return size if nothing was found
+    size_t (*find)(const wchar_t *data, size_t size, wchar_t c);
+    void (*replace)(wchar_t *data, size_t size, wchar_t from, wchar_t to);
+    size_t (*findXmlSpecial)(const wchar_t *data, size_t size);
+    size_t (*findAny)(const wchar_t *data, size_t size, wchar_t a, wchar_t b, wchar_t c);
+};
+
+// defined in textkernels_avx2.cpp
+const Implementation *avx2Implementation();
+
+namespace {
+inline unsigned countTrailingZeros(uint64_t value)
+{
+#ifdef _MSC_VER
+    unsigned long index;
+#ifdef _M_IX86
+    if (static_cast<uint32_t>(value)) {
+        _BitScanForward(&index, static_cast<uint32_t>(value));
+        return index;
+    }
+    _BitScanForward(&index, static_cast<uint32_t>(value >> 32));
+    return index + 32;
+#else
+    _BitScanForward64(&index, value);
+    return index;
+#endif
+#else
+    return __builtin_ctzll(value);
+#endif
+}
+
+inline bool isXmlSpecial(wchar_t c)
+{
+    return c < 0x20 || c == L'&' || c == L'<' || c == L'>' || c == L'"' || c == 0xFFFE
+            || c == 0xFFFF;
+}
+
+inline size_t scalarFind(const wchar_t *data, size_t size, wchar_t c)
+{
+    for (size_t i = 0; i < size; ++i) {
+        if (data[i] == c) {
+            return i;
+        }
+    }
+    return size;
+}
+
+inline size_t scalarFindAny(const wchar_t *data, size_t size, wchar_t a, wchar_t b, wchar_t c)
+{
+    for (size_t i = 0; i < size; ++i) {
+        if (data[i] == a || data[i] == b || data[i] == c) {
+            return i;
+        }
+    }
+    return size;
+}
+
+inline void scalarReplace(wchar_t *data, size_t size, wchar_t from, wchar_t to)
+{
+    for (size_t i = 0; i < size; ++i) {
+        if (data[i] == from) {
+            data[i] = to;
+        }
+    }
+}
+
+inline size_t scalarFindXmlSpecial(const wchar_t *data, size_t size)
+{
+    for (size_t i = 0; i < size; ++i) {
+        if (isXmlSpecial(data[i])) {
+            return i;
+        }
+    }
+    return size;
+}
+
+/**
+ * The algorithms, written against a vector type V providing
+ * Lanes, BitsPerLane, load, store, splat, equal, less, bitOr, select and bits.
+ */
+template<typename V>
+size_t find(const wchar_t *data, size_t size, wchar_t c)
+{
+    const auto needle = V::splat(c);
+    size_t i = 0;
+    for (; i + V::Lanes <= size; i += V::Lanes) {
+        const uint64_t bits = V::bits(V::equal(V::load(data + i), needle));
+        if (bits) {
+            return i + countTrailingZeros(bits) / V::BitsPerLane;
+        }
+    }
+    return i + scalarFind(data + i, size - i, c);
+}
+
+template<typename V>
+size_t findAny(const wchar_t *data, size_t size, wchar_t a, wchar_t b, wchar_t c)
+{
+    const auto needleA = V::splat(a);
+    const auto needleB = V::splat(b);
+    const auto needleC = V::splat(c);
+    size_t i = 0;
+    for (; i + V::Lanes <= size; i += V::Lanes) {
+        const auto value = V::load(data + i);
+        const auto mask = V::bitOr(V::equal(value, needleA),
+                                   V::bitOr(V::equal(value, needleB), V::equal(value, needleC)));
+        const uint64_t bits = V::bits(mask);
+        if (bits) {
+            return i + countTrailingZeros(bits) / V::BitsPerLane;
+        }
+    }
+    return i + scalarFindAny(data + i, size - i, a, b, c);
+}
+
+template<typename V>
+void replace(wchar_t *data, size_t size, wchar_t from, wchar_t to)
+{
+    const auto needle = V::splat(from);
+    const auto replacement = V::splat(to);
+    size_t i = 0;
+    for (; i + V::Lanes <= size; i += V::Lanes) {
+        const auto value = V::load(data + i);
+        const auto mask = V::equal(value, needle);
+        if (V::bits(mask)) {
+            V::store(data + i, V::select(mask, replacement, value));
+        }
+    }
+    scalarReplace(data + i, size - i, from, to);
+}
+
+template<typename V>
+size_t findXmlSpecial(const wchar_t *data, size_t size)
+{
+    const auto control = V::splat(0x20);
+    const auto amp = V::splat(L'&');
+    const auto lt = V::splat(L'<');
+    const auto gt = V::splat(L'>');
+    const auto quot = V::splat(L'"');
+    const auto nonCharacter1 = V::splat(static_cast<wchar_t>(0xFFFE));
+    const auto nonCharacter2 = V::splat(static_cast<wchar_t>(0xFFFF));
+    size_t i = 0;
+    for (; i + V::Lanes <= size; i += V::Lanes) {
+        const auto value = V::load(data + i);
+        auto mask = V::bitOr(V::less(value, control), V::equal(value, amp));
+        mask = V::bitOr(mask, V::bitOr(V::equal(value, lt), V::equal(value, gt)));
+        mask = V::bitOr(mask, V::equal(value, quot));
+        mask = V::bitOr(mask,
+                        V::bitOr(V::equal(value, nonCharacter1), V::equal(value, nonCharacter2)));
+        const uint64_t bits = V::bits(mask);
+        if (bits) {
+            return i + countTrailingZeros(bits) / V::BitsPerLane;
+        }
+    }
+    return i + scalarFindXmlSpecial(data + i, size - i);
+}
+}
+};
@@ -0,0 +1,114 @@
+/*
+    SnoreToast is capable to invoke Windows 8 toast notifications.
+    Copyright (C) 2026  Hannah von Reth <vonreth@kde.org>
+
+    SnoreToast is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    SnoreToast is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with SnoreToast.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#pragma once
+
+#include "completiondispatcher.h"
+
+// libsnoretoast is C++17, co_await is available to C++20 hosts
+#if defined(__cpp_impl_coroutine) && __has_include(<coroutine>)
+
+#include <coroutine>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <utility>
+
+/**
+ * Waits for the result of a displayed toast in a coroutine:
+ *
+ *     const auto action = co_await ToastAwaitable(dispatcher, std::move(toast));
+ *
+ * The toast is added to the dispatcher on construction, so ticket() can be cancelled before
+ * and while the coroutine waits. The coroutine is resumed on the thread calling
+ * CompletionDispatcher::process(), the dispatcher must not be destroyed while a coroutine
+ * waits on it.
+ */
+class ToastAwaitable
+{
+public:
+    ToastAwaitable(CompletionDispatcher &dispatcher, std::unique_ptr<SnoreToasts> toast)
+        : m_state(std::make_shared<State>())
+    {
+        m_ticket = dispatcher.add(std::move(toast),
+                                  [state = m_state](SnoreToastActions::Actions action) {
+                                      state->resume(action);
+                                  });
+    }
+
+    // a coroutine destroyed while it waits must not be resumed by the result
+    ~ToastAwaitable()
+    {
+        std::scoped_lock lock(m_state->mutex);
+        m_state->waiter = nullptr;
+    }
+
+    ToastAwaitable(const ToastAwaitable &) = delete;
+    ToastAwaitable &operator=(const ToastAwaitable &) = delete;
+
+    uint64_t ticket() const { return m_ticket; }
+
+    bool await_ready() const
+    {
+        std::scoped_lock lock(m_state->mutex);
+        return m_state->action.has_value();
+    }
+
+    // doesn't suspend if the result arrived in between
+    bool await_suspend(std::coroutine_handle<> waiter)
+    {
+        std::scoped_lock lock(m_state->mutex);
+        if (m_state->action) {
+            return false;
+        }
+        m_state->waiter = waiter;
+        return true;
+    }
+
+    SnoreToastActions::Actions await_resume() const
+    {
+        std::scoped_lock lock(m_state->mutex);
+        return *m_state->action;
+    }
+
+private:
+    // shared with the callback, which can outlive a destroyed coroutine
+    struct State
+    {
+        std::mutex mutex;
+        std::optional<SnoreToastActions::Actions> action;
+        std::coroutine_handle<> waiter;
+
+        void resume(SnoreToastActions::Actions result)
+        {
+            std::coroutine_handle<> suspended;
+            {
+                std::scoped_lock lock(mutex);
+                action = result;
+                suspended = std::exchange(waiter, nullptr);
+            }
+            if (suspended) {
+                suspended.resume();
+            }
+        }
+    };
+
+    std::shared_ptr<State> m_state;
+    uint64_t m_ticket = 0;
+};
+
+#endif
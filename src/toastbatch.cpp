@@ -0,0 +1,68 @@
+/*
+    SnoreToast is capable to invoke Windows 8 toast notifications.
+    Copyright (C) 2026  Hannah von Reth <vonreth@kde.org>
+
+    SnoreToast is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    SnoreToast is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with SnoreToast.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "toastbatch.h"
+#include "optionparser.h"
+#include "stringutils.h"
+
+namespace {
+constexpr std::string_view UTF8_BOM = "\xEF\xBB\xBF";
+}
+
+ToastBatchReader::ToastBatchReader(std::istream &stream) : m_stream(stream) { }
+
+bool ToastBatchReader::next(ToastBatchRecord &record)
+{
+    while (std::getline(m_stream, m_line)) {
+        ++m_lineNumber;
+        std::string_view line(m_line);
+        if (m_lineNumber == 1 && line.substr(0, UTF8_BOM.size()) == UTF8_BOM) {
+            line.remove_prefix(UTF8_BOM.size());
+        }
+        if (!line.empty() && line.back() == '\r') {
+            line.remove_suffix(1);
+        }
+        const size_t start = line.find_first_not_of(" \t");
+        if (start == std::string_view::npos || line[start] == '#') {
+            continue;
+        }
+
+        record.line = m_lineNumber;
+        record.request = ToastRequest::fromArguments(splitCommandLine(Utils::fromUtf8(line)));
+        switch (record.request.mode) {
+        case ToastRequest::Mode::Toast:
+        case ToastRequest::Mode::Close:
+        case ToastRequest::Mode::Error:
+            break;
+        case ToastRequest::Mode::Help:
+            record.request.mode = ToastRequest::Mode::Error;
+            record.request.error = L"A notification requires a title and a message";
+            break;
+        default:
+            record.request.mode = ToastRequest::Mode::Error;
+            record.request.error = L"Only notifications and -close are supported in a batch";
+            break;
+        }
+        return true;
+    }
+    return false;
+}
+
+std::vector<std::wstring> ToastBatchReader::splitCommandLine(std::wstring_view line)
+{
+    return OptionParser::splitCommandLine(line);
+}
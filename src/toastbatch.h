@@ -0,0 +1,62 @@
+/*
+    SnoreToast is capable to invoke Windows 8 toast notifications.
+    Copyright (C) 2026  Hannah von Reth <vonreth@kde.org>
+
+    SnoreToast is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    SnoreToast is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with SnoreToast.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#pragma once
+
+#include "toastrequest.h"
+
+#include <istream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+struct ToastBatchRecord
+{
+    // 1 based line number in the batch file
+    size_t line = 0;
+    ToastRequest request;
+};
+
+/**
+ * Reads the records of a -batch file.
+ * Every line is a utf-8 encoded command line, quoted like a Windows command line.
+ * Empty lines and lines starting with # are skipped.
+ *
+ * -t "Title" -m "Message" -b "Yes;No" -id 1 -pipeName \\.\pipe\foo
+ */
+class ToastBatchReader
+{
+public:
+    explicit ToastBatchReader(std::istream &stream);
+
+    /**
+     * Reads the next record, returns false at the end of the stream.
+     * Records that are not a notification or a close request are returned with
+     * ToastRequest::Mode::Error.
+     */
+    bool next(ToastBatchRecord &record);
+
+    /**
+     * Splits a command line following the rules of CommandLineToArgvW.
+     */
+    static std::vector<std::wstring> splitCommandLine(std::wstring_view line);
+
+private:
+    std::istream &m_stream;
+    std::string m_line;
+    size_t m_lineNumber = 0;
+};
@@ -0,0 +1,215 @@
+/*
+    SnoreToast is capable to invoke Windows 8 toast notifications.
+    Copyright (C) 2026  Hannah von Reth <vonreth@kde.org>
+
+    SnoreToast is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    SnoreToast is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with SnoreToast.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "toastcoalescer.h"
+#include "toastlog.h"
+#include "toasttrace.h"
+
+#include <algorithm>
+
+namespace {
+constexpr uint64_t FnvOffset = 0xcbf29ce484222325ull;
+constexpr uint64_t FnvPrime = 0x100000001b3ull;
+
+template<typename Char>
+void hashField(uint64_t &hash, std::basic_string_view<Char> field)
+{
+    for (const Char c : field) {
+        hash = (hash ^ static_cast<uint64_t>(c)) * FnvPrime;
+    }
+    // "ab" "c" must differ from "a" "bc"
+    hash = (hash ^ field.size()) * FnvPrime;
+}
+
+template<typename Content>
+bool sameContent(const Content &content, const ToastRequest &request)
+{
+    return content.appID == request.appID && content.title == request.title
+            && content.body == request.body && content.buttons == request.buttons
+            && content.sound == request.sound && content.image == request.image;
+}
+}
+
+ToastCoalescer::ToastCoalescer(Policy policy, Clock clock)
+    : m_policy(policy), m_clock(std::move(clock))
+{
+}
+
+ToastCoalescer::Decision ToastCoalescer::submit(ToastRequest &request)
+{
+    ST_TRACE("ToastCoalescer::submit");
+    if (request.mode != ToastRequest::Mode::Toast) {
+        return Decision::Show;
+    }
+    const uint64_t hash = contentHash(request);
+    std::scoped_lock lock(m_mutex);
+    const auto now = m_clock();
+    expire(now);
+
+    // the hash only finds the candidates, a collision is a different toast; the entries are
+    // only removed by expire() once they are checked, so they might have expired already
+    bool known = false;
+    const auto [first, last] = m_contents.equal_range(hash);
+    for (auto content = first; content != last; ++content) {
+        if (sameContent(content->second, request)) {
+            const bool repeated = !expired(content->second.seen, now);
+            content->second.seen = now;
+            if (repeated) {
+                ++m_statistics.dropped;
+                tLog << L"Dropped a repeated toast:" << request.title;
+                return Decision::Drop;
+            }
+            known = true;
+            break;
+        }
+    }
+    if (!known) {
+        m_contents.emplace(hash,
+                           Content { request.appID, request.title, request.body,
+                                     request.buttons, request.sound, request.image, now });
+        m_contentQueue.emplace_back(now, hash);
+    }
+    const auto id = request.id.empty() ? m_ids.end() : m_ids.find(request.id);
+    if (id != m_ids.end() && !expired(id->second, now)) {
+        id->second = now;
+        ++m_statistics.replaced;
+        return Decision::Replace;
+    }
+
+    const auto [it, isNew] = m_applications.try_emplace(request.appID);
+    auto &application = it->second;
+    if (isNew) {
+        m_applicationQueue.emplace_back(now, request.appID);
+    } else {
+        prune(application, now);
+    }
+    if (application.shown.size() < m_policy.limit) {
+        application.shown.push_back(now);
+        if (id != m_ids.end()) {
+            id->second = now;
+        } else if (!request.id.empty()) {
+            m_ids.emplace(request.id, now);
+            m_idQueue.emplace_back(now, request.id);
+        }
+        ++m_statistics.shown;
+        return Decision::Show;
+    }
+    const size_t count = ++application.summarized;
+    application.lastSummary = now;
+    ++m_statistics.summarized;
+    tLog << L"Summarized" << count << L"toasts of" << request.appID;
+
+    // the summary replaces the previous summary of the application
+    request.id = L"snoretoast.summary." + request.appID;
+    request.body = request.title + L"\n" + request.body;
+    request.title = std::to_wstring(count)
+            + (count == 1 ? L" more notification" : L" more notifications");
+    request.buttons.clear();
+    request.isTextBoxEnabled = false;
+    return Decision::Summarize;
+}
+
+void ToastCoalescer::expire(std::chrono::steady_clock::time_point now)
+{
+    // an entry seen again since it was queued is queued again with the time it was last seen,
+    // every entry is queued once, no matter how often it is repeated
+    while (!m_contentQueue.empty() && expired(m_contentQueue.front().first, now)) {
+        const uint64_t hash = m_contentQueue.front().second;
+        m_contentQueue.pop_front();
+        // one entry for all toasts with the hash
+        auto next = std::chrono::steady_clock::time_point::max();
+        const auto [first, last] = m_contents.equal_range(hash);
+        for (auto it = first; it != last;) {
+            if (expired(it->second.seen, now)) {
+                it = m_contents.erase(it);
+            } else {
+                next = std::min(next, it->second.seen);
+                ++it;
+            }
+        }
+        if (next != std::chrono::steady_clock::time_point::max()) {
+            m_contentQueue.emplace_back(next, hash);
+        }
+    }
+    while (!m_idQueue.empty() && expired(m_idQueue.front().first, now)) {
+        auto id = std::move(m_idQueue.front().second);
+        m_idQueue.pop_front();
+        const auto it = m_ids.find(id);
+        if (it == m_ids.end()) {
+            continue;
+        }
+        if (expired(it->second, now)) {
+            m_ids.erase(it);
+        } else {
+            m_idQueue.emplace_back(it->second, std::move(id));
+        }
+    }
+    while (!m_applicationQueue.empty() && expired(m_applicationQueue.front().first, now)) {
+        auto appID = std::move(m_applicationQueue.front().second);
+        m_applicationQueue.pop_front();
+        const auto it = m_applications.find(appID);
+        if (it == m_applications.end()) {
+            continue;
+        }
+        auto &application = it->second;
+        prune(application, now);
+        if (!application.shown.empty()) {
+            m_applicationQueue.emplace_back(application.shown.front(), std::move(appID));
+        } else if (application.summarized > 0) {
+            m_applicationQueue.emplace_back(application.lastSummary, std::move(appID));
+        } else {
+            m_applications.erase(it);
+        }
+    }
+}
+
+void ToastCoalescer::prune(Application &application, std::chrono::steady_clock::time_point now)
+{
+    while (!application.shown.empty() && expired(application.shown.front(), now)) {
+        application.shown.pop_front();
+    }
+    if (application.summarized > 0 && expired(application.lastSummary, now)) {
+        application.summarized = 0;
+    }
+}
+
+bool ToastCoalescer::expired(std::chrono::steady_clock::time_point time,
+                             std::chrono::steady_clock::time_point now) const
+{
+    return now - time >= m_policy.window;
+}
+
+ToastCoalescer::Statistics ToastCoalescer::statistics() const
+{
+    std::scoped_lock lock(m_mutex);
+    return m_statistics;
+}
+
+uint64_t ToastCoalescer::contentHash(const ToastRequest &request)
+{
+    uint64_t hash = FnvOffset;
+    for (const std::wstring_view field : { std::wstring_view(request.appID),
+                                           std::wstring_view(request.title),
+                                           std::wstring_view(request.body),
+                                           std::wstring_view(request.buttons),
+                                           std::wstring_view(request.sound) }) {
+        hashField(hash, field);
+    }
+    hashField(hash,
+              std::basic_string_view<std::filesystem::path::value_type>(request.image.native()));
+    return hash;
+}
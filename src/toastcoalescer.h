@@ -0,0 +1,128 @@
+/*
+    SnoreToast is capable to invoke Windows 8 toast notifications.
+    Copyright (C) 2026  Hannah von Reth <vonreth@kde.org>
+
+    SnoreToast is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    SnoreToast is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with SnoreToast.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#pragma once
+
+#include "toastrequest.h"
+
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <filesystem>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+/**
+ * Thins out bursts of toasts received by -server or -batch.
+ *
+ * Within the window a toast identical to a previous one is dropped, every repeat extends the
+ * window. A toast reusing the id of a recent toast replaces it in place. More than limit
+ * toasts of one application are collapsed into a single summary toast, which counts the
+ * collapsed toasts and shows the latest of them.
+ *
+ * The clock can be replaced, the decisions only depend on the submitted requests and the
+ * time returned by the clock.
+ */
+class ToastCoalescer
+{
+public:
+    using Clock = std::function<std::chrono::steady_clock::time_point()>;
+
+    struct Policy
+    {
+        std::chrono::milliseconds window = std::chrono::seconds(2);
+        // the toasts of an application displayed within the window before they are summarized
+        size_t limit = 5;
+    };
+
+    enum class Decision {
+        Show,
+        Replace, // show, the toast replaces a toast with the same id
+        Summarize, // show the summary toast the request was changed to
+        Drop
+    };
+
+    struct Statistics
+    {
+        uint64_t shown = 0;
+        uint64_t replaced = 0;
+        uint64_t summarized = 0;
+        uint64_t dropped = 0;
+    };
+
+    explicit ToastCoalescer(Policy policy, Clock clock = std::chrono::steady_clock::now);
+
+    ToastCoalescer(const ToastCoalescer &) = delete;
+    ToastCoalescer &operator=(const ToastCoalescer &) = delete;
+
+    /**
+     * Decides how request is displayed, for Summarize request is replaced by the summary.
+     * Requests other than Mode::Toast are always shown unchanged. Thread safe.
+     */
+    Decision submit(ToastRequest &request);
+
+    Statistics statistics() const;
+
+    /**
+     * The hash identifying identical toasts, the id is not part of it.
+     */
+    static uint64_t contentHash(const ToastRequest &request);
+
+private:
+    // the fields compared for identical toasts, kept to tell a hash collision from a repeat
+    struct Content
+    {
+        std::wstring appID;
+        std::wstring title;
+        std::wstring body;
+        std::wstring buttons;
+        std::wstring sound;
+        std::filesystem::path image;
+        // the last time the toast was seen
+        std::chrono::steady_clock::time_point seen;
+    };
+
+    struct Application
+    {
+        // the toasts counted against the limit
+        std::deque<std::chrono::steady_clock::time_point> shown;
+        size_t summarized = 0;
+        std::chrono::steady_clock::time_point lastSummary;
+    };
+
+    void expire(std::chrono::steady_clock::time_point now);
+    void prune(Application &application, std::chrono::steady_clock::time_point now);
+    bool expired(std::chrono::steady_clock::time_point time,
+                 std::chrono::steady_clock::time_point now) const;
+
+    const Policy m_policy;
+    const Clock m_clock;
+
+    mutable std::mutex m_mutex;
+    std::unordered_multimap<uint64_t, Content> m_contents;
+    // the last time an id was seen
+    std::unordered_map<std::wstring, std::chrono::steady_clock::time_point> m_ids;
+    std::unordered_map<std::wstring, Application> m_applications;
+    // the entries expire() checks once their time left the window, so it only looks at the
+    // expired entries; submit() checks the time of an entry itself
+    std::deque<std::pair<std::chrono::steady_clock::time_point, uint64_t>> m_contentQueue;
+    std::deque<std::pair<std::chrono::steady_clock::time_point, std::wstring>> m_idQueue;
+    std::deque<std::pair<std::chrono::steady_clock::time_point, std::wstring>> m_applicationQueue;
+    Statistics m_statistics;
+};
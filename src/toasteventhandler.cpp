@@ -15,75 +15,53 @@
     You should have received a copy of the GNU Lesser General Public License
     along with SnoreToast.  If not, see <http://www.gnu.org/licenses/>.
 */
-#include "snoretoasts.h"
 #include "toasteventhandler.h"
+#include "toasttrace.h"
 #include "utils.h"
 
-#include <sstream>
 #include <iostream>
-#include <wchar.h>
-#include <algorithm>
-#include <assert.h>
 
 using namespace ABI::Windows::UI::Notifications;
 
-ToastEventHandler::ToastEventHandler(const SnoreToasts &toast)
-    : m_ref(1), m_userAction(SnoreToastActions::Actions::Hidden), m_toast(toast)
+ToastEventHandler::ToastEventHandler(NotificationListener *listener)
+    : m_ref(1), m_listener(listener)
 {
-    std::wstringstream eventName;
-    eventName << L"ToastEvent" << m_toast.id();
-    m_event = CreateEventW(nullptr, true, false, eventName.str().c_str());
 }
 
-ToastEventHandler::~ToastEventHandler()
-{
-    CloseHandle(m_event);
-}
+ToastEventHandler::~ToastEventHandler() { }
 
-HANDLE ToastEventHandler::event()
+void ToastEventHandler::setListener(NotificationListener *listener)
 {
-    return m_event;
+    std::scoped_lock lock(m_mutex);
+    m_listener = listener;
 }
 
-SnoreToastActions::Actions &ToastEventHandler::userAction()
+void ToastEventHandler::replaced()
 {
-    return m_userAction;
+    std::scoped_lock lock(m_mutex);
+    if (m_listener) {
+        m_listener->replaced();
+    }
 }
 
 // DesktopToastActivatedEventHandler
 IFACEMETHODIMP ToastEventHandler::Invoke(_In_ IToastNotification * /*sender*/,
                                          _In_ IInspectable *args)
 {
+    ST_TRACE("ToastEventHandler::Activated");
     IToastActivatedEventArgs *buttonReply = nullptr;
     args->QueryInterface(&buttonReply);
     if (buttonReply == nullptr) {
         std::wcerr << L"args is not a IToastActivatedEventArgs" << std::endl;
-    } else {
-        HSTRING args;
-        buttonReply->get_Arguments(&args);
-        std::wstring data = WindowsGetStringRawBuffer(args, nullptr);
-        tLog << data;
-        const auto dataMap = Utils::splitData(data);
-        const auto action = SnoreToastActions::getAction(dataMap.at(L"action"));
-        assert(dataMap.at(L"notificationId") == m_toast.id());
-
-        if (action == SnoreToastActions::Actions::TextEntered) {
-            // The text is only passed to the named pipe
-            tLog << L"The user entered a text.";
-            m_userAction = SnoreToastActions::Actions::TextEntered;
-        } else if (action == SnoreToastActions::Actions::Clicked) {
-            tLog << L"The user clicked on the toast.";
-            m_userAction = SnoreToastActions::Actions::Clicked;
-        } else {
-            tLog << L"The user clicked on a toast button.";
-            std::wcout << dataMap.at(L"button") << std::endl;
-            m_userAction = SnoreToastActions::Actions::ButtonClicked;
-        }
-        if (m_toast.useFalbackMode() && !m_toast.pipeName().empty()) {
-            Utils::writePipe(m_toast.pipeName(), m_toast.formatAction(m_userAction));
-        }
+        return S_OK;
     }
-    SetEvent(m_event);
+    HSTRING arguments;
+    buttonReply->get_Arguments(&arguments);
+    std::scoped_lock lock(m_mutex);
+    if (m_listener) {
+        m_listener->activated(WindowsGetStringRawBuffer(arguments, nullptr));
+    }
+    buttonReply->Release();
     return S_OK;
 }
 
@@ -91,28 +69,27 @@ IFACEMETHODIMP ToastEventHandler::Invoke(_In_ IToastNotification * /*sender*/,
 IFACEMETHODIMP ToastEventHandler::Invoke(_In_ IToastNotification * /* sender */,
                                          _In_ IToastDismissedEventArgs *e)
 {
+    ST_TRACE("ToastEventHandler::Dismissed");
     ToastDismissalReason tdr;
     HRESULT hr = e->get_Reason(&tdr);
+    DismissalReason reason = DismissalReason::ApplicationHidden;
     if (SUCCEEDED(hr)) {
         switch (tdr) {
         case ToastDismissalReason_ApplicationHidden:
-            tLog << L"The application hid the toast using ToastNotifier.hide()";
-            m_userAction = SnoreToastActions::Actions::Hidden;
+            reason = DismissalReason::ApplicationHidden;
             break;
         case ToastDismissalReason_UserCanceled:
-            tLog << L"The user dismissed this toast";
-            m_userAction = SnoreToastActions::Actions::Dismissed;
+            reason = DismissalReason::UserCanceled;
             break;
         case ToastDismissalReason_TimedOut:
-            tLog << L"The toast has timed out";
-            m_userAction = SnoreToastActions::Actions::Timedout;
+            reason = DismissalReason::TimedOut;
             break;
         }
     }
-    if (!m_toast.pipeName().empty()) {
-        Utils::writePipe(m_toast.pipeName(), m_toast.formatAction(m_userAction));
+    std::scoped_lock lock(m_mutex);
+    if (m_listener) {
+        m_listener->dismissed(reason);
     }
-    SetEvent(m_event);
     return S_OK;
 }
 
@@ -120,10 +97,11 @@ IFACEMETHODIMP ToastEventHandler::Invoke(_In_ IToastNotification * /* sender */,
 IFACEMETHODIMP ToastEventHandler::Invoke(_In_ IToastNotification * /* sender */,
                                          _In_ IToastFailedEventArgs * /* e */)
 {
-    std::wcerr << L"The toast encountered an error." << std::endl;
-    std::wcerr << L"Please make sure that the app id is set correctly." << std::endl;
+    ST_TRACE("ToastEventHandler::Failed");
     std::wcerr << L"Command Line: " << GetCommandLineW() << std::endl;
-    m_userAction = SnoreToastActions::Actions::Error;
-    SetEvent(m_event);
+    std::scoped_lock lock(m_mutex);
+    if (m_listener) {
+        m_listener->failed();
+    }
     return S_OK;
 }
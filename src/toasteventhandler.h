@@ -16,7 +16,9 @@
     along with SnoreToast.  If not, see <http://www.gnu.org/licenses/>.
 */
 #pragma once
-#include "snoretoasts.h"
+#include "winrtnotificationbackend.h"
+
+#include <mutex>
 
 typedef ABI::Windows::Foundation::ITypedEventHandler<
         ABI::Windows::UI::Notifications::ToastNotification *, ::IInspectable *>
@@ -36,11 +38,18 @@ class ToastEventHandler : public Microsoft::WRL::Implements<DesktopToastActivate
 {
 
 public:
-    explicit ToastEventHandler::ToastEventHandler(const SnoreToasts &toast);
+    explicit ToastEventHandler(NotificationListener *listener);
     ~ToastEventHandler();
 
-    HANDLE event();
-    SnoreToastActions::Actions &userAction();
+    /**
+     * Events arriving after the listener was reset to nullptr are ignored.
+     */
+    void setListener(NotificationListener *listener);
+    /**
+     * Tells the listener that another toast replaced the toast, ignored like the events once
+     * the listener was reset.
+     */
+    void replaced();
 
     // DesktopToastActivatedEventHandler
     IFACEMETHODIMP Invoke(_In_ ABI::Windows::UI::Notifications::IToastNotification *sender,
@@ -90,7 +99,6 @@ public:
 
 private:
     ULONG m_ref;
-    SnoreToastActions::Actions m_userAction;
-    HANDLE m_event;
-    const SnoreToasts &m_toast;
+    std::mutex m_mutex;
+    NotificationListener *m_listener;
 };
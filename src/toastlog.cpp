@@ -0,0 +1,486 @@
+/*
+    SnoreToast is capable to invoke Windows 8 toast notifications.
+    Copyright (C) 2019  Hannah von Reth <vonreth@kde.org>
+
+    SnoreToast is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    SnoreToast is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with SnoreToast.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "toastlog.h"
+#include "coreutils.h"
+#include "snoretoasts.h"
+#include "stringutils.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#ifdef _WIN32
+#include <windows.h>
+#endif
+
+namespace {
+constexpr size_t RingCapacity = 128 * 1024;
+constexpr auto SinkInterval = std::chrono::milliseconds(10);
+
+struct RecordHeader
+{
+    // the number of characters, or WrapMarker
+    uint32_t length;
+    ToastLog::Level level;
+    uint8_t padding[3];
+    uint64_t time;
+};
+static_assert(sizeof(RecordHeader) == 16, "records are aligned to the header size");
+
+constexpr uint32_t WrapMarker = UINT32_MAX;
+constexpr size_t MaxRecordLength = (RingCapacity / 4 - sizeof(RecordHeader)) / sizeof(wchar_t);
+
+constexpr size_t recordSize(size_t length)
+{
+    const size_t size = sizeof(RecordHeader) + length * sizeof(wchar_t);
+    return (size + sizeof(RecordHeader) - 1) & ~(sizeof(RecordHeader) - 1);
+}
+
+/**
+ * A single producer single consumer ring of records.
+ * The producer is the owning thread, the consumer is serialized by LogSink.
+ */
+class RingBuffer
+{
+public:
+    explicit RingBuffer(uint32_t thread)
+        : thread(thread),
+          m_data(std::make_unique<RecordHeader[]>(RingCapacity / sizeof(RecordHeader)))
+    {
+    }
+
+    /**
+     * Returns false if the record did not fit, sets full if the ring is filling up.
+     */
+    bool write(ToastLog::Level level, uint64_t time, std::wstring_view text, bool &full)
+    {
+        text = text.substr(0, MaxRecordLength);
+        const size_t size = recordSize(text.size());
+        uint64_t head = m_head.load(std::memory_order_relaxed);
+        const uint64_t tail = m_tail.load(std::memory_order_acquire);
+        size_t offset = head % RingCapacity;
+        const size_t wrap = offset + size > RingCapacity ? RingCapacity - offset : 0;
+        const size_t used = head - tail;
+        full = used + wrap + size > RingCapacity / 2;
+        if (used + wrap + size > RingCapacity) {
+            return false;
+        }
+        if (wrap) {
+            RecordHeader marker = {};
+            marker.length = WrapMarker;
+            std::memcpy(data() + offset, &marker, sizeof(marker));
+            head += wrap;
+            offset = 0;
+        }
+        RecordHeader header = {};
+        header.length = static_cast<uint32_t>(text.size());
+        header.level = level;
+        header.time = time;
+        std::memcpy(data() + offset, &header, sizeof(header));
+        std::memcpy(data() + offset + sizeof(header), text.data(), text.size() * sizeof(wchar_t));
+        m_head.store(head + size, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * Passes the records to f, text is the buffer the records are copied to.
+     */
+    template<typename F>
+    void drain(std::wstring &text, F &&f)
+    {
+        uint64_t tail = m_tail.load(std::memory_order_relaxed);
+        const uint64_t head = m_head.load(std::memory_order_acquire);
+        while (tail != head) {
+            const size_t offset = tail % RingCapacity;
+            RecordHeader header;
+            std::memcpy(&header, data() + offset, sizeof(header));
+            if (header.length == WrapMarker) {
+                tail += RingCapacity - offset;
+                continue;
+            }
+            text.resize(header.length);
+            std::memcpy(text.data(), data() + offset + sizeof(header),
+                        header.length * sizeof(wchar_t));
+            f(header, text);
+            tail += recordSize(header.length);
+        }
+        m_tail.store(tail, std::memory_order_release);
+    }
+
+    bool isEmpty() const
+    {
+        return m_head.load(std::memory_order_acquire) == m_tail.load(std::memory_order_acquire);
+    }
+
+    const uint32_t thread;
+    // set when the owning thread exited
+    std::atomic<bool> closed = false;
+
+private:
+    char *data() { return reinterpret_cast<char *>(m_data.get()); }
+
+    std::unique_ptr<RecordHeader[]> m_data;
+    alignas(64) std::atomic<uint64_t> m_head = 0;
+    alignas(64) std::atomic<uint64_t> m_tail = 0;
+};
+
+ToastLog::Level parseLevel(const char *level, ToastLog::Level fallback)
+{
+    if (!level) {
+        return fallback;
+    }
+    constexpr std::pair<std::string_view, ToastLog::Level> levels[] = {
+        { "trace", ToastLog::Level::Trace },     { "debug", ToastLog::Level::Debug },
+        { "info", ToastLog::Level::Info },       { "warning", ToastLog::Level::Warning },
+        { "error", ToastLog::Level::Error },     { "off", ToastLog::Level::Off },
+    };
+    for (const auto &entry : levels) {
+        if (entry.first == level) {
+            return entry.second;
+        }
+    }
+    return fallback;
+}
+
+const wchar_t *levelName(ToastLog::Level level)
+{
+    switch (level) {
+    case ToastLog::Level::Trace:
+        return L"Trace";
+    case ToastLog::Level::Debug:
+        return L"Debug";
+    case ToastLog::Level::Info:
+        return L"Info";
+    case ToastLog::Level::Warning:
+        return L"Warning";
+    case ToastLog::Level::Error:
+        return L"Error";
+    case ToastLog::Level::Off:
+        break;
+    }
+    return L"";
+}
+
+/**
+ * Owns the ring buffers and the background thread writing them to the outputs.
+ * The sink is never destroyed, it stops at exit and records logged after that are written
+ * synchronously.
+ */
+class LogSink
+{
+public:
+    static LogSink &instance()
+    {
+        static LogSink *sink = new LogSink;
+        return *sink;
+    }
+
+    void configure()
+    {
+        uint8_t outputs = ToastLog::NoOutput;
+#ifdef _WIN32
+        outputs |= ToastLog::Debugger;
+#else
+        // there is no debugger output, only log if explicitly requested
+        if (std::getenv("SNORETOAST_DEBUG")) {
+            outputs |= ToastLog::Stderr;
+        }
+#endif
+        std::filesystem::path file;
+        if (const char *path = std::getenv("SNORETOAST_LOG_FILE")) {
+            outputs |= ToastLog::File;
+            file = path;
+        }
+        setOutputs(outputs, file);
+        ToastLog::setLevel(parseLevel(std::getenv("SNORETOAST_LOG_LEVEL"),
+                                      outputs ? ToastLog::Level::Debug : ToastLog::Level::Off));
+    }
+
+    void push(ToastLog::Level level, uint64_t time, std::wstring_view text);
+
+    void setOutputs(uint8_t outputs, const std::filesystem::path &file)
+    {
+        std::scoped_lock lock(m_mutex);
+        drain();
+        if (m_file) {
+            std::fclose(m_file);
+            m_file = nullptr;
+        }
+        if (outputs & ToastLog::File) {
+#ifdef _WIN32
+            m_file = _wfopen(file.c_str(), L"ab");
+#else
+            m_file = std::fopen(file.c_str(), "ab");
+#endif
+        }
+        m_outputs = outputs;
+        m_headerPending = true;
+    }
+
+    void flush()
+    {
+        std::scoped_lock lock(m_mutex);
+        drain();
+    }
+
+    std::atomic<uint64_t> dropped = 0;
+
+private:
+    struct ThreadBuffer
+    {
+        ~ThreadBuffer()
+        {
+            if (ring) {
+                ring->closed.store(true, std::memory_order_release);
+            }
+        }
+        std::shared_ptr<RingBuffer> ring;
+    };
+
+    RingBuffer *threadBuffer();
+    void run();
+    void stop();
+    // the following require m_mutex
+    void drain();
+    void write(uint32_t thread, ToastLog::Level level, uint64_t time, std::wstring_view text);
+    void output(const std::wstring &line);
+
+    std::mutex m_mutex;
+    std::condition_variable m_condition;
+    std::vector<std::shared_ptr<RingBuffer>> m_rings;
+    uint32_t m_threads = 0;
+    uint64_t m_reportedDrops = 0;
+    uint8_t m_outputs = ToastLog::NoOutput;
+    FILE *m_file = nullptr;
+    bool m_headerPending = true;
+    std::wstring m_text;
+    std::wstring m_line;
+    std::string m_utf8;
+    std::thread m_thread;
+    bool m_stop = false;
+    std::atomic<bool> m_stopped = false;
+};
+
+RingBuffer *LogSink::threadBuffer()
+{
+    static thread_local ThreadBuffer buffer;
+    if (!buffer.ring) {
+        std::scoped_lock lock(m_mutex);
+        buffer.ring = std::make_shared<RingBuffer>(++m_threads);
+        m_rings.push_back(buffer.ring);
+        if (!m_thread.joinable()) {
+            m_thread = std::thread([this] { run(); });
+            std::atexit([] { LogSink::instance().stop(); });
+        }
+    }
+    return buffer.ring.get();
+}
+
+void LogSink::push(ToastLog::Level level, uint64_t time, std::wstring_view text)
+{
+    if (m_stopped.load(std::memory_order_acquire)) {
+        std::scoped_lock lock(m_mutex);
+        write(0, level, time, text);
+        return;
+    }
+    bool full;
+    if (!threadBuffer()->write(level, time, text, full)) {
+        dropped.fetch_add(1, std::memory_order_relaxed);
+    }
+    if (full || level >= ToastLog::Level::Warning) {
+        m_condition.notify_one();
+    }
+}
+
+void LogSink::run()
+{
+    std::unique_lock lock(m_mutex);
+    while (!m_stop) {
+        m_condition.wait_for(lock, SinkInterval);
+        drain();
+    }
+}
+
+void LogSink::stop()
+{
+    {
+        std::scoped_lock lock(m_mutex);
+        m_stop = true;
+    }
+    m_condition.notify_one();
+    if (m_thread.joinable()) {
+        m_thread.join();
+    }
+    std::scoped_lock lock(m_mutex);
+    m_stopped.store(true, std::memory_order_release);
+    drain();
+}
+
+void LogSink::drain()
+{
+    for (auto it = m_rings.begin(); it != m_rings.end();) {
+        auto &ring = **it;
+        // read closed first, the last records of a closed ring must not be missed
+        const bool closed = ring.closed.load(std::memory_order_acquire);
+        ring.drain(m_text, [this, &ring](const RecordHeader &header, std::wstring_view text) {
+            write(ring.thread, header.level, header.time, text);
+        });
+        if (closed && ring.isEmpty()) {
+            it = m_rings.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    const uint64_t dropped = this->dropped.load(std::memory_order_relaxed);
+    if (dropped != m_reportedDrops) {
+        m_line = L"Dropped " + std::to_wstring(dropped - m_reportedDrops) + L" log records\n";
+        m_reportedDrops = dropped;
+        if (m_outputs) {
+            output(m_line);
+        }
+    }
+    if (m_file) {
+        std::fflush(m_file);
+    }
+}
+
+void LogSink::write(uint32_t thread, ToastLog::Level level, uint64_t time, std::wstring_view text)
+{
+    if (!m_outputs) {
+        return;
+    }
+    if (m_headerPending) {
+        m_headerPending = false;
+        m_line = Utils::selfLocate().wstring() + L" v" + SnoreToasts::version() + L"\n";
+        output(m_line);
+    }
+    const auto ns = std::chrono::nanoseconds(time);
+    const std::time_t seconds = std::chrono::duration_cast<std::chrono::seconds>(ns).count();
+    std::tm tm = {};
+#ifdef _WIN32
+    localtime_s(&tm, &seconds);
+#else
+    localtime_r(&seconds, &tm);
+#endif
+    wchar_t stamp[64];
+    const auto milliseconds =
+            std::chrono::duration_cast<std::chrono::milliseconds>(ns).count() % 1000;
+    std::swprintf(stamp, 64, L"[%02d:%02d:%02d.%03d] ", tm.tm_hour, tm.tm_min, tm.tm_sec,
+                  static_cast<int>(milliseconds));
+    m_line.assign(stamp);
+    m_line.append(levelName(level));
+    m_line.append(L" T");
+    m_line.append(std::to_wstring(thread));
+    m_line.push_back(L' ');
+    m_line.append(text);
+    m_line.push_back(L'\n');
+    output(m_line);
+}
+
+void LogSink::output(const std::wstring &line)
+{
+#ifdef _WIN32
+    if (m_outputs & ToastLog::Debugger) {
+        OutputDebugStringW(line.c_str());
+    }
+#endif
+    if (m_outputs & (ToastLog::Stderr | ToastLog::File)) {
+        m_utf8 = Utils::toUtf8(line);
+        if (m_outputs & ToastLog::Stderr) {
+            std::fwrite(m_utf8.data(), 1, m_utf8.size(), stderr);
+        }
+        if (m_file) {
+            std::fwrite(m_utf8.data(), 1, m_utf8.size(), m_file);
+        }
+    }
+}
+
+// read the environment before main
+const bool s_configured = [] {
+    LogSink::instance().configure();
+    return true;
+}();
+}
+
+ToastLog::ToastLog(Level level, const char *function) : m_level(level)
+{
+    static thread_local bool inUse = false;
+    // a record might be created while formatting another one
+    m_buffer = inUse ? &m_nested : nullptr;
+    if (!m_buffer) {
+        static thread_local std::wstring text;
+        inUse = true;
+        m_buffer = &text;
+        m_owner = &inUse;
+    }
+    m_buffer->clear();
+    m_time = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                     std::chrono::system_clock::now().time_since_epoch())
+                     .count();
+    appendNarrow(function);
+    m_buffer->append(L"\n\t\t");
+}
+
+ToastLog::~ToastLog()
+{
+    LogSink::instance().push(m_level, m_time, *m_buffer);
+    if (m_owner) {
+        *m_owner = false;
+    }
+}
+
+void ToastLog::appendNarrow(std::string_view data)
+{
+    const size_t size = m_buffer->size();
+    m_buffer->resize(size + data.size());
+    for (size_t i = 0; i < data.size(); ++i) {
+        (*m_buffer)[size + i] = static_cast<wchar_t>(static_cast<unsigned char>(data[i]));
+    }
+}
+
+ToastLog::Level ToastLog::level()
+{
+    return s_level.load(std::memory_order_relaxed);
+}
+
+void ToastLog::setLevel(Level level)
+{
+    s_level.store(level, std::memory_order_relaxed);
+}
+
+void ToastLog::setOutputs(uint8_t outputs, const std::filesystem::path &file)
+{
+    LogSink::instance().setOutputs(outputs, file);
+}
+
+void ToastLog::flush()
+{
+    LogSink::instance().flush();
+}
+
+uint64_t ToastLog::droppedRecords()
+{
+    return LogSink::instance().dropped.load(std::memory_order_relaxed);
+}
@@ -0,0 +1,178 @@
+/*
+    SnoreToast is capable to invoke Windows 8 toast notifications.
+    Copyright (C) 2019  Hannah von Reth <vonreth@kde.org>
+
+    SnoreToast is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    SnoreToast is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with SnoreToast.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#pragma once
+
+#include <atomic>
+#include <charconv>
+#include <cstdint>
+#include <filesystem>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+/**
+ * Levels below SNORETOAST_LOG_MIN_LEVEL are removed at compile time,
+ * 0 is Trace and 5 disables the log.
+ */
+#ifndef SNORETOAST_LOG_MIN_LEVEL
+#define SNORETOAST_LOG_MIN_LEVEL 0
+#endif
+
+/**
+ * A single log record, created by the tLog family of macros.
+ *
+ * The record is formatted on the calling thread and passed to a per thread ring buffer,
+ * a background sink writes it to the outputs. Disabled levels cost a single relaxed load,
+ * the arguments of a disabled record are not evaluated.
+ *
+ * The log is configured by the environment:
+ * SNORETOAST_LOG_LEVEL (trace, debug, info, warning, error or off),
+ * SNORETOAST_LOG_FILE to log to a file and, outside of Windows, SNORETOAST_DEBUG to log
+ * to stderr. On Windows the log is always passed to OutputDebugString.
+ */
+class ToastLog
+{
+public:
+    enum class Level : uint8_t {
+        Trace,
+        Debug,
+        Info,
+        Warning,
+        Error,
+        Off
+    };
+
+    enum Output : uint8_t {
+        NoOutput = 0,
+        Debugger = 1 << 0,
+        Stderr = 1 << 1,
+        File = 1 << 2
+    };
+
+    ToastLog(Level level, const char *function);
+    ~ToastLog();
+
+    ToastLog(const ToastLog &) = delete;
+    ToastLog &operator=(const ToastLog &) = delete;
+
+    inline ToastLog &log() { return *this; }
+
+    static inline bool isEnabled(Level level)
+    {
+        // without a minimum the comparison of the unsigned level would always be true
+#if SNORETOAST_LOG_MIN_LEVEL > 0
+        if (static_cast<int>(level) < SNORETOAST_LOG_MIN_LEVEL) {
+            return false;
+        }
+#endif
+        return level >= s_level.load(std::memory_order_relaxed);
+    }
+
+    static Level level();
+    static void setLevel(Level level);
+
+    /**
+     * Replaces the outputs of the sink, file is only used with Output::File.
+     */
+    static void setOutputs(uint8_t outputs, const std::filesystem::path &file = {});
+
+    /**
+     * Blocks until the records of all threads were written.
+     */
+    static void flush();
+
+    /**
+     * The records discarded because a ring buffer was full.
+     */
+    static uint64_t droppedRecords();
+
+private:
+    template<typename T>
+    void append(const T &t);
+    void appendNarrow(std::string_view data);
+
+    static inline std::atomic<Level> s_level { Level::Off };
+
+    // a thread local buffer, or m_nested if the buffer is in use by an outer record
+    std::wstring *m_buffer;
+    std::wstring m_nested;
+    bool *m_owner = nullptr;
+    uint64_t m_time;
+    Level m_level;
+
+    template<typename T>
+    friend ToastLog &operator<<(ToastLog &, const T &);
+};
+
+template<typename T>
+void ToastLog::append(const T &t)
+{
+    using Type = std::decay_t<T>;
+    if constexpr (std::is_same_v<Type, bool>) {
+        m_buffer->append(t ? L"true" : L"false");
+    } else if constexpr (std::is_same_v<Type, wchar_t>) {
+        m_buffer->push_back(t);
+    } else if constexpr (std::is_same_v<Type, char>) {
+        m_buffer->push_back(static_cast<wchar_t>(static_cast<unsigned char>(t)));
+    } else if constexpr (std::is_integral_v<Type> || std::is_floating_point_v<Type>) {
+        char buf[32];
+        const auto result = std::to_chars(buf, buf + sizeof(buf), t);
+        appendNarrow({ buf, static_cast<size_t>(result.ptr - buf) });
+    } else if constexpr (std::is_convertible_v<const T &, std::wstring_view>) {
+        m_buffer->append(std::wstring_view(t));
+    } else if constexpr (std::is_convertible_v<const T &, std::string_view>) {
+        appendNarrow(std::string_view(t));
+    } else if constexpr (std::is_same_v<Type, std::filesystem::path>) {
+        m_buffer->push_back(L'"');
+        if constexpr (std::is_same_v<std::filesystem::path::value_type, wchar_t>) {
+            m_buffer->append(t.native());
+        } else {
+            m_buffer->append(t.wstring());
+        }
+        m_buffer->push_back(L'"');
+    } else {
+        std::wostringstream stream;
+        stream << t;
+        m_buffer->append(stream.str());
+    }
+}
+
+template<typename T>
+ToastLog &operator<<(ToastLog &log, const T &t)
+{
+    log.m_buffer->push_back(L' ');
+    log.append(t);
+    return log;
+}
+
+#ifdef _MSC_VER
+#define ST_FUNCSIG __FUNCSIG__
+#else
+#define ST_FUNCSIG __PRETTY_FUNCTION__
+#endif
+
+#define ST_LOG(LEVEL)                                                                              \
+    if (!ToastLog::isEnabled(LEVEL)) {                                                             \
+    } else                                                                                         \
+        ToastLog(LEVEL, ST_FUNCSIG).log()
+
+#define tLog ST_LOG(ToastLog::Level::Debug)
+#define tInfo ST_LOG(ToastLog::Level::Info)
+#define tWarning ST_LOG(ToastLog::Level::Warning)
+#define tError ST_LOG(ToastLog::Level::Error)
@@ -0,0 +1,209 @@
+/*
+    SnoreToast is capable to invoke Windows 8 toast notifications.
+    Copyright (C) 2026  Hannah von Reth <vonreth@kde.org>
+
+    SnoreToast is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    SnoreToast is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with SnoreToast.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "toastregistry.h"
+
+#include <algorithm>
+
+ToastRegistry::ToastRegistry(Clock clock) : m_clock(std::move(clock)) { }
+
+ToastRegistry::Record &ToastRegistry::insert(Application &application, Entry entry)
+{
+    erase(application, entry.id);
+    application.ids.insert(entry.id);
+    application.groups[entry.group].insert(entry.id);
+    auto id = entry.id;
+    return application.records.emplace(std::move(id), Record { std::move(entry) }).first->second;
+}
+
+void ToastRegistry::erase(Application &application, const std::wstring &id)
+{
+    const auto it = application.records.find(id);
+    if (it == application.records.cend()) {
+        return;
+    }
+    const auto group = application.groups.find(it->second.entry.group);
+    group->second.erase(id);
+    if (group->second.empty()) {
+        application.groups.erase(group);
+    }
+    application.ids.erase(id);
+    application.records.erase(it);
+}
+
+void ToastRegistry::setGroup(Application &application, Record &record, const std::wstring &group)
+{
+    const auto &id = record.entry.id;
+    const auto previous = application.groups.find(record.entry.group);
+    previous->second.erase(id);
+    if (previous->second.empty()) {
+        application.groups.erase(previous);
+    }
+    application.groups[group].insert(id);
+    record.entry.group = group;
+}
+
+void ToastRegistry::add(const std::wstring &appID, const std::wstring &id,
+                        const std::wstring &group)
+{
+    Entry entry { id, group, m_clock() };
+    std::scoped_lock lock(m_mutex);
+    insert(m_applications[appID], std::move(entry));
+}
+
+bool ToastRegistry::remove(const std::wstring &appID, const std::wstring &id)
+{
+    std::scoped_lock lock(m_mutex);
+    const auto application = m_applications.find(appID);
+    if (application == m_applications.cend()) {
+        return false;
+    }
+    const size_t size = application->second.records.size();
+    erase(application->second, id);
+    const bool removed = application->second.records.size() != size;
+    if (application->second.records.empty()) {
+        m_applications.erase(application);
+    }
+    return removed;
+}
+
+std::optional<ToastRegistry::Entry> ToastRegistry::find(const std::wstring &appID,
+                                                        const std::wstring &id) const
+{
+    std::scoped_lock lock(m_mutex);
+    const auto application = m_applications.find(appID);
+    if (application == m_applications.cend()) {
+        return std::nullopt;
+    }
+    const auto it = application->second.records.find(id);
+    if (it == application->second.records.cend()) {
+        return std::nullopt;
+    }
+    return it->second.entry;
+}
+
+std::vector<ToastRegistry::Entry> ToastRegistry::withPrefix(const std::wstring &appID,
+                                                            std::wstring_view prefix) const
+{
+    std::vector<Entry> out;
+    std::scoped_lock lock(m_mutex);
+    const auto application = m_applications.find(appID);
+    if (application == m_applications.cend()) {
+        return out;
+    }
+    const auto &ids = application->second.ids;
+    for (auto it = ids.lower_bound(prefix);
+         it != ids.cend() && std::wstring_view(*it).substr(0, prefix.size()) == prefix; ++it) {
+        out.push_back(application->second.records.at(*it).entry);
+    }
+    return out;
+}
+
+std::vector<ToastRegistry::Entry> ToastRegistry::inGroup(const std::wstring &appID,
+                                                         const std::wstring &group) const
+{
+    std::vector<Entry> out;
+    std::scoped_lock lock(m_mutex);
+    const auto application = m_applications.find(appID);
+    if (application == m_applications.cend()) {
+        return out;
+    }
+    const auto ids = application->second.groups.find(group);
+    if (ids == application->second.groups.cend()) {
+        return out;
+    }
+    out.reserve(ids->second.size());
+    for (const auto &id : ids->second) {
+        out.push_back(application->second.records.at(id).entry);
+    }
+    return out;
+}
+
+std::vector<ToastRegistry::Entry> ToastRegistry::entries(const std::wstring &appID) const
+{
+    std::vector<Entry> out;
+    {
+        std::scoped_lock lock(m_mutex);
+        const auto application = m_applications.find(appID);
+        if (application == m_applications.cend()) {
+            return out;
+        }
+        out.reserve(application->second.records.size());
+        for (const auto &record : application->second.records) {
+            out.push_back(record.second.entry);
+        }
+    }
+    std::sort(out.begin(), out.end(), [](const Entry &a, const Entry &b) {
+        return a.created != b.created ? a.created < b.created : a.id < b.id;
+    });
+    return out;
+}
+
+size_t ToastRegistry::reconcile(const std::wstring &appID, const std::vector<HistoryEntry> &history)
+{
+    size_t changes = 0;
+    std::scoped_lock lock(m_mutex);
+    auto &application = m_applications[appID];
+    const uint64_t pass = ++application.reconciliations;
+    size_t found = 0;
+    for (const auto &entry : history) {
+        const auto it = application.records.find(entry.id);
+        if (it == application.records.end()) {
+            // a toast of another process or of an earlier run
+            insert(application, { entry.id, entry.group, {} }).reconciled = pass;
+            ++found;
+            ++changes;
+            continue;
+        }
+        if (it->second.reconciled == pass) {
+            continue;
+        }
+        if (it->second.entry.group != entry.group) {
+            setGroup(application, it->second, entry.group);
+            ++changes;
+        }
+        it->second.reconciled = pass;
+        ++found;
+    }
+    // usually nothing left the history
+    if (found < application.records.size()) {
+        std::vector<std::wstring> removed;
+        for (const auto &record : application.records) {
+            if (record.second.reconciled != pass) {
+                removed.push_back(record.first);
+            }
+        }
+        for (const auto &id : removed) {
+            erase(application, id);
+        }
+        changes += removed.size();
+    }
+    if (application.records.empty()) {
+        m_applications.erase(appID);
+    }
+    return changes;
+}
+
+size_t ToastRegistry::size() const
+{
+    std::scoped_lock lock(m_mutex);
+    size_t out = 0;
+    for (const auto &application : m_applications) {
+        out += application.second.records.size();
+    }
+    return out;
+}
@@ -0,0 +1,109 @@
+/*
+    SnoreToast is capable to invoke Windows 8 toast notifications.
+    Copyright (C) 2026  Hannah von Reth <vonreth@kde.org>
+
+    SnoreToast is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    SnoreToast is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with SnoreToast.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#pragma once
+
+#include "notificationbackend.h"
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <set>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+/**
+ * The notifications shown by the process, per application, that are displayed or in the
+ * action center history.
+ *
+ * A toast is looked up by id in constant time, the ids are also indexed by prefix and by
+ * group for bulk closing. Toasts that left the action center without an event of this process,
+ * or that were shown by other processes, are only noticed by reconcile(), which callers run
+ * before a query that depends on them.
+ */
+class ToastRegistry
+{
+public:
+    using Clock = std::function<std::chrono::system_clock::time_point()>;
+
+    struct Entry
+    {
+        std::wstring id;
+        std::wstring group;
+        // the default value if the toast was only found in the history
+        std::chrono::system_clock::time_point created;
+    };
+
+    explicit ToastRegistry(Clock clock = std::chrono::system_clock::now);
+
+    ToastRegistry(const ToastRegistry &) = delete;
+    ToastRegistry &operator=(const ToastRegistry &) = delete;
+
+    /**
+     * Records a shown toast, a toast with the same id is replaced like in the action center.
+     */
+    void add(const std::wstring &appID, const std::wstring &id, const std::wstring &group);
+    bool remove(const std::wstring &appID, const std::wstring &id);
+
+    std::optional<Entry> find(const std::wstring &appID, const std::wstring &id) const;
+    std::vector<Entry> withPrefix(const std::wstring &appID, std::wstring_view prefix) const;
+    std::vector<Entry> inGroup(const std::wstring &appID, const std::wstring &group) const;
+    /**
+     * All toasts of appID, the oldest first.
+     */
+    std::vector<Entry> entries(const std::wstring &appID) const;
+
+    /**
+     * Replaces the toasts of appID by the history of the notification system, toasts that are
+     * still known keep their creation time.
+     * Returns the number of added and removed toasts.
+     */
+    size_t reconcile(const std::wstring &appID, const std::vector<HistoryEntry> &history);
+
+    size_t size() const;
+
+private:
+    struct Record
+    {
+        Entry entry;
+        // the last reconcile() that found the toast in the history
+        uint64_t reconciled = 0;
+    };
+
+    struct Application
+    {
+        std::unordered_map<std::wstring, Record> records;
+        // the ids ordered for the prefix lookup
+        std::set<std::wstring, std::less<>> ids;
+        std::unordered_map<std::wstring, std::unordered_set<std::wstring>> groups;
+        uint64_t reconciliations = 0;
+    };
+
+    static Record &insert(Application &application, Entry entry);
+    static void erase(Application &application, const std::wstring &id);
+    static void setGroup(Application &application, Record &record, const std::wstring &group);
+
+    const Clock m_clock;
+
+    mutable std::mutex m_mutex;
+    std::unordered_map<std::wstring, Application> m_applications;
+};
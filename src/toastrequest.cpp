@@ -0,0 +1,319 @@
+/*
+    SnoreToast is capable to invoke Windows 8 toast notifications.
+    Copyright (C) 2026  Hannah von Reth <vonreth@kde.org>
+
+    SnoreToast is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    SnoreToast is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with SnoreToast.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "toastrequest.h"
+#include "mappedfile.h"
+#include "optionparser.h"
+
+#include <cwchar>
+
+namespace {
+using OptionParser::NoFlags;
+using OptionParser::Separated;
+using OptionParser::Terminal;
+using Option = OptionParser::Option<ToastRequest>;
+
+/**
+ * Parses a non negative decimal number, the handlers of the table can't fail so the error is
+ * passed on in request.error.
+ */
+bool toNumber(ToastRequest &request, const std::wstring &value, std::wstring_view option,
+              unsigned long long &out)
+{
+    wchar_t *end = nullptr;
+    out = std::wcstoull(value.c_str(), &end, 10);
+    if (value.empty() || value[0] < L'0' || value[0] > L'9' || *end != L'\0') {
+        request.error = value + L" is not a valid argument to " + std::wstring(option);
+        return false;
+    }
+    return true;
+}
+
+// the order of the help
+constexpr Option Options[] = {
+    Option::value(L"-t", L"<title string>",
+                  L"Displayed on the first line of the toast, - reads it from stdin.",
+                  [](ToastRequest &r, const std::wstring *v, size_t) { r.title = v[0]; }),
+    Option::value(L"-m", L"<message string>",
+                  L"Displayed on the remaining lines, wrapped, - reads it from stdin.",
+                  [](ToastRequest &r, const std::wstring *v, size_t) { r.body = v[0]; }),
+    Option::value(L"-b", L"<button1;button2 string>",
+                  L"Displayed on the bottom line, can list multiple buttons separated by \";\"",
+                  [](ToastRequest &r, const std::wstring *v, size_t) { r.buttons = v[0]; }),
+    Option::flag(L"-tb",
+                 L"Displayed a textbox on the bottom line, only if buttons are not presented.",
+                 [](ToastRequest &r, const std::wstring *, size_t) { r.isTextBoxEnabled = true; }),
+    Option::value(L"-p", L"<image URI>", L"Display toast with an image, local files only.",
+                  [](ToastRequest &r, const std::wstring *v, size_t) { r.image = v[0]; }),
+    Option::value(L"-id", L"<id>", L"sets the id for a notification to be able to close it later.",
+                  [](ToastRequest &r, const std::wstring *v, size_t) { r.id = v[0]; }),
+    Option::value(L"-group", L"<group>",
+                  L"Sets the group of a notification, default is \"SnoreToast\".",
+                  [](ToastRequest &r, const std::wstring *v, size_t) { r.group = v[0]; }),
+    Option::value(L"-s", L"<sound URI>",
+                  L"Sets the sound of the notifications, for possible values see "
+                  L"http://msdn.microsoft.com/en-us/library/windows/apps/hh761492.aspx.",
+                  [](ToastRequest &r, const std::wstring *v, size_t) { r.sound = v[0]; }),
+    Option::flag(L"-silent", L"Don't play a sound file when showing the notifications.",
+                 [](ToastRequest &r, const std::wstring *, size_t) { r.silent = true; }),
+    Option::choice(L"-d", L"(short | long)",
+                   L"Set the duration default is \"short\" 7s, \"long\" is 25s.",
+                   [](ToastRequest &r, const std::wstring *, size_t c) {
+                       r.duration = c == 0 ? Duration::Short : Duration::Long;
+                   }),
+    Option::choice(L"-priority", L"(low | normal | high)",
+                   L"The order in which the waiting toasts of -batch -maxVisible are displayed, "
+                   L"default is \"normal\".",
+                   [](ToastRequest &r, const std::wstring *, size_t c) {
+                       r.priority = static_cast<Priority>(c);
+                   }),
+    Option::value(L"-deadline", L"<milliseconds>",
+                  L"Drop the toast if it waited longer for -batch -maxVisible, it is reported as "
+                  L"timed out.",
+                  [](ToastRequest &r, const std::wstring *v, size_t) {
+                      unsigned long long deadline;
+                      if (toNumber(r, v[0], L"-deadline", deadline)) {
+                          r.deadline = std::chrono::milliseconds(deadline);
+                      }
+                  }),
+    Option::value(L"-appID", L"<App.ID>", L"Don't create a shortcut but use the provided app id.",
+                  [](ToastRequest &r, const std::wstring *v, size_t) { r.appID = v[0]; }),
+    Option::value(L"-pid", L"<pid>",
+                  L"Query the appid for the process <pid>, use -appID as fallback. (Only "
+                  L"relevant for applications that might be packaged for the store)",
+                  [](ToastRequest &r, const std::wstring *v, size_t) { r.pid = v[0]; }),
+    Option::value(L"-pipeName", L"<\\.\\pipe\\pipeName\\>",
+                  L"Provide a name pipe which is used for callbacks.",
+                  [](ToastRequest &r, const std::wstring *v, size_t) { r.pipe = v[0]; }),
+    Option::value(L"-application", L"<C:\\foo.exe>",
+                  L"Provide a application that might be started if the pipe does not exist.",
+                  [](ToastRequest &r, const std::wstring *v, size_t) { r.application = v[0]; }),
+    Option::choice(L"-protocol", L"(1 | 2)",
+                   L"The format of the callbacks written to the pipe, default is 1, see "
+                   L"snoretoastprotocol.h for 2.",
+                   [](ToastRequest &r, const std::wstring *, size_t c) {
+                       r.protocol = static_cast<unsigned>(c + 1);
+                   }),
+    Option::flag(L"-pipeKeepAlive",
+                 L"Keep the pipe open and write the callbacks of all notifications of -server or "
+                 L"-batch to it, requires -protocol 2.",
+                 [](ToastRequest &r, const std::wstring *, size_t) { r.pipeKeepAlive = true; }),
+    Option::value(L"-trace", L"<file>",
+                  L"Write a Chrome trace of the notification stages to file, see "
+                  L"chrome://tracing or https://ui.perfetto.dev. Same as setting "
+                  L"SNORETOAST_TRACE.",
+                  [](ToastRequest &r, const std::wstring *v, size_t) { r.traceFile = v[0]; }),
+    Option::value(L"-close", L"<id1;id2>",
+                  L"Closes currently displayed notifications, can list multiple ids separated "
+                  L"by \";\"",
+                  [](ToastRequest &r, const std::wstring *v, size_t) {
+                      r.id = v[0];
+                      r.mode = ToastRequest::Mode::Close;
+                  },
+                  NoFlags),
+    Option::value(L"-closePrefix", L"<prefix>",
+                  L"Closes the notifications of the app id with an id starting with prefix.",
+                  [](ToastRequest &r, const std::wstring *v, size_t) {
+                      r.closePrefix = v[0];
+                      r.mode = ToastRequest::Mode::Close;
+                  },
+                  NoFlags),
+    Option::value(L"-closeGroup", L"<group>",
+                  L"Closes the notifications of the app id in group.",
+                  [](ToastRequest &r, const std::wstring *v, size_t) {
+                      r.closeGroup = v[0];
+                      r.mode = ToastRequest::Mode::Close;
+                  },
+                  NoFlags),
+    Option::flag(L"-list",
+                 L"Prints the notifications of the app id in the action center, one "
+                 L"\"<id> <group> <created>\" per line, the oldest first.",
+                 [](ToastRequest &r, const std::wstring *, size_t) {
+                     r.mode = ToastRequest::Mode::List;
+                 },
+                 NoFlags),
+    Option::value(L"-server", L"<\\.\\pipe\\pipeName\\>",
+                  L"Keep running and accept notification requests on the given pipe.\n"
+                  L"A request is a command line, it is answered with the exit code of the "
+                  L"notification and the output of -list.",
+                  [](ToastRequest &r, const std::wstring *v, size_t) {
+                      r.serverName = v[0];
+                      r.mode = ToastRequest::Mode::Server;
+                  },
+                  NoFlags),
+    Option::value(L"-batch", L"<file | ->",
+                  L"Display all notifications listed in file or stdin, one command line per line.\n"
+                  L"Prints \"<line> <exit code> <result>\" for every notification.",
+                  [](ToastRequest &r, const std::wstring *v, size_t) {
+                      r.batchFile = v[0];
+                      r.mode = ToastRequest::Mode::Batch;
+                  },
+                  NoFlags),
+    Option::value(L"-coalesce", L"<milliseconds>",
+                  L"Thin out bursts of -server or -batch, within the window repeated toasts are "
+                  L"dropped, toasts with a known -id replace it and more than -coalesceLimit "
+                  L"toasts of an application are summarized.",
+                  [](ToastRequest &r, const std::wstring *v, size_t) {
+                      unsigned long long window;
+                      if (toNumber(r, v[0], L"-coalesce", window)) {
+                          r.coalesceWindow = std::chrono::milliseconds(window);
+                      }
+                  }),
+    Option::value(L"-coalesceLimit", L"<count>",
+                  L"The toasts of an application displayed within the -coalesce window, "
+                  L"default is 5.",
+                  [](ToastRequest &r, const std::wstring *v, size_t) {
+                      unsigned long long limit;
+                      if (toNumber(r, v[0], L"-coalesceLimit", limit)) {
+                          r.coalesceLimit = static_cast<size_t>(limit);
+                      }
+                  }),
+    Option::value(L"-maxVisible", L"<count>",
+                  L"The toasts of -batch displayed at the same time, the others wait ordered by "
+                  L"-priority, default is all.",
+                  [](ToastRequest &r, const std::wstring *v, size_t) {
+                      unsigned long long count;
+                      if (toNumber(r, v[0], L"-maxVisible", count)) {
+                          r.maxVisible = static_cast<size_t>(count);
+                      }
+                  }),
+    Option::value(L"-install", L"<name> <application> <appID>",
+                  L"Creates a shortcut <name> in the start menu which point to the executable "
+                  L"<application>, appID used for the notifications.",
+                  [](ToastRequest &r, const std::wstring *v, size_t) {
+                      r.shortcut = v[0];
+                      r.exe = v[1];
+                      r.appID = v[2];
+                      r.mode = ToastRequest::Mode::Install;
+                  },
+                  Separated | Terminal, 3),
+    Option::flag(L"-v", L"Print the version and copying information.",
+                 [](ToastRequest &r, const std::wstring *, size_t) {
+                     r.mode = ToastRequest::Mode::Version;
+                 },
+                 Separated | Terminal),
+    Option::flag(L"-h", L"Print these instructions. Same as no args.",
+                 [](ToastRequest &r, const std::wstring *, size_t) {
+                     r.mode = ToastRequest::Mode::Help;
+                 },
+                 Terminal),
+};
+static_assert(OptionParser::isValid(Options), "invalid option table");
+
+/**
+ * Reads the text passed as - from stdin.
+ */
+bool readStandardInput(ToastRequest &out, std::wstring &error)
+{
+    std::wstring *target = nullptr;
+    for (auto *field : { &out.title, &out.body }) {
+        if (*field == L"-") {
+            if (target) {
+                error = L"Only one of -t and -m can be read from stdin";
+                return false;
+            }
+            target = field;
+        }
+    }
+    if (!target) {
+        return true;
+    }
+    const auto input = MappedFile::standardInput();
+    if (!input) {
+        error = L"Failed to read stdin";
+        return false;
+    }
+    *target = OptionParser::decodeText(input->data());
+    // the final line break of a file or an echo
+    if (!target->empty() && target->back() == L'\n') {
+        target->pop_back();
+        if (!target->empty() && target->back() == L'\r') {
+            target->pop_back();
+        }
+    }
+    return true;
+}
+}
+
+ToastRequest ToastRequest::fromArguments(const std::vector<std::wstring> &args, unsigned inputs)
+{
+    ToastRequest out;
+
+    const auto fail = [&out](Mode mode, const std::wstring &error) -> ToastRequest & {
+        out.mode = mode;
+        out.error = error;
+        return out;
+    };
+
+    std::wstring error;
+    if (inputs & ResponseFiles) {
+        std::vector<std::wstring> expanded = args;
+        if (!OptionParser::expandResponseFiles(Options, expanded, error)
+            || !OptionParser::parse(Options, expanded, out, error)) {
+            return fail(Mode::Error, error);
+        }
+    } else if (!OptionParser::parse(Options, args, out, error)) {
+        return fail(Mode::Error, error);
+    }
+    if (out.mode == Mode::Version || out.mode == Mode::Help) {
+        return out;
+    }
+    if (!out.error.empty()) {
+        return fail(Mode::Error, out.error);
+    }
+    if (out.coalesceWindow.count() > 0 && out.mode != Mode::Server && out.mode != Mode::Batch) {
+        return fail(Mode::Error, L"-coalesce requires -server or -batch");
+    }
+    if (out.maxVisible > 0 && out.mode != Mode::Batch) {
+        return fail(Mode::Error, L"-maxVisible requires -batch");
+    }
+    if (out.mode == Mode::Toast && (inputs & StandardInput) && !readStandardInput(out, error)) {
+        return fail(Mode::Error, error);
+    }
+    switch (out.mode) {
+    case Mode::Close:
+        if (out.id.empty() && out.closePrefix.empty() && out.closeGroup.empty()) {
+            return fail(Mode::Error, L"Close only works if an -id id was provided.");
+        }
+        break;
+    case Mode::Toast:
+        if (out.title.empty() || out.body.empty()) {
+            return fail(Mode::Help, L"");
+        }
+        if (out.isTextBoxEnabled && out.pipe.empty()) {
+            return fail(Mode::Error,
+                        L"TextBox notifications only work if a pipe for the result was provided");
+        }
+        if (out.pipeKeepAlive && out.protocol != 2) {
+            // protocol 1 receivers expect a single message per connection
+            return fail(Mode::Error, L"-pipeKeepAlive requires -protocol 2");
+        }
+        break;
+    default:
+        break;
+    }
+    return out;
+}
+
+std::wstring ToastRequest::helpText()
+{
+    std::wstring out = OptionParser::helpText(Options);
+    OptionParser::appendHelp(out, L"@<file>",
+                             L"Read further arguments from file, one command line per line.",
+                             true);
+    return out;
+}
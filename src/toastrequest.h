@@ -0,0 +1,118 @@
+/*
+    SnoreToast is capable to invoke Windows 8 toast notifications.
+    Copyright (C) 2026  Hannah von Reth <vonreth@kde.org>
+
+    SnoreToast is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    SnoreToast is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with SnoreToast.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#pragma once
+
+#include <chrono>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+enum class Duration {
+    Short, // default 7s
+    Long // 25s
+};
+
+// the order in which waiting toasts are displayed, see ToastScheduler
+enum class Priority { Low, Normal, High };
+
+/**
+ * The parsed form of a snoretoast command line.
+ * Used by the command line application and by the server mode, where each
+ * request consists of the same arguments.
+ */
+struct ToastRequest
+{
+    enum class Mode {
+        Toast,
+        Close,
+        List,
+        Install,
+        Server,
+        Batch,
+        Version,
+        Help,
+        Error // error contains the reason
+    };
+
+    // the sources of arguments available to fromArguments
+    enum Input : unsigned {
+        NoInput = 0,
+        // @file is replaced by the arguments in file
+        ResponseFiles = 1 << 0,
+        // -t - and -m - read the text from stdin
+        StandardInput = 1 << 1
+    };
+
+    /**
+     * Parses the arguments, args must not contain the application name.
+     */
+    static ToastRequest fromArguments(const std::vector<std::wstring> &args,
+                                      unsigned inputs = NoInput);
+
+    /**
+     * The options section of the help, generated from the option table.
+     */
+    static std::wstring helpText();
+
+    Mode mode = Mode::Toast;
+    std::wstring error;
+
+    std::wstring appID;
+    std::wstring pid;
+    std::filesystem::path pipe;
+    std::filesystem::path application;
+    std::wstring title;
+    std::wstring body;
+    std::filesystem::path image;
+    std::wstring id;
+    // empty for the default group
+    std::wstring group;
+    std::wstring sound = L"Notification.Default";
+    std::wstring buttons;
+    Duration duration = Duration::Short;
+    Priority priority = Priority::Normal;
+    // drop the toast if it waited longer, 0 for no deadline
+    std::chrono::milliseconds deadline = std::chrono::milliseconds(0);
+    unsigned protocol = 1;
+    // keep the pipe open for the callbacks of all toasts, requires protocol 2
+    bool pipeKeepAlive = false;
+    bool silent = false;
+    // -trace, write a Chrome trace to the file
+    std::filesystem::path traceFile;
+    bool isTextBoxEnabled = false;
+
+    // -close, id can list several ids separated by ";"
+    std::wstring closePrefix;
+    std::wstring closeGroup;
+
+    // -install
+    std::filesystem::path shortcut;
+    std::filesystem::path exe;
+
+    // -server
+    std::filesystem::path serverName;
+
+    // -batch, - for stdin
+    std::filesystem::path batchFile;
+
+    // -coalesce for -server and -batch, see ToastCoalescer
+    std::chrono::milliseconds coalesceWindow = std::chrono::milliseconds(0);
+    size_t coalesceLimit = 5;
+    // -maxVisible for -batch, 0 displays all toasts at once
+    size_t maxVisible = 0;
+};
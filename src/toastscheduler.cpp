@@ -0,0 +1,229 @@
+/*
+    SnoreToast is capable to invoke Windows 8 toast notifications.
+    Copyright (C) 2026  Hannah von Reth <vonreth@kde.org>
+
+    SnoreToast is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    SnoreToast is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with SnoreToast.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "toastscheduler.h"
+#include "toastlog.h"
+#include "toasttrace.h"
+
+namespace {
+// the nodes of the queue and of the deadline index
+constexpr size_t EntryOverhead = 128;
+
+size_t stringSize(const std::wstring &s)
+{
+    return s.capacity() > std::wstring().capacity() ? (s.capacity() + 1) * sizeof(wchar_t) : 0;
+}
+
+size_t pathSize(const std::filesystem::path &path)
+{
+    return path.native().size() * sizeof(std::filesystem::path::value_type);
+}
+}
+
+ToastScheduler::ToastScheduler(Policy policy, Clock clock)
+    : m_policy(policy), m_clock(std::move(clock))
+{
+}
+
+void ToastScheduler::setDiscardHandler(DiscardHandler handler)
+{
+    std::scoped_lock lock(m_mutex);
+    m_discardHandler = std::move(handler);
+}
+
+bool ToastScheduler::push(ToastRequest request, uint64_t tag)
+{
+    ST_TRACE("ToastScheduler::push");
+    const size_t size = approximateSize(request);
+    const size_t priority = static_cast<size_t>(request.priority);
+    Discarded discarded;
+    bool accepted = false;
+    {
+        std::scoped_lock lock(m_mutex);
+        const auto now = m_clock();
+        expire(now, discarded);
+        const auto isFull = [&] {
+            return m_size >= m_policy.capacity || m_memory + size > m_policy.memoryLimit;
+        };
+        // never evict for a toast that can't fit at all
+        accepted = !m_closed && size <= m_policy.memoryLimit && m_policy.capacity > 0;
+        while (accepted && isFull()) {
+            size_t lowest = 0;
+            while (lowest < PriorityCount && m_queues[lowest].empty()) {
+                ++lowest;
+            }
+            if (m_policy.eviction == Eviction::RejectNew || lowest > priority) {
+                accepted = false;
+                break;
+            }
+            discarded.emplace_back(take(lowest, m_queues[lowest].begin()), Discard::Evicted);
+            ++m_statistics.evicted;
+        }
+        if (accepted) {
+            const uint64_t sequence = m_sequence++;
+            std::optional<Deadlines::iterator> deadline;
+            if (request.deadline.count() > 0) {
+                deadline = m_deadlines.emplace(now + request.deadline,
+                                               std::make_pair(priority, sequence));
+            }
+            // the sequence only grows, the hint makes the insertion constant
+            auto &queue = m_queues[priority];
+            queue.emplace_hint(queue.end(), sequence,
+                               Entry { Item { std::move(request), tag }, size, deadline });
+            ++m_size;
+            m_memory += size;
+            ++m_statistics.pushed;
+            m_statistics.peakSize = std::max(m_statistics.peakSize, m_size);
+            m_statistics.peakMemory = std::max(m_statistics.peakMemory, m_memory);
+        } else {
+            ++m_statistics.rejected;
+        }
+    }
+    if (accepted) {
+        m_condition.notify_one();
+    } else {
+        tWarning << L"Toast scheduler full, rejected" << request.title;
+        discarded.emplace_back(Item { std::move(request), tag }, Discard::Rejected);
+    }
+    notify(discarded);
+    return accepted;
+}
+
+std::optional<ToastScheduler::Item> ToastScheduler::pop()
+{
+    Discarded discarded;
+    std::optional<Item> out;
+    {
+        std::scoped_lock lock(m_mutex);
+        out = takeNext(discarded);
+    }
+    notify(discarded);
+    return out;
+}
+
+std::optional<ToastScheduler::Item> ToastScheduler::waitPop()
+{
+    // the queued toasts might all expire, only a closed scheduler ends the wait
+    while (true) {
+        Discarded discarded;
+        std::optional<Item> out;
+        bool closed;
+        {
+            std::unique_lock lock(m_mutex);
+            m_condition.wait(lock, [this] { return m_size > 0 || m_closed; });
+            out = takeNext(discarded);
+            closed = m_closed;
+        }
+        notify(discarded);
+        if (out || closed) {
+            return out;
+        }
+    }
+}
+
+void ToastScheduler::close()
+{
+    {
+        std::scoped_lock lock(m_mutex);
+        m_closed = true;
+    }
+    m_condition.notify_all();
+}
+
+size_t ToastScheduler::size() const
+{
+    std::scoped_lock lock(m_mutex);
+    return m_size;
+}
+
+size_t ToastScheduler::memoryUsage() const
+{
+    std::scoped_lock lock(m_mutex);
+    return m_memory;
+}
+
+ToastScheduler::Statistics ToastScheduler::statistics() const
+{
+    std::scoped_lock lock(m_mutex);
+    return m_statistics;
+}
+
+size_t ToastScheduler::approximateSize(const ToastRequest &request)
+{
+    size_t size = sizeof(Entry) + EntryOverhead;
+    for (const auto *s : { &request.error, &request.appID, &request.pid, &request.title,
+                           &request.body, &request.id, &request.sound, &request.buttons }) {
+        size += stringSize(*s);
+    }
+    for (const auto *path : { &request.pipe, &request.application, &request.image,
+                              &request.traceFile, &request.shortcut, &request.exe,
+                              &request.serverName, &request.batchFile }) {
+        size += pathSize(*path);
+    }
+    return size;
+}
+
+std::optional<ToastScheduler::Item> ToastScheduler::takeNext(Discarded &discarded)
+{
+    expire(m_clock(), discarded);
+    for (size_t priority = PriorityCount; priority-- > 0;) {
+        if (!m_queues[priority].empty()) {
+            ++m_statistics.popped;
+            return take(priority, m_queues[priority].begin());
+        }
+    }
+    return std::nullopt;
+}
+
+ToastScheduler::Item ToastScheduler::take(size_t priority, Queue::iterator it)
+{
+    if (it->second.deadline) {
+        m_deadlines.erase(*it->second.deadline);
+    }
+    --m_size;
+    m_memory -= it->second.size;
+    Item item = std::move(it->second.item);
+    m_queues[priority].erase(it);
+    return item;
+}
+
+void ToastScheduler::expire(std::chrono::steady_clock::time_point now, Discarded &discarded)
+{
+    while (!m_deadlines.empty() && m_deadlines.begin()->first <= now) {
+        const auto [priority, sequence] = m_deadlines.begin()->second;
+        auto &queue = m_queues[priority];
+        discarded.emplace_back(take(priority, queue.find(sequence)), Discard::Expired);
+        ++m_statistics.expired;
+    }
+}
+
+void ToastScheduler::notify(Discarded &discarded)
+{
+    if (discarded.empty()) {
+        return;
+    }
+    DiscardHandler handler;
+    {
+        std::scoped_lock lock(m_mutex);
+        handler = m_discardHandler;
+    }
+    if (handler) {
+        for (const auto &[item, reason] : discarded) {
+            handler(item, reason);
+        }
+    }
+}
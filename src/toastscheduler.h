@@ -0,0 +1,154 @@
+/*
+    SnoreToast is capable to invoke Windows 8 toast notifications.
+    Copyright (C) 2026  Hannah von Reth <vonreth@kde.org>
+
+    SnoreToast is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    SnoreToast is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with SnoreToast.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#pragma once
+
+#include "toastrequest.h"
+
+#include <array>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <vector>
+
+/**
+ * Orders pending toasts by priority and drops those that are no longer relevant.
+ *
+ * pop() returns the oldest toast of the highest priority. A toast with a deadline, relative to
+ * push(), is discarded as Expired once it passed. The queue is bounded by the number of toasts
+ * and their approximate memory, when it is full the eviction policy decides which toast is
+ * discarded. Every discarded toast is passed to the discard handler, outside of the lock.
+ *
+ * The tag is not interpreted, it identifies the toast for the caller.
+ */
+class ToastScheduler
+{
+public:
+    using Clock = std::function<std::chrono::steady_clock::time_point()>;
+
+    enum class Eviction {
+        // the oldest toast of the lowest priority is evicted, but never for a toast of lower
+        // priority, which is rejected instead
+        LowestPriority,
+        RejectNew
+    };
+
+    enum class Discard { Expired, Evicted, Rejected };
+
+    struct Policy
+    {
+        size_t capacity = 1024;
+        size_t memoryLimit = 16 * 1024 * 1024; // see approximateSize()
+        Eviction eviction = Eviction::LowestPriority;
+    };
+
+    struct Item
+    {
+        ToastRequest request;
+        uint64_t tag = 0;
+    };
+
+    using DiscardHandler = std::function<void(const Item &item, Discard reason)>;
+
+    struct Statistics
+    {
+        uint64_t pushed = 0;
+        uint64_t popped = 0;
+        uint64_t expired = 0;
+        uint64_t evicted = 0;
+        uint64_t rejected = 0;
+        size_t peakSize = 0;
+        size_t peakMemory = 0;
+    };
+
+    explicit ToastScheduler(Policy policy, Clock clock = std::chrono::steady_clock::now);
+
+    ToastScheduler(const ToastScheduler &) = delete;
+    ToastScheduler &operator=(const ToastScheduler &) = delete;
+
+    void setDiscardHandler(DiscardHandler handler);
+
+    /**
+     * Returns false if the toast was rejected.
+     */
+    bool push(ToastRequest request, uint64_t tag = 0);
+
+    /**
+     * Returns the next toast or nothing if the queue is empty.
+     */
+    std::optional<Item> pop();
+
+    /**
+     * Blocks until a toast is available, returns nothing once the scheduler is closed and
+     * empty.
+     */
+    std::optional<Item> waitPop();
+
+    /**
+     * Rejects further toasts, the queued ones can still be popped.
+     */
+    void close();
+
+    size_t size() const;
+    size_t memoryUsage() const;
+    Statistics statistics() const;
+
+    /**
+     * The memory used by request and its entry in the queue.
+     */
+    static size_t approximateSize(const ToastRequest &request);
+
+private:
+    static constexpr size_t PriorityCount = static_cast<size_t>(Priority::High) + 1;
+
+    using Deadlines =
+            std::multimap<std::chrono::steady_clock::time_point, std::pair<size_t, uint64_t>>;
+
+    struct Entry
+    {
+        Item item;
+        size_t size = 0;
+        std::optional<Deadlines::iterator> deadline;
+    };
+    // by sequence, the oldest first
+    using Queue = std::map<uint64_t, Entry>;
+
+    using Discarded = std::vector<std::pair<Item, Discard>>;
+
+    std::optional<Item> takeNext(Discarded &discarded);
+    Item take(size_t priority, Queue::iterator it);
+    void expire(std::chrono::steady_clock::time_point now, Discarded &discarded);
+    void notify(Discarded &discarded);
+
+    const Policy m_policy;
+    const Clock m_clock;
+    DiscardHandler m_discardHandler;
+
+    mutable std::mutex m_mutex;
+    std::condition_variable m_condition;
+    std::array<Queue, PriorityCount> m_queues;
+    Deadlines m_deadlines;
+    uint64_t m_sequence = 0;
+    size_t m_size = 0;
+    size_t m_memory = 0;
+    bool m_closed = false;
+    Statistics m_statistics;
+};
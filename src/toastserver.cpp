@@ -0,0 +1,260 @@
+/*
+    SnoreToast is capable to invoke Windows 8 toast notifications.
+    Copyright (C) 2026  Hannah von Reth <vonreth@kde.org>
+
+    SnoreToast is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    SnoreToast is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with SnoreToast.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "toastserver.h"
+#include "stringutils.h"
+
+#include <algorithm>
+#include <list>
+
+namespace {
+// a request is a command line, anything bigger is a broken or malicious client
+constexpr uint32_t MAX_FRAME_SIZE = 4 * 1024 * 1024;
+
+void appendUInt32(std::string &out, uint32_t value)
+{
+    for (int i = 0; i < 4; ++i) {
+        out.push_back(static_cast<char>((value >> (i * 8)) & 0xFF));
+    }
+}
+
+uint32_t readUInt32(const char *data)
+{
+    uint32_t out = 0;
+    for (int i = 0; i < 4; ++i) {
+        out |= static_cast<uint32_t>(static_cast<uint8_t>(data[i])) << (i * 8);
+    }
+    return out;
+}
+
+bool readFrame(ToastServerConnection &connection, std::string &payload)
+{
+    char header[4];
+    if (!connection.read(header, sizeof(header))) {
+        return false;
+    }
+    const uint32_t size = readUInt32(header);
+    if (size > MAX_FRAME_SIZE) {
+        return false;
+    }
+    payload.resize(size);
+    return size == 0 || connection.read(payload.data(), size);
+}
+
+std::string encodeResponse(uint32_t serial, SnoreToastActions::Actions action,
+                           std::string_view output)
+{
+    std::string out;
+    out.reserve(12 + output.size());
+    appendUInt32(out, static_cast<uint32_t>(8 + output.size()));
+    appendUInt32(out, serial);
+    appendUInt32(out, static_cast<uint32_t>(static_cast<int32_t>(action)));
+    out.append(output);
+    return out;
+}
+}
+
+size_t ToastServerConnection::writeVectored(const std::string_view *buffers, size_t count)
+{
+    size_t written = 0;
+    for (size_t i = 0; i < count; ++i) {
+        // the part written by a failed write() is unknown, the buffer isn't counted
+        if (!buffers[i].empty() && !write(buffers[i].data(), buffers[i].size())) {
+            break;
+        }
+        written += buffers[i].size();
+    }
+    return written;
+}
+
+ToastServer::ToastServer(Handler handler) : ToastServer(std::move(handler), Policy()) { }
+
+ToastServer::ToastServer(Handler handler, Policy policy)
+    : m_handler(std::move(handler)), m_policy(policy)
+{
+}
+
+ToastServer::~ToastServer()
+{
+    {
+        std::scoped_lock lock(m_mutex);
+        m_stop = true;
+    }
+    m_condition.notify_all();
+    for (auto &t : m_workers) {
+        t.join();
+    }
+}
+
+void ToastServer::serve(ToastServerListener &listener)
+{
+    // a thread per connection waiting for its requests, joined once the client disconnected
+    std::mutex mutex;
+    std::list<std::thread> connections;
+    std::vector<std::list<std::thread>::iterator> finished;
+    while (auto connection = listener.accept()) {
+        std::vector<std::thread> done;
+        {
+            std::scoped_lock lock(mutex);
+            for (const auto &it : finished) {
+                done.push_back(std::move(*it));
+                connections.erase(it);
+            }
+            finished.clear();
+            const auto it = connections.emplace(connections.end());
+            // the thread can't report itself before it is stored, the lock is still held
+            *it = std::thread([this, &mutex, &finished, it, connection = std::move(connection)] {
+                handleConnection(*connection);
+                std::scoped_lock lock(mutex);
+                finished.push_back(it);
+            });
+        }
+        for (auto &t : done) {
+            t.join();
+        }
+    }
+    for (auto &t : connections) {
+        t.join();
+    }
+}
+
+void ToastServer::handleConnection(ToastServerConnection &connection)
+{
+    // the requests of the connection still running on a worker
+    std::mutex mutex;
+    std::condition_variable condition;
+    size_t running = 0;
+    std::string payload;
+    while (readFrame(connection, payload)) {
+        uint32_t serial;
+        std::vector<std::wstring> args;
+        if (!decodeRequest(payload, serial, args)) {
+            break;
+        }
+        {
+            std::scoped_lock lock(mutex);
+            ++running;
+        }
+        post([this, &connection, &mutex, &condition, &running, serial, args = std::move(args)] {
+            const ToastRequest request = ToastRequest::fromArguments(args);
+            SnoreToastActions::Actions action = SnoreToastActions::Actions::Error;
+            std::string output;
+            if (request.mode == ToastRequest::Mode::Toast
+                || request.mode == ToastRequest::Mode::Close
+                || request.mode == ToastRequest::Mode::List) {
+                action = m_handler(request, output);
+            }
+            const std::string response = encodeResponse(serial, action, output);
+            std::scoped_lock lock(mutex);
+            connection.write(response.data(), response.size());
+            --running;
+            // notified with the lock held, the waiting connection is destroyed right after
+            condition.notify_all();
+        });
+    }
+    std::unique_lock lock(mutex);
+    condition.wait(lock, [&running] { return running == 0; });
+}
+
+void ToastServer::post(std::function<void()> task)
+{
+    std::scoped_lock lock(m_mutex);
+    m_tasks.push_back(std::move(task));
+    // the idle workers take one queued task each
+    if (m_tasks.size() > m_idle && m_workers.size() < std::max<size_t>(m_policy.workers, 1)) {
+        m_workers.emplace_back([this] { work(); });
+    } else {
+        m_condition.notify_one();
+    }
+}
+
+void ToastServer::work()
+{
+    std::unique_lock lock(m_mutex);
+    while (true) {
+        ++m_idle;
+        m_condition.wait(lock, [this] { return m_stop || !m_tasks.empty(); });
+        --m_idle;
+        if (m_tasks.empty()) {
+            return;
+        }
+        auto task = std::move(m_tasks.front());
+        m_tasks.pop_front();
+        lock.unlock();
+        task();
+        lock.lock();
+    }
+}
+
+std::string ToastServer::encodeRequest(uint32_t serial, const std::vector<std::wstring> &args)
+{
+    std::string out;
+    appendUInt32(out, 0);
+    appendUInt32(out, serial);
+    for (const auto &arg : args) {
+        out.append(Utils::toUtf8(arg));
+        out.push_back('\0');
+    }
+    const uint32_t size = static_cast<uint32_t>(out.size() - 4);
+    for (int i = 0; i < 4; ++i) {
+        out[i] = static_cast<char>((size >> (i * 8)) & 0xFF);
+    }
+    return out;
+}
+
+bool ToastServer::decodeRequest(const std::string &payload, uint32_t &serial,
+                                std::vector<std::wstring> &args)
+{
+    if (payload.size() < 4) {
+        return false;
+    }
+    serial = readUInt32(payload.data());
+    size_t start = 4;
+    while (start < payload.size()) {
+        const size_t end = payload.find('\0', start);
+        if (end == std::string::npos) {
+            // unterminated argument
+            return false;
+        }
+        args.push_back(Utils::fromUtf8(std::string_view(payload).substr(start, end - start)));
+        start = end + 1;
+    }
+    return true;
+}
+
+bool ToastServer::sendRequest(ToastServerConnection &connection, uint32_t serial,
+                              const std::vector<std::wstring> &args)
+{
+    const std::string frame = encodeRequest(serial, args);
+    return connection.write(frame.data(), frame.size());
+}
+
+bool ToastServer::readResponse(ToastServerConnection &connection, uint32_t &serial,
+                               SnoreToastActions::Actions &action, std::string *output)
+{
+    std::string payload;
+    if (!readFrame(connection, payload) || payload.size() < 8) {
+        return false;
+    }
+    serial = readUInt32(payload.data());
+    action = static_cast<SnoreToastActions::Actions>(
+            static_cast<int32_t>(readUInt32(payload.data() + 4)));
+    if (output) {
+        output->assign(payload, 8);
+    }
+    return true;
+}
@@ -0,0 +1,136 @@
+/*
+    SnoreToast is capable to invoke Windows 8 toast notifications.
+    Copyright (C) 2026  Hannah von Reth <vonreth@kde.org>
+
+    SnoreToast is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    SnoreToast is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with SnoreToast.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#pragma once
+
+#include "snoretoastactions.h"
+#include "toastrequest.h"
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+class ToastServerConnection
+{
+public:
+    virtual ~ToastServerConnection() = default;
+
+    /**
+     * Reads exactly size bytes, returns false on eof or error.
+     */
+    virtual bool read(void *data, size_t size) = 0;
+    virtual bool write(const void *data, size_t size) = 0;
+    /**
+     * Writes all buffers with as few system calls as possible, the default implementation
+     * calls write() for every buffer. Returns the number of bytes written, less than the size
+     * of all buffers on error.
+     */
+    virtual size_t writeVectored(const std::string_view *buffers, size_t count);
+};
+
+class ToastServerListener
+{
+public:
+    virtual ~ToastServerListener() = default;
+
+    /**
+     * Blocks until a client connected.
+     * Returns nullptr after close() was called.
+     */
+    virtual std::unique_ptr<ToastServerConnection> accept() = 0;
+    virtual void close() = 0;
+};
+
+/**
+ * Dispatches toast requests received over a local socket or named pipe.
+ *
+ * Every frame starts with a little endian uint32 holding the size of the rest of the frame.
+ * Request:  uint32 serial, followed by the command line arguments as '\0' terminated utf-8
+ * Response: uint32 serial, int32 SnoreToastActions::Actions, followed by the utf-8 output of
+ *           the request, the output of -list, empty for the other requests
+ *
+ * A connection can carry any number of requests, they are handled concurrently by a pool of
+ * at most Policy::workers threads shared by all connections, and the responses are sent in
+ * the order the requests finish.
+ */
+class ToastServer
+{
+public:
+    /**
+     * Handles a Toast, Close or List request, output is sent with the response.
+     */
+    using Handler =
+            std::function<SnoreToastActions::Actions(const ToastRequest &, std::string &output)>;
+
+    struct Policy
+    {
+        // the requests handled at the same time, a toast occupies a worker until its result
+        // is known, further requests wait for a free worker
+        size_t workers = 64;
+    };
+
+    explicit ToastServer(Handler handler);
+    ToastServer(Handler handler, Policy policy);
+    ~ToastServer();
+
+    /**
+     * Accepts connections until the listener is closed.
+     * Returns after all accepted connections were closed by their clients.
+     */
+    void serve(ToastServerListener &listener);
+    void handleConnection(ToastServerConnection &connection);
+
+    static std::string encodeRequest(uint32_t serial, const std::vector<std::wstring> &args);
+    static bool decodeRequest(const std::string &payload, uint32_t &serial,
+                              std::vector<std::wstring> &args);
+
+    static bool sendRequest(ToastServerConnection &connection, uint32_t serial,
+                            const std::vector<std::wstring> &args);
+    static bool readResponse(ToastServerConnection &connection, uint32_t &serial,
+                             SnoreToastActions::Actions &action, std::string *output = nullptr);
+
+private:
+    // runs task on one of the workers, starts a worker if none is idle and the pool is not full
+    void post(std::function<void()> task);
+    void work();
+
+    const Handler m_handler;
+    const Policy m_policy;
+
+    std::mutex m_mutex;
+    std::condition_variable m_condition;
+    std::deque<std::function<void()>> m_tasks;
+    std::vector<std::thread> m_workers;
+    size_t m_idle = 0;
+    bool m_stop = false;
+};
+
+namespace LocalSocket {
+/**
+ * On Windows name is the name of a pipe, \\.\pipe\snoretoast, on other platforms it is
+ * the path of a unix domain socket.
+ */
+std::unique_ptr<ToastServerListener> listen(const std::filesystem::path &name);
+std::unique_ptr<ToastServerConnection> connect(const std::filesystem::path &name);
+};
@@ -0,0 +1,207 @@
+/*
+    SnoreToast is capable to invoke Windows 8 toast notifications.
+    Copyright (C) 2026  Hannah von Reth <vonreth@kde.org>
+
+    SnoreToast is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    SnoreToast is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with SnoreToast.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "toastserver.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace {
+// the buffers passed to a single sendmsg
+constexpr size_t MAX_VECTORS = 64;
+
+bool toAddress(const std::filesystem::path &name, sockaddr_un &address)
+{
+    const std::string path = name.string();
+    address = {};
+    address.sun_family = AF_UNIX;
+    if (path.size() >= sizeof(address.sun_path)) {
+        return false;
+    }
+    std::memcpy(address.sun_path, path.c_str(), path.size() + 1);
+    return true;
+}
+
+class UnixConnection : public ToastServerConnection
+{
+public:
+    explicit UnixConnection(int fd) : m_fd(fd) { }
+    ~UnixConnection() override { ::close(m_fd); }
+
+    bool read(void *data, size_t size) override
+    {
+        auto *out = static_cast<char *>(data);
+        while (size > 0) {
+            const ssize_t r = ::recv(m_fd, out, size, 0);
+            if (r < 0 && errno == EINTR) {
+                continue;
+            }
+            if (r <= 0) {
+                return false;
+            }
+            out += r;
+            size -= static_cast<size_t>(r);
+        }
+        return true;
+    }
+
+    bool write(const void *data, size_t size) override
+    {
+        const auto *in = static_cast<const char *>(data);
+        while (size > 0) {
+            const ssize_t w = ::send(m_fd, in, size, MSG_NOSIGNAL);
+            if (w < 0 && errno == EINTR) {
+                continue;
+            }
+            if (w <= 0) {
+                return false;
+            }
+            in += w;
+            size -= static_cast<size_t>(w);
+        }
+        return true;
+    }
+
+    size_t writeVectored(const std::string_view *buffers, size_t count) override
+    {
+        iovec vectors[MAX_VECTORS];
+        size_t total = 0;
+        while (count > 0) {
+            const size_t n = std::min(count, MAX_VECTORS);
+            for (size_t i = 0; i < n; ++i) {
+                vectors[i] = { const_cast<char *>(buffers[i].data()), buffers[i].size() };
+            }
+            // i is the first vector not completely written
+            size_t i = 0;
+            while (i < n) {
+                msghdr message = {};
+                message.msg_iov = vectors + i;
+                message.msg_iovlen = n - i;
+                const ssize_t w = ::sendmsg(m_fd, &message, MSG_NOSIGNAL);
+                if (w < 0 && errno == EINTR) {
+                    continue;
+                }
+                if (w <= 0) {
+                    return total;
+                }
+                total += static_cast<size_t>(w);
+                size_t written = static_cast<size_t>(w);
+                while (i < n && written >= vectors[i].iov_len) {
+                    written -= vectors[i].iov_len;
+                    ++i;
+                }
+                if (i < n) {
+                    vectors[i].iov_base = static_cast<char *>(vectors[i].iov_base) + written;
+                    vectors[i].iov_len -= written;
+                }
+            }
+            buffers += n;
+            count -= n;
+        }
+        return total;
+    }
+
+private:
+    int m_fd;
+};
+
+class UnixListener : public ToastServerListener
+{
+public:
+    UnixListener(int fd, const std::filesystem::path &path) : m_fd(fd), m_path(path) { }
+    ~UnixListener() override
+    {
+        close();
+        ::close(m_fd);
+        ::unlink(m_path.c_str());
+    }
+
+    std::unique_ptr<ToastServerConnection> accept() override
+    {
+        while (!m_closed) {
+            const int fd = ::accept(m_fd, nullptr, nullptr);
+            if (fd >= 0) {
+                return std::make_unique<UnixConnection>(fd);
+            }
+            if (errno != EINTR && errno != ECONNABORTED) {
+                break;
+            }
+        }
+        return nullptr;
+    }
+
+    void close() override
+    {
+        if (!m_closed.exchange(true)) {
+            // wakes up a blocking accept
+            ::shutdown(m_fd, SHUT_RDWR);
+        }
+    }
+
+private:
+    int m_fd;
+    std::filesystem::path m_path;
+    std::atomic<bool> m_closed = false;
+};
+}
+
+namespace LocalSocket {
+
+std::unique_ptr<ToastServerListener> listen(const std::filesystem::path &name)
+{
+    sockaddr_un address;
+    if (!toAddress(name, address)) {
+        return nullptr;
+    }
+    const int fd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        return nullptr;
+    }
+    // remove a stale socket of a previous instance
+    ::unlink(address.sun_path);
+    if (::bind(fd, reinterpret_cast<sockaddr *>(&address), sizeof(address)) != 0
+        || ::listen(fd, SOMAXCONN) != 0) {
+        ::close(fd);
+        return nullptr;
+    }
+    return std::make_unique<UnixListener>(fd, name);
+}
+
+std::unique_ptr<ToastServerConnection> connect(const std::filesystem::path &name)
+{
+    sockaddr_un address;
+    if (!toAddress(name, address)) {
+        return nullptr;
+    }
+    const int fd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        return nullptr;
+    }
+    if (::connect(fd, reinterpret_cast<sockaddr *>(&address), sizeof(address)) != 0) {
+        ::close(fd);
+        return nullptr;
+    }
+    return std::make_unique<UnixConnection>(fd);
+}
+}
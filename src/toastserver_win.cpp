@@ -0,0 +1,221 @@
+/*
+    SnoreToast is capable to invoke Windows 8 toast notifications.
+    Copyright (C) 2026  Hannah von Reth <vonreth@kde.org>
+
+    SnoreToast is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    SnoreToast is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with SnoreToast.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "toastserver.h"
+
+#include <windows.h>
+
+#include <algorithm>
+
+namespace {
+constexpr DWORD PIPE_BUFFER_SIZE = 4096;
+constexpr DWORD CONNECT_TIMEOUT = 5000;
+
+/**
+ * The pipe is opened overlapped, a synchronous pipe would serialize the pending read of the
+ * next request with the responses written by the request threads.
+ */
+class PipeConnection : public ToastServerConnection
+{
+public:
+    PipeConnection(HANDLE pipe, bool isServer)
+        : m_pipe(pipe),
+          m_isServer(isServer),
+          m_readEvent(CreateEventW(nullptr, true, false, nullptr)),
+          m_writeEvent(CreateEventW(nullptr, true, false, nullptr))
+    {
+    }
+
+    ~PipeConnection() override
+    {
+        if (m_isServer) {
+            FlushFileBuffers(m_pipe);
+            DisconnectNamedPipe(m_pipe);
+        }
+        CloseHandle(m_pipe);
+        CloseHandle(m_readEvent);
+        CloseHandle(m_writeEvent);
+    }
+
+    bool read(void *data, size_t size) override
+    {
+        return transfer(true, static_cast<char *>(data), size) == size;
+    }
+
+    bool write(const void *data, size_t size) override
+    {
+        return transfer(false, const_cast<char *>(static_cast<const char *>(data)), size)
+                == size;
+    }
+
+    // WriteFileGather is not supported on pipes, the buffers are joined for a single write
+    size_t writeVectored(const std::string_view *buffers, size_t count) override
+    {
+        m_gather.clear();
+        for (size_t i = 0; i < count; ++i) {
+            m_gather.append(buffers[i]);
+        }
+        return transfer(false, m_gather.data(), m_gather.size());
+    }
+
+private:
+    // returns the number of bytes transferred, less than size on error
+    size_t transfer(bool isRead, char *data, size_t size)
+    {
+        size_t total = 0;
+        while (total < size) {
+            OVERLAPPED overlapped = {};
+            overlapped.hEvent = isRead ? m_readEvent : m_writeEvent;
+            ResetEvent(overlapped.hEvent);
+            const DWORD chunk =
+                    static_cast<DWORD>(std::min<size_t>(size - total, PIPE_BUFFER_SIZE));
+            const BOOL ok = isRead ? ReadFile(m_pipe, data + total, chunk, nullptr, &overlapped)
+                                   : WriteFile(m_pipe, data + total, chunk, nullptr, &overlapped);
+            if (!ok && GetLastError() != ERROR_IO_PENDING) {
+                return total;
+            }
+            DWORD transferred = 0;
+            if (!GetOverlappedResult(m_pipe, &overlapped, &transferred, true)
+                || transferred == 0) {
+                return total;
+            }
+            total += transferred;
+        }
+        return total;
+    }
+
+    HANDLE m_pipe;
+    bool m_isServer;
+    HANDLE m_readEvent;
+    HANDLE m_writeEvent;
+    std::string m_gather;
+};
+
+HANDLE createPipe(const std::wstring &name, bool first)
+{
+    return CreateNamedPipeW(
+            name.c_str(),
+            PIPE_ACCESS_DUPLEX | FILE_FLAG_OVERLAPPED | (first ? FILE_FLAG_FIRST_PIPE_INSTANCE : 0),
+            PIPE_TYPE_BYTE | PIPE_READMODE_BYTE | PIPE_WAIT | PIPE_REJECT_REMOTE_CLIENTS,
+            PIPE_UNLIMITED_INSTANCES, PIPE_BUFFER_SIZE, PIPE_BUFFER_SIZE, 0, nullptr);
+}
+
+/**
+ * An instance of the pipe always exists, clients connecting while the previous client is
+ * handed over get ERROR_PIPE_BUSY and wait instead of failing with ERROR_FILE_NOT_FOUND.
+ */
+class PipeListener : public ToastServerListener
+{
+public:
+    PipeListener(const std::wstring &name, HANDLE pipe)
+        : m_name(name), m_pending(pipe), m_stopEvent(CreateEventW(nullptr, true, false, nullptr))
+    {
+    }
+
+    ~PipeListener() override
+    {
+        if (m_pending != INVALID_HANDLE_VALUE) {
+            CloseHandle(m_pending);
+        }
+        CloseHandle(m_stopEvent);
+    }
+
+    std::unique_ptr<ToastServerConnection> accept() override
+    {
+        if (m_pending == INVALID_HANDLE_VALUE) {
+            m_pending = createPipe(m_name, false);
+            if (m_pending == INVALID_HANDLE_VALUE) {
+                return nullptr;
+            }
+        }
+        OVERLAPPED overlapped = {};
+        overlapped.hEvent = CreateEventW(nullptr, true, false, nullptr);
+        bool connected = ConnectNamedPipe(m_pending, &overlapped);
+        if (!connected) {
+            switch (GetLastError()) {
+            case ERROR_PIPE_CONNECTED:
+                connected = true;
+                break;
+            case ERROR_IO_PENDING: {
+                const HANDLE handles[] = { overlapped.hEvent, m_stopEvent };
+                DWORD dummy;
+                if (WaitForMultipleObjects(2, handles, false, INFINITE) == WAIT_OBJECT_0) {
+                    connected = GetOverlappedResult(m_pending, &overlapped, &dummy, false);
+                } else {
+                    // overlapped must outlive the cancelled operation, a client connected
+                    // in between is dropped as the listener is closed
+                    CancelIo(m_pending);
+                    GetOverlappedResult(m_pending, &overlapped, &dummy, true);
+                }
+                break;
+            }
+            default:
+                break;
+            }
+        }
+        CloseHandle(overlapped.hEvent);
+        if (!connected) {
+            // the instance can't be reused after a failed connect
+            CloseHandle(m_pending);
+            m_pending = INVALID_HANDLE_VALUE;
+            return nullptr;
+        }
+        HANDLE pipe = m_pending;
+        // the next instance exists before the connected one is handed out, if it can't be
+        // created the next accept() retries
+        m_pending = createPipe(m_name, false);
+        return std::make_unique<PipeConnection>(pipe, true);
+    }
+
+    void close() override { SetEvent(m_stopEvent); }
+
+private:
+    std::wstring m_name;
+    HANDLE m_pending;
+    HANDLE m_stopEvent;
+};
+}
+
+namespace LocalSocket {
+
+std::unique_ptr<ToastServerListener> listen(const std::filesystem::path &name)
+{
+    // fails if another server owns the name or it can't be accessed
+    const std::wstring pipeName = name.wstring();
+    HANDLE pipe = createPipe(pipeName, true);
+    if (pipe == INVALID_HANDLE_VALUE) {
+        return nullptr;
+    }
+    return std::make_unique<PipeListener>(pipeName, pipe);
+}
+
+std::unique_ptr<ToastServerConnection> connect(const std::filesystem::path &name)
+{
+    const std::wstring pipeName = name.wstring();
+    while (true) {
+        HANDLE pipe = CreateFileW(pipeName.c_str(), GENERIC_READ | GENERIC_WRITE, 0, nullptr,
+                                  OPEN_EXISTING, FILE_FLAG_OVERLAPPED, nullptr);
+        if (pipe != INVALID_HANDLE_VALUE) {
+            return std::make_unique<PipeConnection>(pipe, false);
+        }
+        if (GetLastError() != ERROR_PIPE_BUSY
+            || !WaitNamedPipeW(pipeName.c_str(), CONNECT_TIMEOUT)) {
+            return nullptr;
+        }
+    }
+}
+}
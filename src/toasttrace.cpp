@@ -0,0 +1,200 @@
+/*
+    SnoreToast is capable to invoke Windows 8 toast notifications.
+    Copyright (C) 2026  Hannah von Reth <vonreth@kde.org>
+
+    SnoreToast is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    SnoreToast is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with SnoreToast.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "toasttrace.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <memory>
+#include <mutex>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace {
+struct Event
+{
+    const char *name;
+    uint64_t begin;
+    uint64_t end;
+    uint32_t thread;
+    // set once the event is complete, the slot is claimed before
+    std::atomic<bool> ready = false;
+};
+
+struct TraceBuffer
+{
+    std::mutex mutex;
+    std::unique_ptr<Event[]> events;
+    // published after events
+    std::atomic<size_t> capacity = 0;
+    std::atomic<size_t> next = 0;
+    std::atomic<size_t> dropped = 0;
+    std::atomic<uint32_t> threads = 0;
+    uint64_t origin = 0;
+    std::filesystem::path file;
+    bool atExit = false;
+};
+
+TraceBuffer &buffer()
+{
+    // never destroyed, spans might end during the static destruction
+    static TraceBuffer *buffer = new TraceBuffer;
+    return *buffer;
+}
+
+uint32_t threadId()
+{
+    static thread_local const uint32_t id = ++buffer().threads;
+    return id;
+}
+
+unsigned long processId()
+{
+#ifdef _WIN32
+    return GetCurrentProcessId();
+#else
+    return static_cast<unsigned long>(getpid());
+#endif
+}
+
+void writeEscaped(std::ostream &out, const char *name)
+{
+    for (const char *c = name; *c; ++c) {
+        if (*c == '"' || *c == '\\') {
+            out << '\\';
+        }
+        out << *c;
+    }
+}
+
+const bool s_fromEnvironment = [] {
+    if (const char *file = std::getenv("SNORETOAST_TRACE")) {
+        ToastTrace::start(file);
+    }
+    return true;
+}();
+}
+
+uint64_t ToastTrace::now()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                   std::chrono::steady_clock::now().time_since_epoch())
+            .count();
+}
+
+void ToastTrace::record(const char *name, uint64_t begin, uint64_t end)
+{
+    auto &trace = buffer();
+    const size_t capacity = trace.capacity.load(std::memory_order_acquire);
+    const size_t index = trace.next.fetch_add(1, std::memory_order_relaxed);
+    if (index >= capacity) {
+        trace.dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    auto &event = trace.events[index];
+    event.name = name;
+    event.begin = begin;
+    event.end = end;
+    event.thread = threadId();
+    event.ready.store(true, std::memory_order_release);
+}
+
+bool ToastTrace::start(const std::filesystem::path &file, size_t capacity)
+{
+    auto &trace = buffer();
+    std::scoped_lock lock(trace.mutex);
+    // the buffer is never replaced, a span might still record into it
+    if (trace.events) {
+        return false;
+    }
+    trace.events = std::make_unique<Event[]>(capacity);
+    trace.capacity.store(capacity, std::memory_order_release);
+    trace.origin = now();
+    trace.file = file;
+    if (!file.empty() && !trace.atExit) {
+        trace.atExit = true;
+        std::atexit([] { ToastTrace::stop(); });
+    }
+    s_enabled.store(true, std::memory_order_relaxed);
+    return true;
+}
+
+bool ToastTrace::stop()
+{
+    if (!s_enabled.exchange(false)) {
+        return false;
+    }
+    auto &trace = buffer();
+    std::filesystem::path file;
+    {
+        std::scoped_lock lock(trace.mutex);
+        file = std::move(trace.file);
+    }
+    if (file.empty()) {
+        return true;
+    }
+    std::ofstream out(file, std::ios::binary);
+    writeJson(out);
+    return out.good();
+}
+
+void ToastTrace::writeJson(std::ostream &out)
+{
+    auto &trace = buffer();
+    const size_t count = eventCount();
+    const auto pid = processId();
+    char number[32];
+    out << "{\"traceEvents\":[";
+    bool first = true;
+    for (size_t i = 0; i < count; ++i) {
+        const auto &event = trace.events[i];
+        if (!event.ready.load(std::memory_order_acquire)) {
+            continue;
+        }
+        if (!first) {
+            out << ",\n";
+        }
+        first = false;
+        out << "{\"name\":\"";
+        writeEscaped(out, event.name);
+        // the timestamps are microseconds
+        std::snprintf(number, sizeof(number), "%.3f", (event.begin - trace.origin) / 1000.0);
+        out << "\",\"cat\":\"snoretoast\",\"ph\":\"X\",\"ts\":" << number;
+        std::snprintf(number, sizeof(number), "%.3f", (event.end - event.begin) / 1000.0);
+        out << ",\"dur\":" << number << ",\"pid\":" << pid << ",\"tid\":" << event.thread << "}";
+    }
+    out << "],\"displayTimeUnit\":\"ms\"}\n";
+}
+
+size_t ToastTrace::eventCount()
+{
+    auto &trace = buffer();
+    return std::min(trace.next.load(std::memory_order_acquire),
+                    trace.capacity.load(std::memory_order_acquire));
+}
+
+size_t ToastTrace::droppedEvents()
+{
+    return buffer().dropped.load(std::memory_order_relaxed);
+}
@@ -0,0 +1,110 @@
+/*
+    SnoreToast is capable to invoke Windows 8 toast notifications.
+    Copyright (C) 2026  Hannah von Reth <vonreth@kde.org>
+
+    SnoreToast is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    SnoreToast is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with SnoreToast.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <ostream>
+
+/**
+ * Records the duration of the stages of a notification, exported as Chrome trace event JSON
+ * which can be loaded in chrome://tracing or https://ui.perfetto.dev.
+ *
+ * The events are stored in a buffer allocated by start(), events beyond its capacity are
+ * dropped. While tracing is disabled a span costs a single relaxed load, defining
+ * SNORETOAST_DISABLE_TRACE removes the spans at compile time.
+ *
+ * Setting SNORETOAST_TRACE to a file name starts tracing before main, the file is written
+ * at exit.
+ *
+ * void show()
+ * {
+ *     ST_TRACE("show");
+ *     ...
+ * }
+ */
+class ToastTrace
+{
+public:
+    static constexpr size_t DefaultCapacity = 16 * 1024;
+
+    /**
+     * Records a complete event from construction to destruction, name must be a literal.
+     */
+    class Span
+    {
+    public:
+        explicit Span(const char *name) : m_name(isEnabled() ? name : nullptr)
+        {
+            if (m_name) {
+                m_begin = now();
+            }
+        }
+        ~Span()
+        {
+            if (m_name) {
+                record(m_name, m_begin, now());
+            }
+        }
+
+        Span(const Span &) = delete;
+        Span &operator=(const Span &) = delete;
+
+    private:
+        const char *m_name;
+        uint64_t m_begin = 0;
+    };
+
+    static inline bool isEnabled() { return s_enabled.load(std::memory_order_relaxed); }
+
+    /**
+     * Enables tracing, the trace is written to file by stop() or at exit if file is not empty.
+     * Returns false if tracing was already started.
+     */
+    static bool start(const std::filesystem::path &file = {}, size_t capacity = DefaultCapacity);
+
+    /**
+     * Disables tracing and writes the file passed to start().
+     */
+    static bool stop();
+
+    /**
+     * Writes the events recorded since start().
+     */
+    static void writeJson(std::ostream &out);
+
+    static size_t eventCount();
+    static size_t droppedEvents();
+
+private:
+    // nanoseconds on a monotonic clock
+    static uint64_t now();
+    static void record(const char *name, uint64_t begin, uint64_t end);
+
+    static inline std::atomic<bool> s_enabled { false };
+};
+
+#ifdef SNORETOAST_DISABLE_TRACE
+#define ST_TRACE(NAME) static_cast<void>(0)
+#else
+#define ST_TRACE_CONCAT_(A, B) A##B
+#define ST_TRACE_CONCAT(A, B) ST_TRACE_CONCAT_(A, B)
+#define ST_TRACE(NAME) const ToastTrace::Span ST_TRACE_CONCAT(_stTraceSpan, __LINE__)(NAME)
+#endif
@@ -0,0 +1,174 @@
+/*
+    SnoreToast is capable to invoke Windows 8 toast notifications.
+    Copyright (C) 2026  Hannah von Reth <vonreth@kde.org>
+
+    SnoreToast is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    SnoreToast is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with SnoreToast.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "toastxml.h"
+#include "textkernels.h"
+
+#include <string_view>
+
+namespace {
+struct CountingSink
+{
+    void append(std::wstring_view data) { size += data.size(); }
+    size_t size = 0;
+};
+
+struct StringSink
+{
+    void append(std::wstring_view data) { out.append(data); }
+    std::wstring &out;
+};
+
+enum class Context { Text, Attribute };
+
+std::wstring_view replacement(wchar_t c, Context context, bool &drop)
+{
+    switch (c) {
+    case L'&':
+        return L"&amp;";
+    case L'<':
+        return L"&lt;";
+    case L'>':
+        return L"&gt;";
+    case L'"':
+        return L"&quot;";
+    // line breaks in attributes would be normalised to spaces by the parser
+    case L'\t':
+        return context == Context::Attribute ? L"&#9;" : std::wstring_view();
+    case L'\n':
+        return context == Context::Attribute ? L"&#10;" : std::wstring_view();
+    case L'\r':
+        return L"&#13;";
+    default:
+        // characters that are not allowed in xml 1.0, not even as a reference
+        drop = (c < 0x20) || c == 0xFFFE || c == 0xFFFF;
+        return {};
+    }
+}
+
+template<typename Sink>
+void appendEscaped(Sink &sink, std::wstring_view value, Context context)
+{
+    size_t start = 0;
+    for (size_t i = TextKernels::findXmlSpecial(value); i != std::wstring_view::npos;
+         i = TextKernels::findXmlSpecial(value, i + 1)) {
+        bool drop = false;
+        const auto escaped = replacement(value[i], context, drop);
+        if (!escaped.empty() || drop) {
+            sink.append(value.substr(start, i - start));
+            sink.append(escaped);
+            start = i + 1;
+        }
+    }
+    sink.append(value.substr(start));
+}
+
+template<typename Sink>
+void appendAttribute(Sink &sink, std::wstring_view name, std::wstring_view value)
+{
+    sink.append(L" ");
+    sink.append(name);
+    sink.append(L"=\"");
+    appendEscaped(sink, value, Context::Attribute);
+    sink.append(L"\"");
+}
+
+std::wstring_view imagePath(const std::filesystem::path &image, std::wstring &storage)
+{
+#ifdef _WIN32
+    return image.native();
+#else
+    storage = image.wstring();
+    return storage;
+#endif
+}
+
+template<typename Sink>
+void write(Sink &sink, const ToastContent &content, std::wstring_view image)
+{
+    sink.append(L"<toast");
+    appendAttribute(sink, L"launch", content.launchArguments);
+    appendAttribute(sink, L"duration", content.duration == Duration::Short ? L"short" : L"long");
+    sink.append(L"><visual><binding");
+    if (!image.empty()) {
+        appendAttribute(sink, L"template", L"ToastImageAndText02");
+        sink.append(L"><image id=\"1\"");
+        appendAttribute(sink, L"src", image);
+        sink.append(L"/>");
+    } else {
+        appendAttribute(sink, L"template", L"ToastText02");
+        sink.append(L">");
+    }
+    sink.append(L"<text id=\"1\">");
+    appendEscaped(sink, content.title, Context::Text);
+    sink.append(L"</text><text id=\"2\">");
+    appendEscaped(sink, content.body, Context::Text);
+    sink.append(L"</text></binding></visual>");
+
+    if (!content.buttons.empty()) {
+        sink.append(L"<actions>");
+        for (const auto &button : content.buttons) {
+            sink.append(L"<action");
+            appendAttribute(sink, L"content", button.content);
+            appendAttribute(sink, L"arguments", button.arguments);
+            appendAttribute(sink, L"activationType", L"foreground");
+            sink.append(L"/>");
+        }
+        sink.append(L"</actions>");
+    } else if (content.textBox) {
+        sink.append(L"<actions>"
+                    L"<input id=\"textBox\" type=\"text\" placeHolderContent=\"Type a reply\"/>"
+                    L"<action content=\"Send\"");
+        appendAttribute(sink, L"arguments", content.textBoxArguments);
+        appendAttribute(sink, L"hint-inputId", L"textBox");
+        sink.append(L"/></actions>");
+    }
+
+    sink.append(L"<audio");
+    appendAttribute(sink, L"src", content.sound);
+    appendAttribute(sink, L"silent", content.silent ? L"true" : L"false");
+    sink.append(L"/></toast>");
+}
+}
+
+size_t ToastXml::size(const ToastContent &content)
+{
+    std::wstring storage;
+    CountingSink sink;
+    write(sink, content, imagePath(content.image, storage));
+    return sink.size;
+}
+
+void ToastXml::build(const ToastContent &content, std::wstring &out)
+{
+    std::wstring storage;
+    const auto image = imagePath(content.image, storage);
+    CountingSink counter;
+    write(counter, content, image);
+
+    out.clear();
+    out.reserve(counter.size);
+    StringSink sink { out };
+    write(sink, content, image);
+}
+
+std::wstring ToastXml::build(const ToastContent &content)
+{
+    std::wstring out;
+    build(content, out);
+    return out;
+}
@@ -0,0 +1,40 @@
+/*
+    SnoreToast is capable to invoke Windows 8 toast notifications.
+    Copyright (C) 2026  Hannah von Reth <vonreth@kde.org>
+
+    SnoreToast is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    SnoreToast is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with SnoreToast.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#pragma once
+
+#include "notificationbackend.h"
+
+#include <string>
+
+/**
+ * Builds the toast xml payload as a string, equivalent to filling the ToastText02 or
+ * ToastImageAndText02 template node by node.
+ * The payload is written into a single buffer, sized up front by a counting pass.
+ */
+namespace ToastXml {
+/**
+ * The length of the payload in characters.
+ */
+size_t size(const ToastContent &content);
+
+/**
+ * Replaces the content of out with the payload, the capacity of out is reused.
+ */
+void build(const ToastContent &content, std::wstring &out);
+std::wstring build(const ToastContent &content);
+};
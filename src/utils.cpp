@@ -18,101 +18,78 @@
 
 #include "utils.h"
 #include "snoretoasts.h"
+#include "toasttrace.h"
 
 #include <wrl/client.h>
 #include <wrl/implements.h>
 #include <wrl/module.h>
 
+#include <mutex>
+
 using namespace Microsoft::WRL;
 
 namespace {
-bool s_registered = false;
+// every toast with buttons or a text box holds a registration, the class objects are
+// registered by the first and revoked by the last one
+std::mutex s_activatorMutex;
+size_t s_activatorReferences = 0;
 }
 
 namespace Utils {
 
 bool registerActivator()
 {
-    if (!s_registered) {
-        s_registered = true;
+    std::scoped_lock lock(s_activatorMutex);
+    if (s_activatorReferences == 0) {
         Microsoft::WRL::Module<Microsoft::WRL::OutOfProc>::Create([] {});
-        Microsoft::WRL::Module<Microsoft::WRL::OutOfProc>::GetModule().IncrementObjectCount();
-        return SUCCEEDED(
-                Microsoft::WRL::Module<Microsoft::WRL::OutOfProc>::GetModule().RegisterObjects());
+        auto &module = Microsoft::WRL::Module<Microsoft::WRL::OutOfProc>::GetModule();
+        module.IncrementObjectCount();
+        if (!SUCCEEDED(module.RegisterObjects())) {
+            module.DecrementObjectCount();
+            return false;
+        }
     }
+    ++s_activatorReferences;
     return true;
 }
 
 void unregisterActivator()
 {
-    if (s_registered) {
-        s_registered = false;
-        Microsoft::WRL::Module<Microsoft::WRL::OutOfProc>::GetModule().UnregisterObjects();
-        Microsoft::WRL::Module<Microsoft::WRL::OutOfProc>::GetModule().DecrementObjectCount();
+    std::scoped_lock lock(s_activatorMutex);
+    if (s_activatorReferences == 0) {
+        return;
     }
-}
-
-std::unordered_map<std::wstring_view, std::wstring_view> splitData(const std::wstring_view &data)
-{
-    std::unordered_map<std::wstring_view, std::wstring_view> out;
-    size_t start = 0;
-    for (size_t end = data.find(L";", start); end != std::wstring::npos;
-         start = end + 1, end = data.find(L";", start)) {
-        if (start == end) {
-            end = data.size();
-        }
-        const std::wstring_view tmp(data.data() + start, end - start);
-        const auto pos = tmp.find(L"=");
-        if (pos > 0) {
-            out[tmp.substr(0, pos)] = tmp.substr(pos + 1);
-        }
-        // tLog << L"'" << tmp.substr(0, pos) << L"' = '" << tmp.substr(pos + 1) << L"'";
+    if (--s_activatorReferences == 0) {
+        auto &module = Microsoft::WRL::Module<Microsoft::WRL::OutOfProc>::GetModule();
+        module.UnregisterObjects();
+        module.DecrementObjectCount();
     }
-    return out;
-}
-
-const std::filesystem::path &selfLocate()
-{
-    static const std::filesystem::path path = [] {
-        // don't modify the lasterror
-        const auto lastError = GetLastError();
-        std::wstring buf;
-        size_t size;
-        do {
-            buf.resize(buf.size() + 1024);
-            size = GetModuleFileNameW(nullptr, const_cast<wchar_t *>(buf.data()),
-                                      static_cast<DWORD>(buf.size()));
-        } while (GetLastError() == ERROR_INSUFFICIENT_BUFFER);
-        buf.resize(size);
-        SetLastError(lastError);
-        return buf;
-    }();
-    return path;
 }
 
-bool writePipe(const std::filesystem::path &pipe, const std::wstring &data, bool wait)
+bool writePipe(const std::filesystem::path &pipe, std::string_view data, bool wait)
 {
+    ST_TRACE("Utils::writePipe");
     if (wait) {
         WaitNamedPipe(pipe.wstring().c_str(), 20000);
     }
     HANDLE hPipe = CreateFile(pipe.wstring().c_str(), GENERIC_WRITE, 0, nullptr, OPEN_EXISTING, 0,
                               nullptr);
     if (hPipe != INVALID_HANDLE_VALUE) {
-        DWORD written;
-        const DWORD toWrite = static_cast<DWORD>(data.size() * sizeof(wchar_t));
-        WriteFile(hPipe, data.c_str(), toWrite, &written, nullptr);
+        DWORD written = 0;
+        const DWORD toWrite = static_cast<DWORD>(data.size());
+        WriteFile(hPipe, data.data(), toWrite, &written, nullptr);
         const bool success = written == toWrite;
-        tLog << (success ? L"Wrote: " : L"Failed to write: ") << data << " to " << pipe;
-        WriteFile(hPipe, nullptr, sizeof(wchar_t), &written, nullptr);
+        tLog << (success ? L"Wrote:" : L"Failed to write:") << data.size() << L"bytes to" << pipe;
         CloseHandle(hPipe);
         return success;
     }
-    tLog << L"Failed to open pipe: " << pipe << L" data: " << data;
+    tLog << L"Failed to open pipe: " << pipe;
     return false;
 }
 
 bool startProcess(const std::filesystem::path &app)
 {
+    ST_TRACE("Utils::startProcess");
     STARTUPINFO info = {};
     info.cb = sizeof(info);
     PROCESS_INFORMATION pInfo = {};
@@ -121,10 +98,11 @@ bool startProcess(const std::filesystem::path &app)
                        const_cast<wchar_t *>(application.c_str()), nullptr, nullptr, false,
                        DETACHED_PROCESS | INHERIT_PARENT_AFFINITY | CREATE_NO_WINDOW, nullptr,
                        nullptr, &info, &pInfo)) {
-        tLog << L"Failed to start: " << app;
+        tWarning << L"Failed to start: " << app;
         return false;
     }
-    WaitForInputIdle(pInfo.hProcess, INFINITE);
+    // the DeliveryQueue retries until the pipe exists, don't stall it on a slow start
+    WaitForInputIdle(pInfo.hProcess, 1000);
     DWORD status;
     GetExitCodeProcess(pInfo.hProcess, &status);
     CloseHandle(pInfo.hProcess);
@@ -134,21 +112,6 @@ bool startProcess(const std::filesystem::path &app)
     return status == STILL_ACTIVE;
 }
 
-std::wstring formatData(const std::vector<std::pair<std::wstring_view, std::wstring_view>> &data)
-{
-    std::wstringstream out;
-    const auto add = [&](const std::pair<std::wstring_view, std::wstring_view> &p) {
-        if (!p.second.empty()) {
-            out << p.first << L"=" << p.second << L";";
-        }
-    };
-    for (const auto &p : data) {
-        add(p);
-    }
-    add({ L"version", SnoreToasts::version() });
-    return out.str();
-}
-
 std::wstring formatWinError(unsigned long errorCode)
 {
     wchar_t *error = nullptr;
@@ -161,14 +124,3 @@ std::wstring formatWinError(unsigned long errorCode)
     return out;
 }
 }
-
-ToastLog::ToastLog()
-{
-    *this << Utils::selfLocate() << L"v" << SnoreToasts::version() << L"\n\t";
-}
-
-ToastLog::~ToastLog()
-{
-    m_log << L"\n";
-    OutputDebugStringW(m_log.str().c_str());
-}
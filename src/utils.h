@@ -18,63 +18,33 @@
 
 #pragma once
 
+#include "coreutils.h"
+#include "toastlog.h"
+
 #include <comdef.h>
 #include <filesystem>
-#include <sstream>
-#include <unordered_map>
-
-class ToastLog;
-
-class ToastLog
-{
-public:
-    ToastLog();
-    ~ToastLog();
-
-    inline ToastLog &log() { return *this; }
-
-private:
-    std::wstringstream m_log;
-    template<typename T>
-    friend ToastLog &operator<<(ToastLog &, const T &);
-};
-
-template<typename T>
-ToastLog &operator<<(ToastLog &log, const T &t)
-{
-    log.m_log << L" " << t;
-    return log;
-}
 
 template<>
 inline ToastLog &operator<<(ToastLog &log, const HRESULT &hr)
 {
     if (FAILED(hr)) {
         _com_error err(hr);
-        log.m_log << L" Error: " << hr << L" " << err.ErrorMessage();
+        log << L"Error:" << static_cast<long long>(hr) << err.ErrorMessage();
     }
     return log;
 }
 
-#define tLog ToastLog().log() << __FUNCSIG__ << L"\n\t\t"
-
 namespace Utils {
 bool registerActivator();
 void unregisterActivator();
 
-std::unordered_map<std::wstring_view, std::wstring_view> splitData(const std::wstring_view &data);
-
-const std::filesystem::path &selfLocate();
-
-std::wstring formatData(const std::vector<std::pair<std::wstring_view, std::wstring_view>> &data);
-
-bool writePipe(const std::filesystem::path &pipe, const std::wstring &data, bool wait = false);
+bool writePipe(const std::filesystem::path &pipe, std::string_view data, bool wait = false);
 bool startProcess(const std::filesystem::path &app);
 
 inline bool checkResult(const char *file, const long line, const char *func, const HRESULT &hr)
 {
     if (FAILED(hr)) {
-        tLog << file << line << func << L":\n\t\t\t" << hr;
+        tError << file << line << func << L":\n\t\t\t" << hr;
         return false;
     }
     return true;
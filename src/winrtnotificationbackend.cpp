@@ -0,0 +1,658 @@
+/*
+    SnoreToast is capable to invoke Windows 8 toast notifications.
+    Copyright (C) 2013-2019  Hannah von Reth <vonreth@kde.org>
+
+    SnoreToast is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    SnoreToast is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with SnoreToast.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "winrtnotificationbackend.h"
+#include "toasteventhandler.h"
+#include "toasttrace.h"
+#include "toastxml.h"
+#include "utils.h"
+
+#include <wrl\wrappers\corewrappers.h>
+#include <sstream>
+#include <iostream>
+
+using namespace Microsoft::WRL;
+using namespace ABI::Windows::UI;
+using namespace ABI::Windows::UI::Notifications;
+using namespace ABI::Windows::Data::Xml::Dom;
+using namespace Windows::Foundation;
+using namespace Wrappers;
+
+namespace {
+HRESULT setNodeValueString(IXmlDocument *xml, const HSTRING &inputString, IXmlNode *node)
+{
+    ComPtr<IXmlText> inputText;
+    ST_RETURN_ON_ERROR(xml->CreateTextNode(inputString, &inputText));
+
+    ComPtr<IXmlNode> inputTextNode;
+    ST_RETURN_ON_ERROR(inputText.As(&inputTextNode));
+
+    ComPtr<IXmlNode> pAppendedChild;
+    return node->AppendChild(inputTextNode.Get(), &pAppendedChild);
+}
+
+HRESULT addAttribute(IXmlDocument *xml, const std::wstring &name, IXmlNamedNodeMap *attributeMap)
+{
+    ComPtr<ABI::Windows::Data::Xml::Dom::IXmlAttribute> srcAttribute;
+    HRESULT hr = xml->CreateAttribute(HStringReference(name.c_str()).Get(), &srcAttribute);
+
+    if (SUCCEEDED(hr)) {
+        ComPtr<IXmlNode> node;
+        hr = srcAttribute.As(&node);
+        if (SUCCEEDED(hr)) {
+            ComPtr<IXmlNode> pNode;
+            hr = attributeMap->SetNamedItem(node.Get(), &pNode);
+        }
+    }
+    return hr;
+}
+
+HRESULT addAttribute(IXmlDocument *xml, const std::wstring &name, IXmlNamedNodeMap *attributeMap,
+                     const std::wstring &value)
+{
+    ComPtr<ABI::Windows::Data::Xml::Dom::IXmlAttribute> srcAttribute;
+    ST_RETURN_ON_ERROR(xml->CreateAttribute(HStringReference(name.c_str()).Get(), &srcAttribute));
+
+    ComPtr<IXmlNode> node;
+    ST_RETURN_ON_ERROR(srcAttribute.As(&node));
+
+    ComPtr<IXmlNode> pNode;
+    ST_RETURN_ON_ERROR(attributeMap->SetNamedItem(node.Get(), &pNode));
+    return setNodeValueString(xml, HStringReference(value.c_str()).Get(), node.Get());
+}
+
+HRESULT appendElement(IXmlDocument *xml, IXmlNode *parent, const wchar_t *name,
+                      ComPtr<IXmlNode> &out)
+{
+    ComPtr<IXmlElement> element;
+    ST_RETURN_ON_ERROR(xml->CreateElement(HStringReference(name).Get(), &element));
+
+    ComPtr<IXmlNode> nodeTmp;
+    ST_RETURN_ON_ERROR(element.As(&nodeTmp));
+    return parent->AppendChild(nodeTmp.Get(), &out);
+}
+
+HRESULT createNewActionButton(IXmlDocument *xml, IXmlNode *actionsNode, const ToastButton &button)
+{
+    ComPtr<IXmlNode> actionNode;
+    ST_RETURN_ON_ERROR(appendElement(xml, actionsNode, L"action", actionNode));
+
+    ComPtr<IXmlNamedNodeMap> actionAttributes;
+    ST_RETURN_ON_ERROR(actionNode->get_Attributes(&actionAttributes));
+
+    ST_RETURN_ON_ERROR(addAttribute(xml, L"content", actionAttributes.Get(), button.content));
+    ST_RETURN_ON_ERROR(addAttribute(xml, L"arguments", actionAttributes.Get(), button.arguments));
+    return addAttribute(xml, L"activationType", actionAttributes.Get(), L"foreground");
+}
+
+HRESULT setButtons(IXmlDocument *xml, IXmlNode *root, const ToastContent &content)
+{
+    ComPtr<IXmlNode> actionsNode;
+    ST_RETURN_ON_ERROR(appendElement(xml, root, L"actions", actionsNode));
+
+    for (const auto &button : content.buttons) {
+        ST_RETURN_ON_ERROR(createNewActionButton(xml, actionsNode.Get(), button));
+    }
+    return S_OK;
+}
+
+HRESULT setTextBox(IXmlDocument *xml, IXmlNode *root, const ToastContent &content)
+{
+    ComPtr<IXmlNode> actionsNode;
+    ST_RETURN_ON_ERROR(appendElement(xml, root, L"actions", actionsNode));
+
+    ComPtr<IXmlNode> inputNode;
+    ST_RETURN_ON_ERROR(appendElement(xml, actionsNode.Get(), L"input", inputNode));
+
+    ComPtr<IXmlNamedNodeMap> inputAttributes;
+    ST_RETURN_ON_ERROR(inputNode->get_Attributes(&inputAttributes));
+
+    ST_RETURN_ON_ERROR(addAttribute(xml, L"id", inputAttributes.Get(), L"textBox"));
+    ST_RETURN_ON_ERROR(addAttribute(xml, L"type", inputAttributes.Get(), L"text"));
+    ST_RETURN_ON_ERROR(
+            addAttribute(xml, L"placeHolderContent", inputAttributes.Get(), L"Type a reply"));
+
+    ComPtr<IXmlNode> actionNode;
+    ST_RETURN_ON_ERROR(appendElement(xml, actionsNode.Get(), L"action", actionNode));
+
+    ComPtr<IXmlNamedNodeMap> actionAttributes;
+    ST_RETURN_ON_ERROR(actionNode->get_Attributes(&actionAttributes));
+
+    ST_RETURN_ON_ERROR(addAttribute(xml, L"content", actionAttributes.Get(), L"Send"));
+    ST_RETURN_ON_ERROR(
+            addAttribute(xml, L"arguments", actionAttributes.Get(), content.textBoxArguments));
+    return addAttribute(xml, L"hint-inputId", actionAttributes.Get(), L"textBox");
+}
+
+// Set the value of the "src" attribute of the "image" node
+HRESULT setImage(IXmlDocument *xml, const ToastContent &content)
+{
+    ComPtr<IXmlNodeList> nodeList;
+    ST_RETURN_ON_ERROR(xml->GetElementsByTagName(HStringReference(L"image").Get(), &nodeList));
+
+    ComPtr<IXmlNode> imageNode;
+    ST_RETURN_ON_ERROR(nodeList->Item(0, &imageNode));
+
+    ComPtr<IXmlNamedNodeMap> attributes;
+    ST_RETURN_ON_ERROR(imageNode->get_Attributes(&attributes));
+
+    ComPtr<IXmlNode> srcAttribute;
+    ST_RETURN_ON_ERROR(attributes->GetNamedItem(HStringReference(L"src").Get(), &srcAttribute));
+    return setNodeValueString(xml, HStringReference(content.image.wstring().c_str()).Get(),
+                              srcAttribute.Get());
+}
+
+HRESULT setSound(IXmlDocument *xml, const ToastContent &content)
+{
+    ComPtr<IXmlNodeList> nodeList;
+    ST_RETURN_ON_ERROR(xml->GetElementsByTagName(HStringReference(L"audio").Get(), &nodeList));
+
+    ComPtr<IXmlNode> audioNode;
+    ST_RETURN_ON_ERROR(nodeList->Item(0, &audioNode));
+
+    ComPtr<IXmlNamedNodeMap> attributes;
+
+    ST_RETURN_ON_ERROR(audioNode->get_Attributes(&attributes));
+    ComPtr<IXmlNode> srcAttribute;
+
+    ST_RETURN_ON_ERROR(attributes->GetNamedItem(HStringReference(L"src").Get(), &srcAttribute));
+    ST_RETURN_ON_ERROR(setNodeValueString(xml, HStringReference(content.sound.c_str()).Get(),
+                                          srcAttribute.Get()));
+    ST_RETURN_ON_ERROR(attributes->GetNamedItem(HStringReference(L"silent").Get(), &srcAttribute));
+    return setNodeValueString(xml, HStringReference(content.silent ? L"true" : L"false").Get(),
+                              srcAttribute.Get());
+}
+
+// Set the values of each of the text nodes
+HRESULT setTextValues(IXmlDocument *xml, const ToastContent &content)
+{
+    ComPtr<IXmlNodeList> nodeList;
+    ST_RETURN_ON_ERROR(xml->GetElementsByTagName(HStringReference(L"text").Get(), &nodeList));
+    // create the title
+    ComPtr<IXmlNode> textNode;
+    ST_RETURN_ON_ERROR(nodeList->Item(0, &textNode));
+    ST_RETURN_ON_ERROR(
+            setNodeValueString(xml, HStringReference(content.title.c_str()).Get(), textNode.Get()));
+    ST_RETURN_ON_ERROR(nodeList->Item(1, &textNode));
+    return setNodeValueString(xml, HStringReference(content.body.c_str()).Get(), textNode.Get());
+}
+
+void printXML(IXmlDocument *xml)
+{
+    ComPtr<ABI::Windows::Data::Xml::Dom::IXmlNodeSerializer> s;
+    ComPtr<ABI::Windows::Data::Xml::Dom::IXmlDocument> ss(xml);
+    ss.As(&s);
+    HSTRING string;
+    s->GetXml(&string);
+    PCWSTR str = WindowsGetStringRawBuffer(string, nullptr);
+    tLog << L"------------------------\n\t\t\t" << str << L"\n\t\t" << L"------------------------";
+    WindowsDeleteString(string);
+}
+
+void CALLBACK closeRequestedCallback(void *listener, BOOLEAN)
+{
+    static_cast<NotificationListener *>(listener)->closeRequested();
+}
+}
+
+struct WinRTNotificationBackend::DisplayedToast
+{
+    ~DisplayedToast()
+    {
+        if (notification) {
+            notification->remove_Activated(activatedToken);
+            notification->remove_Dismissed(dismissedToken);
+            notification->remove_Failed(failedToken);
+        }
+        if (closeWait) {
+            // blocks until a running callback returned
+            UnregisterWaitEx(closeWait, INVALID_HANDLE_VALUE);
+        }
+        if (closeEvent) {
+            CloseHandle(closeEvent);
+        }
+        if (eventHandler) {
+            eventHandler->setListener(nullptr);
+        }
+    }
+
+    NotificationListener *listener = nullptr;
+    ComPtr<IToastNotifier> notifier;
+    ComPtr<IToastNotification> notification;
+    ComPtr<ToastEventHandler> eventHandler;
+    EventRegistrationToken activatedToken = {};
+    EventRegistrationToken dismissedToken = {};
+    EventRegistrationToken failedToken = {};
+    // signaled by -close from a different process
+    HANDLE closeEvent = nullptr;
+    HANDLE closeWait = nullptr;
+};
+
+WinRTNotificationBackend &WinRTNotificationBackend::instance()
+{
+    static WinRTNotificationBackend _instance;
+    return _instance;
+}
+
+WinRTNotificationBackend::WinRTNotificationBackend()
+{
+    ST_TRACE("GetActivationFactory(ToastNotificationManager)");
+    HRESULT hr = GetActivationFactory(
+            HStringReference(RuntimeClass_Windows_UI_Notifications_ToastNotificationManager).Get(),
+            &m_toastManager);
+    if (!SUCCEEDED(hr)) {
+        std::wcerr << L"SnoreToasts: Failed to register com Factory, please make sure you "
+                      L"correctly initialised with RO_INIT_MULTITHREADED"
+                   << std::endl;
+    }
+}
+
+WinRTNotificationBackend::~WinRTNotificationBackend() = default;
+
+void WinRTNotificationBackend::shutdown()
+{
+    std::map<std::wstring, std::unique_ptr<DisplayedToast>> toasts;
+    std::map<NotificationListener *, std::unique_ptr<DisplayedToast>> replaced;
+    {
+        std::scoped_lock lock(m_mutex);
+        toasts.swap(m_toasts);
+        replaced.swap(m_replaced);
+        m_toastFactory.Reset();
+        m_toastManager.Reset();
+    }
+    // unregisters the event handlers outside of the lock, they might wait for running events
+    toasts.clear();
+    replaced.clear();
+    m_notifiers.clear();
+}
+
+bool WinRTNotificationBackend::isRegistered(const std::wstring &appID)
+{
+    ComPtr<IShellItem> app;
+    return SUCCEEDED(SHCreateItemFromParsingName(std::wstring(L"shell:AppsFolder\\" + appID).data(),
+                                                 nullptr, IID_PPV_ARGS(&app)));
+}
+
+HRESULT WinRTNotificationBackend::notifier(const std::wstring &appID, ComPtr<IToastNotifier> &out)
+{
+    if (!m_toastManager) {
+        return E_FAIL;
+    }
+    HRESULT hr = S_OK;
+    m_notifiers.get(appID, out, [&](ComPtr<IToastNotifier> &notifier) {
+        ST_TRACE("CreateToastNotifierWithId");
+        hr = m_toastManager->CreateToastNotifierWithId(HStringReference(appID.c_str()).Get(),
+                                                       &notifier);
+        return ST_CHECK_RESULT(hr);
+    });
+    return hr;
+}
+
+HRESULT WinRTNotificationBackend::toastFactory(ComPtr<IToastNotificationFactory> &out)
+{
+    std::scoped_lock lock(m_mutex);
+    if (!m_toastFactory) {
+        ST_TRACE("GetActivationFactory(ToastNotification)");
+        ST_RETURN_ON_ERROR(GetActivationFactory(
+                HStringReference(RuntimeClass_Windows_UI_Notifications_ToastNotification).Get(),
+                &m_toastFactory));
+    }
+    out = m_toastFactory;
+    return S_OK;
+}
+
+WinRTNotificationBackend::Notifiers::Statistics
+WinRTNotificationBackend::notifierStatistics() const
+{
+    return m_notifiers.statistics();
+}
+
+::NotificationSetting WinRTNotificationBackend::setting(const std::wstring &appID)
+{
+    ComPtr<IToastNotifier> toastNotifier;
+    ABI::Windows::UI::Notifications::NotificationSetting setting = NotificationSetting_Enabled;
+    if (!ST_CHECK_RESULT(notifier(appID, toastNotifier))) {
+        tLog << "Failed to retreive NotificationSettings ensure your appId is registered";
+    } else if (!ST_CHECK_RESULT(toastNotifier->get_Setting(&setting))) {
+        tLog << "Failed to retreive NotificationSettings ensure your appId is registered";
+        m_notifiers.invalidate(appID);
+    }
+    switch (setting) {
+    case NotificationSetting_Enabled:
+        return ::NotificationSetting::Enabled;
+    case NotificationSetting_DisabledForApplication:
+        return ::NotificationSetting::DisabledForApplication;
+    case NotificationSetting_DisabledForUser:
+        return ::NotificationSetting::DisabledForUser;
+    case NotificationSetting_DisabledByGroupPolicy:
+        return ::NotificationSetting::DisabledByGroupPolicy;
+    case NotificationSetting_DisabledByManifest:
+        return ::NotificationSetting::DisabledByManifest;
+    }
+    return ::NotificationSetting::Enabled;
+}
+
+bool WinRTNotificationBackend::registerActivator()
+{
+    return Utils::registerActivator();
+}
+
+void WinRTNotificationBackend::unregisterActivator()
+{
+    Utils::unregisterActivator();
+}
+
+HRESULT WinRTNotificationBackend::loadXml(const ToastContent &content, ComPtr<IXmlDocument> &xml)
+{
+    ST_TRACE("WinRTNotificationBackend::loadXml");
+    // LoadXml copies the payload, the buffer is reused by the next toast of the thread
+    thread_local std::wstring payload;
+    ToastXml::build(content, payload);
+    tLog << L"------------------------\n\t\t\t" << payload << L"\n\t\t"
+         << L"------------------------";
+
+    ComPtr<IXmlDocument> document;
+    ST_RETURN_ON_ERROR(ActivateInstance(
+            HStringReference(RuntimeClass_Windows_Data_Xml_Dom_XmlDocument).Get(), &document));
+    ComPtr<IXmlDocumentIO> documentIO;
+    ST_RETURN_ON_ERROR(document.As(&documentIO));
+    ST_RETURN_ON_ERROR(documentIO->LoadXml(
+            HStringReference(payload.c_str(), static_cast<unsigned int>(payload.size())).Get()));
+    xml = document;
+    return S_OK;
+}
+
+HRESULT WinRTNotificationBackend::createXml(const ToastContent &content, ComPtr<IXmlDocument> &xml)
+{
+    ST_TRACE("WinRTNotificationBackend::createXml");
+    {
+        ST_TRACE("GetTemplateContent");
+        if (!content.image.empty()) {
+            ST_RETURN_ON_ERROR(m_toastManager->GetTemplateContent(
+                    ToastTemplateType_ToastImageAndText02, &xml));
+        } else {
+            ST_RETURN_ON_ERROR(
+                    m_toastManager->GetTemplateContent(ToastTemplateType_ToastText02, &xml));
+        }
+    }
+    ComPtr<ABI::Windows::Data::Xml::Dom::IXmlNodeList> rootList;
+    ST_RETURN_ON_ERROR(xml->GetElementsByTagName(HStringReference(L"toast").Get(), &rootList));
+
+    ComPtr<IXmlNode> root;
+    ST_RETURN_ON_ERROR(rootList->Item(0, &root));
+    ComPtr<IXmlNamedNodeMap> rootAttributes;
+    ST_RETURN_ON_ERROR(root->get_Attributes(&rootAttributes));
+
+    ST_RETURN_ON_ERROR(
+            addAttribute(xml.Get(), L"launch", rootAttributes.Get(), content.launchArguments));
+    ST_RETURN_ON_ERROR(addAttribute(xml.Get(), L"duration", rootAttributes.Get(),
+                                    content.duration == Duration::Short ? L"short" : L"long"));
+    // Adding buttons
+    if (!content.buttons.empty()) {
+        setButtons(xml.Get(), root.Get(), content);
+    } else if (content.textBox) {
+        setTextBox(xml.Get(), root.Get(), content);
+    }
+    ComPtr<IXmlNode> audioNode;
+    ST_RETURN_ON_ERROR(appendElement(xml.Get(), root.Get(), L"audio", audioNode));
+
+    ComPtr<IXmlNamedNodeMap> attributes;
+    ST_RETURN_ON_ERROR(audioNode->get_Attributes(&attributes));
+    ST_RETURN_ON_ERROR(addAttribute(xml.Get(), L"src", attributes.Get()));
+    ST_RETURN_ON_ERROR(addAttribute(xml.Get(), L"silent", attributes.Get()));
+
+    if (!content.image.empty()) {
+        ST_RETURN_ON_ERROR(setImage(xml.Get(), content));
+    }
+    ST_RETURN_ON_ERROR(setSound(xml.Get(), content));
+
+    ST_RETURN_ON_ERROR(setTextValues(xml.Get(), content));
+
+    if (ToastLog::isEnabled(ToastLog::Level::Debug)) {
+        printXML(xml.Get());
+    }
+    return S_OK;
+}
+
+HRESULT WinRTNotificationBackend::createToast(const std::wstring &appID,
+                                              const ToastContent &content,
+                                              ComPtr<IXmlDocument> xml,
+                                              NotificationListener *listener,
+                                              std::unique_ptr<DisplayedToast> &out)
+{
+    ST_TRACE("WinRTNotificationBackend::createToast");
+    auto toast = std::make_unique<DisplayedToast>();
+    ST_RETURN_ON_ERROR(notifier(appID, toast->notifier));
+
+    ComPtr<IToastNotificationFactory> factory;
+    ST_RETURN_ON_ERROR(toastFactory(factory));
+    const HRESULT hr = factory->CreateToastNotification(xml.Get(), &toast->notification);
+    if (FAILED(hr)) {
+        std::scoped_lock lock(m_mutex);
+        if (m_toastFactory == factory) {
+            m_toastFactory.Reset();
+        }
+    }
+    ST_RETURN_ON_ERROR(hr);
+
+    ComPtr<Notifications::IToastNotification2> toastV2;
+    if (SUCCEEDED(toast->notification.As(&toastV2))) {
+        ST_RETURN_ON_ERROR(toastV2->put_Tag(HStringReference(content.id.c_str()).Get()));
+        ST_RETURN_ON_ERROR(toastV2->put_Group(HStringReference(content.group.c_str()).Get()));
+    }
+
+    if (listener) {
+        toast->listener = listener;
+        // Register the event handlers
+        toast->eventHandler = new ToastEventHandler(listener);
+        // the handler starts with a reference count of 1
+        toast->eventHandler->Release();
+        ST_RETURN_ON_ERROR(toast->notification->add_Activated(toast->eventHandler.Get(),
+                                                              &toast->activatedToken));
+        ST_RETURN_ON_ERROR(toast->notification->add_Dismissed(toast->eventHandler.Get(),
+                                                              &toast->dismissedToken));
+        ST_RETURN_ON_ERROR(toast->notification->add_Failed(toast->eventHandler.Get(),
+                                                           &toast->failedToken));
+
+        std::wstringstream eventName;
+        eventName << L"ToastEvent" << content.id;
+        toast->closeEvent = CreateEventW(nullptr, true, false, eventName.str().c_str());
+        if (!toast->closeEvent
+            || !RegisterWaitForSingleObject(&toast->closeWait, toast->closeEvent,
+                                            closeRequestedCallback, listener, INFINITE,
+                                            WT_EXECUTEONLYONCE)) {
+            tLog << L"Failed to listen for close requests" << Utils::formatWinError(GetLastError());
+        }
+    }
+    out = std::move(toast);
+    return S_OK;
+}
+
+bool WinRTNotificationBackend::show(const std::wstring &appID, const ToastContent &content,
+                                    NotificationListener *listener)
+{
+    if (!m_toastManager) {
+        return false;
+    }
+    ST_TRACE("WinRTNotificationBackend::show");
+    ComPtr<IXmlDocument> xml;
+    std::unique_ptr<DisplayedToast> toast;
+    if (!ST_CHECK_RESULT(loadXml(content, xml))) {
+        tLog << L"Failed to load the xml payload, building it with the template";
+        xml.Reset();
+        if (!ST_CHECK_RESULT(createXml(content, xml))) {
+            return false;
+        }
+    }
+    if (!ST_CHECK_RESULT(createToast(appID, content, xml, listener, toast))) {
+        return false;
+    }
+    ComPtr<IToastNotifier> toastNotifier = toast->notifier;
+    ComPtr<IToastNotification> notification = toast->notification;
+    std::unique_ptr<DisplayedToast> previous;
+    ComPtr<ToastEventHandler> replacedHandler;
+    {
+        std::scoped_lock lock(m_mutex);
+        // like in the action center the toast replaces the toast with the same tag
+        const auto it = m_toasts.find(content.id);
+        if (it != m_toasts.end()) {
+            previous = std::move(it->second);
+            m_toasts.erase(it);
+        }
+        if (previous && previous->listener != listener) {
+            // kept until its listener releases it, which waits for the replaced() below
+            replacedHandler = previous->eventHandler;
+            std::swap(m_replaced[previous->listener], previous);
+        }
+        // without a listener nothing releases the toast
+        if (listener) {
+            m_toasts.emplace(content.id, std::move(toast));
+        }
+    }
+    // destroyed outside of the lock, it waits for running callbacks
+    previous.reset();
+    if (replacedHandler) {
+        replacedHandler->replaced();
+    }
+    ST_TRACE("IToastNotifier::Show");
+    if (!ST_CHECK_RESULT(toastNotifier->Show(notification.Get()))) {
+        // the next toast of appID creates a new notifier
+        m_notifiers.invalidate(appID);
+        return false;
+    }
+    return true;
+}
+
+bool WinRTNotificationBackend::hide(const std::wstring &id, NotificationListener *listener)
+{
+    ComPtr<IToastNotifier> toastNotifier;
+    ComPtr<IToastNotification> notification;
+    {
+        std::scoped_lock lock(m_mutex);
+        const auto it = m_toasts.find(id);
+        if (it == m_toasts.cend() || it->second->listener != listener) {
+            return false;
+        }
+        toastNotifier = it->second->notifier;
+        notification = it->second->notification;
+    }
+    return ST_CHECK_RESULT(toastNotifier->Hide(notification.Get()));
+}
+
+void WinRTNotificationBackend::release(const std::wstring &id, NotificationListener *listener)
+{
+    std::unique_ptr<DisplayedToast> toast;
+    {
+        std::scoped_lock lock(m_mutex);
+        const auto it = m_toasts.find(id);
+        if (it != m_toasts.cend() && it->second->listener == listener) {
+            toast = std::move(it->second);
+            m_toasts.erase(it);
+        } else if (const auto replaced = m_replaced.find(listener);
+                   replaced != m_replaced.cend()) {
+            toast = std::move(replaced->second);
+            m_replaced.erase(replaced);
+        }
+    }
+    // destroyed outside of the lock, it waits for running callbacks
+    toast.reset();
+}
+
+bool WinRTNotificationBackend::requestClose(const std::wstring &id)
+{
+    std::wstringstream eventName;
+    eventName << L"ToastEvent" << id;
+
+    HANDLE event = OpenEventW(EVENT_MODIFY_STATE, FALSE, eventName.str().c_str());
+    if (event) {
+        SetEvent(event);
+        CloseHandle(event);
+        return true;
+    }
+    return false;
+}
+
+bool WinRTNotificationBackend::removeFromHistory(const std::wstring &appID,
+                                                 const std::wstring &group, const std::wstring &id)
+{
+    if (!m_toastManager) {
+        return false;
+    }
+    ComPtr<IToastNotificationManagerStatics2> toastStatics2;
+    ComPtr<IToastNotificationHistory> history;
+    if (ST_CHECK_RESULT(m_toastManager.As(&toastStatics2))
+        && ST_CHECK_RESULT(toastStatics2->get_History(&history))) {
+        return ST_CHECK_RESULT(history->RemoveGroupedTagWithId(
+                HStringReference(id.c_str()).Get(), HStringReference(group.c_str()).Get(),
+                HStringReference(appID.c_str()).Get()));
+    }
+    return false;
+}
+
+std::vector<HistoryEntry> WinRTNotificationBackend::history(const std::wstring &appID)
+{
+    std::vector<HistoryEntry> out;
+    if (!m_toastManager) {
+        return out;
+    }
+    ST_TRACE("IToastNotificationHistory2::GetHistoryWithId");
+    ComPtr<IToastNotificationManagerStatics2> toastStatics2;
+    ComPtr<IToastNotificationHistory> history;
+    ComPtr<IToastNotificationHistory2> history2;
+    ComPtr<ABI::Windows::Foundation::Collections::IVectorView<ToastNotification *>> toasts;
+    if (!ST_CHECK_RESULT(m_toastManager.As(&toastStatics2))
+        || !ST_CHECK_RESULT(toastStatics2->get_History(&history))
+        || !ST_CHECK_RESULT(history.As(&history2))
+        || !ST_CHECK_RESULT(
+                history2->GetHistoryWithId(HStringReference(appID.c_str()).Get(), &toasts))) {
+        return out;
+    }
+    unsigned int size = 0;
+    if (!ST_CHECK_RESULT(toasts->get_Size(&size))) {
+        return out;
+    }
+    out.reserve(size);
+    const auto toString = [](const HString &string) {
+        unsigned int length = 0;
+        const wchar_t *data = string.GetRawBuffer(&length);
+        return std::wstring(data, length);
+    };
+    for (unsigned int i = 0; i < size; ++i) {
+        ComPtr<IToastNotification> toast;
+        ComPtr<IToastNotification2> toastV2;
+        HString tag;
+        HString group;
+        if (SUCCEEDED(toasts->GetAt(i, &toast)) && SUCCEEDED(toast.As(&toastV2))
+            && SUCCEEDED(toastV2->get_Tag(tag.GetAddressOf()))
+            && SUCCEEDED(toastV2->get_Group(group.GetAddressOf()))) {
+            out.push_back({ toString(tag), toString(group) });
+        }
+    }
+    return out;
+}
+
+bool WinRTNotificationBackend::writePipe(const std::filesystem::path &pipe, std::string_view data,
+                                         bool wait)
+{
+    return Utils::writePipe(pipe, data, wait);
+}
+
+bool WinRTNotificationBackend::startProcess(const std::filesystem::path &app)
+{
+    return Utils::startProcess(app);
+}
@@ -0,0 +1,120 @@
+/*
+    SnoreToast is capable to invoke Windows 8 toast notifications.
+    Copyright (C) 2013-2019  Hannah von Reth <vonreth@kde.org>
+
+    SnoreToast is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    SnoreToast is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with SnoreToast.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#pragma once
+
+#include "notificationbackend.h"
+#include "notifiercache.h"
+#include "libsnoretoast_export.h"
+
+#include <sdkddkver.h>
+
+// Windows Header Files:
+#include <windows.h>
+#include <sal.h>
+#include <psapi.h>
+#include <strsafe.h>
+#include <objbase.h>
+#include <shobjidl.h>
+#include <functiondiscoverykeys.h>
+#include <guiddef.h>
+#include <shlguid.h>
+
+#include <wrl/client.h>
+#include <wrl/implements.h>
+#include <windows.ui.notifications.h>
+
+#include <map>
+#include <memory>
+#include <mutex>
+
+using namespace Microsoft::WRL;
+using namespace ABI::Windows::Data::Xml::Dom;
+
+class ToastEventHandler;
+
+/**
+ * Displays the toasts with Windows.UI.Notifications.
+ * Windows::Foundation::Initialize(RO_INIT_MULTITHREADED) must be called before the backend is
+ * created.
+ */
+class LIBSNORETOAST_EXPORT WinRTNotificationBackend : public NotificationBackend
+{
+public:
+    using Notifiers = NotifierCache<ComPtr<ABI::Windows::UI::Notifications::IToastNotifier>>;
+
+    /**
+     * The process wide instance, also used by the com server receiving the activations.
+     */
+    static WinRTNotificationBackend &instance();
+
+    WinRTNotificationBackend();
+    ~WinRTNotificationBackend() override;
+
+    /**
+     * Releases the WinRT objects, instance() outlives Windows::Foundation::Uninitialize() so
+     * this has to be called before, while no other thread uses the backend. The backend can't
+     * show toasts afterwards.
+     */
+    void shutdown();
+
+    bool isRegistered(const std::wstring &appID) override;
+    NotificationSetting setting(const std::wstring &appID) override;
+    bool registerActivator() override;
+    void unregisterActivator() override;
+    bool show(const std::wstring &appID, const ToastContent &content,
+              NotificationListener *listener) override;
+    bool hide(const std::wstring &id, NotificationListener *listener) override;
+    void release(const std::wstring &id, NotificationListener *listener) override;
+    bool requestClose(const std::wstring &id) override;
+    bool removeFromHistory(const std::wstring &appID, const std::wstring &group,
+                           const std::wstring &id) override;
+    std::vector<HistoryEntry> history(const std::wstring &appID) override;
+    bool writePipe(const std::filesystem::path &pipe, std::string_view data,
+                   bool wait = false) override;
+    bool startProcess(const std::filesystem::path &app) override;
+
+    /**
+     * The lookups of the notifiers, shared by all toasts of the process.
+     */
+    Notifiers::Statistics notifierStatistics() const;
+
+private:
+    struct DisplayedToast;
+
+    HRESULT notifier(const std::wstring &appID,
+                     ComPtr<ABI::Windows::UI::Notifications::IToastNotifier> &out);
+    // looked up on first use and after a failure
+    HRESULT toastFactory(ComPtr<ABI::Windows::UI::Notifications::IToastNotificationFactory> &out);
+    // builds the payload with ToastXml and parses it in one call
+    HRESULT loadXml(const ToastContent &content, ComPtr<IXmlDocument> &xml);
+    // fallback, fills the toast template node by node
+    HRESULT createXml(const ToastContent &content, ComPtr<IXmlDocument> &xml);
+    HRESULT createToast(const std::wstring &appID, const ToastContent &content,
+                        ComPtr<IXmlDocument> xml, NotificationListener *listener,
+                        std::unique_ptr<DisplayedToast> &out);
+
+    ComPtr<ABI::Windows::UI::Notifications::IToastNotificationManagerStatics> m_toastManager;
+    Notifiers m_notifiers;
+
+    std::mutex m_mutex;
+    ComPtr<ABI::Windows::UI::Notifications::IToastNotificationFactory> m_toastFactory;
+    // the toasts with a listener by id
+    std::map<std::wstring, std::unique_ptr<DisplayedToast>> m_toasts;
+    // the toasts replaced by a toast of another listener, until their listener releases them
+    std::map<NotificationListener *, std::unique_ptr<DisplayedToast>> m_replaced;
+};
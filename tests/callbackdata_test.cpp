@@ -0,0 +1,146 @@
+/*
+    SnoreToast is capable to invoke Windows 8 toast notifications.
+    Copyright (C) 2026  Hannah von Reth <vonreth@kde.org>
+
+    SnoreToast is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    SnoreToast is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with SnoreToast.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "testing.h"
+
+#include "actionformatter.h"
+#include "callbackdata.h"
+#include "config.h"
+
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace {
+// the escaped characters, the characters of the escape sequences and some non ascii text
+constexpr std::wstring_view Alphabet = L"%;=%;=253BbDdx ä中";
+// paths are converted with the locale, which might be ascii only
+constexpr size_t AsciiSize = 15;
+
+std::wstring randomValue(Testing::Random &random, size_t alphabetSize = Alphabet.size())
+{
+    std::wstring out(random.below(12), L' ');
+    for (auto &c : out) {
+        c = Alphabet[random.below(alphabetSize)];
+    }
+    return out;
+}
+}
+
+SNORETOAST_TEST(CallbackData_EscapedValuesRoundTrip)
+{
+    Testing::Random random;
+    CallbackData data;
+    for (int round = 0; round < 5000; ++round) {
+        // more fields than the inline capacity every now and then
+        std::vector<std::pair<std::wstring, std::wstring>> fields(1 + random.below(24));
+        std::wstring encoded;
+        for (size_t i = 0; i < fields.size(); ++i) {
+            fields[i] = { L"key" + std::to_wstring(i), randomValue(random) };
+            const ActionFormatter::Field field { fields[i].first, fields[i].second };
+            const size_t before = encoded.size();
+            ActionFormatter::appendField(encoded, field);
+            SNORETOAST_COMPARE(encoded.size() - before, ActionFormatter::fieldSize(field));
+        }
+        data.parse(encoded);
+        for (const auto &field : fields) {
+            if (field.second.empty()) {
+                // empty values are not written
+                SNORETOAST_CHECK(!data.contains(field.first));
+            } else {
+                SNORETOAST_COMPARE(data.value(field.first), field.second);
+            }
+        }
+    }
+}
+
+SNORETOAST_TEST(CallbackData_EscapeSequences)
+{
+    std::wstring escaped;
+    CallbackData::appendEscaped(escaped, L"a%b;c=d");
+    SNORETOAST_COMPARE(escaped, L"a%25b%3Bc%3Dd");
+    SNORETOAST_COMPARE(CallbackData::escape(L'x'), L"");
+
+    // lower case escapes are accepted
+    const CallbackData data(L"a=%3b%3d;");
+    SNORETOAST_COMPARE(data.value(L"a"), L";=");
+}
+
+SNORETOAST_TEST(CallbackData_UnknownEscapesAreKept)
+{
+    // payloads of older versions were not escaped
+    const CallbackData data(L"a=100%;b=%41%;c=%2;d=50%25");
+    SNORETOAST_COMPARE(data.value(L"a"), L"100%");
+    SNORETOAST_COMPARE(data.value(L"b"), L"%41%");
+    SNORETOAST_COMPARE(data.value(L"c"), L"%2");
+    SNORETOAST_COMPARE(data.value(L"d"), L"50%");
+}
+
+SNORETOAST_TEST(CallbackData_MalformedSegments)
+{
+    const CallbackData data(L";;=x;a=1;novalue;b=;a=2;trailing");
+    SNORETOAST_COMPARE(data.size(), size_t(3));
+    // the last occurrence wins
+    SNORETOAST_COMPARE(data.value(L"a"), L"2");
+    SNORETOAST_CHECK(data.contains(L"b"));
+    SNORETOAST_COMPARE(data.value(L"b"), L"");
+    SNORETOAST_CHECK(!data.contains(L"novalue"));
+    SNORETOAST_CHECK(!data.contains(L"trailing"));
+    SNORETOAST_CHECK(data.find(L"x") == nullptr);
+}
+
+SNORETOAST_TEST(CallbackData_ReparseDiscardsContent)
+{
+    CallbackData data(L"a=%25;b=2;");
+    data.parse(L"c=3;");
+    SNORETOAST_COMPARE(data.size(), size_t(1));
+    SNORETOAST_CHECK(!data.contains(L"a"));
+    SNORETOAST_COMPARE(data.value(L"c"), L"3");
+}
+
+SNORETOAST_TEST(ActionFormatter_FormatRoundTrip)
+{
+    Testing::Random random;
+    ActionFormatter formatter;
+    std::wstring out;
+    std::wstring buffer(16, L'\0');
+    for (int round = 0; round < 2000; ++round) {
+        const auto id = randomValue(random);
+        const auto pipe = L"\\\\.\\pipe\\" + randomValue(random, AsciiSize);
+        const auto application = randomValue(random, AsciiSize);
+        const unsigned protocol = 1 + unsigned(random.below(2));
+        formatter.setToast(id, pipe, application, protocol);
+
+        const auto text = randomValue(random);
+        const auto action = SnoreToastActions::Actions(random.below(6));
+        const std::vector<ActionFormatter::Field> extra { { L"text", text } };
+        formatter.format(out, action, extra);
+        SNORETOAST_COMPARE(out.size(), formatter.size(action, extra));
+        // too small buffers report the required size
+        SNORETOAST_COMPARE(formatter.format(buffer.data(), buffer.size(), action, extra),
+                           out.size());
+
+        const CallbackData data(out);
+        SNORETOAST_CHECK(SnoreToastActions::getAction(data.value(L"action")) == action);
+        SNORETOAST_COMPARE(data.value(L"notificationId"), id);
+        SNORETOAST_COMPARE(data.value(L"pipe"), pipe);
+        SNORETOAST_COMPARE(data.value(L"application"), application);
+        SNORETOAST_COMPARE(data.value(L"protocol"), protocol == 1 ? L"" : L"2");
+        SNORETOAST_COMPARE(data.value(L"text"), text);
+        SNORETOAST_COMPARE(data.value(L"version"), SNORETOAST_VERSION);
+    }
+}
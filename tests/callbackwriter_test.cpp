@@ -0,0 +1,197 @@
+/*
+    SnoreToast is capable to invoke Windows 8 toast notifications.
+    Copyright (C) 2026  Hannah von Reth <vonreth@kde.org>
+
+    SnoreToast is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    SnoreToast is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with SnoreToast.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "testing.h"
+
+#include "callbackwriter.h"
+
+#include <algorithm>
+#include <chrono>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace std::chrono_literals;
+
+namespace {
+// the receivers of the pipes, shared with their connections
+struct Receivers
+{
+    std::mutex mutex;
+    std::map<std::filesystem::path, std::vector<std::string>> received;
+    // the pipes that refuse connections and the ones whose connections fail to write
+    std::set<std::filesystem::path> unreachable;
+    std::set<std::filesystem::path> broken;
+    size_t open = 0;
+
+    std::vector<std::string> messages(const std::filesystem::path &pipe)
+    {
+        std::scoped_lock lock(mutex);
+        return received[pipe];
+    }
+
+    size_t openConnections()
+    {
+        std::scoped_lock lock(mutex);
+        return open;
+    }
+};
+
+class Connection : public ToastServerConnection
+{
+public:
+    Connection(Receivers &receivers, const std::filesystem::path &pipe)
+        : m_receivers(receivers), m_pipe(pipe)
+    {
+        std::scoped_lock lock(m_receivers.mutex);
+        ++m_receivers.open;
+    }
+    ~Connection() override
+    {
+        std::scoped_lock lock(m_receivers.mutex);
+        --m_receivers.open;
+    }
+
+    bool read(void *, size_t) override { return false; }
+    bool write(const void *data, size_t size) override
+    {
+        std::scoped_lock lock(m_receivers.mutex);
+        if (m_receivers.broken.count(m_pipe)) {
+            return false;
+        }
+        m_receivers.received[m_pipe].emplace_back(static_cast<const char *>(data), size);
+        return true;
+    }
+
+private:
+    Receivers &m_receivers;
+    const std::filesystem::path m_pipe;
+};
+
+CallbackWriter::Connector connector(Receivers &receivers)
+{
+    return [&receivers](const std::filesystem::path &pipe)
+                   -> std::unique_ptr<ToastServerConnection> {
+        {
+            std::scoped_lock lock(receivers.mutex);
+            if (receivers.unreachable.count(pipe)) {
+                return nullptr;
+            }
+        }
+        return std::make_unique<Connection>(receivers, pipe);
+    };
+}
+
+// the writer thread closes the idle pipes on its own
+template<typename Predicate>
+bool waitFor(Predicate predicate)
+{
+    const auto deadline = std::chrono::steady_clock::now() + 10s;
+    while (!predicate()) {
+        if (std::chrono::steady_clock::now() > deadline) {
+            return false;
+        }
+        std::this_thread::sleep_for(1ms);
+    }
+    return true;
+}
+}
+
+SNORETOAST_TEST(CallbackWriter_KeepsConnectionsOpen)
+{
+    Receivers receivers;
+    CallbackWriter writer(0us, connector(receivers));
+    for (int i = 0; i < 3; ++i) {
+        writer.post("a", "a" + std::to_string(i));
+        writer.post("b", "b" + std::to_string(i));
+        writer.flush();
+    }
+    const std::vector<std::string> expected = { "a0", "a1", "a2" };
+    SNORETOAST_CHECK(receivers.messages("a") == expected);
+    SNORETOAST_COMPARE(receivers.messages("b").size(), size_t(3));
+    SNORETOAST_COMPARE(writer.statistics().connects, uint64_t(2));
+    SNORETOAST_COMPARE(writer.statistics().messages, uint64_t(6));
+    SNORETOAST_COMPARE(writer.pipeCount(), size_t(2));
+    SNORETOAST_COMPARE(receivers.openConnections(), size_t(2));
+}
+
+SNORETOAST_TEST(CallbackWriter_ClosesFailedPipes)
+{
+    Receivers receivers;
+    receivers.unreachable.insert("gone");
+    std::vector<std::string> fallbacks;
+    CallbackWriter writer(0us, connector(receivers),
+                          [&fallbacks](const std::filesystem::path &, const std::filesystem::path &,
+                                       std::string message) {
+                              fallbacks.push_back(std::move(message));
+                          });
+    writer.post("gone", "first");
+    writer.post("alive", "message");
+    writer.post("broken", "message");
+    writer.flush();
+    SNORETOAST_COMPARE(writer.pipeCount(), size_t(2));
+    SNORETOAST_COMPARE(writer.statistics().closed, uint64_t(1));
+
+    // a receiver that stops reading drops the connection kept open
+    {
+        std::scoped_lock lock(receivers.mutex);
+        receivers.broken.insert("broken");
+    }
+    writer.post("broken", "lost");
+    writer.post("gone", "second");
+    writer.flush();
+    const std::vector<std::string> expected = { "first", "lost", "second" };
+    SNORETOAST_COMPARE(fallbacks.size(), size_t(3));
+    SNORETOAST_CHECK(std::is_permutation(fallbacks.cbegin(), fallbacks.cend(), expected.cbegin()));
+    SNORETOAST_COMPARE(writer.pipeCount(), size_t(1));
+    SNORETOAST_COMPARE(writer.statistics().closed, uint64_t(3));
+    SNORETOAST_COMPARE(receivers.openConnections(), size_t(1));
+
+    // a pipe reachable again is reconnected
+    {
+        std::scoped_lock lock(receivers.mutex);
+        receivers.unreachable.clear();
+    }
+    writer.post("gone", "third");
+    writer.flush();
+    SNORETOAST_COMPARE(receivers.messages("gone").size(), size_t(1));
+    SNORETOAST_COMPARE(writer.pipeCount(), size_t(2));
+}
+
+SNORETOAST_TEST(CallbackWriter_ClosesIdlePipes)
+{
+    Receivers receivers;
+    CallbackWriter writer(0us, connector(receivers), nullptr, 20ms);
+    for (int i = 0; i < 16; ++i) {
+        writer.post("pipe" + std::to_string(i), "message");
+    }
+    writer.flush();
+    SNORETOAST_CHECK(waitFor([&writer] { return writer.pipeCount() == 0; }));
+    SNORETOAST_COMPARE(receivers.openConnections(), size_t(0));
+    SNORETOAST_COMPARE(writer.statistics().closed, uint64_t(16));
+
+    // the next message opens a new connection
+    writer.post("pipe0", "again");
+    writer.flush();
+    SNORETOAST_COMPARE(receivers.messages("pipe0").size(), size_t(2));
+    SNORETOAST_COMPARE(writer.statistics().connects, uint64_t(17));
+    SNORETOAST_CHECK(waitFor([&receivers] { return receivers.openConnections() == 0; }));
+}
@@ -0,0 +1,307 @@
+/*
+    SnoreToast is capable to invoke Windows 8 toast notifications.
+    Copyright (C) 2026  Hannah von Reth <vonreth@kde.org>
+
+    SnoreToast is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    SnoreToast is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with SnoreToast.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "testing.h"
+
+#include "completiondispatcher.h"
+#include "mocknotificationbackend.h"
+#include "snoretoasts.h"
+
+#include <atomic>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#ifndef _WIN32
+#include <poll.h>
+#endif
+
+using namespace std::chrono_literals;
+using Actions = SnoreToastActions::Actions;
+using Results = std::vector<std::pair<uint64_t, Actions>>;
+
+namespace {
+std::unique_ptr<SnoreToasts> show(MockNotificationBackend &backend, const std::wstring &id)
+{
+    auto toast = std::make_unique<SnoreToasts>(&backend, L"Dispatcher.App");
+    toast->setId(id);
+    toast->displayToast(L"Title", L"Body", {});
+    return toast;
+}
+
+// the event ending toast i and its result
+Actions trigger(MockNotificationBackend &backend, const std::wstring &id, size_t i)
+{
+    switch (i % 3) {
+    case 0:
+        backend.activate(id);
+        return Actions::Clicked;
+    case 1:
+        backend.dismiss(id, DismissalReason::UserCanceled);
+        return Actions::Dismissed;
+    default:
+        backend.dismiss(id, DismissalReason::TimedOut);
+        return Actions::Timedout;
+    }
+}
+}
+
+SNORETOAST_TEST(CompletionDispatcher_DeliversInTheOrderOfTheResults)
+{
+    MockNotificationBackend backend;
+    Results results;
+    CompletionDispatcher dispatcher(
+            [&results](uint64_t tag, Actions action) { results.emplace_back(tag, action); });
+    for (uint64_t i = 0; i < 3; ++i) {
+        dispatcher.add(show(backend, L"order." + std::to_wstring(i)), 10 + i);
+    }
+    SNORETOAST_COMPARE(dispatcher.size(), size_t(3));
+    trigger(backend, L"order.2", 2);
+    trigger(backend, L"order.0", 0);
+    // nothing is delivered without process()
+    SNORETOAST_CHECK(results.empty());
+    dispatcher.process();
+    const Results expected { { 12, Actions::Timedout }, { 10, Actions::Clicked } };
+    SNORETOAST_CHECK(results == expected);
+    SNORETOAST_COMPARE(dispatcher.size(), size_t(1));
+
+    // only the first event of a toast counts
+    trigger(backend, L"order.1", 1);
+    backend.activate(L"order.1");
+    dispatcher.process();
+    SNORETOAST_COMPARE(results.size(), size_t(3));
+    SNORETOAST_CHECK(results.back() == std::make_pair(uint64_t(11), Actions::Dismissed));
+    SNORETOAST_COMPARE(dispatcher.size(), size_t(0));
+    SNORETOAST_COMPARE(dispatcher.statistics().completed, uint64_t(3));
+}
+
+SNORETOAST_TEST(CompletionDispatcher_FinishedBeforeAdd)
+{
+    MockNotificationBackend backend;
+    std::vector<Actions> results;
+    CompletionDispatcher dispatcher(
+            [&results](uint64_t, Actions action) { results.push_back(action); });
+    auto toast = show(backend, L"early");
+    backend.activate(L"early");
+    dispatcher.add(std::move(toast), 0);
+    dispatcher.process();
+    SNORETOAST_CHECK(results == std::vector<Actions>({ Actions::Clicked }));
+}
+
+SNORETOAST_TEST(CompletionDispatcher_Timeouts)
+{
+    MockNotificationBackend backend;
+    Testing::ManualClock<> clock;
+    Results results;
+    CompletionDispatcher dispatcher(
+            [&results](uint64_t tag, Actions action) { results.emplace_back(tag, action); },
+            { 10s }, clock.function());
+    dispatcher.add(show(backend, L"timeout.0"), 0);
+    clock.advance(5s);
+    dispatcher.add(show(backend, L"timeout.1"), 1);
+    const auto first = clock.now() + 5s;
+
+    SNORETOAST_CHECK(dispatcher.process() == first);
+    clock.advance(5s);
+    SNORETOAST_CHECK(dispatcher.process() == first + 5s);
+    // a toast without a result is reported like a timed out userAction()
+    const Results expected { { 0, Actions::Error } };
+    SNORETOAST_CHECK(results == expected);
+    // a late event is ignored
+    backend.activate(L"timeout.0");
+    trigger(backend, L"timeout.1", 0);
+    SNORETOAST_CHECK(dispatcher.process() == std::chrono::steady_clock::time_point::max());
+    SNORETOAST_COMPARE(results.size(), size_t(2));
+    SNORETOAST_CHECK(results.back() == std::make_pair(uint64_t(1), Actions::Clicked));
+
+    const auto statistics = dispatcher.statistics();
+    SNORETOAST_COMPARE(statistics.timedOut, uint64_t(1));
+    SNORETOAST_COMPARE(statistics.completed, uint64_t(1));
+}
+
+SNORETOAST_TEST(CompletionDispatcher_ReleasesPendingToasts)
+{
+    MockNotificationBackend backend;
+    size_t results = 0;
+    {
+        CompletionDispatcher dispatcher([&results](uint64_t, Actions) { ++results; });
+        dispatcher.add(show(backend, L"pending"), 0);
+    }
+    // the toast is gone without a result, a later event finds no listener
+    SNORETOAST_COMPARE(results, size_t(0));
+    SNORETOAST_CHECK(!backend.activate(L"pending"));
+}
+
+SNORETOAST_TEST(CompletionDispatcher_Callbacks)
+{
+    MockNotificationBackend backend;
+    CompletionDispatcher dispatcher;
+    std::vector<std::pair<int, Actions>> results;
+    for (int i = 0; i < 2; ++i) {
+        dispatcher.add(show(backend, L"callback." + std::to_wstring(i)),
+                       [&results, i](Actions action) { results.emplace_back(i, action); });
+    }
+    backend.dismiss(L"callback.1", DismissalReason::TimedOut);
+    backend.dismiss(L"callback.0", DismissalReason::UserCanceled);
+    dispatcher.process();
+    const std::vector<std::pair<int, Actions>> expected { { 1, Actions::Timedout },
+                                                          { 0, Actions::Dismissed } };
+    SNORETOAST_CHECK(results == expected);
+}
+
+SNORETOAST_TEST(CompletionDispatcher_Promises)
+{
+    MockNotificationBackend backend;
+    std::future<Actions> broken;
+    {
+        CompletionDispatcher dispatcher;
+        std::promise<Actions> clicked;
+        auto result = clicked.get_future();
+        dispatcher.add(show(backend, L"promise.0"), std::move(clicked));
+        std::promise<Actions> pending;
+        broken = pending.get_future();
+        dispatcher.add(show(backend, L"promise.1"), std::move(pending));
+
+        backend.activate(L"promise.0");
+        SNORETOAST_CHECK(result.wait_for(0s) == std::future_status::timeout);
+        dispatcher.process();
+        SNORETOAST_CHECK(result.wait_for(0s) == std::future_status::ready);
+        SNORETOAST_CHECK(result.get() == Actions::Clicked);
+    }
+    // released by the destructor without a result
+    try {
+        broken.get();
+        SNORETOAST_CHECK(false);
+    } catch (const std::future_error &error) {
+        SNORETOAST_CHECK(error.code() == std::future_errc::broken_promise);
+    }
+}
+
+SNORETOAST_TEST(CompletionDispatcher_Cancel)
+{
+    MockNotificationBackend backend;
+    Results results;
+    CompletionDispatcher dispatcher(
+            [&results](uint64_t tag, Actions action) { results.emplace_back(tag, action); });
+    const auto cancelled = dispatcher.add(show(backend, L"cancel.0"), 0);
+    const auto clicked = dispatcher.add(show(backend, L"cancel.1"), 1);
+    backend.activate(L"cancel.1");
+
+    SNORETOAST_CHECK(dispatcher.cancel(cancelled));
+    // the result is known, twice and for the clicked toast
+    SNORETOAST_CHECK(!dispatcher.cancel(cancelled));
+    SNORETOAST_CHECK(!dispatcher.cancel(clicked));
+    dispatcher.process();
+    const Results expected { { 1, Actions::Clicked }, { 0, Actions::Hidden } };
+    SNORETOAST_CHECK(results == expected);
+    // delivered and unknown tickets
+    SNORETOAST_CHECK(!dispatcher.cancel(cancelled));
+    SNORETOAST_CHECK(!dispatcher.cancel(cancelled + 100));
+    // the cancelled toast is closed
+    SNORETOAST_CHECK(!backend.activate(L"cancel.0"));
+
+    const auto statistics = dispatcher.statistics();
+    SNORETOAST_COMPARE(statistics.cancelled, uint64_t(1));
+    SNORETOAST_COMPARE(statistics.completed, uint64_t(1));
+}
+
+#ifndef _WIN32
+SNORETOAST_TEST(CompletionDispatcher_NativeHandle)
+{
+    const auto readable = [](int fd) {
+        pollfd entry { fd, POLLIN, 0 };
+        return ::poll(&entry, 1, 0) == 1 && (entry.revents & POLLIN);
+    };
+    MockNotificationBackend backend;
+    size_t results = 0;
+    CompletionDispatcher dispatcher([&results](uint64_t, Actions) { ++results; });
+    const int fd = dispatcher.nativeHandle();
+    SNORETOAST_CHECK(fd >= 0);
+    SNORETOAST_CHECK(!readable(fd));
+
+    // the event loop has to pick up the first timeout
+    dispatcher.add(show(backend, L"handle.0"), 0);
+    SNORETOAST_CHECK(readable(fd));
+    dispatcher.process();
+    SNORETOAST_CHECK(!readable(fd));
+    // a later timeout doesn't change the next wake up
+    dispatcher.add(show(backend, L"handle.1"), 1);
+    SNORETOAST_CHECK(!readable(fd));
+
+    backend.activate(L"handle.0");
+    backend.activate(L"handle.1");
+    SNORETOAST_CHECK(readable(fd));
+    dispatcher.process();
+    SNORETOAST_COMPARE(results, size_t(2));
+    SNORETOAST_CHECK(!readable(fd));
+}
+#endif
+
+SNORETOAST_TEST(CompletionDispatcher_ThousandsOfConcurrentToasts)
+{
+    constexpr size_t Toasts = 4000;
+    constexpr size_t Threads = 4;
+    MockNotificationBackend backend;
+    std::vector<std::atomic<int>> deliveries(Toasts);
+    std::vector<std::atomic<int>> results(Toasts);
+    CompletionDispatcher dispatcher([&](uint64_t tag, Actions action) {
+        ++deliveries[tag];
+        results[tag] = static_cast<int>(action);
+    });
+    dispatcher.start();
+
+    // the producers show and hand over the toasts while the others end them
+    std::vector<std::atomic<bool>> shown(Toasts);
+    std::vector<Actions> expected(Toasts);
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < Threads; ++t) {
+        threads.emplace_back([&, t] {
+            for (size_t i = t; i < Toasts; i += Threads) {
+                dispatcher.add(show(backend, L"stress." + std::to_wstring(i)), i);
+                shown[i] = true;
+            }
+        });
+        threads.emplace_back([&, t] {
+            // a different partition than the producer of the same index
+            for (size_t i = (t + 1) % Threads; i < Toasts; i += Threads) {
+                while (!shown[i]) {
+                    std::this_thread::yield();
+                }
+                expected[i] = trigger(backend, L"stress." + std::to_wstring(i), i);
+            }
+        });
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+    SNORETOAST_CHECK(dispatcher.waitUntilEmpty(60s));
+    dispatcher.stop();
+
+    for (size_t i = 0; i < Toasts; ++i) {
+        SNORETOAST_COMPARE(deliveries[i].load(), 1);
+        SNORETOAST_COMPARE(results[i].load(), static_cast<int>(expected[i]));
+    }
+    const auto statistics = dispatcher.statistics();
+    SNORETOAST_COMPARE(statistics.added, uint64_t(Toasts));
+    SNORETOAST_COMPARE(statistics.completed, uint64_t(Toasts));
+    SNORETOAST_COMPARE(statistics.timedOut, uint64_t(0));
+    SNORETOAST_COMPARE(backend.showCount(), Toasts);
+}
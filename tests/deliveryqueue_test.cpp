@@ -0,0 +1,187 @@
+/*
+    SnoreToast is capable to invoke Windows 8 toast notifications.
+    Copyright (C) 2026  Hannah von Reth <vonreth@kde.org>
+
+    SnoreToast is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    SnoreToast is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with SnoreToast.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "testing.h"
+
+#include "deliveryqueue.h"
+#include "mocknotificationbackend.h"
+
+#include <string>
+
+using namespace std::chrono_literals;
+
+namespace {
+DeliveryQueue::Policy testPolicy()
+{
+    DeliveryQueue::Policy policy;
+    policy.capacity = 4;
+    policy.initialBackoff = 50ms;
+    policy.maxBackoff = 200ms;
+    policy.deadline = 1s;
+    return policy;
+}
+}
+
+SNORETOAST_TEST(DeliveryQueue_DeliversRightAway)
+{
+    MockNotificationBackend backend;
+    Testing::ManualClock<> clock;
+    DeliveryQueue queue(&backend, testPolicy(), clock.function());
+    SNORETOAST_CHECK(queue.push("pipe", "app.exe", "message"));
+    SNORETOAST_COMPARE(queue.size(), size_t(1));
+
+    SNORETOAST_CHECK(queue.process() == std::chrono::steady_clock::time_point::max());
+    SNORETOAST_COMPARE(queue.size(), size_t(0));
+    const auto messages = backend.pipeMessages();
+    SNORETOAST_COMPARE(messages.size(), size_t(1));
+    SNORETOAST_COMPARE(messages[0].pipe.string(), "pipe");
+    SNORETOAST_COMPARE(messages[0].data, "message");
+    // the application is only started if the pipe is not available
+    SNORETOAST_CHECK(backend.startedProcesses().empty());
+    SNORETOAST_COMPARE(queue.statistics().delivered, uint64_t(1));
+}
+
+SNORETOAST_TEST(DeliveryQueue_RetriesWithBackoff)
+{
+    MockNotificationBackend backend;
+    backend.setPipeAvailable(false);
+    Testing::ManualClock<> clock;
+    DeliveryQueue queue(&backend, testPolicy(), clock.function());
+    queue.push("pipe", "app.exe", "message");
+
+    SNORETOAST_CHECK(queue.process() == clock.now() + 50ms);
+    // the application is started once
+    SNORETOAST_COMPARE(backend.startedProcesses().size(), size_t(1));
+    SNORETOAST_COMPARE(backend.startedProcesses()[0].string(), "app.exe");
+
+    // nothing happens before the attempt is due
+    clock.advance(49ms);
+    SNORETOAST_CHECK(queue.process() == clock.now() + 1ms);
+    SNORETOAST_COMPARE(queue.statistics().retries, uint64_t(1));
+
+    // the backoff doubles up to maxBackoff
+    for (const auto backoff : { 100ms, 200ms, 200ms }) {
+        clock.advance(queue.process() - clock.now());
+        SNORETOAST_CHECK(queue.process() == clock.now() + backoff);
+    }
+    SNORETOAST_COMPARE(backend.startedProcesses().size(), size_t(1));
+    SNORETOAST_COMPARE(queue.statistics().retries, uint64_t(4));
+
+    backend.setPipeAvailable(true);
+    clock.advance(200ms);
+    SNORETOAST_CHECK(queue.process() == std::chrono::steady_clock::time_point::max());
+    SNORETOAST_COMPARE(backend.pipeMessages().size(), size_t(1));
+    const auto statistics = queue.statistics();
+    SNORETOAST_COMPARE(statistics.delivered, uint64_t(1));
+    SNORETOAST_COMPARE(statistics.started, uint64_t(1));
+    SNORETOAST_COMPARE(statistics.expired, uint64_t(0));
+}
+
+SNORETOAST_TEST(DeliveryQueue_ExpiresAtTheDeadline)
+{
+    MockNotificationBackend backend;
+    backend.setPipeAvailable(false);
+    Testing::ManualClock<> clock;
+    DeliveryQueue queue(&backend, testPolicy(), clock.function());
+    const auto deadline = clock.now() + 1s;
+    // without an application nothing is started
+    queue.push("pipe", {}, "message");
+
+    auto next = queue.process();
+    while (next != std::chrono::steady_clock::time_point::max()) {
+        // the last attempt happens at the deadline
+        SNORETOAST_CHECK(next <= deadline);
+        clock.set(next);
+        next = queue.process();
+    }
+    SNORETOAST_CHECK(clock.now() == deadline);
+    SNORETOAST_COMPARE(queue.size(), size_t(0));
+    SNORETOAST_CHECK(backend.startedProcesses().empty());
+    const auto statistics = queue.statistics();
+    SNORETOAST_COMPARE(statistics.expired, uint64_t(1));
+    SNORETOAST_COMPARE(statistics.delivered, uint64_t(0));
+    // attempts at 0, 50, 150, 350, 550, 750, 950 and 1000 ms
+    SNORETOAST_COMPARE(statistics.retries, uint64_t(7));
+}
+
+SNORETOAST_TEST(DeliveryQueue_DropOldest)
+{
+    MockNotificationBackend backend;
+    backend.setPipeAvailable(false);
+    Testing::ManualClock<> clock;
+    DeliveryQueue queue(&backend, testPolicy(), clock.function());
+    for (int i = 0; i < 6; ++i) {
+        SNORETOAST_CHECK(queue.push("pipe", {}, std::to_string(i)));
+        clock.advance(1ms);
+    }
+    SNORETOAST_COMPARE(queue.size(), size_t(4));
+    SNORETOAST_COMPARE(queue.statistics().dropped, uint64_t(2));
+
+    backend.setPipeAvailable(true);
+    queue.process();
+    const auto messages = backend.pipeMessages();
+    SNORETOAST_COMPARE(messages.size(), size_t(4));
+    for (size_t i = 0; i < messages.size(); ++i) {
+        SNORETOAST_COMPARE(messages[i].data, std::to_string(i + 2));
+    }
+}
+
+SNORETOAST_TEST(DeliveryQueue_RejectNew)
+{
+    MockNotificationBackend backend;
+    backend.setPipeAvailable(false);
+    Testing::ManualClock<> clock;
+    auto policy = testPolicy();
+    policy.dropPolicy = DeliveryQueue::DropPolicy::RejectNew;
+    DeliveryQueue queue(&backend, policy, clock.function());
+    for (int i = 0; i < 4; ++i) {
+        SNORETOAST_CHECK(queue.push("pipe", {}, std::to_string(i)));
+    }
+    SNORETOAST_CHECK(!queue.push("pipe", {}, "4"));
+    SNORETOAST_COMPARE(queue.statistics().dropped, uint64_t(1));
+
+    // the retries keep their order
+    queue.process();
+    backend.setPipeAvailable(true);
+    clock.advance(50ms);
+    queue.process();
+    const auto messages = backend.pipeMessages();
+    SNORETOAST_COMPARE(messages.size(), size_t(4));
+    for (size_t i = 0; i < messages.size(); ++i) {
+        SNORETOAST_COMPARE(messages[i].data, std::to_string(i));
+    }
+}
+
+SNORETOAST_TEST(DeliveryQueue_Worker)
+{
+    MockNotificationBackend backend;
+    DeliveryQueue queue(&backend);
+    queue.start();
+    // within the default capacity, nothing is dropped however slow the worker is
+    for (int i = 0; i < 64; ++i) {
+        SNORETOAST_CHECK(queue.push("pipe", {}, std::to_string(i)));
+    }
+    SNORETOAST_CHECK(queue.waitUntilEmpty(10s));
+    SNORETOAST_COMPARE(backend.pipeMessages().size(), size_t(64));
+    queue.stop();
+    // a stopped queue keeps the messages until it is started again
+    queue.push("pipe", {}, "late");
+    SNORETOAST_CHECK(!queue.waitUntilEmpty(10ms));
+    queue.start();
+    SNORETOAST_CHECK(queue.waitUntilEmpty(10s));
+    SNORETOAST_COMPARE(backend.pipeMessages().back().data, "late");
+}
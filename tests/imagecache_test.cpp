@@ -0,0 +1,174 @@
+/*
+    SnoreToast is capable to invoke Windows 8 toast notifications.
+    Copyright (C) 2026  Hannah von Reth <vonreth@kde.org>
+
+    SnoreToast is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    SnoreToast is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with SnoreToast.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "testing.h"
+
+#include "imagecache.h"
+#include "pngimage.h"
+
+#include <cstdio>
+#include <string>
+
+namespace {
+std::string encodedImage(uint32_t width, uint32_t height, bool noise = false)
+{
+    Testing::Random random;
+    PngImage::Pixels pixels { width, height, std::vector<uint8_t>(size_t(width) * height * 4) };
+    for (size_t i = 0; i < pixels.rgba.size(); ++i) {
+        pixels.rgba[i] = i % 4 == 3 ? 255 : noise ? static_cast<uint8_t>(random.next()) : 90;
+    }
+    std::string out;
+    PngImage::encode(pixels, out);
+    return out;
+}
+
+std::string fileContent(const std::filesystem::path &path)
+{
+    std::string out(std::filesystem::file_size(path), '\0');
+    FILE *file = std::fopen(path.string().c_str(), "rb");
+    out.resize(std::fread(out.data(), 1, out.size(), file));
+    std::fclose(file);
+    return out;
+}
+}
+
+SNORETOAST_TEST(ImageCache_AcceptsImagesWithinTheLimits)
+{
+    const Testing::TemporaryDirectory directory;
+    ImageCache cache(directory.path() / "cache");
+    // not a PNG, but small enough
+    const auto icon = directory.write("icon.jpg", "jpeg data");
+    SNORETOAST_CHECK(cache.normalize(icon) == icon);
+    SNORETOAST_CHECK(cache.normalize(icon) == icon);
+    SNORETOAST_COMPARE(cache.statistics().accepted, uint64_t(2));
+    // nothing is stored
+    SNORETOAST_CHECK(!std::filesystem::exists(cache.directory()));
+
+    // a missing image is passed on, the notification system reports it
+    const auto missing = directory.path() / "missing.png";
+    SNORETOAST_CHECK(cache.normalize(missing) == missing);
+}
+
+SNORETOAST_TEST(ImageCache_DownscalesLargeImages)
+{
+    if (!PngImage::isCodecAvailable()) {
+        std::printf("  skipped, built without zlib\n");
+        return;
+    }
+    const Testing::TemporaryDirectory directory;
+    ImageCache::Limits limits;
+    limits.maxDimension = 64;
+    ImageCache cache(directory.path() / "cache", limits);
+    const auto image = directory.write("wide.png", encodedImage(256, 32));
+
+    const auto result = cache.normalize(image);
+    SNORETOAST_CHECK(result != image);
+    SNORETOAST_CHECK(result.parent_path() == cache.directory());
+    const auto header = PngImage::readHeader(fileContent(result));
+    SNORETOAST_CHECK(header);
+    SNORETOAST_COMPARE(header->width, 64u);
+    SNORETOAST_COMPARE(header->height, 8u);
+    SNORETOAST_COMPARE(cache.statistics().stored, uint64_t(1));
+    // no partial files are left behind
+    SNORETOAST_COMPARE(std::distance(std::filesystem::directory_iterator(cache.directory()),
+                                     std::filesystem::directory_iterator()),
+                       std::ptrdiff_t(1));
+
+    // the result for the path is remembered
+    SNORETOAST_CHECK(cache.normalize(image) == result);
+    SNORETOAST_COMPARE(cache.statistics().hits, uint64_t(1));
+
+    // the copy is named after the content, other paths and caches reuse it
+    const auto copy = directory.write("copy.png", fileContent(image));
+    ImageCache other(cache.directory(), limits);
+    SNORETOAST_CHECK(other.normalize(copy) == result);
+    SNORETOAST_COMPARE(other.statistics().hits, uint64_t(1));
+    SNORETOAST_COMPARE(other.statistics().stored, uint64_t(0));
+
+    // a changed file is checked again
+    directory.write("wide.png", encodedImage(32, 32));
+    SNORETOAST_CHECK(cache.normalize(image) == image);
+    SNORETOAST_COMPARE(cache.statistics().accepted, uint64_t(1));
+
+    // a removed copy is created again
+    std::filesystem::remove(result);
+    SNORETOAST_CHECK(other.normalize(copy) == result);
+    SNORETOAST_CHECK(std::filesystem::exists(result));
+    SNORETOAST_COMPARE(other.statistics().stored, uint64_t(1));
+}
+
+SNORETOAST_TEST(ImageCache_ShrinksLargeFiles)
+{
+    if (!PngImage::isCodecAvailable()) {
+        std::printf("  skipped, built without zlib\n");
+        return;
+    }
+    const Testing::TemporaryDirectory directory;
+    ImageCache::Limits limits;
+    limits.maxFileSize = 16 * 1024;
+    ImageCache cache(directory.path() / "cache", limits);
+    // noise doesn't compress, the file exceeds the limit within the dimensions
+    const auto image = directory.write("noise.png", encodedImage(128, 128, true));
+    SNORETOAST_CHECK(std::filesystem::file_size(image) > limits.maxFileSize);
+
+    const auto result = cache.normalize(image);
+    SNORETOAST_CHECK(result != image);
+    SNORETOAST_CHECK(std::filesystem::file_size(result) <= limits.maxFileSize);
+    const auto header = PngImage::readHeader(fileContent(result));
+    SNORETOAST_CHECK(header);
+    SNORETOAST_CHECK(header->width < 128 && header->width == header->height);
+}
+
+SNORETOAST_TEST(ImageCache_KeepsImagesThatCantBeDownscaled)
+{
+    const Testing::TemporaryDirectory directory;
+    ImageCache::Limits limits;
+    limits.maxDimension = 4;
+    limits.maxFileSize = 8;
+    ImageCache cache(directory.path() / "cache", limits);
+
+    // too large, but not a PNG
+    const auto jpeg = directory.write("photo.jpg", std::string(100, 'x'));
+    SNORETOAST_CHECK(cache.normalize(jpeg) == jpeg);
+    SNORETOAST_COMPARE(cache.statistics().failed, uint64_t(1));
+    // remembered as failed
+    SNORETOAST_CHECK(cache.normalize(jpeg) == jpeg);
+    SNORETOAST_COMPARE(cache.statistics().failed, uint64_t(2));
+
+    // a valid header with corrupt data
+    auto png = encodedImage(16, 16);
+    png.replace(png.size() - 30, 10, 10, '\0');
+    const auto corrupt = directory.write("corrupt.png", png);
+    SNORETOAST_CHECK(cache.normalize(corrupt) == corrupt);
+    SNORETOAST_COMPARE(cache.statistics().failed, uint64_t(3));
+    SNORETOAST_COMPARE(cache.statistics().stored, uint64_t(0));
+}
+
+SNORETOAST_TEST(ImageCache_ContentHash)
+{
+    SNORETOAST_COMPARE(ImageCache::contentHash("image"), ImageCache::contentHash("image"));
+    // every byte and the length count
+    std::string data(64, 'a');
+    const auto hash = ImageCache::contentHash(data);
+    for (size_t i = 0; i < data.size(); ++i) {
+        auto changed = data;
+        changed[i] = 'b';
+        SNORETOAST_CHECK(ImageCache::contentHash(changed) != hash);
+    }
+    SNORETOAST_CHECK(ImageCache::contentHash(data + '\0') != hash);
+    SNORETOAST_CHECK(ImageCache::contentHash("") != ImageCache::contentHash(std::string(1, '\0')));
+}
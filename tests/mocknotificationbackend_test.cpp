@@ -0,0 +1,150 @@
+/*
+    SnoreToast is capable to invoke Windows 8 toast notifications.
+    Copyright (C) 2026  Hannah von Reth <vonreth@kde.org>
+
+    SnoreToast is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    SnoreToast is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with SnoreToast.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "testing.h"
+
+#include "mocknotificationbackend.h"
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <thread>
+
+using namespace std::chrono_literals;
+
+namespace {
+// counts its events, records an event still running when it is destroyed
+class Listener : public NotificationListener
+{
+public:
+    explicit Listener(std::atomic<size_t> &destroyedWhileRunning)
+        : m_destroyedWhileRunning(destroyedWhileRunning)
+    {
+    }
+
+    ~Listener() override { m_destroyedWhileRunning += m_running.load(); }
+
+    void activated(std::wstring_view) override { event(); }
+    void dismissed(DismissalReason) override { event(); }
+    void failed() override { event(); }
+    void closeRequested() override { event(); }
+    void replaced() override { event(); }
+
+    std::atomic<size_t> events = 0;
+
+private:
+    void event()
+    {
+        ++m_running;
+        std::this_thread::sleep_for(50us);
+        ++events;
+        --m_running;
+    }
+
+    std::atomic<size_t> &m_destroyedWhileRunning;
+    std::atomic<size_t> m_running = 0;
+};
+
+ToastContent content(const std::wstring &id)
+{
+    ToastContent out;
+    out.id = id;
+    out.title = L"Title";
+    return out;
+}
+}
+
+SNORETOAST_TEST(MockNotificationBackend_Events)
+{
+    MockNotificationBackend backend;
+    std::atomic<size_t> destroyedWhileRunning = 0;
+    Listener first(destroyedWhileRunning);
+    Listener second(destroyedWhileRunning);
+    SNORETOAST_CHECK(backend.show(L"App", content(L"1"), &first));
+    SNORETOAST_CHECK(backend.activate(L"1"));
+    SNORETOAST_CHECK(backend.dismiss(L"1", DismissalReason::UserCanceled));
+    SNORETOAST_CHECK(backend.requestClose(L"1"));
+    SNORETOAST_COMPARE(first.events.load(), size_t(3));
+
+    // a toast with the same id of another listener replaces it
+    SNORETOAST_CHECK(backend.show(L"App", content(L"1"), &second));
+    SNORETOAST_COMPARE(first.events.load(), size_t(4));
+    SNORETOAST_CHECK(backend.activate(L"1"));
+    SNORETOAST_COMPARE(second.events.load(), size_t(1));
+
+    // no events after release
+    backend.release(L"1", &second);
+    SNORETOAST_CHECK(!backend.activate(L"1"));
+    SNORETOAST_CHECK(!backend.activate(L"2"));
+    SNORETOAST_COMPARE(second.events.load(), size_t(1));
+}
+
+// release() waits for the events of the listener running on other threads, the listener can
+// be destroyed right after
+SNORETOAST_TEST(MockNotificationBackend_ReleaseWaitsForEvents)
+{
+    constexpr size_t Rounds = 500;
+    MockNotificationBackend backend;
+    std::atomic<size_t> destroyedWhileRunning = 0;
+    std::atomic<size_t> shown = 0;
+    std::atomic<bool> done = false;
+    std::thread events([&] {
+        while (!done) {
+            backend.activate(L"toast");
+            backend.dismiss(L"toast", DismissalReason::UserCanceled);
+        }
+    });
+    size_t delivered = 0;
+    for (size_t i = 0; i < Rounds; ++i) {
+        auto listener = std::make_unique<Listener>(destroyedWhileRunning);
+        backend.show(L"App", content(L"toast"), listener.get());
+        ++shown;
+        if (i % 2) {
+            std::this_thread::sleep_for(20us);
+        }
+        backend.release(L"toast", listener.get());
+        delivered += listener->events;
+        listener.reset();
+    }
+    done = true;
+    events.join();
+    SNORETOAST_COMPARE(destroyedWhileRunning.load(), size_t(0));
+    SNORETOAST_CHECK(delivered > 0);
+}
+
+// a listener releasing itself from its own event doesn't wait for itself
+SNORETOAST_TEST(MockNotificationBackend_ReleaseFromEvent)
+{
+    class SelfReleasing : public NotificationListener
+    {
+    public:
+        explicit SelfReleasing(MockNotificationBackend &backend) : m_backend(backend) { }
+        void activated(std::wstring_view) override { m_backend.release(L"self", this); }
+        void dismissed(DismissalReason) override { }
+        void failed() override { }
+        void closeRequested() override { }
+        void replaced() override { }
+
+    private:
+        MockNotificationBackend &m_backend;
+    };
+    MockNotificationBackend backend;
+    SelfReleasing listener(backend);
+    SNORETOAST_CHECK(backend.show(L"App", content(L"self"), &listener));
+    SNORETOAST_CHECK(backend.activate(L"self"));
+    SNORETOAST_CHECK(!backend.activate(L"self"));
+}
@@ -0,0 +1,154 @@
+/*
+    SnoreToast is capable to invoke Windows 8 toast notifications.
+    Copyright (C) 2026  Hannah von Reth <vonreth@kde.org>
+
+    SnoreToast is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    SnoreToast is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with SnoreToast.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "testing.h"
+
+#include "mocknotificationbackend.h"
+#include "notifiercache.h"
+#include "snoretoasts.h"
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace std::chrono_literals;
+
+namespace {
+using Handle = std::shared_ptr<const std::wstring>;
+}
+
+SNORETOAST_TEST(NotifierCache_CreatesOncePerAppID)
+{
+    NotifierCache<Handle> cache;
+    int created = 0;
+    const auto create = [&created](const std::wstring &appID) {
+        return [&created, appID](Handle &out) {
+            ++created;
+            out = std::make_shared<const std::wstring>(appID);
+            return true;
+        };
+    };
+    Handle first;
+    Handle second;
+    SNORETOAST_CHECK(cache.get(L"A", first, create(L"A")));
+    SNORETOAST_CHECK(cache.get(L"A", second, create(L"A")));
+    SNORETOAST_CHECK(first == second);
+    SNORETOAST_CHECK(cache.get(L"B", second, create(L"B")));
+    SNORETOAST_COMPARE(*second, L"B");
+    SNORETOAST_COMPARE(created, 2);
+    SNORETOAST_COMPARE(cache.size(), size_t(2));
+
+    const auto statistics = cache.statistics();
+    SNORETOAST_COMPARE(statistics.hits, uint64_t(1));
+    SNORETOAST_COMPARE(statistics.misses, uint64_t(2));
+}
+
+SNORETOAST_TEST(NotifierCache_FailedCreationIsNotCached)
+{
+    NotifierCache<Handle> cache;
+    Handle out;
+    SNORETOAST_CHECK(!cache.get(L"A", out, [](Handle &) { return false; }));
+    SNORETOAST_CHECK(!out);
+    SNORETOAST_COMPARE(cache.size(), size_t(0));
+    SNORETOAST_CHECK(cache.get(L"A", out, [](Handle &h) {
+        h = std::make_shared<const std::wstring>(L"A");
+        return true;
+    }));
+    SNORETOAST_COMPARE(cache.statistics().misses, uint64_t(2));
+}
+
+SNORETOAST_TEST(NotifierCache_Invalidate)
+{
+    NotifierCache<Handle> cache;
+    const auto create = [](Handle &out) {
+        out = std::make_shared<const std::wstring>(L"A");
+        return true;
+    };
+    Handle held;
+    cache.get(L"A", held, create);
+    cache.invalidate(L"A");
+    // unknown appIDs are not counted
+    cache.invalidate(L"B");
+    SNORETOAST_COMPARE(cache.statistics().invalidations, uint64_t(1));
+    // the holders keep the notifier alive, the next lookup creates a new one
+    SNORETOAST_COMPARE(held.use_count(), 1l);
+    Handle fresh;
+    cache.get(L"A", fresh, create);
+    SNORETOAST_CHECK(fresh != held);
+
+    cache.get(L"B", fresh, create);
+    cache.clear();
+    SNORETOAST_COMPARE(cache.size(), size_t(0));
+    SNORETOAST_COMPARE(cache.statistics().invalidations, uint64_t(3));
+}
+
+SNORETOAST_TEST(NotifierCache_ConcurrentMissesShareTheFirstNotifier)
+{
+    NotifierCache<Handle> cache;
+    constexpr size_t Threads = 8;
+    std::atomic<size_t> waiting = 0;
+    std::vector<Handle> results(Threads);
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < Threads; ++i) {
+        threads.emplace_back([&, i] {
+            cache.get(L"A", results[i], [&](Handle &out) {
+                // every thread misses before any of them stores its notifier
+                ++waiting;
+                while (waiting < Threads) {
+                    std::this_thread::yield();
+                }
+                out = std::make_shared<const std::wstring>(std::to_wstring(i));
+                return true;
+            });
+        });
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+    SNORETOAST_COMPARE(cache.size(), size_t(1));
+    SNORETOAST_COMPARE(cache.statistics().misses, uint64_t(Threads));
+    for (const auto &result : results) {
+        SNORETOAST_CHECK(result == results[0]);
+    }
+}
+
+SNORETOAST_TEST(NotifierCache_SharedByTheToastsOfABackend)
+{
+    MockNotificationBackend backend;
+    for (int i = 0; i < 10; ++i) {
+        SnoreToasts toast(&backend, L"App");
+        toast.setId(std::to_wstring(i));
+        SNORETOAST_CHECK(toast.displayToast(L"Title", L"Body", {}));
+    }
+    SnoreToasts other(&backend, L"Other");
+    SNORETOAST_CHECK(other.displayToast(L"Title", L"Body", {}));
+    auto statistics = backend.notifierStatistics();
+    SNORETOAST_COMPARE(statistics.misses, uint64_t(2));
+
+    // a failed show invalidates the notifier of the appID
+    backend.setShowAvailable(false);
+    SnoreToasts failing(&backend, L"App");
+    SNORETOAST_CHECK(!failing.displayToast(L"Title", L"Body", {}));
+    SNORETOAST_COMPARE(backend.notifierStatistics().invalidations, uint64_t(1));
+    backend.setShowAvailable(true);
+    SNORETOAST_CHECK(failing.displayToast(L"Title", L"Body", {}));
+    statistics = backend.notifierStatistics();
+    SNORETOAST_COMPARE(statistics.misses, uint64_t(3));
+    SNORETOAST_CHECK(statistics.hits > 0);
+}
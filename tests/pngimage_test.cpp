@@ -0,0 +1,238 @@
+/*
+    SnoreToast is capable to invoke Windows 8 toast notifications.
+    Copyright (C) 2026  Hannah von Reth <vonreth@kde.org>
+
+    SnoreToast is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    SnoreToast is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with SnoreToast.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "testing.h"
+
+#include "pngimage.h"
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+namespace {
+void appendU32(std::string &out, uint32_t value)
+{
+    for (int shift = 24; shift >= 0; shift -= 8) {
+        out.push_back(static_cast<char>((value >> shift) & 0xff));
+    }
+}
+
+void appendChunk(std::string &out, std::string_view type, std::string_view data)
+{
+    appendU32(out, static_cast<uint32_t>(data.size()));
+    out.append(type).append(data);
+    // the decoder doesn't verify the checksums
+    appendU32(out, 0);
+}
+
+/**
+ * A PNG with the filtered rows stored without compression, for the formats encode() doesn't
+ * write.
+ */
+using Chunks = std::vector<std::pair<std::string, std::string>>;
+
+std::string storedPng(uint32_t width, uint32_t height, uint8_t depth, uint8_t colorType,
+                      std::string_view rows, const Chunks &chunks = {}, uint8_t interlace = 0)
+{
+    std::string out = "\x89PNG\r\n\x1a\n";
+    std::string header;
+    appendU32(header, width);
+    appendU32(header, height);
+    header += { static_cast<char>(depth), static_cast<char>(colorType), 0, 0,
+                static_cast<char>(interlace) };
+    appendChunk(out, "IHDR", header);
+    for (const auto &[type, data] : chunks) {
+        appendChunk(out, type, data);
+    }
+    // a zlib stream with a single stored deflate block
+    std::string zlib = "\x78\x01\x01";
+    const auto size = static_cast<uint16_t>(rows.size());
+    zlib += { static_cast<char>(size & 0xff), static_cast<char>(size >> 8),
+              static_cast<char>(~size & 0xff), static_cast<char>((~size >> 8) & 0xff) };
+    zlib.append(rows);
+    uint32_t a = 1;
+    uint32_t b = 0;
+    for (const char c : rows) {
+        a = (a + static_cast<unsigned char>(c)) % 65521;
+        b = (b + a) % 65521;
+    }
+    appendU32(zlib, (b << 16) | a);
+    appendChunk(out, "IDAT", zlib);
+    appendChunk(out, "IEND", {});
+    return out;
+}
+
+PngImage::Pixels randomPixels(Testing::Random &random, uint32_t width, uint32_t height,
+                              bool opaque)
+{
+    PngImage::Pixels out { width, height, std::vector<uint8_t>(size_t(width) * height * 4) };
+    for (size_t i = 0; i < out.rgba.size(); ++i) {
+        out.rgba[i] = opaque && i % 4 == 3 ? 255 : static_cast<uint8_t>(random.next());
+    }
+    return out;
+}
+}
+
+SNORETOAST_TEST(PngImage_ReadHeader)
+{
+    const auto png = storedPng(3, 2, 16, 2, std::string(2 * 13, '\0'));
+    const auto header = PngImage::readHeader(png);
+    SNORETOAST_CHECK(header);
+    SNORETOAST_COMPARE(header->width, 3u);
+    SNORETOAST_COMPARE(header->height, 2u);
+    SNORETOAST_COMPARE(int(header->bitDepth), 16);
+    SNORETOAST_COMPARE(int(header->colorType), 2);
+    SNORETOAST_CHECK(!header->interlaced);
+    SNORETOAST_CHECK(PngImage::readHeader(storedPng(1, 1, 8, 0, "\0\0", {}, 1))->interlaced);
+
+    // the header fields suffice, without the checksum
+    SNORETOAST_CHECK(PngImage::readHeader(png.substr(0, 29)));
+    SNORETOAST_CHECK(!PngImage::readHeader(png.substr(0, 28)));
+    SNORETOAST_CHECK(!PngImage::readHeader("GIF89a"));
+    std::string broken = png;
+    broken[1] = 'X';
+    SNORETOAST_CHECK(!PngImage::readHeader(broken));
+    // zero sizes and invalid depths
+    SNORETOAST_CHECK(!PngImage::readHeader(storedPng(0, 1, 8, 0, "")));
+    SNORETOAST_CHECK(!PngImage::readHeader(storedPng(1, 0, 8, 0, "")));
+    SNORETOAST_CHECK(!PngImage::readHeader(storedPng(1, 1, 4, 2, "")));
+    SNORETOAST_CHECK(!PngImage::readHeader(storedPng(1, 1, 16, 3, "")));
+    SNORETOAST_CHECK(!PngImage::readHeader(storedPng(1, 1, 8, 1, "")));
+    SNORETOAST_CHECK(!PngImage::readHeader(storedPng(1, 1, 8, 0, "", {}, 2)));
+}
+
+SNORETOAST_TEST(PngImage_EncodeDecodeRoundTrip)
+{
+    if (!PngImage::isCodecAvailable()) {
+        std::printf("  skipped, built without zlib\n");
+        return;
+    }
+    Testing::Random random;
+    for (const bool opaque : { true, false }) {
+        for (int round = 0; round < 20; ++round) {
+            const auto pixels = randomPixels(random, 1 + uint32_t(random.below(40)),
+                                             1 + uint32_t(random.below(40)), opaque);
+            std::string png;
+            SNORETOAST_CHECK(PngImage::encode(pixels, png));
+            const auto header = PngImage::readHeader(png);
+            SNORETOAST_CHECK(header);
+            // opaque images are stored as RGB
+            SNORETOAST_COMPARE(int(header->colorType), opaque ? 2 : 6);
+
+            PngImage::Pixels decoded;
+            std::wstring error;
+            SNORETOAST_CHECK(PngImage::decode(png, decoded, error));
+            SNORETOAST_COMPARE(decoded.width, pixels.width);
+            SNORETOAST_COMPARE(decoded.height, pixels.height);
+            SNORETOAST_CHECK(decoded.rgba == pixels.rgba);
+        }
+    }
+}
+
+SNORETOAST_TEST(PngImage_DecodeFormats)
+{
+    if (!PngImage::isCodecAvailable()) {
+        std::printf("  skipped, built without zlib\n");
+        return;
+    }
+    PngImage::Pixels pixels;
+    std::wstring error;
+
+    // 8 bit gray with the Sub and Up filters: 10 15 20 / 11 16 21
+    SNORETOAST_CHECK(PngImage::decode(
+            storedPng(3, 2, 8, 0, std::string_view("\x01\x0a\x05\x05\x02\x01\x01\x01", 8)),
+            pixels, error));
+    const std::vector<uint8_t> gray = { 10, 10, 10, 255, 15, 15, 15, 255, 20, 20, 20, 255,
+                                        11, 11, 11, 255, 16, 16, 16, 255, 21, 21, 21, 255 };
+    SNORETOAST_CHECK(pixels.rgba == gray);
+
+    // 2 bit palette with a transparent entry, indices 0 1 2 3
+    SNORETOAST_CHECK(PngImage::decode(
+            storedPng(4, 1, 2, 3, std::string_view("\x00\x1b", 2),
+                      { { "PLTE", std::string("\xff\x00\x00\x00\xff\x00\x00\x00\xff\x10\x20\x30",
+                                              12) },
+                        { "tRNS", std::string("\xff\x80", 2) } }),
+            pixels, error));
+    SNORETOAST_CHECK(pixels.rgba
+                     == std::vector<uint8_t>({ 255, 0, 0, 255, 0, 255, 0, 128, 0, 0, 255, 255,
+                                               16, 32, 48, 255 }));
+
+    // 16 bit gray with a transparent key
+    SNORETOAST_CHECK(PngImage::decode(storedPng(2, 1, 16, 0,
+                                                std::string_view("\x00\x12\x34\xab\xcd", 5),
+                                                { { "tRNS", std::string("\xab\xcd", 2) } }),
+                                      pixels, error));
+    SNORETOAST_CHECK(pixels.rgba
+                     == std::vector<uint8_t>({ 0x12, 0x12, 0x12, 255, 0xab, 0xab, 0xab, 0 }));
+
+    // 1 bit gray is scaled to the full range
+    SNORETOAST_CHECK(PngImage::decode(storedPng(2, 1, 1, 0, std::string_view("\x00\x40", 2)),
+                                      pixels, error));
+    SNORETOAST_CHECK(pixels.rgba == std::vector<uint8_t>({ 0, 0, 0, 255, 255, 255, 255, 255 }));
+}
+
+SNORETOAST_TEST(PngImage_DecodeErrors)
+{
+    if (!PngImage::isCodecAvailable()) {
+        std::printf("  skipped, built without zlib\n");
+        return;
+    }
+    PngImage::Pixels pixels;
+    std::wstring error;
+    const auto check = [&](std::string_view png, std::wstring_view expected) {
+        error.clear();
+        return !PngImage::decode(png, pixels, error) && error == expected;
+    };
+    SNORETOAST_CHECK(check("not a png", L"Not a PNG image"));
+    SNORETOAST_CHECK(check(storedPng(1, 1, 8, 0, std::string("\0\0", 2), {}, 1),
+                           L"Interlaced PNG images are not supported"));
+    const auto png = storedPng(1, 1, 8, 0, std::string("\0\0", 2));
+    SNORETOAST_CHECK(check(png.substr(0, png.size() - 20), L"The image is truncated"));
+    SNORETOAST_CHECK(check(storedPng(1, 1, 8, 3, std::string("\0\0", 2)),
+                           L"The image has no palette"));
+    // too few rows and an unknown filter
+    SNORETOAST_CHECK(check(storedPng(1, 2, 8, 0, std::string("\0\0", 2)),
+                           L"The image data is corrupt"));
+    SNORETOAST_CHECK(check(storedPng(1, 1, 8, 0, std::string("\x05\0", 2)),
+                           L"The image data is corrupt"));
+}
+
+SNORETOAST_TEST(PngImage_Scale)
+{
+    Testing::Random random;
+    // a uniform image stays uniform
+    PngImage::Pixels uniform { 7, 5, {} };
+    for (int i = 0; i < 35; ++i) {
+        uniform.rgba.insert(uniform.rgba.end(), { 10, 200, 30, 255 });
+    }
+    const auto small = PngImage::scale(uniform, 3, 2);
+    SNORETOAST_COMPARE(small.width, 3u);
+    SNORETOAST_COMPARE(small.height, 2u);
+    for (size_t i = 0; i < small.rgba.size(); i += 4) {
+        SNORETOAST_CHECK(std::vector<uint8_t>(small.rgba.begin() + i, small.rgba.begin() + i + 4)
+                         == std::vector<uint8_t>({ 10, 200, 30, 255 }));
+    }
+
+    // the color of transparent pixels doesn't bleed into their neighbours
+    const PngImage::Pixels mixed { 2, 1, { 255, 0, 0, 255, 0, 0, 255, 0 } };
+    SNORETOAST_CHECK(PngImage::scale(mixed, 1, 1).rgba
+                     == std::vector<uint8_t>({ 255, 0, 0, 128 }));
+
+    // the same size keeps the pixels
+    const auto pixels = randomPixels(random, 9, 4, true);
+    SNORETOAST_CHECK(PngImage::scale(pixels, 9, 4).rgba == pixels.rgba);
+}
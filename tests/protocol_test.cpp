@@ -0,0 +1,256 @@
+/*
+    SnoreToast is capable to invoke Windows 8 toast notifications.
+    Copyright (C) 2026  Hannah von Reth <vonreth@kde.org>
+
+    SnoreToast is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    SnoreToast is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with SnoreToast.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "testing.h"
+
+#include "snoretoastprotocol.h"
+
+#include <cstring>
+#include <string>
+#include <utility>
+#include <vector>
+
+using SnoreToastProtocol::Status;
+
+namespace {
+using Fields = std::vector<std::pair<std::u16string, std::u16string>>;
+
+/**
+ * The decoder requires two byte aligned data, std::string gives no such guarantee.
+ */
+class AlignedBuffer
+{
+public:
+    explicit AlignedBuffer(std::string_view data)
+        : m_storage((data.size() + 1) / 2, u'\0'), m_size(data.size())
+    {
+        std::memcpy(m_storage.data(), data.data(), data.size());
+    }
+
+    const void *data() const { return m_storage.data(); }
+    char *bytes() { return reinterpret_cast<char *>(m_storage.data()); }
+    size_t size() const { return m_size; }
+
+private:
+    std::u16string m_storage;
+    size_t m_size;
+};
+
+std::string encode(SnoreToastActions::Actions action, const Fields &fields)
+{
+    std::string out;
+    SnoreToastProtocol::Encoder encoder(out);
+    encoder.begin(action);
+    for (const auto &field : fields) {
+        encoder.addField(std::u16string_view(field.first), std::u16string_view(field.second));
+    }
+    encoder.end();
+    return out;
+}
+
+Fields toFields(const SnoreToastProtocol::Message &message)
+{
+    Fields out;
+    for (const auto &field : message) {
+        out.emplace_back(field.key, field.value);
+    }
+    return out;
+}
+
+std::u16string randomString(Testing::Random &random)
+{
+    std::u16string out(random.below(10), u' ');
+    for (auto &c : out) {
+        c = static_cast<char16_t>(1 + random.below(0xffff));
+    }
+    return out;
+}
+
+// the message encoded by a clicked toast with the fields a and b
+const std::string &sample()
+{
+    static const std::string out = encode(SnoreToastActions::Actions::Clicked,
+                                          { { u"a", u"1" }, { u"b", u"two" } });
+    return out;
+}
+
+void store(char *data, uint32_t value, size_t bytes)
+{
+    SnoreToastProtocol::Detail::store(data, value, bytes);
+}
+
+Status decodeModified(size_t offset, uint32_t value, size_t bytes)
+{
+    AlignedBuffer buffer(sample());
+    store(buffer.bytes() + offset, value, bytes);
+    SnoreToastProtocol::Message message;
+    return SnoreToastProtocol::decode(buffer.data(), buffer.size(), message);
+}
+}
+
+SNORETOAST_TEST(Protocol_RoundTrip)
+{
+    Testing::Random random;
+    for (int round = 0; round < 2000; ++round) {
+        // several messages share a stream
+        std::string stream;
+        std::vector<std::pair<SnoreToastActions::Actions, Fields>> expected(1 + random.below(4));
+        for (auto &message : expected) {
+            message.first = SnoreToastActions::Actions(int(random.below(7)) - 1);
+            message.second.resize(random.below(6));
+            for (auto &field : message.second) {
+                field = { randomString(random), randomString(random) };
+            }
+            stream.append(encode(message.first, message.second));
+        }
+        const AlignedBuffer buffer(stream);
+        size_t offset = 0;
+        for (const auto &message : expected) {
+            SnoreToastProtocol::Message decoded;
+            const auto data = static_cast<const char *>(buffer.data()) + offset;
+            SNORETOAST_CHECK(SnoreToastProtocol::isVersion2(data, buffer.size() - offset));
+            SNORETOAST_CHECK(SnoreToastProtocol::decode(data, buffer.size() - offset, decoded)
+                             == Status::Ok);
+            SNORETOAST_CHECK(decoded.action() == message.first);
+            SNORETOAST_CHECK(toFields(decoded) == message.second);
+            offset += decoded.size();
+        }
+        SNORETOAST_COMPARE(offset, buffer.size());
+    }
+}
+
+SNORETOAST_TEST(Protocol_Lookup)
+{
+    const AlignedBuffer buffer(sample());
+    SnoreToastProtocol::Message message;
+    SNORETOAST_CHECK(SnoreToastProtocol::decode(buffer.data(), buffer.size(), message)
+                     == Status::Ok);
+    SNORETOAST_CHECK(message.value(u"b") == u"two");
+    SNORETOAST_CHECK(message.contains(u"a"));
+    SNORETOAST_CHECK(!message.contains(u"c"));
+    SNORETOAST_CHECK(message.value(u"c").empty());
+}
+
+SNORETOAST_TEST(Protocol_WideStringsAreUtf16)
+{
+    // wchar_t is UTF-32 on Linux, characters outside the BMP become surrogate pairs
+    std::string out;
+    SnoreToastProtocol::Encoder encoder(out);
+    encoder.begin(SnoreToastActions::Actions::TextEntered);
+    encoder.addField(L"text", std::wstring_view(L"aä\U0001d11e"));
+    encoder.end();
+
+    const AlignedBuffer buffer(out);
+    SnoreToastProtocol::Message message;
+    SNORETOAST_CHECK(SnoreToastProtocol::decode(buffer.data(), buffer.size(), message)
+                     == Status::Ok);
+    SNORETOAST_CHECK(message.value(u"text") == u"aä\U0001d11e");
+    SNORETOAST_COMPARE(message.value(u"text").size(), size_t(4));
+}
+
+SNORETOAST_TEST(Protocol_PartialMessagesAreIncomplete)
+{
+    const AlignedBuffer buffer(sample());
+    SnoreToastProtocol::Message message;
+    for (size_t size = 0; size < buffer.size(); ++size) {
+        SNORETOAST_COMPARE(SnoreToastProtocol::decode(buffer.data(), size, message),
+                           Status::Incomplete);
+    }
+    SNORETOAST_COMPARE(SnoreToastProtocol::decode(buffer.data(), buffer.size(), message),
+                       Status::Ok);
+}
+
+SNORETOAST_TEST(Protocol_InvalidHeaders)
+{
+    // magic
+    SNORETOAST_COMPARE(decodeModified(0, 'X', 1), Status::Invalid);
+    // version
+    SNORETOAST_COMPARE(decodeModified(4, 1, 2), Status::Invalid);
+    // header size, too small and odd
+    SNORETOAST_COMPARE(decodeModified(6, 16, 2), Status::Invalid);
+    SNORETOAST_COMPARE(decodeModified(6, 21, 2), Status::Invalid);
+    // action
+    SNORETOAST_COMPARE(decodeModified(8, 6, 4), Status::Invalid);
+    SNORETOAST_COMPARE(decodeModified(8, uint32_t(-2), 4), Status::Invalid);
+    // more fields than the payload holds and fewer than it holds
+    SNORETOAST_COMPARE(decodeModified(12, 3, 4), Status::Invalid);
+    SNORETOAST_COMPARE(decodeModified(12, 1, 4), Status::Invalid);
+    // a payload beyond the limit is rejected before it was received
+    SNORETOAST_COMPARE(decodeModified(16, SnoreToastProtocol::MaxPayloadSize + 1, 4),
+                       Status::Invalid);
+    // a field length beyond the payload, also if the sum overflows 32 bits
+    const size_t field = SnoreToastProtocol::HeaderSize;
+    SNORETOAST_COMPARE(decodeModified(field, 100, 4), Status::Invalid);
+    SNORETOAST_COMPARE(decodeModified(field, 0xffffffff, 4), Status::Invalid);
+    SNORETOAST_COMPARE(decodeModified(field + 4, 0x80000000, 4), Status::Invalid);
+
+    // version 1 strings are not version 2 messages
+    const std::wstring legacy = L"action=clicked;";
+    SNORETOAST_CHECK(!SnoreToastProtocol::isVersion2(legacy.data(),
+                                                     legacy.size() * sizeof(wchar_t)));
+    SnoreToastProtocol::Message message;
+    SNORETOAST_COMPARE(SnoreToastProtocol::decode(legacy.data(), legacy.size(), message),
+                       Status::Invalid);
+}
+
+SNORETOAST_TEST(Protocol_UnalignedDataIsRejected)
+{
+    std::u16string storage(sample().size() / 2 + 1, u'\0');
+    char *unaligned = reinterpret_cast<char *>(storage.data()) + 1;
+    std::memcpy(unaligned, sample().data(), sample().size());
+    SnoreToastProtocol::Message message;
+    SNORETOAST_COMPARE(SnoreToastProtocol::decode(unaligned, sample().size(), message),
+                       Status::Invalid);
+}
+
+SNORETOAST_TEST(Protocol_LargerHeadersAreSkipped)
+{
+    // a newer version might extend the header
+    std::string extended = sample();
+    extended.insert(SnoreToastProtocol::HeaderSize, 4, '\x7f');
+    store(extended.data() + 4, SnoreToastProtocol::Version + 1, 2);
+    store(extended.data() + 6, SnoreToastProtocol::HeaderSize + 4, 2);
+    const AlignedBuffer buffer(extended);
+    SnoreToastProtocol::Message message;
+    SNORETOAST_CHECK(SnoreToastProtocol::decode(buffer.data(), buffer.size(), message)
+                     == Status::Ok);
+    SNORETOAST_COMPARE(message.size(), extended.size());
+    SNORETOAST_CHECK(message.value(u"a") == u"1");
+}
+
+SNORETOAST_TEST(Protocol_CorruptedMessagesAreSafe)
+{
+    Testing::Random random;
+    for (int round = 0; round < 20000; ++round) {
+        AlignedBuffer buffer(sample());
+        for (size_t flips = 1 + random.below(3); flips > 0; --flips) {
+            buffer.bytes()[random.below(buffer.size())] = static_cast<char>(random.next());
+        }
+        SnoreToastProtocol::Message message;
+        if (SnoreToastProtocol::decode(buffer.data(), buffer.size(), message) != Status::Ok) {
+            continue;
+        }
+        // a message that decodes stays within its bytes
+        SNORETOAST_CHECK(message.size() <= buffer.size());
+        const auto end = static_cast<const char *>(buffer.data()) + message.size();
+        for (const auto &field : message) {
+            const auto value = reinterpret_cast<const char *>(field.value.data()
+                                                              + field.value.size());
+            SNORETOAST_CHECK(value <= end);
+        }
+    }
+}
@@ -0,0 +1,277 @@
+/*
+    SnoreToast is capable to invoke Windows 8 toast notifications.
+    Copyright (C) 2026  Hannah von Reth <vonreth@kde.org>
+
+    SnoreToast is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    SnoreToast is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with SnoreToast.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "testing.h"
+
+#include "snoretoastreceiver.h"
+#include "toastserver.h"
+
+#include <atomic>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+using namespace std::chrono_literals;
+using Actions = SnoreToastActions::Actions;
+
+namespace {
+std::filesystem::path socketName(const Testing::TemporaryDirectory &directory, const char *name)
+{
+#ifdef _WIN32
+    return std::filesystem::path(L"\\\\.\\pipe\\")
+            / (directory.path().filename().string() + "_" + name);
+#else
+    return directory.path() / name;
+#endif
+}
+
+// a protocol 1 callback, utf-16 with a terminator
+std::string v1Message(std::u16string_view text)
+{
+    return std::string(reinterpret_cast<const char *>(text.data()),
+                       text.size() * sizeof(char16_t))
+            + std::string(sizeof(char16_t), '\0');
+}
+
+std::string v2Message(Actions action, const std::wstring &id, const std::wstring &button = {})
+{
+    std::string out;
+    SnoreToastProtocol::Encoder encoder(out);
+    encoder.begin(action);
+    encoder.addField(std::wstring_view(L"notificationId"), std::wstring_view(id));
+    if (!button.empty()) {
+        encoder.addField(std::wstring_view(L"button"), std::wstring_view(button));
+    }
+    encoder.end();
+    return out;
+}
+
+struct Received
+{
+    Actions action;
+    std::u16string id;
+    std::u16string button;
+    std::u16string text;
+    uint64_t connection;
+
+    bool operator==(const Received &other) const
+    {
+        return action == other.action && id == other.id && button == other.button
+                && text == other.text;
+    }
+};
+
+// the receiver and the writer share the test thread, poll() is called until the expected
+// events arrived
+class Receiver
+{
+public:
+    explicit Receiver(const std::filesystem::path &name)
+    {
+        m_receiver.setHandler([this](const SnoreToastEvent &event) {
+            received.push_back({ event.action(), std::u16string(event.notificationId()),
+                                 std::u16string(event.button()), std::u16string(event.text()),
+                                 event.connection() });
+        });
+        m_listening = m_receiver.listen(name);
+    }
+
+    bool isListening() const { return m_listening; }
+
+    bool waitFor(size_t count)
+    {
+        for (int i = 0; i < 500 && received.size() < count; ++i) {
+            m_receiver.poll(10ms);
+        }
+        return received.size() == count;
+    }
+
+    bool waitForErrors(uint64_t count)
+    {
+        for (int i = 0; i < 500 && m_receiver.statistics().errors < count; ++i) {
+            m_receiver.poll(10ms);
+        }
+        return m_receiver.statistics().errors == count;
+    }
+
+    // handles what is already there
+    void drain()
+    {
+        while (m_receiver.poll(50ms) > 0) { }
+    }
+
+    SnoreToastReceiver::Statistics statistics() const { return m_receiver.statistics(); }
+
+    std::vector<Received> received;
+
+private:
+    SnoreToastReceiver m_receiver;
+    bool m_listening = false;
+};
+}
+
+SNORETOAST_TEST(SnoreToastReceiver_Protocols)
+{
+    const Testing::TemporaryDirectory directory;
+    const auto name = socketName(directory, "protocols");
+    Receiver receiver(name);
+    SNORETOAST_CHECK(receiver.isListening());
+
+    auto v1 = LocalSocket::connect(name);
+    SNORETOAST_CHECK(v1);
+    // the protocol 1 values are unescaped
+    const auto first = v1Message(u"action=buttonClicked;notificationId=1;button=a%3Bb%25;");
+    SNORETOAST_CHECK(v1->write(first.data(), first.size()));
+    SNORETOAST_CHECK(receiver.waitFor(1));
+
+    auto v2 = LocalSocket::connect(name);
+    SNORETOAST_CHECK(v2);
+    const auto second = v2Message(Actions::Clicked, L"2");
+    SNORETOAST_CHECK(v2->write(second.data(), second.size()));
+    SNORETOAST_CHECK(receiver.waitFor(2));
+
+    const std::vector<Received> expected { { Actions::ButtonClicked, u"1", u"a;b%", u"", 0 },
+                                           { Actions::Clicked, u"2", u"", u"", 0 } };
+    SNORETOAST_CHECK(receiver.received == expected);
+    SNORETOAST_CHECK(receiver.received[0].connection != receiver.received[1].connection);
+    SNORETOAST_COMPARE(receiver.statistics().connections, uint64_t(2));
+    SNORETOAST_COMPARE(receiver.statistics().events, uint64_t(2));
+    SNORETOAST_COMPARE(receiver.statistics().errors, uint64_t(0));
+}
+
+SNORETOAST_TEST(SnoreToastReceiver_SplitFrames)
+{
+    const Testing::TemporaryDirectory directory;
+    const auto name = socketName(directory, "split");
+    Receiver receiver(name);
+    auto connection = LocalSocket::connect(name);
+    SNORETOAST_CHECK(connection);
+
+    // every split of both protocols, including the middle of a utf-16 unit and of the header
+    const std::vector<std::string> messages = {
+        v2Message(Actions::ButtonClicked, L"split", L"Ok"),
+        v1Message(u"action=textEntered;notificationId=split;text=hello;"),
+    };
+    size_t expected = 0;
+    for (const auto &message : messages) {
+        for (size_t split = 1; split < message.size(); split += 3) {
+            SNORETOAST_CHECK(connection->write(message.data(), split));
+            receiver.drain();
+            SNORETOAST_COMPARE(receiver.received.size(), expected);
+            SNORETOAST_CHECK(connection->write(message.data() + split, message.size() - split));
+            SNORETOAST_CHECK(receiver.waitFor(++expected));
+        }
+    }
+    SNORETOAST_CHECK(receiver.received.front() == Received({ Actions::ButtonClicked, u"split",
+                                                             u"Ok", u"", 0 }));
+    SNORETOAST_CHECK(receiver.received.back() == Received({ Actions::TextEntered, u"split", u"",
+                                                            u"hello", 0 }));
+    SNORETOAST_COMPARE(receiver.statistics().connections, uint64_t(1));
+    SNORETOAST_COMPARE(receiver.statistics().errors, uint64_t(0));
+}
+
+SNORETOAST_TEST(SnoreToastReceiver_ManyMessagesPerConnection)
+{
+    const Testing::TemporaryDirectory directory;
+    const auto name = socketName(directory, "many");
+    Receiver receiver(name);
+    auto connection = LocalSocket::connect(name);
+    SNORETOAST_CHECK(connection);
+
+    // both protocols mixed in a single write
+    std::string data;
+    std::vector<Received> expected;
+    for (int i = 0; i < 200; ++i) {
+        const auto id = std::to_wstring(i);
+        const std::u16string id16(id.begin(), id.end());
+        if (i % 2) {
+            data += v1Message(u"action=timedout;notificationId=" + id16 + u";");
+            expected.push_back({ Actions::Timedout, id16, u"", u"", 0 });
+        } else {
+            data += v2Message(Actions::Dismissed, id);
+            expected.push_back({ Actions::Dismissed, id16, u"", u"", 0 });
+        }
+    }
+    SNORETOAST_CHECK(connection->write(data.data(), data.size()));
+    SNORETOAST_CHECK(receiver.waitFor(expected.size()));
+    SNORETOAST_CHECK(receiver.received == expected);
+    SNORETOAST_COMPARE(receiver.statistics().connections, uint64_t(1));
+}
+
+SNORETOAST_TEST(SnoreToastReceiver_InvalidData)
+{
+    const Testing::TemporaryDirectory directory;
+    const auto name = socketName(directory, "invalid");
+    Receiver receiver(name);
+
+    // a protocol 2 header with a wrong magic
+    const std::string header(SnoreToastProtocol::HeaderSize, 'S');
+    // a protocol 1 callback without an action
+    const auto noAction = v1Message(u"notificationId=1;");
+    uint64_t errors = 0;
+    for (const auto *data : { &header, &noAction }) {
+        auto connection = LocalSocket::connect(name);
+        SNORETOAST_CHECK(connection);
+        SNORETOAST_CHECK(connection->write(data->data(), data->size()));
+        SNORETOAST_CHECK(receiver.waitForErrors(++errors));
+        // the connection is closed by the receiver
+        char byte;
+        SNORETOAST_CHECK(!connection->read(&byte, 1));
+    }
+    // a valid message still arrives on a new connection
+    auto connection = LocalSocket::connect(name);
+    const auto valid = v2Message(Actions::Clicked, L"valid");
+    SNORETOAST_CHECK(connection->write(valid.data(), valid.size()));
+    SNORETOAST_CHECK(receiver.waitFor(1));
+    SNORETOAST_COMPARE(receiver.statistics().events, uint64_t(1));
+    SNORETOAST_COMPARE(receiver.statistics().errors, uint64_t(2));
+}
+
+SNORETOAST_TEST(SnoreToastReceiver_StopEndsRun)
+{
+    const Testing::TemporaryDirectory directory;
+    const auto name = socketName(directory, "stop");
+    SnoreToastReceiver receiver;
+    std::atomic<size_t> received = 0;
+    receiver.setHandler(Actions::Clicked, [&received](const SnoreToastEvent &) { ++received; });
+    SNORETOAST_CHECK(receiver.listen(name));
+    std::thread thread([&receiver] { receiver.run(); });
+
+    auto connection = LocalSocket::connect(name);
+    SNORETOAST_CHECK(connection);
+    const auto message = v2Message(Actions::Clicked, L"run");
+    SNORETOAST_CHECK(connection->write(message.data(), message.size()));
+    while (received == 0) {
+        std::this_thread::yield();
+    }
+    receiver.stop();
+    thread.join();
+    SNORETOAST_COMPARE(receiver.statistics().events, uint64_t(1));
+
+    // run() can be started again
+    thread = std::thread([&receiver] { receiver.run(); });
+    SNORETOAST_CHECK(connection->write(message.data(), message.size()));
+    while (received == 1) {
+        std::this_thread::yield();
+    }
+    receiver.stop();
+    thread.join();
+    SNORETOAST_COMPARE(received.load(), size_t(2));
+}
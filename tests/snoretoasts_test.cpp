@@ -0,0 +1,112 @@
+/*
+    SnoreToast is capable to invoke Windows 8 toast notifications.
+    Copyright (C) 2026  Hannah von Reth <vonreth@kde.org>
+
+    SnoreToast is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    SnoreToast is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with SnoreToast.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "testing.h"
+
+#include "mocknotificationbackend.h"
+#include "snoretoasts.h"
+
+#include <memory>
+#include <string>
+
+namespace {
+std::unique_ptr<SnoreToasts> instance(MockNotificationBackend &backend)
+{
+    return std::make_unique<SnoreToasts>(&backend, L"SnoreToasts.App");
+}
+}
+
+SNORETOAST_TEST(SnoreToasts_PlainToastsDontRegisterTheActivator)
+{
+    MockNotificationBackend backend;
+    auto toasts = instance(backend);
+    for (int i = 0; i < 3; ++i) {
+        toasts->setId(L"plain." + std::to_wstring(i));
+        SNORETOAST_CHECK(toasts->displayToast(L"Title", L"Body", {}));
+    }
+    SNORETOAST_COMPARE(backend.showCount(), size_t(3));
+    SNORETOAST_COMPARE(backend.activatorRegistrations(), size_t(0));
+}
+
+SNORETOAST_TEST(SnoreToasts_ActionsRegisterTheActivatorOnce)
+{
+    MockNotificationBackend backend;
+    auto buttons = instance(backend);
+    buttons->setButtons(L"Ok;Cancel");
+    // a plain toast first, the activator is registered with the first toast that needs it
+    auto text = instance(backend);
+    SNORETOAST_CHECK(text->displayToast(L"Title", L"Body", {}));
+    SNORETOAST_COMPARE(backend.activatorRegistrations(), size_t(0));
+
+    for (int i = 0; i < 3; ++i) {
+        buttons->setId(L"buttons." + std::to_wstring(i));
+        SNORETOAST_CHECK(buttons->displayToast(L"Title", L"Body", {}));
+        SNORETOAST_COMPARE(backend.activatorRegistrations(), size_t(1));
+    }
+    text->setTextBoxEnabled(true);
+    for (int i = 0; i < 3; ++i) {
+        text->setId(L"text." + std::to_wstring(i));
+        SNORETOAST_CHECK(text->displayToast(L"Title", L"Body", {}));
+        SNORETOAST_COMPARE(backend.activatorRegistrations(), size_t(2));
+    }
+    // a plain toast of an instance that registered keeps it
+    text->setTextBoxEnabled(false);
+    SNORETOAST_CHECK(text->displayToast(L"Title", L"Body", {}));
+    SNORETOAST_COMPARE(backend.activatorRegistrations(), size_t(2));
+
+    // released with the instance
+    buttons.reset();
+    SNORETOAST_COMPARE(backend.activatorRegistrations(), size_t(1));
+    text.reset();
+    SNORETOAST_COMPARE(backend.activatorRegistrations(), size_t(0));
+}
+
+SNORETOAST_TEST(SnoreToasts_FallbackModeDoesntRegisterTheActivator)
+{
+    // without a registered appID the activator can't be reached
+    MockNotificationBackend backend;
+    backend.setRegistered(false);
+    auto toasts = instance(backend);
+    toasts->setButtons(L"Ok");
+    toasts->setTextBoxEnabled(true);
+    SNORETOAST_CHECK(toasts->displayToast(L"Title", L"Body", {}));
+    SNORETOAST_CHECK(toasts->useFalbackMode());
+    SNORETOAST_COMPARE(backend.activatorRegistrations(), size_t(0));
+}
+
+SNORETOAST_TEST(SnoreToasts_FailedShowLeavesNoRegistryEntry)
+{
+    MockNotificationBackend backend;
+    auto &registry = SnoreToasts::registry(&backend);
+    auto toasts = instance(backend);
+    toasts->setId(L"failed");
+    backend.setShowAvailable(false);
+    SNORETOAST_CHECK(!toasts->displayToast(L"Title", L"Body", {}));
+    SNORETOAST_CHECK(!registry.find(L"SnoreToasts.App", L"failed"));
+
+    // a toast that failed to replace a displayed one keeps its entry
+    backend.setShowAvailable(true);
+    toasts->setId(L"replaced");
+    toasts->setGroup(L"first");
+    SNORETOAST_CHECK(toasts->displayToast(L"Title", L"Body", {}));
+    backend.setShowAvailable(false);
+    toasts->setGroup(L"second");
+    SNORETOAST_CHECK(!toasts->displayToast(L"Title", L"Body", {}));
+    const auto entry = registry.find(L"SnoreToasts.App", L"replaced");
+    SNORETOAST_CHECK(entry.has_value());
+    SNORETOAST_COMPARE(entry->group, std::wstring(L"first"));
+}
@@ -0,0 +1,152 @@
+/*
+    SnoreToast is capable to invoke Windows 8 toast notifications.
+    Copyright (C) 2026  Hannah von Reth <vonreth@kde.org>
+
+    SnoreToast is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    SnoreToast is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with SnoreToast.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "testing.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <vector>
+
+namespace {
+struct Entry
+{
+    const char *name;
+    Testing::Function function;
+};
+
+std::vector<Entry> &registry()
+{
+    static std::vector<Entry> _registry;
+    return _registry;
+}
+
+// the failures of the running test
+size_t s_failures = 0;
+
+void usage(const char *self)
+{
+    std::printf("Usage: %s [--filter=<substring>] [--list]\n", self);
+}
+}
+
+Testing::Registration::Registration(const char *name, Function function)
+{
+    registry().push_back({ name, function });
+}
+
+void Testing::fail(const char *file, int line, const std::string &message)
+{
+    ++s_failures;
+    std::printf("  %s:%d: check failed: %s\n", file, line, message.c_str());
+}
+
+std::string Testing::toString(std::string_view value)
+{
+    return '"' + std::string(value) + '"';
+}
+
+std::string Testing::toString(std::wstring_view value)
+{
+    // non ascii characters are shown as \x{...}
+    std::string out = "L\"";
+    for (const wchar_t c : value) {
+        if (c >= 0x20 && c < 0x7f) {
+            out.push_back(static_cast<char>(c));
+        } else {
+            char buffer[16];
+            std::snprintf(buffer, sizeof(buffer), "\\x{%x}", static_cast<unsigned>(c));
+            out.append(buffer);
+        }
+    }
+    out.push_back('"');
+    return out;
+}
+
+Testing::TemporaryDirectory::TemporaryDirectory()
+{
+    // unique across the ctest processes running in parallel
+    static std::atomic<uint64_t> counter = 0;
+    const auto stamp = std::chrono::steady_clock::now().time_since_epoch().count();
+    m_path = std::filesystem::temp_directory_path()
+            / ("snoretoast_tests_" + std::to_string(stamp) + "_" + std::to_string(counter++));
+    std::filesystem::create_directories(m_path);
+}
+
+Testing::TemporaryDirectory::~TemporaryDirectory()
+{
+    std::error_code error;
+    std::filesystem::remove_all(m_path, error);
+}
+
+std::filesystem::path Testing::TemporaryDirectory::write(const std::filesystem::path &name,
+                                                         std::string_view data) const
+{
+    const auto out = m_path / name;
+    std::ofstream(out, std::ios::binary).write(data.data(), std::streamsize(data.size()));
+    return out;
+}
+
+int main(int argc, char *argv[])
+{
+    std::string filter;
+    bool list = false;
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (arg.rfind("--filter=", 0) == 0) {
+            filter = arg.substr(std::strlen("--filter="));
+        } else if (arg == "--list") {
+            list = true;
+        } else {
+            usage(argv[0]);
+            return arg == "--help" ? 0 : 1;
+        }
+    }
+
+    auto entries = registry();
+    std::sort(entries.begin(), entries.end(),
+              [](const Entry &a, const Entry &b) { return std::strcmp(a.name, b.name) < 0; });
+
+    size_t run = 0;
+    size_t failed = 0;
+    for (const auto &entry : entries) {
+        if (!filter.empty() && std::strstr(entry.name, filter.c_str()) == nullptr) {
+            continue;
+        }
+        if (list) {
+            std::printf("%s\n", entry.name);
+            continue;
+        }
+        s_failures = 0;
+        entry.function();
+        ++run;
+        std::printf("%s %s\n", s_failures ? "FAIL" : "PASS", entry.name);
+        if (s_failures) {
+            ++failed;
+        }
+        std::fflush(stdout);
+    }
+    if (list) {
+        return 0;
+    }
+    std::printf("%zu tests, %zu failed\n", run, failed);
+    // a filter that matches nothing is a broken test registration
+    return failed > 0 || run == 0 ? 1 : 0;
+}
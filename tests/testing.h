@@ -0,0 +1,180 @@
+/*
+    SnoreToast is capable to invoke Windows 8 toast notifications.
+    Copyright (C) 2026  Hannah von Reth <vonreth@kde.org>
+
+    SnoreToast is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    SnoreToast is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with SnoreToast.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+/**
+ * A minimal test harness, tests register themselves with SNORETOAST_TEST and are run by
+ * snoretoast_tests. A failed check reports the location and ends the test.
+ *
+ * SNORETOAST_TEST(MyClass_Case)
+ * {
+ *     SNORETOAST_CHECK(MyClass().isValid());
+ *     SNORETOAST_COMPARE(MyClass().size(), 0);
+ * }
+ */
+namespace Testing {
+using Function = void (*)();
+
+struct Registration
+{
+    Registration(const char *name, Function function);
+};
+
+/**
+ * Marks the running test as failed.
+ */
+void fail(const char *file, int line, const std::string &message);
+
+std::string toString(std::string_view value);
+std::string toString(std::wstring_view value);
+
+template<typename T>
+std::string toString(const T &value)
+{
+    if constexpr (std::is_convertible_v<const T &, std::string_view>) {
+        return toString(std::string_view(value));
+    } else if constexpr (std::is_convertible_v<const T &, std::wstring_view>) {
+        return toString(std::wstring_view(value));
+    } else if constexpr (std::is_enum_v<T>) {
+        return std::to_string(static_cast<int64_t>(value));
+    } else {
+        std::ostringstream out;
+        out << value;
+        return out.str();
+    }
+}
+
+template<typename A, typename E>
+bool compare(const A &actual, const E &expected, const char *actualString,
+             const char *expectedString, const char *file, int line)
+{
+    if (actual == expected) {
+        return true;
+    }
+    fail(file, line,
+         std::string(actualString) + " == " + expectedString + "\n    actual:   "
+                 + toString(actual) + "\n    expected: " + toString(expected));
+    return false;
+}
+
+/**
+ * A deterministic generator, the tests are reproducible.
+ */
+class Random
+{
+public:
+    explicit Random(uint64_t seed = 0x5eed) : m_state(seed) { }
+
+    uint64_t next()
+    {
+        // splitmix64
+        uint64_t z = (m_state += 0x9e3779b97f4a7c15ull);
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+        return z ^ (z >> 31);
+    }
+
+    /**
+     * A number in [0, bound).
+     */
+    size_t below(size_t bound) { return static_cast<size_t>(next() % bound); }
+
+private:
+    uint64_t m_state;
+};
+
+/**
+ * A directory for the files of a test, removed with its content by the destructor.
+ */
+class TemporaryDirectory
+{
+public:
+    TemporaryDirectory();
+    ~TemporaryDirectory();
+
+    TemporaryDirectory(const TemporaryDirectory &) = delete;
+    TemporaryDirectory &operator=(const TemporaryDirectory &) = delete;
+
+    const std::filesystem::path &path() const { return m_path; }
+
+    /**
+     * Writes data to the file name in the directory and returns its path.
+     */
+    std::filesystem::path write(const std::filesystem::path &name, std::string_view data) const;
+
+private:
+    std::filesystem::path m_path;
+};
+
+/**
+ * A clock that only moves when advanced, passed as the Clock of the tested classes:
+ *
+ *   Testing::ManualClock<> clock;
+ *   DeliveryQueue queue(&backend, policy, clock.function());
+ */
+template<typename C = std::chrono::steady_clock>
+class ManualClock
+{
+public:
+    typename C::time_point now() const { return m_now.load(); }
+    void advance(typename C::duration duration) { m_now = m_now.load() + duration; }
+    void set(typename C::time_point now) { m_now = now; }
+
+    /**
+     * The clock must outlive the function.
+     */
+    std::function<typename C::time_point()> function()
+    {
+        return [this] { return now(); };
+    }
+
+private:
+    // the tested classes might read the clock from their worker threads
+    std::atomic<typename C::time_point> m_now { typename C::time_point(std::chrono::hours(1)) };
+};
+};
+
+#define SNORETOAST_TEST(NAME)                                                                      \
+    static void NAME();                                                                            \
+    static const Testing::Registration NAME##_registration(#NAME, NAME);                          \
+    static void NAME()
+
+#define SNORETOAST_CHECK(CONDITION)                                                                \
+    do {                                                                                           \
+        if (!(CONDITION)) {                                                                        \
+            Testing::fail(__FILE__, __LINE__, #CONDITION);                                         \
+            return;                                                                                \
+        }                                                                                          \
+    } while (false)
+
+#define SNORETOAST_COMPARE(ACTUAL, EXPECTED)                                                       \
+    do {                                                                                           \
+        if (!Testing::compare(ACTUAL, EXPECTED, #ACTUAL, #EXPECTED, __FILE__, __LINE__)) {         \
+            return;                                                                                \
+        }                                                                                          \
+    } while (false)
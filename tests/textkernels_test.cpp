@@ -0,0 +1,158 @@
+/*
+    SnoreToast is capable to invoke Windows 8 toast notifications.
+    Copyright (C) 2026  Hannah von Reth <vonreth@kde.org>
+
+    SnoreToast is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    SnoreToast is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with SnoreToast.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "testing.h"
+
+#include "textkernels.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+using TextKernels::Isa;
+
+namespace {
+// the results of all kernels for one input
+struct Results
+{
+    size_t find;
+    size_t findAny;
+    size_t findXmlSpecial;
+    std::wstring replaced;
+
+    bool operator==(const Results &other) const
+    {
+        return find == other.find && findAny == other.findAny
+                && findXmlSpecial == other.findXmlSpecial && replaced == other.replaced;
+    }
+};
+
+Results run(std::wstring_view data, wchar_t needle, size_t from)
+{
+    std::wstring replaced(data);
+    TextKernels::replace(replaced, needle, L'#');
+    return { TextKernels::find(data, needle, from),
+             TextKernels::findAny(data, needle, L'<', 0xFFFE, from),
+             TextKernels::findXmlSpecial(data, from), replaced };
+}
+
+// the characters the kernels look for and their neighbours, surrogates and non ascii
+std::vector<wchar_t> alphabet()
+{
+    std::vector<wchar_t> out = { L'a', L'z', L' ', L'&', L'<', L'>', L'"', L';', L'=',
+                                 0x00, 0x01, 0x09, 0x0A, 0x1F, 0x20, 0x7F, 0x80, 0xE4,
+                                 0x3C3C, 0x263C, 0xD800, 0xDBFF, 0xDC00, 0xDFFF, 0xFFFD, 0xFFFE,
+                                 0xFFFF };
+    if constexpr (sizeof(wchar_t) == 4) {
+        // beyond the bmp, the low bits match the special characters
+        for (const unsigned c : { 0x1003Cu, 0x1FFFEu, 0x10FFFFu, 0x80000000u, 0xFFFFFFFFu }) {
+            out.push_back(static_cast<wchar_t>(c));
+        }
+    }
+    return out;
+}
+
+/**
+ * Compares isa against the scalar kernels, with a needle at every position of every length up
+ * to a few vectors, at every alignment, and with random input.
+ */
+bool matchesScalar(Isa isa)
+{
+    const auto characters = alphabet();
+    Testing::Random random;
+    std::vector<std::pair<std::wstring, size_t>> inputs;
+    // one special character at every position, the rest plain, starting at every alignment
+    for (size_t size = 0; size <= 70; ++size) {
+        for (size_t offset = 0; offset < 4; ++offset) {
+            for (size_t position = 0; position <= size; ++position) {
+                std::wstring buffer(offset + size, L'x');
+                if (position < size) {
+                    buffer[offset + position] = characters[random.below(characters.size())];
+                }
+                inputs.emplace_back(std::move(buffer), offset);
+            }
+        }
+    }
+    for (int i = 0; i < 5000; ++i) {
+        std::wstring buffer(random.below(300), L'x');
+        for (auto &c : buffer) {
+            // mostly plain text
+            if (random.below(8) == 0) {
+                c = characters[random.below(characters.size())];
+            }
+        }
+        const size_t offset = std::min<size_t>(random.below(4), buffer.size());
+        inputs.emplace_back(std::move(buffer), offset);
+    }
+
+    for (const auto &[buffer, offset] : inputs) {
+        const std::wstring_view data = std::wstring_view(buffer).substr(offset);
+        const wchar_t needle = characters[random.below(characters.size())];
+        const size_t from = data.empty() ? 0 : random.below(data.size() + 1);
+        TextKernels::setIsa(Isa::Scalar);
+        const auto expected = run(data, needle, from);
+        TextKernels::setIsa(isa);
+        const auto actual = run(data, needle, from);
+        if (!(actual == expected)) {
+            std::printf("  %s differs, size %zu offset %zu from %zu needle 0x%x\n",
+                        TextKernels::isaName(isa), data.size(), offset, from,
+                        static_cast<unsigned>(needle));
+            return false;
+        }
+    }
+    return true;
+}
+}
+
+SNORETOAST_TEST(TextKernels_Scalar)
+{
+    TextKernels::setIsa(Isa::Scalar);
+    const std::wstring_view data = L"a&b<c\x1F\xFFFE";
+    SNORETOAST_COMPARE(TextKernels::find(data, L'b'), size_t(2));
+    SNORETOAST_COMPARE(TextKernels::find(data, L'b', 3), std::wstring_view::npos);
+    SNORETOAST_COMPARE(TextKernels::find(L"", L'b'), std::wstring_view::npos);
+    SNORETOAST_COMPARE(TextKernels::findAny(data, L'c', L'<', L'z'), size_t(3));
+    SNORETOAST_COMPARE(TextKernels::findXmlSpecial(data), size_t(1));
+    SNORETOAST_COMPARE(TextKernels::findXmlSpecial(data, 5), size_t(5));
+    SNORETOAST_COMPARE(TextKernels::findXmlSpecial(L"plain \xE4 text"), std::wstring_view::npos);
+    std::wstring replaced = L"a;b;c";
+    TextKernels::replace(replaced, L';', L',');
+    SNORETOAST_COMPARE(replaced, L"a,b,c");
+    TextKernels::setIsa(TextKernels::bestIsa());
+}
+
+// every implementation the cpu supports against the scalar one
+SNORETOAST_TEST(TextKernels_MatchScalar)
+{
+    const Isa selected = TextKernels::isa();
+    bool checked = false;
+    for (const auto isa : { Isa::Sse2, Isa::Avx2, Isa::Neon }) {
+        if (!TextKernels::setIsa(isa)) {
+            std::printf("  skipped %s, not supported\n", TextKernels::isaName(isa));
+            continue;
+        }
+        checked = true;
+        const bool matches = matchesScalar(isa);
+        TextKernels::setIsa(selected);
+        SNORETOAST_CHECK(matches);
+    }
+    TextKernels::setIsa(selected);
+    if (!checked) {
+        std::printf("  skipped, built without vector kernels\n");
+    }
+}
@@ -0,0 +1,164 @@
+/*
+    SnoreToast is capable to invoke Windows 8 toast notifications.
+    Copyright (C) 2026  Hannah von Reth <vonreth@kde.org>
+
+    SnoreToast is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    SnoreToast is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with SnoreToast.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "testing.h"
+
+#include "mocknotificationbackend.h"
+#include "snoretoasts.h"
+#include "toastawaitable.h"
+
+#include <cstdio>
+#include <memory>
+#include <optional>
+#include <string>
+
+using Actions = SnoreToastActions::Actions;
+
+#ifdef __cpp_impl_coroutine
+
+namespace {
+// runs until the first suspension, the frame is kept until the Task is destroyed
+class Task
+{
+public:
+    struct promise_type
+    {
+        Task get_return_object()
+        {
+            return Task(std::coroutine_handle<promise_type>::from_promise(*this));
+        }
+        std::suspend_never initial_suspend() noexcept { return {}; }
+        std::suspend_always final_suspend() noexcept { return {}; }
+        void return_void() { }
+        void unhandled_exception() { std::terminate(); }
+    };
+
+    explicit Task(std::coroutine_handle<promise_type> handle) : m_handle(handle) { }
+    ~Task()
+    {
+        if (m_handle) {
+            m_handle.destroy();
+        }
+    }
+    Task(const Task &) = delete;
+    Task &operator=(const Task &) = delete;
+
+    bool done() const { return m_handle.done(); }
+
+private:
+    std::coroutine_handle<promise_type> m_handle;
+};
+
+std::unique_ptr<SnoreToasts> show(MockNotificationBackend &backend, const std::wstring &id)
+{
+    auto toast = std::make_unique<SnoreToasts>(&backend, L"Awaitable.App");
+    toast->setId(id);
+    toast->displayToast(L"Title", L"Body", {});
+    return toast;
+}
+
+Task wait(CompletionDispatcher &dispatcher, std::unique_ptr<SnoreToasts> toast,
+          std::optional<Actions> &result)
+{
+    result = co_await ToastAwaitable(dispatcher, std::move(toast));
+}
+
+Task waitCancellable(CompletionDispatcher &dispatcher, std::unique_ptr<SnoreToasts> toast,
+                     uint64_t &ticket, std::optional<Actions> &result)
+{
+    ToastAwaitable awaitable(dispatcher, std::move(toast));
+    ticket = awaitable.ticket();
+    result = co_await awaitable;
+}
+
+Task waitReady(CompletionDispatcher &dispatcher, MockNotificationBackend &backend,
+               std::optional<Actions> &result)
+{
+    ToastAwaitable awaitable(dispatcher, show(backend, L"ready"));
+    backend.activate(L"ready");
+    dispatcher.process();
+    if (!awaitable.await_ready()) {
+        co_return;
+    }
+    result = co_await awaitable;
+}
+}
+
+SNORETOAST_TEST(ToastAwaitable_ResumesOnProcess)
+{
+    MockNotificationBackend backend;
+    CompletionDispatcher dispatcher;
+    std::optional<Actions> result;
+    Task task = wait(dispatcher, show(backend, L"resume"), result);
+    SNORETOAST_CHECK(!task.done());
+    dispatcher.process();
+    SNORETOAST_CHECK(!task.done());
+
+    backend.dismiss(L"resume", DismissalReason::UserCanceled);
+    SNORETOAST_CHECK(!task.done());
+    dispatcher.process();
+    SNORETOAST_CHECK(task.done());
+    SNORETOAST_CHECK(result == Actions::Dismissed);
+}
+
+SNORETOAST_TEST(ToastAwaitable_ResultBeforeAwait)
+{
+    MockNotificationBackend backend;
+    CompletionDispatcher dispatcher;
+    std::optional<Actions> result;
+    // doesn't suspend
+    Task task = waitReady(dispatcher, backend, result);
+    SNORETOAST_CHECK(task.done());
+    SNORETOAST_CHECK(result == Actions::Clicked);
+}
+
+SNORETOAST_TEST(ToastAwaitable_Cancel)
+{
+    MockNotificationBackend backend;
+    CompletionDispatcher dispatcher;
+    uint64_t ticket = 0;
+    std::optional<Actions> result;
+    Task task = waitCancellable(dispatcher, show(backend, L"cancel"), ticket, result);
+    SNORETOAST_CHECK(dispatcher.cancel(ticket));
+    dispatcher.process();
+    SNORETOAST_CHECK(task.done());
+    SNORETOAST_CHECK(result == Actions::Hidden);
+}
+
+SNORETOAST_TEST(ToastAwaitable_DestroyedCoroutine)
+{
+    MockNotificationBackend backend;
+    CompletionDispatcher dispatcher;
+    std::optional<Actions> result;
+    {
+        Task task = wait(dispatcher, show(backend, L"destroyed"), result);
+    }
+    // the result reaches the callback, but no coroutine
+    backend.activate(L"destroyed");
+    dispatcher.process();
+    SNORETOAST_CHECK(!result);
+    SNORETOAST_COMPARE(dispatcher.size(), size_t(0));
+}
+
+#else
+
+SNORETOAST_TEST(ToastAwaitable_ResumesOnProcess)
+{
+    std::printf("  skipped, built without coroutines\n");
+}
+
+#endif
@@ -0,0 +1,257 @@
+/*
+    SnoreToast is capable to invoke Windows 8 toast notifications.
+    Copyright (C) 2026  Hannah von Reth <vonreth@kde.org>
+
+    SnoreToast is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    SnoreToast is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with SnoreToast.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "testing.h"
+
+#include "toastcoalescer.h"
+
+#include <algorithm>
+#include <map>
+#include <string>
+#include <tuple>
+#include <vector>
+
+using namespace std::chrono_literals;
+using Decision = ToastCoalescer::Decision;
+
+namespace {
+ToastRequest toast(std::wstring appID, std::wstring title, std::wstring body = L"body",
+                   std::wstring id = {})
+{
+    ToastRequest out;
+    out.appID = std::move(appID);
+    out.title = std::move(title);
+    out.body = std::move(body);
+    out.id = std::move(id);
+    return out;
+}
+
+Decision submit(ToastCoalescer &coalescer, ToastRequest request)
+{
+    return coalescer.submit(request);
+}
+
+/**
+ * The documented behaviour without any of the bookkeeping of the implementation, nothing is
+ * ever removed.
+ */
+class ReferenceCoalescer
+{
+public:
+    explicit ReferenceCoalescer(ToastCoalescer::Policy policy) : m_policy(policy) { }
+
+    Decision submit(ToastRequest &request, std::chrono::steady_clock::time_point now)
+    {
+        const auto content = std::make_tuple(request.appID, request.title, request.body);
+        const auto seen = m_contents.find(content);
+        const bool repeated = seen != m_contents.end() && !expired(seen->second, now);
+        m_contents[content] = now;
+        if (repeated) {
+            return Decision::Drop;
+        }
+        const auto id = m_ids.find(request.id);
+        if (!request.id.empty() && id != m_ids.end() && !expired(id->second, now)) {
+            id->second = now;
+            return Decision::Replace;
+        }
+        auto &application = m_applications[request.appID];
+        auto &shown = application.shown;
+        shown.erase(std::remove_if(shown.begin(), shown.end(),
+                                   [this, now](auto time) { return expired(time, now); }),
+                    shown.end());
+        if (shown.size() < m_policy.limit) {
+            application.shown.push_back(now);
+            if (!request.id.empty()) {
+                m_ids[request.id] = now;
+            }
+            return Decision::Show;
+        }
+        if (application.summarized > 0 && expired(application.lastSummary, now)) {
+            application.summarized = 0;
+        }
+        ++application.summarized;
+        application.lastSummary = now;
+        request.title = std::to_wstring(application.summarized);
+        return Decision::Summarize;
+    }
+
+private:
+    struct Application
+    {
+        std::vector<std::chrono::steady_clock::time_point> shown;
+        size_t summarized = 0;
+        std::chrono::steady_clock::time_point lastSummary;
+    };
+
+    bool expired(std::chrono::steady_clock::time_point time,
+                 std::chrono::steady_clock::time_point now) const
+    {
+        return now - time >= m_policy.window;
+    }
+
+    const ToastCoalescer::Policy m_policy;
+    std::map<std::tuple<std::wstring, std::wstring, std::wstring>,
+             std::chrono::steady_clock::time_point>
+            m_contents;
+    std::map<std::wstring, std::chrono::steady_clock::time_point> m_ids;
+    std::map<std::wstring, Application> m_applications;
+};
+}
+
+SNORETOAST_TEST(ToastCoalescer_DropsRepeats)
+{
+    Testing::ManualClock<> clock;
+    ToastCoalescer coalescer({ 2s, 5 }, clock.function());
+    SNORETOAST_CHECK(submit(coalescer, toast(L"App", L"Disk full")) == Decision::Show);
+    clock.advance(1500ms);
+    SNORETOAST_CHECK(submit(coalescer, toast(L"App", L"Disk full")) == Decision::Drop);
+    // the id is not part of the content
+    SNORETOAST_CHECK(submit(coalescer, toast(L"App", L"Disk full", L"body", L"1"))
+                     == Decision::Drop);
+    // every repeat extends the window
+    clock.advance(1500ms);
+    SNORETOAST_CHECK(submit(coalescer, toast(L"App", L"Disk full")) == Decision::Drop);
+    clock.advance(2s);
+    SNORETOAST_CHECK(submit(coalescer, toast(L"App", L"Disk full")) == Decision::Show);
+
+    const auto statistics = coalescer.statistics();
+    SNORETOAST_COMPARE(statistics.shown, uint64_t(2));
+    SNORETOAST_COMPARE(statistics.dropped, uint64_t(3));
+}
+
+SNORETOAST_TEST(ToastCoalescer_DistinctToastsAreShown)
+{
+    Testing::ManualClock<> clock;
+    ToastCoalescer coalescer({ 2s, 100 }, clock.function());
+    const auto base = toast(L"App", L"Title", L"Body");
+    std::vector<ToastRequest> variants(7, base);
+    variants[1].appID = L"Other";
+    variants[2].title = L"Title2";
+    variants[3].body = L"Body2";
+    variants[4].buttons = L"Ok";
+    variants[5].sound = L"Notification.Mail";
+    variants[6].image = "image.png";
+    for (auto &request : variants) {
+        SNORETOAST_CHECK(submit(coalescer, request) == Decision::Show);
+    }
+    // the field boundaries are part of the content
+    SNORETOAST_CHECK(submit(coalescer, toast(L"App", L"ab", L"c")) == Decision::Show);
+    SNORETOAST_CHECK(submit(coalescer, toast(L"App", L"a", L"bc")) == Decision::Show);
+    SNORETOAST_CHECK(ToastCoalescer::contentHash(toast(L"App", L"ab", L"c"))
+                     != ToastCoalescer::contentHash(toast(L"App", L"a", L"bc")));
+    for (auto &request : variants) {
+        SNORETOAST_CHECK(submit(coalescer, request) == Decision::Drop);
+    }
+}
+
+SNORETOAST_TEST(ToastCoalescer_ReplacesIds)
+{
+    Testing::ManualClock<> clock;
+    ToastCoalescer coalescer({ 2s, 1 }, clock.function());
+    SNORETOAST_CHECK(submit(coalescer, toast(L"App", L"Progress 1", L"", L"job"))
+                     == Decision::Show);
+    clock.advance(1s);
+    // a replacement doesn't count against the limit
+    SNORETOAST_CHECK(submit(coalescer, toast(L"App", L"Progress 2", L"", L"job"))
+                     == Decision::Replace);
+    clock.advance(1500ms);
+    // the replacement extended the window of the id, not of the application
+    SNORETOAST_CHECK(submit(coalescer, toast(L"App", L"Progress 3", L"", L"job"))
+                     == Decision::Replace);
+    SNORETOAST_CHECK(submit(coalescer, toast(L"App", L"Other")) == Decision::Show);
+    clock.advance(2s);
+    SNORETOAST_CHECK(submit(coalescer, toast(L"App", L"Progress 4", L"", L"job"))
+                     == Decision::Show);
+    SNORETOAST_COMPARE(coalescer.statistics().replaced, uint64_t(2));
+}
+
+SNORETOAST_TEST(ToastCoalescer_Summarizes)
+{
+    Testing::ManualClock<> clock;
+    ToastCoalescer coalescer({ 2s, 2 }, clock.function());
+    SNORETOAST_CHECK(submit(coalescer, toast(L"App", L"1")) == Decision::Show);
+    SNORETOAST_CHECK(submit(coalescer, toast(L"App", L"2")) == Decision::Show);
+
+    auto request = toast(L"App", L"3", L"third", L"3");
+    request.buttons = L"Ok;Cancel";
+    request.isTextBoxEnabled = true;
+    SNORETOAST_CHECK(coalescer.submit(request) == Decision::Summarize);
+    SNORETOAST_COMPARE(request.id, L"snoretoast.summary.App");
+    SNORETOAST_COMPARE(request.title, L"1 more notification");
+    SNORETOAST_COMPARE(request.body, L"3\nthird");
+    SNORETOAST_COMPARE(request.buttons, L"");
+    SNORETOAST_CHECK(!request.isTextBoxEnabled);
+
+    request = toast(L"App", L"4");
+    SNORETOAST_CHECK(coalescer.submit(request) == Decision::Summarize);
+    SNORETOAST_COMPARE(request.title, L"2 more notifications");
+    // other applications have their own limit
+    SNORETOAST_CHECK(submit(coalescer, toast(L"Other", L"1")) == Decision::Show);
+
+    // the limit applies to the window
+    clock.advance(2s);
+    SNORETOAST_CHECK(submit(coalescer, toast(L"App", L"5")) == Decision::Show);
+    SNORETOAST_CHECK(submit(coalescer, toast(L"App", L"6")) == Decision::Show);
+    request = toast(L"App", L"7");
+    SNORETOAST_CHECK(coalescer.submit(request) == Decision::Summarize);
+    SNORETOAST_COMPARE(request.title, L"1 more notification");
+    SNORETOAST_COMPARE(coalescer.statistics().summarized, uint64_t(3));
+}
+
+SNORETOAST_TEST(ToastCoalescer_OtherModesPassThrough)
+{
+    Testing::ManualClock<> clock;
+    ToastCoalescer coalescer({ 2s, 1 }, clock.function());
+    SNORETOAST_CHECK(submit(coalescer, toast(L"App", L"Title", L"Body", L"1")) == Decision::Show);
+    // a close of the toast is neither a repeat nor summarized
+    for (int i = 0; i < 3; ++i) {
+        auto close = toast(L"App", L"Title", L"Body", L"1");
+        close.mode = ToastRequest::Mode::Close;
+        SNORETOAST_CHECK(coalescer.submit(close) == Decision::Show);
+        SNORETOAST_COMPARE(close.id, L"1");
+        SNORETOAST_COMPARE(close.title, L"Title");
+    }
+    auto list = toast(L"App", L"", L"");
+    list.mode = ToastRequest::Mode::List;
+    SNORETOAST_CHECK(coalescer.submit(list) == Decision::Show);
+    SNORETOAST_COMPARE(coalescer.statistics().shown, uint64_t(1));
+}
+
+SNORETOAST_TEST(ToastCoalescer_MatchesTheReference)
+{
+    Testing::Random random;
+    Testing::ManualClock<> clock;
+    const ToastCoalescer::Policy policy { 2s, 3 };
+    ToastCoalescer coalescer(policy, clock.function());
+    ReferenceCoalescer reference(policy);
+    for (int i = 0; i < 50000; ++i) {
+        // bursts and pauses, some of them exactly at the end of the window
+        const size_t step = random.below(10);
+        clock.advance(step == 0 ? 2000ms
+                                : step < 3 ? 0ms : std::chrono::milliseconds(random.below(700)));
+        auto request = toast(L"App" + std::to_wstring(random.below(3)),
+                             L"Title" + std::to_wstring(random.below(5)),
+                             L"Body" + std::to_wstring(random.below(3)),
+                             random.below(2) ? L"" : L"id" + std::to_wstring(random.below(4)));
+        auto expected = request;
+        const auto decision = coalescer.submit(request);
+        SNORETOAST_CHECK(decision == reference.submit(expected, clock.now()));
+        if (decision == Decision::Summarize) {
+            SNORETOAST_CHECK(request.title.rfind(expected.title + L" more", 0) == 0);
+        }
+    }
+}
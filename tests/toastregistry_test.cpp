@@ -0,0 +1,229 @@
+/*
+    SnoreToast is capable to invoke Windows 8 toast notifications.
+    Copyright (C) 2026  Hannah von Reth <vonreth@kde.org>
+
+    SnoreToast is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    SnoreToast is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with SnoreToast.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "testing.h"
+
+#include "mocknotificationbackend.h"
+#include "snoretoasts.h"
+#include "toastregistry.h"
+
+#include <algorithm>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace std::chrono_literals;
+
+namespace {
+std::vector<std::wstring> ids(std::vector<ToastRegistry::Entry> entries, bool sort = true)
+{
+    std::vector<std::wstring> out;
+    for (const auto &entry : entries) {
+        out.push_back(entry.id);
+    }
+    if (sort) {
+        std::sort(out.begin(), out.end());
+    }
+    return out;
+}
+
+using Ids = std::vector<std::wstring>;
+}
+
+SNORETOAST_TEST(ToastRegistry_AddFindRemove)
+{
+    Testing::ManualClock<std::chrono::system_clock> clock;
+    ToastRegistry registry(clock.function());
+    registry.add(L"App", L"1", L"g");
+    clock.advance(1s);
+    registry.add(L"Other", L"1", L"h");
+    SNORETOAST_COMPARE(registry.size(), size_t(2));
+
+    auto entry = registry.find(L"App", L"1");
+    SNORETOAST_CHECK(entry);
+    SNORETOAST_COMPARE(entry->group, L"g");
+    SNORETOAST_CHECK(entry->created == clock.now() - 1s);
+    SNORETOAST_COMPARE(registry.find(L"Other", L"1")->group, L"h");
+    SNORETOAST_CHECK(!registry.find(L"App", L"2"));
+    SNORETOAST_CHECK(!registry.find(L"Unknown", L"1"));
+
+    // the same id replaces the toast, including its group
+    registry.add(L"App", L"1", L"new");
+    entry = registry.find(L"App", L"1");
+    SNORETOAST_COMPARE(entry->group, L"new");
+    SNORETOAST_CHECK(entry->created == clock.now());
+    SNORETOAST_CHECK(registry.inGroup(L"App", L"g").empty());
+    SNORETOAST_COMPARE(registry.size(), size_t(2));
+
+    SNORETOAST_CHECK(registry.remove(L"App", L"1"));
+    SNORETOAST_CHECK(!registry.remove(L"App", L"1"));
+    SNORETOAST_CHECK(!registry.remove(L"Unknown", L"1"));
+    SNORETOAST_CHECK(!registry.find(L"App", L"1"));
+    SNORETOAST_COMPARE(registry.size(), size_t(1));
+}
+
+SNORETOAST_TEST(ToastRegistry_Indexes)
+{
+    Testing::ManualClock<std::chrono::system_clock> clock;
+    ToastRegistry registry(clock.function());
+    for (const auto id : { L"job.2", L"job.10", L"job", L"jobs", L"mail.1", L"jo" }) {
+        registry.add(L"App", id, id[0] == L'j' ? L"jobs" : L"");
+        clock.advance(1s);
+    }
+    registry.add(L"Other", L"job.3", L"jobs");
+
+    SNORETOAST_CHECK(ids(registry.withPrefix(L"App", L"job.")) == Ids({ L"job.10", L"job.2" }));
+    SNORETOAST_CHECK(ids(registry.withPrefix(L"App", L"job"))
+                     == Ids({ L"job", L"job.10", L"job.2", L"jobs" }));
+    SNORETOAST_COMPARE(registry.withPrefix(L"App", L"").size(), size_t(6));
+    SNORETOAST_CHECK(registry.withPrefix(L"App", L"x").empty());
+    SNORETOAST_CHECK(registry.withPrefix(L"Unknown", L"").empty());
+
+    SNORETOAST_CHECK(ids(registry.inGroup(L"App", L"jobs"))
+                     == Ids({ L"jo", L"job", L"job.10", L"job.2", L"jobs" }));
+    SNORETOAST_CHECK(ids(registry.inGroup(L"App", L"")) == Ids({ L"mail.1" }));
+    SNORETOAST_CHECK(registry.inGroup(L"App", L"none").empty());
+
+    // the oldest first
+    SNORETOAST_CHECK(ids(registry.entries(L"App"), false)
+                     == Ids({ L"job.2", L"job.10", L"job", L"jobs", L"mail.1", L"jo" }));
+}
+
+SNORETOAST_TEST(ToastRegistry_Reconcile)
+{
+    Testing::ManualClock<std::chrono::system_clock> clock;
+    ToastRegistry registry(clock.function());
+    registry.add(L"App", L"kept", L"g");
+    registry.add(L"App", L"moved", L"g");
+    registry.add(L"App", L"gone", L"g");
+    const auto created = clock.now();
+    clock.advance(1s);
+
+    // one toast of another process, one changed group, one removed, a duplicate entry
+    const std::vector<HistoryEntry> history = {
+        { L"kept", L"g" }, { L"moved", L"h" }, { L"foreign", L"g" }, { L"kept", L"g" }
+    };
+    SNORETOAST_COMPARE(registry.reconcile(L"App", history), size_t(3));
+    SNORETOAST_CHECK(ids(registry.entries(L"App")) == Ids({ L"foreign", L"kept", L"moved" }));
+    SNORETOAST_CHECK(ids(registry.inGroup(L"App", L"g")) == Ids({ L"foreign", L"kept" }));
+    SNORETOAST_CHECK(ids(registry.inGroup(L"App", L"h")) == Ids({ L"moved" }));
+    // known toasts keep their time, the others are the oldest
+    SNORETOAST_CHECK(registry.find(L"App", L"kept")->created == created);
+    SNORETOAST_CHECK(registry.find(L"App", L"foreign")->created
+                     == std::chrono::system_clock::time_point());
+    SNORETOAST_COMPARE(registry.entries(L"App").front().id, L"foreign");
+
+    // nothing changed
+    SNORETOAST_COMPARE(registry.reconcile(L"App", history), size_t(0));
+    // an empty history removes the application
+    SNORETOAST_COMPARE(registry.reconcile(L"App", {}), size_t(3));
+    SNORETOAST_COMPARE(registry.size(), size_t(0));
+}
+
+SNORETOAST_TEST(ToastRegistry_MatchesTheReference)
+{
+    Testing::Random random;
+    Testing::ManualClock<std::chrono::system_clock> clock;
+    ToastRegistry registry(clock.function());
+    // id -> group of each application
+    std::map<std::wstring, std::map<std::wstring, std::wstring>> reference;
+    const auto randomId = [&random] {
+        std::wstring out(1 + random.below(3), L'a');
+        for (auto &c : out) {
+            c = static_cast<wchar_t>(L'a' + random.below(3));
+        }
+        return out;
+    };
+    for (int i = 0; i < 20000; ++i) {
+        clock.advance(1ms);
+        const auto appID = L"App" + std::to_wstring(random.below(2));
+        auto &toasts = reference[appID];
+        const auto id = randomId();
+        const auto group = L"g" + std::to_wstring(random.below(3));
+        switch (random.below(8)) {
+        case 0:
+            SNORETOAST_COMPARE(registry.remove(appID, id), toasts.erase(id) == 1);
+            break;
+        case 1: {
+            // every toast left the history with a chance of one in four
+            std::vector<HistoryEntry> history;
+            for (auto it = toasts.begin(); it != toasts.end();) {
+                if (random.below(4) == 0) {
+                    it = toasts.erase(it);
+                } else {
+                    history.push_back({ it->first, it->second });
+                    ++it;
+                }
+            }
+            registry.reconcile(appID, history);
+            break;
+        }
+        default:
+            registry.add(appID, id, group);
+            toasts[id] = group;
+        }
+
+        const auto prefix = randomId().substr(0, random.below(3));
+        Ids expectedPrefix;
+        Ids expectedGroup;
+        for (const auto &[toastId, toastGroup] : toasts) {
+            if (toastId.rfind(prefix, 0) == 0) {
+                expectedPrefix.push_back(toastId);
+            }
+            if (toastGroup == group) {
+                expectedGroup.push_back(toastId);
+            }
+        }
+        SNORETOAST_CHECK(ids(registry.withPrefix(appID, prefix)) == expectedPrefix);
+        SNORETOAST_CHECK(ids(registry.inGroup(appID, group)) == expectedGroup);
+        SNORETOAST_COMPARE(registry.entries(appID).size(), toasts.size());
+        const auto found = registry.find(appID, id);
+        SNORETOAST_COMPARE(bool(found), toasts.count(id) == 1);
+    }
+}
+
+SNORETOAST_TEST(ToastRegistry_BulkCloseThroughSnoreToasts)
+{
+    MockNotificationBackend backend;
+    std::vector<std::unique_ptr<SnoreToasts>> toasts;
+    for (const auto id : { L"job.1", L"job.2", L"job.3", L"mail.1" }) {
+        auto toast = std::make_unique<SnoreToasts>(&backend, L"Registry.App");
+        toast->setId(id);
+        toast->setGroup(id[0] == L'j' ? L"jobs" : L"mail");
+        SNORETOAST_CHECK(toast->displayToast(L"Title", id, {}));
+        toasts.push_back(std::move(toast));
+    }
+    // a toast of another process, only known from the history
+    ToastContent foreign;
+    foreign.id = L"job.4";
+    foreign.group = L"jobs";
+    SNORETOAST_CHECK(backend.show(L"Registry.App", foreign, nullptr));
+
+    SnoreToasts closer(&backend, L"Registry.App");
+    SNORETOAST_COMPARE(closer.notifications().size(), size_t(5));
+    SNORETOAST_COMPARE(closer.closeNotificationsWithPrefix(L"job.1"), size_t(1));
+    SNORETOAST_CHECK(toasts[0]->userAction() == SnoreToastActions::Actions::Hidden);
+    SNORETOAST_COMPARE(closer.closeGroup(L"jobs"), size_t(3));
+    SNORETOAST_CHECK(!backend.toast(L"job.4"));
+    // the instances that showed the toasts hide them
+    for (size_t i = 1; i < 3; ++i) {
+        SNORETOAST_CHECK(toasts[i]->userAction() == SnoreToastActions::Actions::Hidden);
+    }
+    SNORETOAST_CHECK(ids(closer.notifications()) == Ids({ L"mail.1" }));
+    SNORETOAST_COMPARE(closer.closeGroup(L"jobs"), size_t(0));
+}
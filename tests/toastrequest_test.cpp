@@ -0,0 +1,299 @@
+/*
+    SnoreToast is capable to invoke Windows 8 toast notifications.
+    Copyright (C) 2026  Hannah von Reth <vonreth@kde.org>
+
+    SnoreToast is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    SnoreToast is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with SnoreToast.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "testing.h"
+
+#include "optionparser.h"
+#include "toastrequest.h"
+
+#include <string>
+#include <vector>
+
+using namespace std::chrono_literals;
+using Mode = ToastRequest::Mode;
+
+namespace {
+// a table exercising what the ToastRequest table doesn't
+struct Target
+{
+    std::wstring first;
+    std::wstring second;
+    size_t choice = 0;
+    bool flag = false;
+};
+using TestOption = OptionParser::Option<Target>;
+constexpr TestOption TestOptions[] = {
+    TestOption::value(L"-pair", L"<a> <b>", L"Two values.",
+                      [](Target &t, const std::wstring *v, size_t) {
+                          t.first = v[0];
+                          t.second = v[1];
+                      },
+                      OptionParser::Optional, 2),
+    TestOption::choice(L"-c", L"( x | y | z )", L"A choice.",
+                       [](Target &t, const std::wstring *, size_t c) { t.choice = c; }),
+    TestOption::flag(L"-stop", L"Ends the parsing.",
+                     [](Target &t, const std::wstring *, size_t) { t.flag = true; },
+                     OptionParser::Terminal),
+};
+static_assert(OptionParser::isValid(TestOptions));
+
+constexpr TestOption DuplicateOptions[] = {
+    TestOption::flag(L"-a", L"", [](Target &, const std::wstring *, size_t) { }),
+    TestOption::flag(L"-A", L"", [](Target &, const std::wstring *, size_t) { }),
+};
+static_assert(!OptionParser::isValid(DuplicateOptions));
+
+constexpr TestOption SingleChoiceOptions[] = {
+    TestOption::choice(L"-a", L"(x)", L"", [](Target &, const std::wstring *, size_t) { }),
+};
+static_assert(!OptionParser::isValid(SingleChoiceOptions));
+
+static_assert(OptionParser::choiceIndex(L"(short | long)", L"long") == 1);
+static_assert(OptionParser::choiceIndex(L"(short | long)", L"Long") == std::wstring_view::npos);
+
+ToastRequest parse(std::vector<std::wstring> args, unsigned inputs = ToastRequest::NoInput)
+{
+    return ToastRequest::fromArguments(args, inputs);
+}
+}
+
+SNORETOAST_TEST(OptionParser_Table)
+{
+    Target target;
+    std::wstring error;
+    SNORETOAST_CHECK(OptionParser::parse(TestOptions, { L"-PAIR", L"1", L"2", L"-c", L"z" },
+                                         target, error));
+    SNORETOAST_COMPARE(target.first, L"1");
+    SNORETOAST_COMPARE(target.second, L"2");
+    SNORETOAST_COMPARE(target.choice, size_t(2));
+
+    // a terminal option ends the parsing, the rest is not validated
+    target = {};
+    SNORETOAST_CHECK(OptionParser::parse(TestOptions, { L"-stop", L"-unknown" }, target, error));
+    SNORETOAST_CHECK(target.flag);
+
+    SNORETOAST_CHECK(!OptionParser::parse(TestOptions, { L"-pair", L"1" }, target, error));
+    SNORETOAST_COMPARE(error, L"Missing argument to -pair.\nSupply argument as -pair <a> <b>");
+    SNORETOAST_CHECK(!OptionParser::parse(TestOptions, { L"-c", L"w" }, target, error));
+    SNORETOAST_COMPARE(error, L"w is not a valid argument to -c");
+    SNORETOAST_CHECK(!OptionParser::parse(TestOptions, { L"pair" }, target, error));
+    SNORETOAST_COMPARE(error, L"Unknown argument: pair\n");
+}
+
+SNORETOAST_TEST(OptionParser_HelpText)
+{
+    const auto help = OptionParser::helpText(TestOptions);
+    SNORETOAST_COMPARE(help.substr(0, help.find(L'\n')),
+                       L"[-pair] <a> <b>                         | Two values.");
+    SNORETOAST_CHECK(help.find(L"\n-stop ") != std::wstring::npos);
+
+    // every option of the application is documented
+    const auto toastHelp = ToastRequest::helpText();
+    for (const auto option : { L"[-t] <title string>", L"-close <id1;id2>", L"[-coalesce]",
+                               L"-install <name> <application> <appID>", L"@<file>" }) {
+        SNORETOAST_CHECK(toastHelp.find(option) != std::wstring::npos);
+    }
+    // the help lines are aligned
+    for (size_t line = 0; line < toastHelp.size();) {
+        const size_t end = toastHelp.find(L'\n', line);
+        if (end != line) {
+            SNORETOAST_COMPARE(toastHelp.substr(line + 40, 2), L"| ");
+        }
+        line = end + 1;
+    }
+}
+
+SNORETOAST_TEST(OptionParser_SplitCommandLine)
+{
+    using Args = std::vector<std::wstring>;
+    SNORETOAST_CHECK(OptionParser::splitCommandLine(L"  -t  \"a title\"\t-m x ")
+                     == Args({ L"-t", L"a title", L"-m", L"x" }));
+    // the rules of CommandLineToArgvW
+    SNORETOAST_CHECK(OptionParser::splitCommandLine(LR"(a\\b a\"b a\\"b c" "d)")
+                     == Args({ LR"(a\\b)", LR"(a"b)", LR"(a\b c)", L"d" }));
+    SNORETOAST_CHECK(OptionParser::splitCommandLine(LR"("C:\path\" x)")
+                     == Args({ LR"(C:\path" x)" }));
+    SNORETOAST_CHECK(OptionParser::splitCommandLine(L"\"\"") == Args({ L"" }));
+    SNORETOAST_CHECK(OptionParser::splitCommandLine(L" \t").empty());
+}
+
+SNORETOAST_TEST(OptionParser_DecodeText)
+{
+    SNORETOAST_COMPARE(OptionParser::decodeText("a\xc3\xa4"), L"aä");
+    SNORETOAST_COMPARE(OptionParser::decodeText("\xEF\xBB\xBF" "a"), L"a");
+    SNORETOAST_COMPARE(OptionParser::decodeText(std::string_view("\xFF\xFE" "a\0\xe4\0", 6)),
+                       L"aä");
+    // surrogate pairs are combined for 32 bit wchar_t
+    const auto clef = OptionParser::decodeText(std::string_view("\xFF\xFE\x34\xD8\x1E\xDD", 6));
+    SNORETOAST_COMPARE(clef, std::wstring(L"\U0001d11e"));
+}
+
+SNORETOAST_TEST(ToastRequest_Toast)
+{
+    const auto request = parse({ L"-t", L"Title", L"-M", L"Body", L"-id", L"7", L"-d", L"long",
+                                 L"-priority", L"high", L"-protocol", L"2", L"-pipeKeepAlive",
+                                 L"-pipeName", L"pipe", L"-tb", L"-silent" });
+    SNORETOAST_CHECK(request.mode == Mode::Toast);
+    SNORETOAST_COMPARE(request.error, L"");
+    SNORETOAST_COMPARE(request.title, L"Title");
+    SNORETOAST_COMPARE(request.body, L"Body");
+    SNORETOAST_COMPARE(request.id, L"7");
+    SNORETOAST_CHECK(request.duration == Duration::Long);
+    SNORETOAST_CHECK(request.priority == Priority::High);
+    SNORETOAST_COMPARE(request.protocol, 2u);
+    SNORETOAST_CHECK(request.pipeKeepAlive);
+    SNORETOAST_CHECK(request.isTextBoxEnabled);
+    SNORETOAST_CHECK(request.silent);
+    SNORETOAST_COMPARE(request.pipe.string(), "pipe");
+
+    // without text the help is shown
+    SNORETOAST_CHECK(parse({}).mode == Mode::Help);
+    SNORETOAST_CHECK(parse({ L"-t", L"Title" }).mode == Mode::Help);
+}
+
+SNORETOAST_TEST(ToastRequest_Modes)
+{
+    auto request = parse({ L"-close", L"1;2" });
+    SNORETOAST_CHECK(request.mode == Mode::Close);
+    SNORETOAST_COMPARE(request.id, L"1;2");
+    SNORETOAST_CHECK(parse({ L"-closeGroup", L"g" }).mode == Mode::Close);
+    SNORETOAST_CHECK(parse({ L"-list" }).mode == Mode::List);
+    SNORETOAST_CHECK(parse({ L"-v", L"-unknown" }).mode == Mode::Version);
+    SNORETOAST_CHECK(parse({ L"-h" }).mode == Mode::Help);
+
+    request = parse({ L"-batch", L"-", L"-coalesce", L"250", L"-coalesceLimit", L"3",
+                      L"-maxVisible", L"2" });
+    SNORETOAST_CHECK(request.mode == Mode::Batch);
+    SNORETOAST_COMPARE(request.batchFile.string(), "-");
+    SNORETOAST_CHECK(request.coalesceWindow == 250ms);
+    SNORETOAST_COMPARE(request.coalesceLimit, size_t(3));
+    SNORETOAST_COMPARE(request.maxVisible, size_t(2));
+
+    request = parse({ L"-server", L"name", L"-coalesce", L"10" });
+    SNORETOAST_CHECK(request.mode == Mode::Server);
+    SNORETOAST_COMPARE(request.serverName.string(), "name");
+
+    request = parse({ L"-install", L"Name", L"app.exe", L"App.ID", L"-t" });
+    SNORETOAST_CHECK(request.mode == Mode::Install);
+    SNORETOAST_COMPARE(request.shortcut.string(), "Name");
+    SNORETOAST_COMPARE(request.exe.string(), "app.exe");
+    SNORETOAST_COMPARE(request.appID, L"App.ID");
+}
+
+SNORETOAST_TEST(ToastRequest_Errors)
+{
+    const std::vector<std::pair<std::vector<std::wstring>, std::wstring>> cases = {
+        { { L"-x" }, L"Unknown argument: -x\n" },
+        { { L"-t" }, L"Missing argument to -t.\nSupply argument as -t <title string>" },
+        { { L"-t", L"a", L"-m", L"b", L"-d", L"medium" }, L"medium is not a valid argument to -d" },
+        { { L"-t", L"a", L"-m", L"b", L"-deadline", L"12x" },
+          L"12x is not a valid argument to -deadline" },
+        { { L"-t", L"a", L"-m", L"b", L"-deadline", L"-1" },
+          L"-1 is not a valid argument to -deadline" },
+        { { L"-t", L"a", L"-m", L"b", L"-coalesce", L"5" },
+          L"-coalesce requires -server or -batch" },
+        { { L"-server", L"s", L"-maxVisible", L"1" }, L"-maxVisible requires -batch" },
+        { { L"-t", L"a", L"-m", L"b", L"-tb" },
+          L"TextBox notifications only work if a pipe for the result was provided" },
+        { { L"-t", L"a", L"-m", L"b", L"-pipeKeepAlive" }, L"-pipeKeepAlive requires -protocol 2" },
+        { { L"-closePrefix", L"" }, L"Close only works if an -id id was provided." },
+        { { L"-t", L"-", L"-m", L"-" }, L"Only one of -t and -m can be read from stdin" },
+    };
+    for (const auto &[args, error] : cases) {
+        const auto request = parse(args, ToastRequest::StandardInput);
+        SNORETOAST_CHECK(request.mode == Mode::Error);
+        SNORETOAST_COMPARE(request.error, error);
+    }
+}
+
+SNORETOAST_TEST(ToastRequest_ResponseFiles)
+{
+    const Testing::TemporaryDirectory directory;
+    const auto inner = directory.write("inner.txt", "-m \"from the inner file\"\n");
+    const auto outer = directory.write("outer.txt",
+                                       "# a comment\r\n"
+                                       "-t \"a title\" -id 3\r\n"
+                                       "\r\n"
+                                       "@" + inner.string() + "\n");
+    const auto arg = L"@" + outer.wstring();
+
+    auto request = parse({ arg, L"-id", L"4" }, ToastRequest::ResponseFiles);
+    SNORETOAST_CHECK(request.mode == Mode::Toast);
+    SNORETOAST_COMPARE(request.title, L"a title");
+    SNORETOAST_COMPARE(request.body, L"from the inner file");
+    // later arguments win
+    SNORETOAST_COMPARE(request.id, L"4");
+
+    // only expanded if requested, like in -server requests
+    request = parse({ arg });
+    SNORETOAST_CHECK(request.mode == Mode::Error);
+    SNORETOAST_COMPARE(request.error, L"Unknown argument: " + arg + L"\n");
+
+    // utf-16 with a byte order mark
+    const auto utf16 = directory.write("utf16.txt",
+                                       std::string_view("\xFF\xFE-\0t\0 \0\xe4\0", 10));
+    std::vector<std::wstring> args = { L"@" + utf16.wstring() };
+    std::wstring error;
+    SNORETOAST_CHECK(OptionParser::expandResponseFiles(args, error));
+    SNORETOAST_CHECK(args == std::vector<std::wstring>({ L"-t", L"ä" }));
+}
+
+SNORETOAST_TEST(ToastRequest_ResponseFileErrors)
+{
+    const Testing::TemporaryDirectory directory;
+    const auto missing = directory.path() / "missing.txt";
+    auto request = parse({ L"@" + missing.wstring() }, ToastRequest::ResponseFiles);
+    SNORETOAST_CHECK(request.mode == Mode::Error);
+    SNORETOAST_COMPARE(request.error, L"Failed to read the response file: " + missing.wstring());
+
+    // a file including itself
+    const auto self = directory.path() / "self.txt";
+    directory.write("self.txt", "@" + self.string());
+    request = parse({ L"@" + self.wstring() }, ToastRequest::ResponseFiles);
+    SNORETOAST_CHECK(request.mode == Mode::Error);
+    SNORETOAST_COMPARE(request.error, L"Response files are nested too deep: @" + self.wstring());
+
+    // a lone @ is an argument
+    std::vector<std::wstring> args = { L"@" };
+    std::wstring error;
+    SNORETOAST_CHECK(OptionParser::expandResponseFiles(args, error));
+    SNORETOAST_CHECK(args == std::vector<std::wstring>({ L"@" }));
+}
+
+SNORETOAST_TEST(ToastRequest_ResponseFilesKeepValues)
+{
+    // mentions are titles and bodies, not response files
+    auto request = parse({ L"-t", L"@alice", L"-m", L"@bob" }, ToastRequest::ResponseFiles);
+    SNORETOAST_CHECK(request.mode == Mode::Toast);
+    SNORETOAST_COMPARE(request.title, L"@alice");
+    SNORETOAST_COMPARE(request.body, L"@bob");
+
+    // the value of the last option in a file follows on the command line
+    const Testing::TemporaryDirectory directory;
+    const auto file = directory.write("values.txt", "-m @carol\n-t\n");
+    request = parse({ L"@" + file.wstring(), L"@dave" }, ToastRequest::ResponseFiles);
+    SNORETOAST_CHECK(request.mode == Mode::Toast);
+    SNORETOAST_COMPARE(request.title, L"@dave");
+    SNORETOAST_COMPARE(request.body, L"@carol");
+
+    // a file after a value is expanded
+    request = parse({ L"-t", L"@erin", L"@" + file.wstring(), L"@frank" },
+                    ToastRequest::ResponseFiles);
+    SNORETOAST_CHECK(request.mode == Mode::Toast);
+    SNORETOAST_COMPARE(request.title, L"@frank");
+    SNORETOAST_COMPARE(request.body, L"@carol");
+}
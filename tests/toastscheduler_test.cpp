@@ -0,0 +1,266 @@
+/*
+    SnoreToast is capable to invoke Windows 8 toast notifications.
+    Copyright (C) 2026  Hannah von Reth <vonreth@kde.org>
+
+    SnoreToast is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    SnoreToast is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with SnoreToast.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "testing.h"
+
+#include "toastscheduler.h"
+
+#include <optional>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+using namespace std::chrono_literals;
+using Discard = ToastScheduler::Discard;
+using Eviction = ToastScheduler::Eviction;
+
+namespace {
+ToastRequest toast(Priority priority, std::chrono::milliseconds deadline = 0ms)
+{
+    ToastRequest out;
+    out.title = L"Title";
+    out.body = L"Body";
+    out.priority = priority;
+    out.deadline = deadline;
+    return out;
+}
+
+// the tags of the popped toasts until the scheduler is empty
+std::vector<uint64_t> drain(ToastScheduler &scheduler)
+{
+    std::vector<uint64_t> out;
+    while (const auto item = scheduler.pop()) {
+        out.push_back(item->tag);
+    }
+    return out;
+}
+
+struct Recorder
+{
+    explicit Recorder(ToastScheduler &scheduler)
+    {
+        scheduler.setDiscardHandler([this](const ToastScheduler::Item &item, Discard reason) {
+            discarded.emplace_back(item.tag, reason);
+        });
+    }
+
+    std::vector<std::pair<uint64_t, Discard>> discarded;
+};
+}
+
+SNORETOAST_TEST(ToastScheduler_PriorityOrder)
+{
+    ToastScheduler scheduler({});
+    SNORETOAST_CHECK(!scheduler.pop());
+    scheduler.push(toast(Priority::Low), 1);
+    scheduler.push(toast(Priority::Normal), 2);
+    scheduler.push(toast(Priority::High), 3);
+    scheduler.push(toast(Priority::Normal), 4);
+    scheduler.push(toast(Priority::High), 5);
+    scheduler.push(toast(Priority::Low), 6);
+    SNORETOAST_COMPARE(scheduler.size(), size_t(6));
+    // the oldest of the highest priority first
+    SNORETOAST_CHECK(drain(scheduler) == std::vector<uint64_t>({ 3, 5, 2, 4, 1, 6 }));
+    SNORETOAST_COMPARE(scheduler.size(), size_t(0));
+    SNORETOAST_COMPARE(scheduler.memoryUsage(), size_t(0));
+
+    const auto statistics = scheduler.statistics();
+    SNORETOAST_COMPARE(statistics.pushed, uint64_t(6));
+    SNORETOAST_COMPARE(statistics.popped, uint64_t(6));
+    SNORETOAST_COMPARE(statistics.peakSize, size_t(6));
+    SNORETOAST_COMPARE(statistics.peakMemory, 6 * ToastScheduler::approximateSize(toast({})));
+}
+
+SNORETOAST_TEST(ToastScheduler_FifoWithinPriority)
+{
+    ToastScheduler scheduler({});
+    std::vector<uint64_t> expected;
+    for (uint64_t i = 0; i < 100; ++i) {
+        scheduler.push(toast(Priority::Normal), i);
+        expected.push_back(i);
+        // interleaved pops keep the order
+        if (i % 10 == 9) {
+            const auto item = scheduler.pop();
+            SNORETOAST_CHECK(item && item->tag == expected.front());
+            expected.erase(expected.begin());
+        }
+    }
+    SNORETOAST_CHECK(drain(scheduler) == expected);
+}
+
+SNORETOAST_TEST(ToastScheduler_Deadlines)
+{
+    Testing::ManualClock<> clock;
+    ToastScheduler scheduler({}, clock.function());
+    Recorder recorder(scheduler);
+    scheduler.push(toast(Priority::High, 100ms), 1);
+    scheduler.push(toast(Priority::Normal, 300ms), 2);
+    scheduler.push(toast(Priority::Low), 3);
+    scheduler.push(toast(Priority::Low, 100ms), 4);
+
+    clock.advance(99ms);
+    SNORETOAST_COMPARE(scheduler.size(), size_t(4));
+    // the deadline is inclusive
+    clock.advance(1ms);
+    const auto item = scheduler.pop();
+    SNORETOAST_CHECK(item && item->tag == 2);
+    const std::vector<std::pair<uint64_t, Discard>> expected { { 1, Discard::Expired },
+                                                               { 4, Discard::Expired } };
+    SNORETOAST_CHECK(recorder.discarded == expected);
+
+    // without a deadline a toast waits forever, expired toasts are also dropped by push
+    clock.advance(1h);
+    scheduler.push(toast(Priority::Normal, 1ms), 5);
+    clock.advance(1ms);
+    scheduler.push(toast(Priority::Low), 6);
+    SNORETOAST_COMPARE(scheduler.size(), size_t(2));
+    SNORETOAST_CHECK(recorder.discarded.back() == std::make_pair(uint64_t(5), Discard::Expired));
+    SNORETOAST_CHECK(drain(scheduler) == std::vector<uint64_t>({ 3, 6 }));
+
+    const auto statistics = scheduler.statistics();
+    SNORETOAST_COMPARE(statistics.expired, uint64_t(3));
+    SNORETOAST_COMPARE(statistics.popped, uint64_t(3));
+}
+
+SNORETOAST_TEST(ToastScheduler_EvictsLowestPriority)
+{
+    ToastScheduler scheduler({ 3 });
+    Recorder recorder(scheduler);
+    SNORETOAST_CHECK(scheduler.push(toast(Priority::Low), 1));
+    SNORETOAST_CHECK(scheduler.push(toast(Priority::Normal), 2));
+    SNORETOAST_CHECK(scheduler.push(toast(Priority::Low), 3));
+    // the oldest of the lowest priority makes room
+    SNORETOAST_CHECK(scheduler.push(toast(Priority::High), 4));
+    // the same priority evicts the older toast
+    SNORETOAST_CHECK(scheduler.push(toast(Priority::Low), 5));
+    SNORETOAST_CHECK(scheduler.push(toast(Priority::Normal), 6));
+    // a lower priority never evicts
+    SNORETOAST_CHECK(!scheduler.push(toast(Priority::Low), 7));
+
+    const std::vector<std::pair<uint64_t, Discard>> expected { { 1, Discard::Evicted },
+                                                               { 3, Discard::Evicted },
+                                                               { 5, Discard::Evicted },
+                                                               { 7, Discard::Rejected } };
+    SNORETOAST_CHECK(recorder.discarded == expected);
+    SNORETOAST_CHECK(drain(scheduler) == std::vector<uint64_t>({ 4, 2, 6 }));
+
+    const auto statistics = scheduler.statistics();
+    SNORETOAST_COMPARE(statistics.pushed, uint64_t(6));
+    SNORETOAST_COMPARE(statistics.evicted, uint64_t(3));
+    SNORETOAST_COMPARE(statistics.rejected, uint64_t(1));
+    SNORETOAST_COMPARE(statistics.peakSize, size_t(3));
+}
+
+SNORETOAST_TEST(ToastScheduler_RejectsNew)
+{
+    ToastScheduler scheduler({ 2, 16 * 1024 * 1024, Eviction::RejectNew });
+    Recorder recorder(scheduler);
+    SNORETOAST_CHECK(scheduler.push(toast(Priority::Low), 1));
+    SNORETOAST_CHECK(scheduler.push(toast(Priority::Low), 2));
+    SNORETOAST_CHECK(!scheduler.push(toast(Priority::High), 3));
+    const std::vector<std::pair<uint64_t, Discard>> expected { { 3, Discard::Rejected } };
+    SNORETOAST_CHECK(recorder.discarded == expected);
+    SNORETOAST_CHECK(drain(scheduler) == std::vector<uint64_t>({ 1, 2 }));
+    // room again
+    SNORETOAST_CHECK(scheduler.push(toast(Priority::High), 4));
+    SNORETOAST_COMPARE(scheduler.statistics().rejected, uint64_t(1));
+}
+
+SNORETOAST_TEST(ToastScheduler_MemoryLimit)
+{
+    auto large = toast(Priority::Low);
+    large.body.assign(4096, L'x');
+    // the sizes as accounted by the scheduler
+    const auto usage = [](ToastRequest request) {
+        ToastScheduler scheduler({});
+        scheduler.push(std::move(request));
+        return scheduler.memoryUsage();
+    };
+    const size_t small = usage(toast(Priority::Low));
+    const size_t big = usage(large);
+    SNORETOAST_CHECK(big > small + 4096);
+
+    // the large toast fits next to one small toast
+    const size_t limit = big + 2 * small - 1;
+    ToastScheduler scheduler({ 100, limit });
+    Recorder recorder(scheduler);
+    SNORETOAST_CHECK(scheduler.push(toast(Priority::Low), 1));
+    SNORETOAST_CHECK(scheduler.push(toast(Priority::Low), 2));
+    SNORETOAST_COMPARE(scheduler.memoryUsage(), 2 * small);
+    // evicts until the large toast fits
+    SNORETOAST_CHECK(scheduler.push(large, 3));
+    SNORETOAST_COMPARE(scheduler.memoryUsage(), big + small);
+    // a toast larger than the limit is rejected without evicting
+    auto huge = large;
+    huge.body.assign(limit, L'x');
+    SNORETOAST_CHECK(!scheduler.push(huge, 4));
+    SNORETOAST_COMPARE(scheduler.size(), size_t(2));
+
+    const std::vector<std::pair<uint64_t, Discard>> expected { { 1, Discard::Evicted },
+                                                               { 4, Discard::Rejected } };
+    SNORETOAST_CHECK(recorder.discarded == expected);
+    SNORETOAST_COMPARE(scheduler.statistics().peakMemory, big + small);
+
+    ToastScheduler rejecting({ 100, limit, Eviction::RejectNew });
+    SNORETOAST_CHECK(rejecting.push(toast(Priority::Low), 1));
+    SNORETOAST_CHECK(rejecting.push(toast(Priority::Low), 2));
+    SNORETOAST_CHECK(!rejecting.push(large, 3));
+}
+
+SNORETOAST_TEST(ToastScheduler_CloseWakesWaitPop)
+{
+    ToastScheduler scheduler({});
+    scheduler.push(toast(Priority::Normal), 1);
+    std::vector<uint64_t> popped;
+    std::thread worker([&] {
+        while (const auto item = scheduler.waitPop()) {
+            popped.push_back(item->tag);
+        }
+    });
+    // the worker waits for the next toast until the scheduler is closed
+    while (scheduler.size() > 0) {
+        std::this_thread::yield();
+    }
+    scheduler.push(toast(Priority::Normal), 2);
+    scheduler.close();
+    worker.join();
+    // the queued toast is still delivered, a closed scheduler rejects
+    SNORETOAST_CHECK(popped == std::vector<uint64_t>({ 1, 2 }));
+    SNORETOAST_CHECK(!scheduler.push(toast(Priority::High), 3));
+    SNORETOAST_CHECK(!scheduler.waitPop());
+}
+
+SNORETOAST_TEST(ToastScheduler_WaitPopSkipsExpired)
+{
+    Testing::ManualClock<> clock;
+    ToastScheduler scheduler({}, clock.function());
+    Recorder recorder(scheduler);
+    scheduler.push(toast(Priority::Normal, 10ms), 1);
+    clock.advance(10ms);
+    std::optional<ToastScheduler::Item> item;
+    // the expired toast doesn't end the wait
+    std::thread worker([&] { item = scheduler.waitPop(); });
+    while (scheduler.statistics().expired == 0) {
+        std::this_thread::yield();
+    }
+    scheduler.push(toast(Priority::Normal), 2);
+    worker.join();
+    SNORETOAST_CHECK(item && item->tag == 2);
+    SNORETOAST_CHECK(recorder.discarded.size() == 1
+                     && recorder.discarded[0] == std::make_pair(uint64_t(1), Discard::Expired));
+}
@@ -0,0 +1,203 @@
+/*
+    SnoreToast is capable to invoke Windows 8 toast notifications.
+    Copyright (C) 2026  Hannah von Reth <vonreth@kde.org>
+
+    SnoreToast is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    SnoreToast is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with SnoreToast.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "testing.h"
+
+#include "mocknotificationbackend.h"
+#include "snoretoasts.h"
+#include "toastserver.h"
+
+#include <atomic>
+#include <filesystem>
+#include <memory>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+using Actions = SnoreToastActions::Actions;
+using Mode = ToastRequest::Mode;
+
+namespace {
+std::filesystem::path socketName(const Testing::TemporaryDirectory &directory, const char *name)
+{
+#ifdef _WIN32
+    return std::filesystem::path(L"\\\\.\\pipe\\")
+            / (directory.path().filename().string() + "_" + name);
+#else
+    return directory.path() / name;
+#endif
+}
+
+// serves the listener until it is destroyed, all clients have to be gone by then
+class Server
+{
+public:
+    Server(const std::filesystem::path &name, ToastServer::Handler handler,
+           ToastServer::Policy policy = {})
+        : m_listener(LocalSocket::listen(name)), m_server(std::move(handler), policy)
+    {
+        if (m_listener) {
+            m_thread = std::thread([this] { m_server.serve(*m_listener); });
+        }
+    }
+
+    ~Server()
+    {
+        if (m_listener) {
+            m_listener->close();
+            m_thread.join();
+        }
+    }
+
+    bool isListening() const { return m_listener != nullptr; }
+
+private:
+    std::unique_ptr<ToastServerListener> m_listener;
+    ToastServer m_server;
+    std::thread m_thread;
+};
+}
+
+SNORETOAST_TEST(ToastServer_RequestEncoding)
+{
+    const std::vector<std::wstring> args = { L"-m", L"", L"-t", L"Titel ä" };
+    const std::string frame = ToastServer::encodeRequest(42, args);
+    uint32_t serial = 0;
+    std::vector<std::wstring> decoded;
+    SNORETOAST_CHECK(ToastServer::decodeRequest(frame.substr(4), serial, decoded));
+    SNORETOAST_COMPARE(serial, uint32_t(42));
+    SNORETOAST_CHECK(decoded == args);
+
+    // an unterminated argument
+    decoded.clear();
+    SNORETOAST_CHECK(!ToastServer::decodeRequest(frame.substr(4, frame.size() - 5), serial,
+                                                 decoded));
+    SNORETOAST_CHECK(!ToastServer::decodeRequest("abc", serial, decoded));
+}
+
+SNORETOAST_TEST(ToastServer_Requests)
+{
+    const Testing::TemporaryDirectory directory;
+    const auto name = socketName(directory, "requests");
+    std::atomic<size_t> handled = 0;
+    Server server(name, [&handled](const ToastRequest &request, std::string &output) {
+        ++handled;
+        if (request.mode == Mode::List) {
+            output = "a\nb\n";
+            return Actions::Clicked;
+        }
+        return request.mode == Mode::Close ? Actions::Hidden : Actions::Dismissed;
+    });
+    SNORETOAST_CHECK(server.isListening());
+
+    auto connection = LocalSocket::connect(name);
+    SNORETOAST_CHECK(connection);
+    SNORETOAST_CHECK(ToastServer::sendRequest(*connection, 1, { L"-t", L"a", L"-m", L"b" }));
+    SNORETOAST_CHECK(ToastServer::sendRequest(*connection, 2, { L"-list" }));
+    SNORETOAST_CHECK(ToastServer::sendRequest(*connection, 3, { L"-close", L"x" }));
+    // errors and modes the server doesn't handle are not passed to the handler
+    SNORETOAST_CHECK(ToastServer::sendRequest(*connection, 4, { L"-unknown" }));
+    SNORETOAST_CHECK(ToastServer::sendRequest(*connection, 5, { L"-v" }));
+
+    std::vector<std::pair<Actions, std::string>> responses(6);
+    for (int i = 0; i < 5; ++i) {
+        uint32_t serial = 0;
+        Actions action;
+        std::string output;
+        SNORETOAST_CHECK(ToastServer::readResponse(*connection, serial, action, &output));
+        SNORETOAST_CHECK(serial >= 1 && serial <= 5);
+        responses[serial] = { action, output };
+    }
+    SNORETOAST_CHECK(responses[1] == std::make_pair(Actions::Dismissed, std::string()));
+    SNORETOAST_CHECK(responses[2] == std::make_pair(Actions::Clicked, std::string("a\nb\n")));
+    SNORETOAST_CHECK(responses[3] == std::make_pair(Actions::Hidden, std::string()));
+    SNORETOAST_CHECK(responses[4].first == Actions::Error);
+    SNORETOAST_CHECK(responses[5].first == Actions::Error);
+    SNORETOAST_COMPARE(handled.load(), size_t(3));
+}
+
+SNORETOAST_TEST(ToastServer_ListenFailure)
+{
+    const Testing::TemporaryDirectory directory;
+#ifdef _WIN32
+    // the first instance owns the name
+    const auto name = socketName(directory, "owned");
+    const auto first = LocalSocket::listen(name);
+    SNORETOAST_CHECK(first);
+    SNORETOAST_CHECK(!LocalSocket::listen(name));
+#else
+    SNORETOAST_CHECK(!LocalSocket::listen(directory.path() / "missing" / "socket"));
+#endif
+    SNORETOAST_CHECK(!LocalSocket::connect(socketName(directory, "nobody")));
+}
+
+// toasts shown on the mock backend by many clients at once, each pipelining its requests
+SNORETOAST_TEST(ToastServer_LoadManyClients)
+{
+    constexpr size_t Clients = 32;
+    constexpr size_t Requests = 64;
+    const Testing::TemporaryDirectory directory;
+    const auto name = socketName(directory, "load");
+    MockNotificationBackend backend;
+    Server server(
+            name,
+            [&backend](const ToastRequest &request, std::string &) {
+                SnoreToasts toast(&backend, L"Server.App");
+                toast.setId(request.id);
+                toast.displayToast(request.title, request.body, {});
+                backend.activate(request.id);
+                return toast.userAction();
+            },
+            { 8 });
+    SNORETOAST_CHECK(server.isListening());
+
+    std::atomic<size_t> failures = 0;
+    std::vector<std::thread> clients;
+    for (size_t c = 0; c < Clients; ++c) {
+        clients.emplace_back([&, c] {
+            auto connection = LocalSocket::connect(name);
+            if (!connection) {
+                ++failures;
+                return;
+            }
+            for (uint32_t i = 0; i < Requests; ++i) {
+                const auto id = std::to_wstring(c) + L"." + std::to_wstring(i);
+                if (!ToastServer::sendRequest(*connection, i,
+                                              { L"-t", L"Load", L"-m", id, L"-id", id })) {
+                    ++failures;
+                    return;
+                }
+            }
+            std::set<uint32_t> serials;
+            for (size_t i = 0; i < Requests; ++i) {
+                uint32_t serial = 0;
+                Actions action;
+                if (!ToastServer::readResponse(*connection, serial, action)
+                    || action != Actions::Clicked || !serials.insert(serial).second) {
+                    ++failures;
+                    return;
+                }
+            }
+        });
+    }
+    for (auto &client : clients) {
+        client.join();
+    }
+    SNORETOAST_COMPARE(failures.load(), size_t(0));
+    SNORETOAST_COMPARE(backend.showCount(), Clients * Requests);
+}